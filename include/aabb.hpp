@@ -0,0 +1,570 @@
+#ifndef FZOLV_AABB_kqz9bv
+#define FZOLV_AABB_kqz9bv
+
+#include <batch.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <parallel.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        template <typename T>
+        constexpr auto lowerOf(T a, T b) -> T
+        {
+            return b < a ? b : a;
+        }
+
+        template <typename T>
+        constexpr auto upperOf(T a, T b) -> T
+        {
+            return a < b ? b : a;
+        }
+    }
+
+    /**
+     * @brief An axis-aligned 2D box given by its minimum and maximum corners, boundaries included
+     *
+     * A box whose minimum exceeds its maximum on some axis is empty. Empty() returns the inverted box that every union
+     * and expansion starts from, so a box can be grown point by point without special-casing the first point.
+     *
+     * @tparam T The type of the vector components, must be numeric
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class AABB2
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector2<T>;
+
+        /**
+         * @brief Default constructor, creates the degenerate box containing only the origin
+         */
+        constexpr AABB2() = default;
+
+        constexpr AABB2(const Vector2<T> &minCorner, const Vector2<T> &maxCorner) : min{minCorner}, max{maxCorner} {}
+
+        /**
+         * @brief The empty box, the identity of Union and expand
+         */
+        static constexpr auto Empty() -> AABB2
+        {
+            constexpr T high = std::numeric_limits<T>::max();
+            constexpr T low = std::numeric_limits<T>::lowest();
+            return {{high, high}, {low, low}};
+        }
+
+        /**
+         * @brief Create the box with the given center and half extents
+         */
+        static constexpr auto FromCenterExtents(const Vector2<T> &center, const Vector2<T> &halfExtents) -> AABB2
+        {
+            return {center - halfExtents, center + halfExtents};
+        }
+
+        /**
+         * @brief Create the smallest box containing every point, empty for no points
+         */
+        static constexpr auto FromPoints(span<const Vector2<T>> points) -> AABB2
+        {
+            AABB2 box = Empty();
+            for (const auto &point : points)
+            {
+                box.expand(point);
+            }
+            return box;
+        }
+
+        /**
+         * @brief The smallest box containing both boxes
+         */
+        static constexpr auto Union(const AABB2 &a, const AABB2 &b) -> AABB2
+        {
+            return {{detail::lowerOf(a.min.x, b.min.x), detail::lowerOf(a.min.y, b.min.y)},
+                    {detail::upperOf(a.max.x, b.max.x), detail::upperOf(a.max.y, b.max.y)}};
+        }
+
+        /**
+         * @brief The region shared by both boxes, empty when they do not overlap
+         */
+        static constexpr auto Intersection(const AABB2 &a, const AABB2 &b) -> AABB2
+        {
+            return {{detail::upperOf(a.min.x, b.min.x), detail::upperOf(a.min.y, b.min.y)},
+                    {detail::lowerOf(a.max.x, b.max.x), detail::lowerOf(a.max.y, b.max.y)}};
+        }
+
+        [[nodiscard]] constexpr auto isEmpty() const -> bool { return min.x > max.x || min.y > max.y; }
+
+        [[nodiscard]] constexpr auto center() const -> Vector2<T> { return (min + max) / T(2); }
+
+        [[nodiscard]] constexpr auto size() const -> Vector2<T> { return max - min; }
+
+        [[nodiscard]] constexpr auto halfExtents() const -> Vector2<T> { return size() / T(2); }
+
+        [[nodiscard]] constexpr auto area() const -> T { return (max.x - min.x) * (max.y - min.y); }
+
+        ///< Half the perimeter, the cost metric of bounding volume hierarchies in 2D
+        [[nodiscard]] constexpr auto halfPerimeter() const -> T { return (max.x - min.x) + (max.y - min.y); }
+
+        [[nodiscard]] constexpr auto contains(const Vector2<T> &point) const -> bool
+        {
+            return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+        }
+
+        [[nodiscard]] constexpr auto contains(const AABB2 &other) const -> bool
+        {
+            return other.min.x >= min.x && other.max.x <= max.x && other.min.y >= min.y && other.max.y <= max.y;
+        }
+
+        /**
+         * @brief Whether the boxes share at least one point, touching boxes overlap
+         */
+        [[nodiscard]] constexpr auto overlaps(const AABB2 &other) const -> bool
+        {
+            return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+        }
+
+        /**
+         * @brief Grow the box in-place so that it contains a point and return a reference to itself
+         */
+        constexpr auto expand(const Vector2<T> &point) -> AABB2 &
+        {
+            min = {detail::lowerOf(min.x, point.x), detail::lowerOf(min.y, point.y)};
+            max = {detail::upperOf(max.x, point.x), detail::upperOf(max.y, point.y)};
+            return *this;
+        }
+
+        constexpr auto expand(const AABB2 &other) -> AABB2 & { return *this = Union(*this, other); }
+
+        /**
+         * @brief Move every side outwards by margin in-place, or inwards for a negative margin
+         */
+        constexpr auto inflate(T margin) -> AABB2 &
+        {
+            min -= Vector2<T>{margin, margin};
+            max += Vector2<T>{margin, margin};
+            return *this;
+        }
+
+        constexpr auto operator==(const AABB2 &other) const -> bool { return min == other.min && max == other.max; }
+
+        constexpr auto operator!=(const AABB2 &other) const -> bool { return !(*this == other); }
+
+        Vector2<T> min;
+        Vector2<T> max;
+    };
+
+    /**
+     * @brief An axis-aligned 3D box given by its minimum and maximum corners, see AABB2
+     *
+     * @tparam T The type of the vector components, must be numeric
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class AABB3
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector3<T>;
+
+        constexpr AABB3() = default;
+
+        constexpr AABB3(const Vector3<T> &minCorner, const Vector3<T> &maxCorner) : min{minCorner}, max{maxCorner} {}
+
+        static constexpr auto Empty() -> AABB3
+        {
+            constexpr T high = std::numeric_limits<T>::max();
+            constexpr T low = std::numeric_limits<T>::lowest();
+            return {{high, high, high}, {low, low, low}};
+        }
+
+        static constexpr auto FromCenterExtents(const Vector3<T> &center, const Vector3<T> &halfExtents) -> AABB3
+        {
+            return {center - halfExtents, center + halfExtents};
+        }
+
+        static constexpr auto FromPoints(span<const Vector3<T>> points) -> AABB3
+        {
+            AABB3 box = Empty();
+            for (const auto &point : points)
+            {
+                box.expand(point);
+            }
+            return box;
+        }
+
+        static constexpr auto Union(const AABB3 &a, const AABB3 &b) -> AABB3
+        {
+            return {{detail::lowerOf(a.min.x, b.min.x), detail::lowerOf(a.min.y, b.min.y), detail::lowerOf(a.min.z, b.min.z)},
+                    {detail::upperOf(a.max.x, b.max.x), detail::upperOf(a.max.y, b.max.y), detail::upperOf(a.max.z, b.max.z)}};
+        }
+
+        static constexpr auto Intersection(const AABB3 &a, const AABB3 &b) -> AABB3
+        {
+            return {{detail::upperOf(a.min.x, b.min.x), detail::upperOf(a.min.y, b.min.y), detail::upperOf(a.min.z, b.min.z)},
+                    {detail::lowerOf(a.max.x, b.max.x), detail::lowerOf(a.max.y, b.max.y), detail::lowerOf(a.max.z, b.max.z)}};
+        }
+
+        [[nodiscard]] constexpr auto isEmpty() const -> bool
+        {
+            return min.x > max.x || min.y > max.y || min.z > max.z;
+        }
+
+        [[nodiscard]] constexpr auto center() const -> Vector3<T> { return (min + max) / T(2); }
+
+        [[nodiscard]] constexpr auto size() const -> Vector3<T> { return max - min; }
+
+        [[nodiscard]] constexpr auto halfExtents() const -> Vector3<T> { return size() / T(2); }
+
+        [[nodiscard]] constexpr auto volume() const -> T { return (max.x - min.x) * (max.y - min.y) * (max.z - min.z); }
+
+        ///< Half the surface area, the cost metric of bounding volume hierarchies
+        [[nodiscard]] constexpr auto halfSurfaceArea() const -> T
+        {
+            const Vector3<T> extent = size();
+            return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+        }
+
+        [[nodiscard]] constexpr auto contains(const Vector3<T> &point) const -> bool
+        {
+            return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y && point.z >= min.z &&
+                   point.z <= max.z;
+        }
+
+        [[nodiscard]] constexpr auto contains(const AABB3 &other) const -> bool
+        {
+            return other.min.x >= min.x && other.max.x <= max.x && other.min.y >= min.y && other.max.y <= max.y &&
+                   other.min.z >= min.z && other.max.z <= max.z;
+        }
+
+        [[nodiscard]] constexpr auto overlaps(const AABB3 &other) const -> bool
+        {
+            return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y &&
+                   min.z <= other.max.z && max.z >= other.min.z;
+        }
+
+        constexpr auto expand(const Vector3<T> &point) -> AABB3 &
+        {
+            min = {detail::lowerOf(min.x, point.x), detail::lowerOf(min.y, point.y), detail::lowerOf(min.z, point.z)};
+            max = {detail::upperOf(max.x, point.x), detail::upperOf(max.y, point.y), detail::upperOf(max.z, point.z)};
+            return *this;
+        }
+
+        constexpr auto expand(const AABB3 &other) -> AABB3 & { return *this = Union(*this, other); }
+
+        constexpr auto inflate(T margin) -> AABB3 &
+        {
+            min -= Vector3<T>{margin, margin, margin};
+            max += Vector3<T>{margin, margin, margin};
+            return *this;
+        }
+
+        constexpr auto operator==(const AABB3 &other) const -> bool { return min == other.min && max == other.max; }
+
+        constexpr auto operator!=(const AABB3 &other) const -> bool { return !(*this == other); }
+
+        Vector3<T> min;
+        Vector3<T> max;
+    };
+
+    using AABB2f = AABB2<float>;
+    using AABB2i = AABB2<int>;
+    using AABB3f = AABB3<float>;
+
+    static_assert(std::is_trivially_copyable<AABB2f>::value, "AABB2f must be trivially copyable");
+    static_assert(sizeof(AABB2f) == 4 * sizeof(float), "AABB2f must load as one SIMD register");
+    static_assert(sizeof(AABB3f) == 6 * sizeof(float), "AABB3f must not contain padding");
+
+    namespace batch
+    {
+        /**
+         * @brief The number of 64-bit words in the bitmask of count boxes
+         */
+        constexpr auto maskWords(std::size_t count) -> std::size_t { return (count + 63) / 64; }
+
+        namespace detail
+        {
+            /**
+             * @brief Fill the mask one word at a time, test(i) returns the overlap bit of box i
+             *
+             * Each word is built in a register and stored once, instead of a read-modify-write per box.
+             */
+            template <typename Test>
+            inline void fillMask(std::uint64_t *mask, std::size_t count, Test test)
+            {
+                for (std::size_t base = 0; base < count; base += 64)
+                {
+                    const std::size_t end = count - base < 64 ? count - base : 64;
+                    std::uint64_t word = 0;
+                    for (std::size_t bit = 0; bit < end; ++bit)
+                    {
+                        word |= static_cast<std::uint64_t>(test(base + bit)) << bit;
+                    }
+                    mask[base / 64] = word;
+                }
+            }
+
+            namespace scalar
+            {
+                inline void overlaps(const AABB2f *boxes, const AABB2f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    fillMask(mask, count, [&](std::size_t i) { return boxes[i].overlaps(query); });
+                }
+
+                inline void overlaps(const AABB3f *boxes, const AABB3f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    fillMask(mask, count, [&](std::size_t i) { return boxes[i].overlaps(query); });
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                /**
+                 * @brief Test one box per register: [min.x, min.y, -max.x, -max.y] <= [qmax.x, qmax.y, -qmin.x, -qmin.y]
+                 *
+                 * Negation is exact, so all four comparisons match the scalar ones, NaNs included.
+                 */
+                inline void overlaps(const AABB2f *boxes, const AABB2f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const __m128 sign = _mm_set_ps(-0.0F, -0.0F, 0.0F, 0.0F);
+                    const __m128 bound = _mm_xor_ps(_mm_set_ps(query.min.y, query.min.x, query.max.y, query.max.x), sign);
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 const __m128 box = _mm_xor_ps(_mm_loadu_ps(data + 4 * i), sign);
+                                 return _mm_movemask_ps(_mm_cmple_ps(box, bound)) == 0xF;
+                             });
+                }
+
+                /**
+                 * @brief Test one box with two overlapping loads, [min.x, min.y, min.z, -max.x] and
+                 * [min.z, -max.x, -max.y, -max.z], both inside the six floats of the box
+                 */
+                inline void overlaps(const AABB3f *boxes, const AABB3f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const __m128 lowSign = _mm_set_ps(-0.0F, 0.0F, 0.0F, 0.0F);
+                    const __m128 highSign = _mm_set_ps(-0.0F, -0.0F, -0.0F, 0.0F);
+                    const __m128 lowBound =
+                        _mm_xor_ps(_mm_set_ps(query.min.x, query.max.z, query.max.y, query.max.x), lowSign);
+                    const __m128 highBound =
+                        _mm_xor_ps(_mm_set_ps(query.min.z, query.min.y, query.min.x, query.max.z), highSign);
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 const __m128 low = _mm_xor_ps(_mm_loadu_ps(data + 6 * i), lowSign);
+                                 const __m128 high = _mm_xor_ps(_mm_loadu_ps(data + 6 * i + 2), highSign);
+                                 const __m128 inside = _mm_and_ps(_mm_cmple_ps(low, lowBound), _mm_cmple_ps(high, highBound));
+                                 return _mm_movemask_ps(inside) == 0xF;
+                             });
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                ///< Two boxes per register, the same comparisons as the SSE2 kernel
+                FZOLV_TARGET_AVX2 inline void overlaps(const AABB2f *boxes, const AABB2f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const __m256 sign = _mm256_set_ps(-0.0F, -0.0F, 0.0F, 0.0F, -0.0F, -0.0F, 0.0F, 0.0F);
+                    const __m256 bound = _mm256_xor_ps(_mm256_set_ps(query.min.y, query.min.x, query.max.y, query.max.x,
+                                                                     query.min.y, query.min.x, query.max.y, query.max.x),
+                                                       sign);
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    const std::size_t full = count & ~std::size_t{63};
+                    for (std::size_t base = 0; base < full; base += 64)
+                    {
+                        std::uint64_t word = 0;
+                        for (std::size_t bit = 0; bit < 64; bit += 2)
+                        {
+                            const __m256 box = _mm256_xor_ps(_mm256_loadu_ps(data + 4 * (base + bit)), sign);
+                            const int bits = _mm256_movemask_ps(_mm256_cmp_ps(box, bound, _CMP_LE_OQ));
+                            const std::uint64_t pair = static_cast<std::uint64_t>((bits & 0xF) == 0xF) |
+                                                       (static_cast<std::uint64_t>((bits >> 4) == 0xF) << 1);
+                            word |= pair << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                    if (full < count)
+                    {
+                        sse2::overlaps(boxes + full, query, mask + full / 64, count - full);
+                    }
+                }
+
+                /**
+                 * @brief Two boxes per pair of registers, the first eight and the last eight of their twelve floats
+                 *
+                 * Lanes 0-5 of the first load hold the first box and lanes 2-7 of the second load the second one, the
+                 * other lanes repeat components of the neighbouring box and are ignored.
+                 */
+                FZOLV_TARGET_AVX2 inline void overlaps(const AABB3f *boxes, const AABB3f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const __m256 frontSign = _mm256_set_ps(0.0F, 0.0F, -0.0F, -0.0F, -0.0F, 0.0F, 0.0F, 0.0F);
+                    const __m256 backSign = _mm256_set_ps(-0.0F, -0.0F, -0.0F, 0.0F, 0.0F, 0.0F, -0.0F, -0.0F);
+                    const __m256 frontBound = _mm256_xor_ps(_mm256_set_ps(query.max.y, query.max.x, query.min.z, query.min.y,
+                                                                          query.min.x, query.max.z, query.max.y, query.max.x),
+                                                            frontSign);
+                    const __m256 backBound = _mm256_xor_ps(_mm256_set_ps(query.min.z, query.min.y, query.min.x, query.max.z,
+                                                                         query.max.y, query.max.x, query.min.z, query.min.y),
+                                                           backSign);
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    const std::size_t full = count & ~std::size_t{63};
+                    for (std::size_t base = 0; base < full; base += 64)
+                    {
+                        std::uint64_t word = 0;
+                        for (std::size_t bit = 0; bit < 64; bit += 2)
+                        {
+                            const float *pair = data + 6 * (base + bit);
+                            const __m256 front = _mm256_xor_ps(_mm256_loadu_ps(pair), frontSign);
+                            const __m256 back = _mm256_xor_ps(_mm256_loadu_ps(pair + 4), backSign);
+                            const int first = _mm256_movemask_ps(_mm256_cmp_ps(front, frontBound, _CMP_LE_OQ));
+                            const int second = _mm256_movemask_ps(_mm256_cmp_ps(back, backBound, _CMP_LE_OQ));
+                            const std::uint64_t both = static_cast<std::uint64_t>((first & 0x3F) == 0x3F) |
+                                                       (static_cast<std::uint64_t>((second >> 2) == 0x3F) << 1);
+                            word |= both << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                    if (full < count)
+                    {
+                        sse2::overlaps(boxes + full, query, mask + full / 64, count - full);
+                    }
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                ///< One box per register, the same comparisons as the SSE2 kernel
+                inline void overlaps(const AABB2f *boxes, const AABB2f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const uint32x4_t sign = {0U, 0U, 0x80000000U, 0x80000000U};
+                    const float lanes[4] = {query.max.x, query.max.y, query.min.x, query.min.y};
+                    const float32x4_t bound = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vld1q_f32(lanes)), sign));
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 const float32x4_t box =
+                                     vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vld1q_f32(data + 4 * i)), sign));
+                                 return vminvq_u32(vcleq_f32(box, bound)) != 0;
+                             });
+                }
+
+                ///< One box per pair of overlapping loads, the same lanes as the SSE2 kernel
+                inline void overlaps(const AABB3f *boxes, const AABB3f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    const uint32x4_t lowSign = {0U, 0U, 0U, 0x80000000U};
+                    const uint32x4_t highSign = {0U, 0x80000000U, 0x80000000U, 0x80000000U};
+                    const float lowLanes[4] = {query.max.x, query.max.y, query.max.z, query.min.x};
+                    const float highLanes[4] = {query.max.z, query.min.x, query.min.y, query.min.z};
+                    const uint32x4_t lowBound = veorq_u32(vreinterpretq_u32_f32(vld1q_f32(lowLanes)), lowSign);
+                    const uint32x4_t highBound = veorq_u32(vreinterpretq_u32_f32(vld1q_f32(highLanes)), highSign);
+                    const auto *data = reinterpret_cast<const float *>(boxes);
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 const uint32x4_t low = veorq_u32(vreinterpretq_u32_f32(vld1q_f32(data + 6 * i)), lowSign);
+                                 const uint32x4_t high = veorq_u32(vreinterpretq_u32_f32(vld1q_f32(data + 6 * i + 2)), highSign);
+                                 const uint32x4_t inside =
+                                     vandq_u32(vcleq_f32(vreinterpretq_f32_u32(low), vreinterpretq_f32_u32(lowBound)),
+                                               vcleq_f32(vreinterpretq_f32_u32(high), vreinterpretq_f32_u32(highBound)));
+                                 return vminvq_u32(inside) != 0;
+                             });
+                }
+            }
+#endif
+
+            namespace best
+            {
+                inline void overlaps(const AABB2f *boxes, const AABB2f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    FZOLV_DISPATCH(overlaps, (boxes, query, mask, count))
+                }
+
+                inline void overlaps(const AABB3f *boxes, const AABB3f &query, std::uint64_t *mask, std::size_t count)
+                {
+                    FZOLV_DISPATCH(overlaps, (boxes, query, mask, count))
+                }
+            }
+        }
+
+        /**
+         * @brief Test every box against one query box and record the result as a bitmask
+         *
+         * Bit i % 64 of mask[i / 64] is set when boxes[i].overlaps(query). Every word of mask is overwritten and bits
+         * past the last box are cleared. For AABB2f and AABB3f the tests run on the kernels of simd::activeLevel().
+         *
+         * @param boxes The boxes to test
+         * @param query The box to test against
+         * @param mask The result bits, must hold exactly maskWords(boxes.size()) words
+         */
+        template <typename T>
+        void overlaps(span<const AABB2<T>> boxes, const AABB2<T> &query, span<std::uint64_t> mask)
+        {
+            assert(mask.size() == maskWords(boxes.size()));
+            if constexpr (std::is_same<T, float>::value)
+            {
+                static_assert(parallelChunkAlignment % 64 == 0, "chunks must not share mask words");
+                ///< Chunks start at multiples of 64 boxes, so every thread writes whole mask words of its own
+                parallelFor(boxes.size(), detail::batchGrain,
+                            [&](std::size_t begin, std::size_t end)
+                            {
+                                detail::best::overlaps(boxes.data() + begin, query, mask.data() + begin / 64,
+                                                       end - begin);
+                            });
+            }
+            else
+            {
+                detail::fillMask(mask.data(), boxes.size(), [&](std::size_t i) { return boxes[i].overlaps(query); });
+            }
+        }
+
+        /**
+         * @brief Test every 3D box against one query box and record the result as a bitmask, see the AABB2 overload
+         */
+        template <typename T>
+        void overlaps(span<const AABB3<T>> boxes, const AABB3<T> &query, span<std::uint64_t> mask)
+        {
+            assert(mask.size() == maskWords(boxes.size()));
+            if constexpr (std::is_same<T, float>::value)
+            {
+                static_assert(parallelChunkAlignment % 64 == 0, "chunks must not share mask words");
+                parallelFor(boxes.size(), detail::batchGrain,
+                            [&](std::size_t begin, std::size_t end)
+                            {
+                                detail::best::overlaps(boxes.data() + begin, query, mask.data() + begin / 64,
+                                                       end - begin);
+                            });
+            }
+            else
+            {
+                detail::fillMask(mask.data(), boxes.size(), [&](std::size_t i) { return boxes[i].overlaps(query); });
+            }
+        }
+
+        ///< Non-template overloads so that containers of boxes convert to spans implicitly
+
+        inline void overlaps(span<const AABB2f> boxes, const AABB2f &query, span<std::uint64_t> mask)
+        {
+            overlaps<float>(boxes, query, mask);
+        }
+
+        inline void overlaps(span<const AABB3f> boxes, const AABB3f &query, span<std::uint64_t> mask)
+        {
+            overlaps<float>(boxes, query, mask);
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_AABB_kqz9bv */
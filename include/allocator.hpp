@@ -0,0 +1,128 @@
+#ifndef FZOLV_ALLOCATOR_3wvywi
+#define FZOLV_ALLOCATOR_3wvywi
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace Fzolv
+{
+    /**
+     * @brief The alignment used for bulk vector storage, one cache line
+     *
+     * 64 bytes covers a cache line on current x86 and ARM cores and is wide enough for aligned AVX-512 loads.
+     */
+    constexpr std::size_t cacheLineSize = 64;
+
+    /**
+     * @brief A standard allocator that hands out over-aligned storage
+     *
+     * AlignedAllocator lets standard containers store lanes of vector components at an alignment suitable for
+     * aligned SIMD loads. By default it uses the global aligned operator new. Constructed from a std::pmr memory
+     * resource, such as a FrameArena, it takes its storage from there instead; like std::pmr::polymorphic_allocator,
+     * it then stays with its container on assignment and swap, and copies of a container fall back to operator new.
+     * Two allocators compare equal when they use the same resource.
+     *
+     * @tparam T The type of the elements to allocate
+     * @tparam Alignment The alignment of every allocation in bytes, must be a power of two
+     */
+    template <typename T, std::size_t Alignment = cacheLineSize>
+    class AlignedAllocator
+    {
+        static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+        static_assert(Alignment >= alignof(T), "Alignment must not be weaker than the alignment of T");
+
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+
+        constexpr AlignedAllocator() noexcept = default;
+
+        /**
+         * @brief Allocate from a memory resource, implicit so that a resource can be passed wherever an allocator is
+         *
+         * @param upstream The resource to allocate from, nullptr for the global aligned operator new
+         */
+        constexpr AlignedAllocator(std::pmr::memory_resource *upstream) noexcept : source{upstream} {} // NOLINT
+
+        template <typename U>
+        constexpr AlignedAllocator(const AlignedAllocator<U, Alignment> &other) noexcept : source{other.resource()}
+        {
+        }
+
+        /**
+         * @brief The resource storage comes from, nullptr for the global aligned operator new
+         */
+        [[nodiscard]] constexpr auto resource() const noexcept -> std::pmr::memory_resource * { return source; }
+
+        ///< Copies of a container may outlive the resource of the original, such as the frame of a FrameArena
+        [[nodiscard]] auto select_on_container_copy_construction() const noexcept -> AlignedAllocator { return {}; }
+
+        /**
+         * @brief Allocate uninitialized storage for count elements
+         *
+         * @param count The number of elements to allocate
+         * @return T* A pointer to storage aligned to Alignment bytes
+         */
+        [[nodiscard]] auto allocate(std::size_t count) -> T *
+        {
+            if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+
+            if (source != nullptr)
+            {
+                return static_cast<T *>(source->allocate(count * sizeof(T), Alignment));
+            }
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        /**
+         * @brief Release storage obtained from allocate
+         *
+         * @param pointer The pointer returned by allocate
+         * @param count The number of elements passed to allocate
+         */
+        void deallocate(T *pointer, std::size_t count) noexcept
+        {
+            if (source != nullptr)
+            {
+                source->deallocate(pointer, count * sizeof(T), Alignment);
+                return;
+            }
+            ::operator delete(pointer, count * sizeof(T), std::align_val_t{Alignment});
+        }
+
+        template <typename U>
+        friend constexpr auto operator==(const AlignedAllocator &lhs, const AlignedAllocator<U, Alignment> &rhs) noexcept
+            -> bool
+        {
+            return lhs.resource() == rhs.resource() ||
+                   (lhs.resource() != nullptr && rhs.resource() != nullptr && lhs.resource()->is_equal(*rhs.resource()));
+        }
+
+        template <typename U>
+        friend constexpr auto operator!=(const AlignedAllocator &lhs, const AlignedAllocator<U, Alignment> &rhs) noexcept
+            -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        std::pmr::memory_resource *source = nullptr;
+    };
+}
+
+#endif /* end of include guard: FZOLV_ALLOCATOR_3wvywi */
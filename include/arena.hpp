@@ -0,0 +1,182 @@
+#ifndef FZOLV_ARENA_oiusee
+#define FZOLV_ARENA_oiusee
+
+#include <algorithm>
+#include <allocator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace Fzolv
+{
+    /**
+     * @brief A linear allocator for scratch buffers that live for one frame, usable as a std::pmr memory resource
+     *
+     * Allocations bump a pointer through a block of upstream memory and always start on a cache line, so SIMD
+     * kernels can use aligned loads on every buffer. Deallocation does nothing. reset() reclaims everything at
+     * once and starts a new generation; when a frame did not fit into one block, the blocks are merged into a single
+     * larger one, so after a few frames the arena reaches a steady state in which it never calls its upstream.
+     *
+     * The arena is not thread-safe. Memory from one generation must not be used after the next reset().
+     */
+    class FrameArena final : public std::pmr::memory_resource
+    {
+    public:
+        /**
+         * @brief Create an arena and allocate its first block
+         *
+         * @param initialCapacity The size of the first block in bytes, 0 to allocate on first use
+         * @param upstream Where the blocks come from
+         */
+        explicit FrameArena(std::size_t initialCapacity = std::size_t{1} << 20,
+                            std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+            : source{upstream}
+        {
+            if (initialCapacity > 0)
+            {
+                pushBlock(initialCapacity);
+            }
+        }
+
+        FrameArena(const FrameArena &) = delete;
+        auto operator=(const FrameArena &) -> FrameArena & = delete;
+
+        ~FrameArena() override { release(); }
+
+        /**
+         * @brief Reclaim every allocation at once and start the next generation
+         */
+        void reset() noexcept
+        {
+            if (head != nullptr && head->next != nullptr)
+            {
+                ///< If the upstream cannot provide the merged block, the newest and largest block is reused instead
+                std::size_t total = 0;
+                for (Block *block = head; block != nullptr; block = block->next)
+                {
+                    total += block->size;
+                }
+                try
+                {
+                    void *merged = source->allocate(total, cacheLineSize);
+                    release();
+                    adoptBlock(merged, total);
+                }
+                catch (...)
+                {
+                    rewindTo(head);
+                }
+            }
+            else if (head != nullptr)
+            {
+                rewindTo(head);
+            }
+            used = 0;
+            ++frame;
+        }
+
+        /**
+         * @brief Return every block to the upstream resource, the next allocation starts a new block
+         */
+        void release() noexcept
+        {
+            while (head != nullptr)
+            {
+                Block *next = head->next;
+                source->deallocate(head, head->size, cacheLineSize);
+                head = next;
+            }
+            cursor = nullptr;
+            limit = nullptr;
+            used = 0;
+        }
+
+        /**
+         * @brief The number of reset() calls so far, memory from an older generation is no longer valid
+         */
+        [[nodiscard]] auto generation() const noexcept -> std::uint64_t { return frame; }
+
+        /**
+         * @brief The number of bytes allocated since the last reset, without alignment padding
+         */
+        [[nodiscard]] auto bytesUsed() const noexcept -> std::size_t { return used; }
+
+        /**
+         * @brief The number of bytes of every block together, block headers included
+         */
+        [[nodiscard]] auto capacity() const noexcept -> std::size_t
+        {
+            std::size_t total = 0;
+            for (Block *block = head; block != nullptr; block = block->next)
+            {
+                total += block->size;
+            }
+            return total;
+        }
+
+        [[nodiscard]] auto upstreamResource() const noexcept -> std::pmr::memory_resource * { return source; }
+
+    private:
+        ///< Placed at the start of every block, the usable memory begins on the next cache line
+        struct Block
+        {
+            Block *next;
+            std::size_t size;
+        };
+
+        static_assert(sizeof(Block) <= cacheLineSize, "the block header must fit in front of the first cache line");
+
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override
+        {
+            const std::size_t align = std::max(alignment, cacheLineSize);
+            std::byte *aligned = alignUp(cursor, align);
+            if (cursor == nullptr || aligned > limit || static_cast<std::size_t>(limit - aligned) < bytes)
+            {
+                const std::size_t grown = head != nullptr ? head->size * 2 : std::size_t{1} << 16;
+                pushBlock(std::max(grown, bytes + align + cacheLineSize));
+                aligned = alignUp(cursor, align);
+            }
+            cursor = aligned + bytes;
+            used += bytes;
+            return aligned;
+        }
+
+        void do_deallocate(void *, std::size_t, std::size_t) noexcept override {}
+
+        auto do_is_equal(const std::pmr::memory_resource &other) const noexcept -> bool override { return this == &other; }
+
+        static auto alignUp(std::byte *pointer, std::size_t alignment) noexcept -> std::byte *
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+            return pointer + ((alignment - address % alignment) % alignment);
+        }
+
+        void pushBlock(std::size_t size)
+        {
+            size = std::max(size, 2 * cacheLineSize);
+            adoptBlock(source->allocate(size, cacheLineSize), size);
+        }
+
+        void adoptBlock(void *memory, std::size_t size) noexcept
+        {
+            head = ::new (memory) Block{head, size};
+            rewindTo(head);
+        }
+
+        void rewindTo(Block *block) noexcept
+        {
+            cursor = reinterpret_cast<std::byte *>(block) + cacheLineSize;
+            limit = reinterpret_cast<std::byte *>(block) + block->size;
+        }
+
+        std::pmr::memory_resource *source;
+        Block *head = nullptr;
+        std::byte *cursor = nullptr;
+        std::byte *limit = nullptr;
+        std::size_t used = 0;
+        std::uint64_t frame = 0;
+    };
+}
+
+#endif /* end of include guard: FZOLV_ARENA_oiusee */
@@ -0,0 +1,1884 @@
+#ifndef FZOLV_BATCH_vk8ynd
+#define FZOLV_BATCH_vk8ynd
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <climits>
+#include <cstddef>
+#include <parallel.hpp>
+#include <profile.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    /**
+     * @brief Batch versions of the Vector2 member functions that operate on whole spans of vectors
+     *
+     * Every kernel computes the same expression as the matching member function, in the same order, so switching an
+     * inner loop from the member function to the batch kernel does not change its results. For Vector2f each call
+     * runs the AVX2, SSE2, NEON or scalar kernel of simd::activeLevel(), picked by FZOLV_DISPATCH in detail::best, so
+     * simd::setLevel switches every batch operation to another level at run time. Results are bit-identical to the
+     * member functions on every level as long as the compiler does not contract the scalar code into fused
+     * multiply-adds, which the Fzolv CMake target ensures with -ffp-contract=off, see simd.hpp.
+     */
+    namespace batch
+    {
+        namespace detail
+        {
+            ///< The rounding of batch::floor, batch::ceil and batch::round, picked at compile time by the kernels
+            enum class RoundMode
+            {
+                Floor,
+                Ceil,
+                Nearest
+            };
+
+            template <RoundMode M>
+            inline auto roundComponent(float value) -> float
+            {
+                if constexpr (M == RoundMode::Floor)
+                {
+                    return math::floor(value);
+                }
+                else if constexpr (M == RoundMode::Ceil)
+                {
+                    return math::ceil(value);
+                }
+                else
+                {
+                    return math::round(value);
+                }
+            }
+
+            /**
+             * @brief Convert an integral float to int, values outside the int range and NaNs become INT_MIN
+             *
+             * INT_MIN is what the x86 conversion instructions return for them, the other kernels produce it too.
+             */
+            inline auto toCell(float value) -> int
+            {
+                return value >= -2147483648.0F && value < 2147483648.0F ? static_cast<int>(value) : INT_MIN;
+            }
+
+            /**
+             * @brief Per-component bounds for clamping interleaved floats, repeated over 24 lanes
+             *
+             * 24 is a multiple of the vector sizes 1, 2 and 3 and of the register widths, so a run of floats starting
+             * at a vector boundary reads the bounds of float i from lane i % 24.
+             */
+            struct BoundLanes
+            {
+                float low[24];
+                float high[24];
+            };
+
+            inline auto boundLanes(const float *low, const float *high, std::size_t components) -> BoundLanes
+            {
+                BoundLanes lanes{};
+                for (std::size_t i = 0; i < 24; ++i)
+                {
+                    lanes.low[i] = low[i % components];
+                    lanes.high[i] = high[i % components];
+                }
+                return lanes;
+            }
+
+            namespace scalar
+            {
+                inline void clamp(const float *in, float *out, std::size_t count, const BoundLanes &bounds)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::clampComponent(in[i], bounds.low[i % 24], bounds.high[i % 24]);
+                    }
+                }
+
+                inline void minimum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = std::min(lhs[i], rhs[i]);
+                    }
+                }
+
+                inline void maximum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = std::max(lhs[i], rhs[i]);
+                    }
+                }
+
+                inline void abs(const float *in, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = std::fabs(in[i]);
+                    }
+                }
+
+                ///< Normalize vectors stored as separate component lanes in-place, like Vector2f::normalize
+
+                inline void normalizeLanes(float *xs, float *ys, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        Vector2f value{xs[i], ys[i]};
+                        value.normalize();
+                        xs[i] = value.x;
+                        ys[i] = value.y;
+                    }
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, float *zs, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        Vector3f value{xs[i], ys[i], zs[i]};
+                        value.normalize();
+                        xs[i] = value.x;
+                        ys[i] = value.y;
+                        zs[i] = value.z;
+                    }
+                }
+
+                template <RoundMode M>
+                inline void round(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = {roundComponent<M>(values[i].x), roundComponent<M>(values[i].y)};
+                    }
+                }
+
+                inline void snapToGrid(const Vector2f *positions, Vector2f cellSize, Vector2i *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = {toCell(math::floor(positions[i].x / cellSize.x)), toCell(math::floor(positions[i].y / cellSize.y))};
+                    }
+                }
+
+                inline void dot(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = lhs[i].dot(rhs[i]);
+                    }
+                }
+
+                inline void cross(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = lhs[i].cross(rhs[i]);
+                    }
+                }
+
+                inline void lengthSquared(const Vector2f *values, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = values[i].lengthSquared();
+                    }
+                }
+
+                inline void distanceToSquared(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = lhs[i].distanceToSquared(rhs[i]);
+                    }
+                }
+
+                inline void normalize(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = values[i].normalized();
+                    }
+                }
+
+                inline void normalizeFast(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = values[i].normalizedFast();
+                    }
+                }
+
+                ///< Interpolation kernels read amounts[i * amountStep], a step of 0 applies one amount to every vector
+
+                inline void lerp(const Vector2f *start, const Vector2f *end, const float *amounts, std::size_t amountStep,
+                                 Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Vector2f::Lerp(start[i], end[i], amounts[i * amountStep]);
+                    }
+                }
+
+                inline void smoothstep(const Vector2f *start, const Vector2f *end, const float *amounts,
+                                       std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Vector2f::SmoothStep(start[i], end[i], amounts[i * amountStep]);
+                    }
+                }
+
+                inline void hermite(const Vector2f *p0, const Vector2f *m0, const Vector2f *p1, const Vector2f *m1,
+                                    const float *amounts, std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Vector2f::Hermite(p0[i], m0[i], p1[i], m1[i], amounts[i * amountStep]);
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                ///< Lanes of a where mask is set and of b elsewhere, SSE2 has no blend
+                inline auto select(__m128 mask, __m128 a, __m128 b) -> __m128
+                {
+                    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+                }
+
+                inline auto select(__m128i mask, __m128i a, __m128i b) -> __m128i
+                {
+                    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+                }
+
+                ///< Load four consecutive vectors and split them into a register of x and a register of y components
+                inline void load4(const Vector2f *values, __m128 &xs, __m128 &ys)
+                {
+                    const auto *raw = reinterpret_cast<const float *>(values);
+                    const __m128 lo = _mm_loadu_ps(raw);
+                    const __m128 hi = _mm_loadu_ps(raw + 4);
+                    xs = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+                    ys = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+                }
+
+                inline void dot(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 ax, ay, bx, by;
+                        load4(lhs + i, ax, ay);
+                        load4(rhs + i, bx, by);
+                        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)));
+                    }
+                    scalar::dot(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void cross(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 ax, ay, bx, by;
+                        load4(lhs + i, ax, ay);
+                        load4(rhs + i, bx, by);
+                        _mm_storeu_ps(out + i, _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+                    }
+                    scalar::cross(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void lengthSquared(const Vector2f *values, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 vx, vy;
+                        load4(values + i, vx, vy);
+                        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+                    }
+                    scalar::lengthSquared(values + i, out + i, count - i);
+                }
+
+                inline void distanceToSquared(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 ax, ay, bx, by;
+                        load4(lhs + i, ax, ay);
+                        load4(rhs + i, bx, by);
+                        const __m128 dx = _mm_sub_ps(ax, bx);
+                        const __m128 dy = _mm_sub_ps(ay, by);
+                        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                    }
+                    scalar::distanceToSquared(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                ///< Interleave registers of x and y components back into four consecutive vectors
+                inline void store4(Vector2f *values, __m128 xs, __m128 ys)
+                {
+                    auto *raw = reinterpret_cast<float *>(values);
+                    _mm_storeu_ps(raw, _mm_unpacklo_ps(xs, ys));
+                    _mm_storeu_ps(raw + 4, _mm_unpackhi_ps(xs, ys));
+                }
+
+                inline void normalize(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const __m128 zero = _mm_setzero_ps();
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 vx, vy;
+                        load4(values + i, vx, vy);
+                        const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+                        const __m128 keep = _mm_cmpeq_ps(len, zero);
+                        vx = _mm_or_ps(_mm_and_ps(keep, vx), _mm_andnot_ps(keep, _mm_div_ps(vx, len)));
+                        vy = _mm_or_ps(_mm_and_ps(keep, vy), _mm_andnot_ps(keep, _mm_div_ps(vy, len)));
+                        store4(out + i, vx, vy);
+                    }
+                    scalar::normalize(values + i, out + i, count - i);
+                }
+
+                inline void normalizeFast(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const __m128 lowest = _mm_set1_ps(FLT_MIN);
+                    const __m128 highest = _mm_set1_ps(FLT_MAX);
+                    const __m128 half = _mm_set1_ps(0.5F);
+                    const __m128 threeHalves = _mm_set1_ps(1.5F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 vx, vy;
+                        load4(values + i, vx, vy);
+                        const __m128 lenSq = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+                        const __m128 inRange = _mm_and_ps(_mm_cmpge_ps(lenSq, lowest), _mm_cmple_ps(lenSq, highest));
+                        if (_mm_movemask_ps(inRange) != 0xF)
+                        {
+                            ///< Rare zero, denormal or non-finite lengths take the exact path, like the member function
+                            scalar::normalizeFast(values + i, out + i, 4);
+                            continue;
+                        }
+
+                        __m128 inv = _mm_rsqrt_ps(lenSq);
+                        inv = _mm_mul_ps(inv, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(half, lenSq), inv), inv)));
+                        store4(out + i, _mm_mul_ps(vx, inv), _mm_mul_ps(vy, inv));
+                    }
+                    scalar::normalizeFast(values + i, out + i, count - i);
+                }
+
+                inline auto loadAmounts(const float *amounts, std::size_t amountStep, std::size_t i) -> __m128
+                {
+                    return amountStep == 0 ? _mm_set1_ps(amounts[0]) : _mm_loadu_ps(amounts + i);
+                }
+
+                inline auto lerp4(__m128 start, __m128 end, __m128 t) -> __m128
+                {
+                    return _mm_add_ps(start, _mm_mul_ps(_mm_sub_ps(end, start), t));
+                }
+
+                ///< max and min return their second operand for NaN, which matches the scalar clamp to 0
+                inline auto smoothstep4(__m128 amount) -> __m128
+                {
+                    const __m128 t = _mm_min_ps(_mm_max_ps(amount, _mm_setzero_ps()), _mm_set1_ps(1.0F));
+                    return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0F), _mm_mul_ps(_mm_set1_ps(2.0F), t)));
+                }
+
+                inline void lerp(const Vector2f *start, const Vector2f *end, const float *amounts, std::size_t amountStep,
+                                 Vector2f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 sx, sy, ex, ey;
+                        load4(start + i, sx, sy);
+                        load4(end + i, ex, ey);
+                        const __m128 t = loadAmounts(amounts, amountStep, i);
+                        store4(out + i, lerp4(sx, ex, t), lerp4(sy, ey, t));
+                    }
+                    scalar::lerp(start + i, end + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                inline void smoothstep(const Vector2f *start, const Vector2f *end, const float *amounts,
+                                       std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 sx, sy, ex, ey;
+                        load4(start + i, sx, sy);
+                        load4(end + i, ex, ey);
+                        const __m128 t = smoothstep4(loadAmounts(amounts, amountStep, i));
+                        store4(out + i, lerp4(sx, ex, t), lerp4(sy, ey, t));
+                    }
+                    scalar::smoothstep(start + i, end + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                inline void hermite(const Vector2f *p0, const Vector2f *m0, const Vector2f *p1, const Vector2f *m1,
+                                    const float *amounts, std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    const __m128 one = _mm_set1_ps(1.0F);
+                    const __m128 two = _mm_set1_ps(2.0F);
+                    const __m128 three = _mm_set1_ps(3.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 t = loadAmounts(amounts, amountStep, i);
+                        const __m128 t2 = _mm_mul_ps(t, t);
+                        const __m128 t3 = _mm_mul_ps(t2, t);
+                        const __m128 h00 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, t3), _mm_mul_ps(three, t2)), one);
+                        const __m128 h10 = _mm_add_ps(_mm_sub_ps(t3, _mm_mul_ps(two, t2)), t);
+                        const __m128 h01 = _mm_sub_ps(_mm_mul_ps(three, t2), _mm_mul_ps(two, t3));
+                        const __m128 h11 = _mm_sub_ps(t3, t2);
+
+                        __m128 ax, ay, bx, by, cx, cy, dx, dy;
+                        load4(p0 + i, ax, ay);
+                        load4(m0 + i, bx, by);
+                        load4(p1 + i, cx, cy);
+                        load4(m1 + i, dx, dy);
+                        const __m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h00, ax), _mm_mul_ps(h10, bx)),
+                                                    _mm_add_ps(_mm_mul_ps(h01, cx), _mm_mul_ps(h11, dx)));
+                        const __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h00, ay), _mm_mul_ps(h10, by)),
+                                                    _mm_add_ps(_mm_mul_ps(h01, cy), _mm_mul_ps(h11, dy)));
+                        store4(out + i, x, y);
+                    }
+                    scalar::hermite(p0 + i, m0 + i, p1 + i, m1 + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                /**
+                 * @brief roundComponent on four lanes without SSE4.1
+                 *
+                 * Magnitudes from 2^23 on are integral already and NaNs pass through. The others go through a
+                 * truncating int conversion, then step down or up. Nearest adds the largest float below one half
+                 * with the sign of the value first, which rounds halves away from zero like std::round. The sign is
+                 * put back last, so that negative values that round to zero give -0.
+                 */
+                template <RoundMode M>
+                inline auto round4(__m128 value) -> __m128
+                {
+                    const __m128 signMask = _mm_set1_ps(-0.0F);
+                    const __m128 sign = _mm_and_ps(value, signMask);
+                    const __m128 small = _mm_cmplt_ps(_mm_andnot_ps(signMask, value), _mm_set1_ps(8388608.0F));
+                    __m128 shifted = value;
+                    if constexpr (M == RoundMode::Nearest)
+                    {
+                        shifted = _mm_add_ps(value, _mm_or_ps(sign, _mm_set1_ps(0.49999997F)));
+                    }
+                    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(shifted));
+                    if constexpr (M == RoundMode::Floor)
+                    {
+                        t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, value), _mm_set1_ps(1.0F)));
+                    }
+                    else if constexpr (M == RoundMode::Ceil)
+                    {
+                        t = _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, value), _mm_set1_ps(1.0F)));
+                    }
+                    return _mm_or_ps(select(small, t, value), sign);
+                }
+
+                template <RoundMode M>
+                inline void round(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const auto *in = reinterpret_cast<const float *>(values);
+                    auto *result = reinterpret_cast<float *>(out);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        _mm_storeu_ps(result + 2 * i, round4<M>(_mm_loadu_ps(in + 2 * i)));
+                        _mm_storeu_ps(result + 2 * i + 4, round4<M>(_mm_loadu_ps(in + 2 * i + 4)));
+                    }
+                    scalar::round<M>(values + i, out + i, count - i);
+                }
+
+                ///< maxps and minps return their second operand for NaNs, which keeps the order of clampComponent
+                inline void clamp(const float *in, float *out, std::size_t count, const BoundLanes &bounds)
+                {
+                    __m128 low[6], high[6];
+                    for (int k = 0; k < 6; ++k)
+                    {
+                        low[k] = _mm_loadu_ps(bounds.low + 4 * k);
+                        high[k] = _mm_loadu_ps(bounds.high + 4 * k);
+                    }
+                    std::size_t i = 0;
+                    for (; i + 24 <= count; i += 24)
+                    {
+                        for (int k = 0; k < 6; ++k)
+                        {
+                            const __m128 value = _mm_loadu_ps(in + i + 4 * k);
+                            _mm_storeu_ps(out + i + 4 * k, _mm_min_ps(high[k], _mm_max_ps(low[k], value)));
+                        }
+                    }
+                    scalar::clamp(in + i, out + i, count - i, bounds);
+                }
+
+                ///< std::min(a, b) is b < a ? b : a, which is minps with swapped operands
+                inline void minimum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        _mm_storeu_ps(out + i, _mm_min_ps(_mm_loadu_ps(rhs + i), _mm_loadu_ps(lhs + i)));
+                    }
+                    scalar::minimum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void maximum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        _mm_storeu_ps(out + i, _mm_max_ps(_mm_loadu_ps(rhs + i), _mm_loadu_ps(lhs + i)));
+                    }
+                    scalar::maximum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void abs(const float *in, float *out, std::size_t count)
+                {
+                    const __m128 signMask = _mm_set1_ps(-0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        _mm_storeu_ps(out + i, _mm_andnot_ps(signMask, _mm_loadu_ps(in + i)));
+                    }
+                    scalar::abs(in + i, out + i, count - i);
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 vx = _mm_loadu_ps(xs + i);
+                        const __m128 vy = _mm_loadu_ps(ys + i);
+                        const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+                        const __m128 keep = _mm_cmpeq_ps(len, _mm_setzero_ps());
+                        _mm_storeu_ps(xs + i, select(keep, vx, _mm_div_ps(vx, len)));
+                        _mm_storeu_ps(ys + i, select(keep, vy, _mm_div_ps(vy, len)));
+                    }
+                    scalar::normalizeLanes(xs + i, ys + i, count - i);
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, float *zs, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 vx = _mm_loadu_ps(xs + i);
+                        const __m128 vy = _mm_loadu_ps(ys + i);
+                        const __m128 vz = _mm_loadu_ps(zs + i);
+                        const __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+                        const __m128 len = _mm_sqrt_ps(lenSq);
+                        const __m128 keep = _mm_cmpeq_ps(len, _mm_setzero_ps());
+                        _mm_storeu_ps(xs + i, select(keep, vx, _mm_div_ps(vx, len)));
+                        _mm_storeu_ps(ys + i, select(keep, vy, _mm_div_ps(vy, len)));
+                        _mm_storeu_ps(zs + i, select(keep, vz, _mm_div_ps(vz, len)));
+                    }
+                    scalar::normalizeLanes(xs + i, ys + i, zs + i, count - i);
+                }
+
+                inline void snapToGrid(const Vector2f *positions, Vector2f cellSize, Vector2i *out, std::size_t count)
+                {
+                    ///< Vectors are interleaved, so one register holds two of them and divides by (x, y, x, y)
+                    const __m128 cells = _mm_setr_ps(cellSize.x, cellSize.y, cellSize.x, cellSize.y);
+                    const auto *in = reinterpret_cast<const float *>(positions);
+                    auto *result = reinterpret_cast<int *>(out);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        for (std::size_t k = 0; k < 8; k += 4)
+                        {
+                            const __m128 cell = round4<RoundMode::Floor>(_mm_div_ps(_mm_loadu_ps(in + 2 * i + k), cells));
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(result + 2 * i + k), _mm_cvttps_epi32(cell));
+                        }
+                    }
+                    scalar::snapToGrid(positions + i, cellSize, out + i, count - i);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                ///< Load eight consecutive vectors and split them into a register of x and a register of y components
+                FZOLV_TARGET_AVX2 inline void load8(const Vector2f *values, __m256 &xs, __m256 &ys)
+                {
+                    const auto *raw = reinterpret_cast<const float *>(values);
+                    const __m256 lo = _mm256_loadu_ps(raw);
+                    const __m256 hi = _mm256_loadu_ps(raw + 8);
+                    const __m256 evens = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+                    const __m256 odds = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+                    xs = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(evens), _MM_SHUFFLE(3, 1, 2, 0)));
+                    ys = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odds), _MM_SHUFFLE(3, 1, 2, 0)));
+                }
+
+                FZOLV_TARGET_AVX2 inline void dot(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        __m256 ax, ay, bx, by;
+                        load8(lhs + i, ax, ay);
+                        load8(rhs + i, bx, by);
+                        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)));
+                    }
+                    sse2::dot(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void cross(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        __m256 ax, ay, bx, by;
+                        load8(lhs + i, ax, ay);
+                        load8(rhs + i, bx, by);
+                        _mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_mul_ps(ax, by), _mm256_mul_ps(ay, bx)));
+                    }
+                    sse2::cross(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void lengthSquared(const Vector2f *values, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        __m256 vx, vy;
+                        load8(values + i, vx, vy);
+                        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+                    }
+                    sse2::lengthSquared(values + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void distanceToSquared(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        __m256 ax, ay, bx, by;
+                        load8(lhs + i, ax, ay);
+                        load8(rhs + i, bx, by);
+                        const __m256 dx = _mm256_sub_ps(ax, bx);
+                        const __m256 dy = _mm256_sub_ps(ay, by);
+                        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+                    }
+                    sse2::distanceToSquared(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                template <RoundMode M>
+                FZOLV_TARGET_AVX2 inline auto round8(__m256 value) -> __m256
+                {
+                    if constexpr (M == RoundMode::Floor)
+                    {
+                        return _mm256_round_ps(value, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+                    }
+                    else if constexpr (M == RoundMode::Ceil)
+                    {
+                        return _mm256_round_ps(value, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+                    }
+                    else
+                    {
+                        ///< roundps has no mode for halves away from zero, see sse2::round4
+                        const __m256 half = _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.0F)), _mm256_set1_ps(0.49999997F));
+                        return _mm256_round_ps(_mm256_add_ps(value, half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+                    }
+                }
+
+                template <RoundMode M>
+                FZOLV_TARGET_AVX2 inline void round(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const auto *in = reinterpret_cast<const float *>(values);
+                    auto *result = reinterpret_cast<float *>(out);
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        _mm256_storeu_ps(result + 2 * i, round8<M>(_mm256_loadu_ps(in + 2 * i)));
+                        _mm256_storeu_ps(result + 2 * i + 8, round8<M>(_mm256_loadu_ps(in + 2 * i + 8)));
+                    }
+                    sse2::round<M>(values + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void clamp(const float *in, float *out, std::size_t count, const BoundLanes &bounds)
+                {
+                    __m256 low[3], high[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        low[k] = _mm256_loadu_ps(bounds.low + 8 * k);
+                        high[k] = _mm256_loadu_ps(bounds.high + 8 * k);
+                    }
+                    std::size_t i = 0;
+                    for (; i + 24 <= count; i += 24)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const __m256 value = _mm256_loadu_ps(in + i + 8 * k);
+                            _mm256_storeu_ps(out + i + 8 * k, _mm256_min_ps(high[k], _mm256_max_ps(low[k], value)));
+                        }
+                    }
+                    sse2::clamp(in + i, out + i, count - i, bounds);
+                }
+
+                FZOLV_TARGET_AVX2 inline void minimum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_loadu_ps(rhs + i), _mm256_loadu_ps(lhs + i)));
+                    }
+                    sse2::minimum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void maximum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_loadu_ps(rhs + i), _mm256_loadu_ps(lhs + i)));
+                    }
+                    sse2::maximum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void abs(const float *in, float *out, std::size_t count)
+                {
+                    const __m256 signMask = _mm256_set1_ps(-0.0F);
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        _mm256_storeu_ps(out + i, _mm256_andnot_ps(signMask, _mm256_loadu_ps(in + i)));
+                    }
+                    sse2::abs(in + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void normalizeLanes(float *xs, float *ys, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m256 vx = _mm256_loadu_ps(xs + i);
+                        const __m256 vy = _mm256_loadu_ps(ys + i);
+                        const __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+                        const __m256 keep = _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_EQ_OQ);
+                        _mm256_storeu_ps(xs + i, _mm256_blendv_ps(_mm256_div_ps(vx, len), vx, keep));
+                        _mm256_storeu_ps(ys + i, _mm256_blendv_ps(_mm256_div_ps(vy, len), vy, keep));
+                    }
+                    sse2::normalizeLanes(xs + i, ys + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void normalizeLanes(float *xs, float *ys, float *zs, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m256 vx = _mm256_loadu_ps(xs + i);
+                        const __m256 vy = _mm256_loadu_ps(ys + i);
+                        const __m256 vz = _mm256_loadu_ps(zs + i);
+                        const __m256 lenSq =
+                            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+                        const __m256 len = _mm256_sqrt_ps(lenSq);
+                        const __m256 keep = _mm256_cmp_ps(len, _mm256_setzero_ps(), _CMP_EQ_OQ);
+                        _mm256_storeu_ps(xs + i, _mm256_blendv_ps(_mm256_div_ps(vx, len), vx, keep));
+                        _mm256_storeu_ps(ys + i, _mm256_blendv_ps(_mm256_div_ps(vy, len), vy, keep));
+                        _mm256_storeu_ps(zs + i, _mm256_blendv_ps(_mm256_div_ps(vz, len), vz, keep));
+                    }
+                    sse2::normalizeLanes(xs + i, ys + i, zs + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void snapToGrid(const Vector2f *positions, Vector2f cellSize, Vector2i *out,
+                                                         std::size_t count)
+                {
+                    const __m256 cells = _mm256_setr_ps(cellSize.x, cellSize.y, cellSize.x, cellSize.y, cellSize.x,
+                                                        cellSize.y, cellSize.x, cellSize.y);
+                    const auto *in = reinterpret_cast<const float *>(positions);
+                    auto *result = reinterpret_cast<int *>(out);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m256 cell = _mm256_floor_ps(_mm256_div_ps(_mm256_loadu_ps(in + 2 * i), cells));
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(result + 2 * i), _mm256_cvttps_epi32(cell));
+                    }
+                    sse2::snapToGrid(positions + i, cellSize, out + i, count - i);
+                }
+
+                using sse2::hermite;
+                using sse2::lerp;
+                using sse2::normalize;
+                using sse2::normalizeFast;
+                using sse2::smoothstep;
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                ///< Load four consecutive vectors, deinterleaved into x and y registers
+                inline auto load4(const Vector2f *values) -> float32x4x2_t
+                {
+                    return vld2q_f32(reinterpret_cast<const float *>(values));
+                }
+
+                inline void dot(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t a = load4(lhs + i);
+                        const float32x4x2_t b = load4(rhs + i);
+                        vst1q_f32(out + i, vaddq_f32(vmulq_f32(a.val[0], b.val[0]), vmulq_f32(a.val[1], b.val[1])));
+                    }
+                    scalar::dot(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void cross(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t a = load4(lhs + i);
+                        const float32x4x2_t b = load4(rhs + i);
+                        vst1q_f32(out + i, vsubq_f32(vmulq_f32(a.val[0], b.val[1]), vmulq_f32(a.val[1], b.val[0])));
+                    }
+                    scalar::cross(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void lengthSquared(const Vector2f *values, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t v = load4(values + i);
+                        vst1q_f32(out + i, vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1])));
+                    }
+                    scalar::lengthSquared(values + i, out + i, count - i);
+                }
+
+                inline void distanceToSquared(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t a = load4(lhs + i);
+                        const float32x4x2_t b = load4(rhs + i);
+                        const float32x4_t dx = vsubq_f32(a.val[0], b.val[0]);
+                        const float32x4_t dy = vsubq_f32(a.val[1], b.val[1]);
+                        vst1q_f32(out + i, vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy)));
+                    }
+                    scalar::distanceToSquared(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                ///< Interleave registers of x and y components back into four consecutive vectors
+                inline void store4(Vector2f *values, float32x4_t xs, float32x4_t ys)
+                {
+                    vst2q_f32(reinterpret_cast<float *>(values), float32x4x2_t{{xs, ys}});
+                }
+
+                inline void normalize(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t v = load4(values + i);
+                        const float32x4_t lenSq = vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1]));
+                        const float32x4_t len = vsqrtq_f32(lenSq);
+                        const uint32x4_t keep = vceqq_f32(len, zero);
+                        store4(out + i, vbslq_f32(keep, v.val[0], vdivq_f32(v.val[0], len)),
+                               vbslq_f32(keep, v.val[1], vdivq_f32(v.val[1], len)));
+                    }
+                    scalar::normalize(values + i, out + i, count - i);
+                }
+
+                inline void normalizeFast(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const float32x4_t lowest = vdupq_n_f32(FLT_MIN);
+                    const float32x4_t highest = vdupq_n_f32(FLT_MAX);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t v = load4(values + i);
+                        const float32x4_t lenSq = vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1]));
+                        const uint32x4_t inRange = vandq_u32(vcgeq_f32(lenSq, lowest), vcleq_f32(lenSq, highest));
+                        if (vminvq_u32(inRange) == 0)
+                        {
+                            ///< Rare zero, denormal or non-finite lengths take the exact path, like the member function
+                            scalar::normalizeFast(values + i, out + i, 4);
+                            continue;
+                        }
+
+                        ///< Two refinement steps, the same sequence as simd::rsqrt
+                        float32x4_t inv = vrsqrteq_f32(lenSq);
+                        inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lenSq, inv), inv));
+                        inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lenSq, inv), inv));
+                        store4(out + i, vmulq_f32(v.val[0], inv), vmulq_f32(v.val[1], inv));
+                    }
+                    scalar::normalizeFast(values + i, out + i, count - i);
+                }
+
+                inline auto loadAmounts(const float *amounts, std::size_t amountStep, std::size_t i) -> float32x4_t
+                {
+                    return amountStep == 0 ? vdupq_n_f32(amounts[0]) : vld1q_f32(amounts + i);
+                }
+
+                inline auto lerp4(float32x4_t start, float32x4_t end, float32x4_t t) -> float32x4_t
+                {
+                    return vaddq_f32(start, vmulq_f32(vsubq_f32(end, start), t));
+                }
+
+                ///< vmaxq and vminq propagate NaN, so NaN factors are mapped to 0 first like the scalar clamp
+                inline auto smoothstep4(float32x4_t amount) -> float32x4_t
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    const float32x4_t one = vdupq_n_f32(1.0F);
+                    float32x4_t t = vbslq_f32(vcgtq_f32(amount, zero), amount, zero);
+                    t = vbslq_f32(vcltq_f32(t, one), t, one);
+                    return vmulq_f32(vmulq_f32(t, t), vsubq_f32(vdupq_n_f32(3.0F), vmulq_f32(vdupq_n_f32(2.0F), t)));
+                }
+
+                inline void lerp(const Vector2f *start, const Vector2f *end, const float *amounts, std::size_t amountStep,
+                                 Vector2f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t a = load4(start + i);
+                        const float32x4x2_t b = load4(end + i);
+                        const float32x4_t t = loadAmounts(amounts, amountStep, i);
+                        store4(out + i, lerp4(a.val[0], b.val[0], t), lerp4(a.val[1], b.val[1], t));
+                    }
+                    scalar::lerp(start + i, end + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                inline void smoothstep(const Vector2f *start, const Vector2f *end, const float *amounts,
+                                       std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x2_t a = load4(start + i);
+                        const float32x4x2_t b = load4(end + i);
+                        const float32x4_t t = smoothstep4(loadAmounts(amounts, amountStep, i));
+                        store4(out + i, lerp4(a.val[0], b.val[0], t), lerp4(a.val[1], b.val[1], t));
+                    }
+                    scalar::smoothstep(start + i, end + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                inline void hermite(const Vector2f *p0, const Vector2f *m0, const Vector2f *p1, const Vector2f *m1,
+                                    const float *amounts, std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    const float32x4_t one = vdupq_n_f32(1.0F);
+                    const float32x4_t two = vdupq_n_f32(2.0F);
+                    const float32x4_t three = vdupq_n_f32(3.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t t = loadAmounts(amounts, amountStep, i);
+                        const float32x4_t t2 = vmulq_f32(t, t);
+                        const float32x4_t t3 = vmulq_f32(t2, t);
+                        const float32x4_t h00 = vaddq_f32(vsubq_f32(vmulq_f32(two, t3), vmulq_f32(three, t2)), one);
+                        const float32x4_t h10 = vaddq_f32(vsubq_f32(t3, vmulq_f32(two, t2)), t);
+                        const float32x4_t h01 = vsubq_f32(vmulq_f32(three, t2), vmulq_f32(two, t3));
+                        const float32x4_t h11 = vsubq_f32(t3, t2);
+
+                        const float32x4x2_t a = load4(p0 + i);
+                        const float32x4x2_t b = load4(m0 + i);
+                        const float32x4x2_t c = load4(p1 + i);
+                        const float32x4x2_t d = load4(m1 + i);
+                        float32x4_t r[2];
+                        for (int k = 0; k < 2; ++k)
+                        {
+                            r[k] = vaddq_f32(vaddq_f32(vmulq_f32(h00, a.val[k]), vmulq_f32(h10, b.val[k])),
+                                             vaddq_f32(vmulq_f32(h01, c.val[k]), vmulq_f32(h11, d.val[k])));
+                        }
+                        store4(out + i, r[0], r[1]);
+                    }
+                    scalar::hermite(p0 + i, m0 + i, p1 + i, m1 + i, amounts + i * amountStep, amountStep, out + i, count - i);
+                }
+
+                ///< frintm, frintp and frinta round exactly like std::floor, std::ceil and std::round
+                template <RoundMode M>
+                inline auto round4(float32x4_t value) -> float32x4_t
+                {
+                    if constexpr (M == RoundMode::Floor)
+                    {
+                        return vrndmq_f32(value);
+                    }
+                    else if constexpr (M == RoundMode::Ceil)
+                    {
+                        return vrndpq_f32(value);
+                    }
+                    else
+                    {
+                        return vrndaq_f32(value);
+                    }
+                }
+
+                template <RoundMode M>
+                inline void round(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    const auto *in = reinterpret_cast<const float *>(values);
+                    auto *result = reinterpret_cast<float *>(out);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        vst1q_f32(result + 2 * i, round4<M>(vld1q_f32(in + 2 * i)));
+                        vst1q_f32(result + 2 * i + 4, round4<M>(vld1q_f32(in + 2 * i + 4)));
+                    }
+                    scalar::round<M>(values + i, out + i, count - i);
+                }
+
+                ///< Compares and selects instead of vmaxq and vminq, which return NaN when either operand is one
+                inline void clamp(const float *in, float *out, std::size_t count, const BoundLanes &bounds)
+                {
+                    std::size_t i = 0;
+                    for (; i + 24 <= count; i += 24)
+                    {
+                        for (int k = 0; k < 6; ++k)
+                        {
+                            const float32x4_t low = vld1q_f32(bounds.low + 4 * k);
+                            const float32x4_t high = vld1q_f32(bounds.high + 4 * k);
+                            const float32x4_t value = vld1q_f32(in + i + 4 * k);
+                            const float32x4_t raised = vbslq_f32(vcltq_f32(value, low), low, value);
+                            vst1q_f32(out + i + 4 * k, vbslq_f32(vcgtq_f32(raised, high), high, raised));
+                        }
+                    }
+                    scalar::clamp(in + i, out + i, count - i, bounds);
+                }
+
+                inline void minimum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t a = vld1q_f32(lhs + i);
+                        const float32x4_t b = vld1q_f32(rhs + i);
+                        vst1q_f32(out + i, vbslq_f32(vcltq_f32(b, a), b, a));
+                    }
+                    scalar::minimum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void maximum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t a = vld1q_f32(lhs + i);
+                        const float32x4_t b = vld1q_f32(rhs + i);
+                        vst1q_f32(out + i, vbslq_f32(vcltq_f32(a, b), b, a));
+                    }
+                    scalar::maximum(lhs + i, rhs + i, out + i, count - i);
+                }
+
+                inline void abs(const float *in, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        vst1q_f32(out + i, vabsq_f32(vld1q_f32(in + i)));
+                    }
+                    scalar::abs(in + i, out + i, count - i);
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, std::size_t count)
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t vx = vld1q_f32(xs + i);
+                        const float32x4_t vy = vld1q_f32(ys + i);
+                        const float32x4_t len = vsqrtq_f32(vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)));
+                        const uint32x4_t keep = vceqq_f32(len, zero);
+                        vst1q_f32(xs + i, vbslq_f32(keep, vx, vdivq_f32(vx, len)));
+                        vst1q_f32(ys + i, vbslq_f32(keep, vy, vdivq_f32(vy, len)));
+                    }
+                    scalar::normalizeLanes(xs + i, ys + i, count - i);
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, float *zs, std::size_t count)
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4_t vx = vld1q_f32(xs + i);
+                        const float32x4_t vy = vld1q_f32(ys + i);
+                        const float32x4_t vz = vld1q_f32(zs + i);
+                        const float32x4_t lenSq = vaddq_f32(vaddq_f32(vmulq_f32(vx, vx), vmulq_f32(vy, vy)), vmulq_f32(vz, vz));
+                        const float32x4_t len = vsqrtq_f32(lenSq);
+                        const uint32x4_t keep = vceqq_f32(len, zero);
+                        vst1q_f32(xs + i, vbslq_f32(keep, vx, vdivq_f32(vx, len)));
+                        vst1q_f32(ys + i, vbslq_f32(keep, vy, vdivq_f32(vy, len)));
+                        vst1q_f32(zs + i, vbslq_f32(keep, vz, vdivq_f32(vz, len)));
+                    }
+                    scalar::normalizeLanes(xs + i, ys + i, zs + i, count - i);
+                }
+
+                inline void snapToGrid(const Vector2f *positions, Vector2f cellSize, Vector2i *out, std::size_t count)
+                {
+                    const float lanes[4] = {cellSize.x, cellSize.y, cellSize.x, cellSize.y};
+                    const float32x4_t cells = vld1q_f32(lanes);
+                    const float32x4_t low = vdupq_n_f32(-2147483648.0F);
+                    const float32x4_t high = vdupq_n_f32(2147483648.0F);
+                    const auto *in = reinterpret_cast<const float *>(positions);
+                    auto *result = reinterpret_cast<int *>(out);
+                    std::size_t i = 0;
+                    for (; i + 2 <= count; i += 2)
+                    {
+                        const float32x4_t cell = vrndmq_f32(vdivq_f32(vld1q_f32(in + 2 * i), cells));
+                        ///< fcvtzs saturates and turns NaNs into 0, toCell gives INT_MIN for both
+                        const uint32x4_t inRange = vandq_u32(vcgeq_f32(cell, low), vcltq_f32(cell, high));
+                        vst1q_s32(result + 2 * i, vbslq_s32(inRange, vcvtq_s32_f32(cell), vdupq_n_s32(INT_MIN)));
+                    }
+                    scalar::snapToGrid(positions + i, cellSize, out + i, count - i);
+                }
+            }
+#endif
+
+/**
+ * @brief The body of a kernel in batch::detail::best: return name args from the kernels of simd::activeLevel()
+ *
+ * Headers adding kernels next to the ones of this file forward to them from best the same way.
+ */
+#if FZOLV_SIMD_AVX2
+#define FZOLV_DISPATCH_AVX2(name, args)                                                                                  \
+    case simd::Level::AVX2:                                                                                              \
+        return avx2::name args;
+#else
+#define FZOLV_DISPATCH_AVX2(name, args)
+#endif
+#if FZOLV_SIMD_SSE2
+#define FZOLV_DISPATCH_SSE2(name, args)                                                                                  \
+    case simd::Level::SSE2:                                                                                              \
+        return sse2::name args;
+#else
+#define FZOLV_DISPATCH_SSE2(name, args)
+#endif
+#if FZOLV_SIMD_NEON
+#define FZOLV_DISPATCH_NEON(name, args)                                                                                  \
+    case simd::Level::NEON:                                                                                              \
+        return neon::name args;
+#else
+#define FZOLV_DISPATCH_NEON(name, args)
+#endif
+#define FZOLV_DISPATCH(name, args)                                                                                       \
+    FZOLV_PROFILE_ZONE("batch::" #name, count);                                                                          \
+    switch (simd::activeLevel())                                                                                         \
+    {                                                                                                                    \
+        FZOLV_DISPATCH_AVX2(name, args)                                                                                  \
+        FZOLV_DISPATCH_SSE2(name, args)                                                                                  \
+        FZOLV_DISPATCH_NEON(name, args)                                                                                  \
+    default:                                                                                                             \
+        return scalar::name args;                                                                                        \
+    }
+
+            /**
+             * @brief The kernels the public functions call, each one runs the version of the active SIMD level
+             *
+             * The level is read once per call, so the check costs nothing next to a pass over an array. Every level
+             * produces the same results as the scalar kernels, under the -ffp-contract=off condition of simd.hpp.
+             */
+            namespace best
+            {
+                inline void dot(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(dot, (lhs, rhs, out, count))
+                }
+
+                inline void cross(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(cross, (lhs, rhs, out, count))
+                }
+
+                inline void lengthSquared(const Vector2f *values, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(lengthSquared, (values, out, count))
+                }
+
+                inline void distanceToSquared(const Vector2f *lhs, const Vector2f *rhs, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(distanceToSquared, (lhs, rhs, out, count))
+                }
+
+                inline void normalize(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(normalize, (values, out, count))
+                }
+
+                inline void normalizeFast(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(normalizeFast, (values, out, count))
+                }
+
+                inline void lerp(const Vector2f *start, const Vector2f *end, const float *amounts, std::size_t amountStep,
+                                 Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(lerp, (start, end, amounts, amountStep, out, count))
+                }
+
+                inline void smoothstep(const Vector2f *start, const Vector2f *end, const float *amounts,
+                                       std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(smoothstep, (start, end, amounts, amountStep, out, count))
+                }
+
+                inline void hermite(const Vector2f *p0, const Vector2f *m0, const Vector2f *p1, const Vector2f *m1,
+                                    const float *amounts, std::size_t amountStep, Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(hermite, (p0, m0, p1, m1, amounts, amountStep, out, count))
+                }
+
+                template <RoundMode M>
+                inline void round(const Vector2f *values, Vector2f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(round<M>, (values, out, count))
+                }
+
+                inline void clamp(const float *in, float *out, std::size_t count, const BoundLanes &bounds)
+                {
+                    FZOLV_DISPATCH(clamp, (in, out, count, bounds))
+                }
+
+                inline void minimum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(minimum, (lhs, rhs, out, count))
+                }
+
+                inline void maximum(const float *lhs, const float *rhs, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(maximum, (lhs, rhs, out, count))
+                }
+
+                inline void abs(const float *in, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(abs, (in, out, count))
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, std::size_t count)
+                {
+                    FZOLV_DISPATCH(normalizeLanes, (xs, ys, count))
+                }
+
+                inline void normalizeLanes(float *xs, float *ys, float *zs, std::size_t count)
+                {
+                    FZOLV_DISPATCH(normalizeLanes, (xs, ys, zs, count))
+                }
+
+                inline void snapToGrid(const Vector2f *positions, Vector2f cellSize, Vector2i *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(snapToGrid, (positions, cellSize, out, count))
+                }
+            }
+
+            ///< The minimum number of vectors per thread, smaller chunks spend more time waking threads than working
+            constexpr std::size_t batchGrain = std::size_t{1} << 14;
+        }
+
+        /**
+         * @brief Compute the dot product of every pair of vectors, out[i] = lhs[i].dot(rhs[i])
+         *
+         * @param lhs The left-hand side vectors
+         * @param rhs The right-hand side vectors, must have the same size as lhs
+         * @param out The dot products, must have the same size as lhs
+         */
+        template <typename T>
+        void dot(span<const Vector2<T>> lhs, span<const Vector2<T>> rhs, span<T> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            parallelFor(lhs.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::dot(lhs.data() + begin, rhs.data() + begin, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    out[i] = lhs[i].dot(rhs[i]);
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief Compute the cross product of every pair of vectors, out[i] = lhs[i].cross(rhs[i])
+         *
+         * @param lhs The left-hand side vectors
+         * @param rhs The right-hand side vectors, must have the same size as lhs
+         * @param out The cross products, must have the same size as lhs
+         */
+        template <typename T>
+        void cross(span<const Vector2<T>> lhs, span<const Vector2<T>> rhs, span<T> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            parallelFor(lhs.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::cross(lhs.data() + begin, rhs.data() + begin, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    out[i] = lhs[i].cross(rhs[i]);
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief Compute the squared length of every vector, out[i] = values[i].lengthSquared()
+         *
+         * @param values The vectors to measure
+         * @param out The squared lengths, must have the same size as values
+         */
+        template <typename T>
+        void lengthSquared(span<const Vector2<T>> values, span<T> out)
+        {
+            assert(values.size() == out.size());
+            parallelFor(values.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::lengthSquared(values.data() + begin, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    out[i] = values[i].lengthSquared();
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief Compute the squared distance of every pair of vectors, out[i] = lhs[i].distanceToSquared(rhs[i])
+         *
+         * @param lhs The vectors to measure from
+         * @param rhs The vectors to measure to, must have the same size as lhs
+         * @param out The squared distances, must have the same size as lhs
+         */
+        template <typename T>
+        void distanceToSquared(span<const Vector2<T>> lhs, span<const Vector2<T>> rhs, span<T> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            parallelFor(lhs.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::distanceToSquared(lhs.data() + begin, rhs.data() + begin, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    out[i] = lhs[i].distanceToSquared(rhs[i]);
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief Normalize every vector, out[i] = values[i].normalized()
+         *
+         * values and out may be the same span to normalize in place.
+         *
+         * @param values The vectors to normalize
+         * @param out The normalized vectors, must have the same size as values
+         */
+        template <typename T>
+        void normalize(span<const Vector2<T>> values, span<Vector2<T>> out)
+        {
+            assert(values.size() == out.size());
+            parallelFor(values.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::normalize(values.data() + begin, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    out[i] = values[i].normalized();
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief Normalize every vector with a reciprocal square root estimate, out[i] = values[i].normalizedFast()
+         *
+         * Components are within normalizeFastMaxRelativeError of the exact result and match the member function on
+         * the same machine. values and out may be the same span to normalize in place.
+         *
+         * @param values The vectors to normalize
+         * @param out The normalized vectors, must have the same size as values
+         */
+        template <typename T>
+        void normalizeFast(span<const Vector2<T>> values, span<Vector2<T>> out)
+        {
+            assert(values.size() == out.size());
+            if constexpr (std::is_same<T, float>::value && simd::hasFastRsqrt)
+            {
+                parallelFor(values.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                            { detail::best::normalizeFast(values.data() + begin, out.data() + begin, end - begin); });
+            }
+            else
+            {
+                normalize<T>(values, out);
+            }
+        }
+
+        namespace detail
+        {
+            /**
+             * @brief Clamp vectors of a number of float components, split across threads at vector boundaries
+             */
+            inline void clampVectors(const float *in, float *out, std::size_t count, std::size_t components,
+                                     const float *low, const float *high)
+            {
+                const BoundLanes bounds = boundLanes(low, high, components);
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::clamp(in + begin * components, out + begin * components, (end - begin) * components, bounds); });
+            }
+
+            inline void minimumFloats(const float *lhs, const float *rhs, float *out, std::size_t count)
+            {
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::minimum(lhs + begin, rhs + begin, out + begin, end - begin); });
+            }
+
+            inline void maximumFloats(const float *lhs, const float *rhs, float *out, std::size_t count)
+            {
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::maximum(lhs + begin, rhs + begin, out + begin, end - begin); });
+            }
+
+            inline void absFloats(const float *in, float *out, std::size_t count)
+            {
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::abs(in + begin, out + begin, end - begin); });
+            }
+
+            template <RoundMode M, typename T>
+            void round(span<const Vector2<T>> values, span<Vector2<T>> out)
+            {
+                assert(values.size() == out.size());
+                parallelFor(values.size(), batchGrain,
+                            [&](std::size_t begin, std::size_t end)
+                            {
+                                if constexpr (std::is_same<T, float>::value)
+                                {
+                                    best::round<M>(values.data() + begin, out.data() + begin, end - begin);
+                                }
+                                else
+                                {
+                                    for (std::size_t i = begin; i < end; ++i)
+                                    {
+                                        Vector2<T> value = values[i];
+                                        if constexpr (M == RoundMode::Floor)
+                                        {
+                                            value.floor();
+                                        }
+                                        else if constexpr (M == RoundMode::Ceil)
+                                        {
+                                            value.ceil();
+                                        }
+                                        else
+                                        {
+                                            value.round();
+                                        }
+                                        out[i] = value;
+                                    }
+                                }
+                            });
+            }
+
+            template <typename T>
+            void lerp(span<const Vector2<T>> start, span<const Vector2<T>> end, const precision_type_t<T> *amounts,
+                      std::size_t amountStep, span<Vector2<T>> out)
+            {
+                assert(start.size() == end.size() && start.size() == out.size());
+                parallelFor(start.size(), batchGrain,
+                            [&](std::size_t begin, std::size_t stop)
+                            {
+                                if constexpr (std::is_same<T, float>::value)
+                                {
+                                    best::lerp(start.data() + begin, end.data() + begin, amounts + begin * amountStep,
+                                               amountStep, out.data() + begin, stop - begin);
+                                }
+                                else
+                                {
+                                    for (std::size_t i = begin; i < stop; ++i)
+                                    {
+                                        out[i] = Vector2<T>::Lerp(start[i], end[i], amounts[i * amountStep]);
+                                    }
+                                }
+                            });
+            }
+
+            template <typename T>
+            void smoothstep(span<const Vector2<T>> start, span<const Vector2<T>> end, const precision_type_t<T> *amounts,
+                            std::size_t amountStep, span<Vector2<T>> out)
+            {
+                assert(start.size() == end.size() && start.size() == out.size());
+                parallelFor(start.size(), batchGrain,
+                            [&](std::size_t begin, std::size_t stop)
+                            {
+                                if constexpr (std::is_same<T, float>::value)
+                                {
+                                    best::smoothstep(start.data() + begin, end.data() + begin,
+                                                     amounts + begin * amountStep, amountStep, out.data() + begin,
+                                                     stop - begin);
+                                }
+                                else
+                                {
+                                    for (std::size_t i = begin; i < stop; ++i)
+                                    {
+                                        out[i] = Vector2<T>::SmoothStep(start[i], end[i], amounts[i * amountStep]);
+                                    }
+                                }
+                            });
+            }
+
+            template <typename T>
+            void hermite(span<const Vector2<T>> p0, span<const Vector2<T>> m0, span<const Vector2<T>> p1,
+                         span<const Vector2<T>> m1, const precision_type_t<T> *amounts, std::size_t amountStep,
+                         span<Vector2<T>> out)
+            {
+                assert(p0.size() == m0.size() && p0.size() == p1.size() && p0.size() == m1.size());
+                assert(p0.size() == out.size());
+                parallelFor(p0.size(), batchGrain,
+                            [&](std::size_t begin, std::size_t stop)
+                            {
+                                if constexpr (std::is_same<T, float>::value)
+                                {
+                                    best::hermite(p0.data() + begin, m0.data() + begin, p1.data() + begin,
+                                                  m1.data() + begin, amounts + begin * amountStep, amountStep,
+                                                  out.data() + begin, stop - begin);
+                                }
+                                else
+                                {
+                                    for (std::size_t i = begin; i < stop; ++i)
+                                    {
+                                        out[i] = Vector2<T>::Hermite(p0[i], m0[i], p1[i], m1[i], amounts[i * amountStep]);
+                                    }
+                                }
+                            });
+            }
+        }
+
+        /**
+         * @brief Interpolate every pair of vectors with its own factor, out[i] = Vector2::Lerp(start[i], end[i], amounts[i])
+         *
+         * out may be the same span as start or end.
+         *
+         * @param start The vectors at amount 0
+         * @param end The vectors at amount 1, must have the same size as start
+         * @param amounts The interpolation factors, must have the same size as start
+         * @param out The interpolated vectors, must have the same size as start
+         */
+        template <typename T>
+        void lerp(span<const Vector2<T>> start, span<const Vector2<T>> end, span<const precision_type_t<T>> amounts,
+                  span<Vector2<T>> out)
+        {
+            assert(amounts.size() == start.size());
+            detail::lerp<T>(start, end, amounts.data(), 1, out);
+        }
+
+        /**
+         * @brief Interpolate every pair of vectors with the same factor, out[i] = Vector2::Lerp(start[i], end[i], amount)
+         */
+        template <typename T>
+        void lerp(span<const Vector2<T>> start, span<const Vector2<T>> end, precision_type_t<T> amount,
+                  span<Vector2<T>> out)
+        {
+            detail::lerp<T>(start, end, &amount, 0, out);
+        }
+
+        /**
+         * @brief Ease between every pair of vectors, out[i] = Vector2::SmoothStep(start[i], end[i], amounts[i])
+         *
+         * @param start The vectors at amount 0
+         * @param end The vectors at amount 1, must have the same size as start
+         * @param amounts The interpolation factors, clamped to [0, 1], must have the same size as start
+         * @param out The interpolated vectors, must have the same size as start
+         */
+        template <typename T>
+        void smoothstep(span<const Vector2<T>> start, span<const Vector2<T>> end, span<const precision_type_t<T>> amounts,
+                        span<Vector2<T>> out)
+        {
+            assert(amounts.size() == start.size());
+            detail::smoothstep<T>(start, end, amounts.data(), 1, out);
+        }
+
+        template <typename T>
+        void smoothstep(span<const Vector2<T>> start, span<const Vector2<T>> end, precision_type_t<T> amount,
+                        span<Vector2<T>> out)
+        {
+            detail::smoothstep<T>(start, end, &amount, 0, out);
+        }
+
+        /**
+         * @brief Evaluate a cubic Hermite spline per element, out[i] = Vector2::Hermite(p0[i], m0[i], p1[i], m1[i], amounts[i])
+         *
+         * @param p0 The start points
+         * @param m0 The start tangents
+         * @param p1 The end points
+         * @param m1 The end tangents
+         * @param amounts The interpolation factors
+         * @param out The points on the splines, every span must have the same size
+         */
+        template <typename T>
+        void hermite(span<const Vector2<T>> p0, span<const Vector2<T>> m0, span<const Vector2<T>> p1,
+                     span<const Vector2<T>> m1, span<const precision_type_t<T>> amounts, span<Vector2<T>> out)
+        {
+            assert(amounts.size() == p0.size());
+            detail::hermite<T>(p0, m0, p1, m1, amounts.data(), 1, out);
+        }
+
+        template <typename T>
+        void hermite(span<const Vector2<T>> p0, span<const Vector2<T>> m0, span<const Vector2<T>> p1,
+                     span<const Vector2<T>> m1, precision_type_t<T> amount, span<Vector2<T>> out)
+        {
+            detail::hermite<T>(p0, m0, p1, m1, &amount, 0, out);
+        }
+
+        /**
+         * @brief Round every component down, out[i] = Vector2(values[i]).floor()
+         *
+         * values and out may be the same span to round in place.
+         *
+         * @param values The vectors to round
+         * @param out The rounded vectors, must have the same size as values
+         */
+        template <typename T>
+        void floor(span<const Vector2<T>> values, span<Vector2<T>> out)
+        {
+            detail::round<detail::RoundMode::Floor, T>(values, out);
+        }
+
+        /**
+         * @brief Round every component up, out[i] = Vector2(values[i]).ceil()
+         */
+        template <typename T>
+        void ceil(span<const Vector2<T>> values, span<Vector2<T>> out)
+        {
+            detail::round<detail::RoundMode::Ceil, T>(values, out);
+        }
+
+        /**
+         * @brief Round every component to the nearest integer, halves away from zero, out[i] = Vector2(values[i]).round()
+         */
+        template <typename T>
+        void round(span<const Vector2<T>> values, span<Vector2<T>> out)
+        {
+            detail::round<detail::RoundMode::Nearest, T>(values, out);
+        }
+
+        /**
+         * @brief The grid cell of every position, floor(positions[i] / cellSize) converted to int in one pass
+         *
+         * Cells whose coordinates do not fit into an int, and NaN positions, get INT_MIN for that coordinate.
+         *
+         * @param positions The positions to snap
+         * @param cellSize The width and height of a cell
+         * @param out The cell coordinates, must have the same size as positions
+         */
+        template <typename T>
+        void snapToGrid(span<const Vector2<T>> positions, Vector2<T> cellSize, span<Vector2i> out)
+        {
+            static_assert(std::is_floating_point<T>::value, "positions must be floating point");
+            assert(positions.size() == out.size());
+            parallelFor(positions.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            if constexpr (std::is_same<T, float>::value)
+                            {
+                                detail::best::snapToGrid(positions.data() + begin, cellSize, out.data() + begin, end - begin);
+                            }
+                            else
+                            {
+                                for (std::size_t i = begin; i < end; ++i)
+                                {
+                                    const T limit = T(2147483648.0);
+                                    const T x = math::floor(positions[i].x / cellSize.x);
+                                    const T y = math::floor(positions[i].y / cellSize.y);
+                                    out[i] = {x >= -limit && x < limit ? static_cast<int>(x) : INT_MIN,
+                                              y >= -limit && y < limit ? static_cast<int>(y) : INT_MIN};
+                                }
+                            }
+                        });
+        }
+
+        ///< Vector2f overloads, so that containers of Vector2f convert to spans without naming the span type
+
+        inline void dot(span<const Vector2f> lhs, span<const Vector2f> rhs, span<float> out) { dot<float>(lhs, rhs, out); }
+
+        inline void cross(span<const Vector2f> lhs, span<const Vector2f> rhs, span<float> out) { cross<float>(lhs, rhs, out); }
+
+        inline void lengthSquared(span<const Vector2f> values, span<float> out) { lengthSquared<float>(values, out); }
+
+        inline void distanceToSquared(span<const Vector2f> lhs, span<const Vector2f> rhs, span<float> out)
+        {
+            distanceToSquared<float>(lhs, rhs, out);
+        }
+
+        inline void normalize(span<const Vector2f> values, span<Vector2f> out) { normalize<float>(values, out); }
+
+        inline void normalize(span<Vector2f> values) { normalize<float>(values, values); }
+
+        inline void normalizeFast(span<const Vector2f> values, span<Vector2f> out) { normalizeFast<float>(values, out); }
+
+        inline void normalizeFast(span<Vector2f> values) { normalizeFast<float>(values, values); }
+
+        inline void lerp(span<const Vector2f> start, span<const Vector2f> end, span<const float> amounts, span<Vector2f> out)
+        {
+            lerp<float>(start, end, amounts, out);
+        }
+
+        inline void lerp(span<const Vector2f> start, span<const Vector2f> end, float amount, span<Vector2f> out)
+        {
+            lerp<float>(start, end, amount, out);
+        }
+
+        inline void smoothstep(span<const Vector2f> start, span<const Vector2f> end, span<const float> amounts,
+                               span<Vector2f> out)
+        {
+            smoothstep<float>(start, end, amounts, out);
+        }
+
+        inline void smoothstep(span<const Vector2f> start, span<const Vector2f> end, float amount, span<Vector2f> out)
+        {
+            smoothstep<float>(start, end, amount, out);
+        }
+
+        inline void hermite(span<const Vector2f> p0, span<const Vector2f> m0, span<const Vector2f> p1,
+                            span<const Vector2f> m1, span<const float> amounts, span<Vector2f> out)
+        {
+            hermite<float>(p0, m0, p1, m1, amounts, out);
+        }
+
+        inline void hermite(span<const Vector2f> p0, span<const Vector2f> m0, span<const Vector2f> p1,
+                            span<const Vector2f> m1, float amount, span<Vector2f> out)
+        {
+            hermite<float>(p0, m0, p1, m1, amount, out);
+        }
+
+        inline void floor(span<const Vector2f> values, span<Vector2f> out) { floor<float>(values, out); }
+
+        inline void floor(span<Vector2f> values) { floor<float>(values, values); }
+
+        inline void ceil(span<const Vector2f> values, span<Vector2f> out) { ceil<float>(values, out); }
+
+        inline void ceil(span<Vector2f> values) { ceil<float>(values, values); }
+
+        inline void round(span<const Vector2f> values, span<Vector2f> out) { round<float>(values, out); }
+
+        inline void round(span<Vector2f> values) { round<float>(values, values); }
+
+        inline void snapToGrid(span<const Vector2f> positions, Vector2f cellSize, span<Vector2i> out)
+        {
+            snapToGrid<float>(positions, cellSize, out);
+        }
+
+        inline void snapToGrid(span<const Vector2f> positions, float cellSize, span<Vector2i> out)
+        {
+            snapToGrid<float>(positions, {cellSize, cellSize}, out);
+        }
+
+        /**
+         * @brief Clamp every vector component-wise to [min, max], out[i] = Vector2f::clamp(values[i], min, max)
+         *
+         * Compiles to SIMD min and max instructions without branches. values and out may be the same span.
+         *
+         * @param values The vectors to clamp
+         * @param min The lower bounds, each component at most the matching one of max
+         * @param max The upper bounds
+         * @param out The clamped vectors, must have the same size as values
+         */
+        inline void clamp(span<const Vector2f> values, const Vector2f &min, const Vector2f &max, span<Vector2f> out)
+        {
+            assert(values.size() == out.size());
+            detail::clampVectors(reinterpret_cast<const float *>(values.data()), reinterpret_cast<float *>(out.data()),
+                                 values.size(), 2, &min.x, &max.x);
+        }
+
+        inline void clamp(span<Vector2f> values, const Vector2f &min, const Vector2f &max) { clamp(values, min, max, values); }
+
+        inline void clamp(span<const Vector3f> values, const Vector3f &min, const Vector3f &max, span<Vector3f> out)
+        {
+            assert(values.size() == out.size());
+            detail::clampVectors(reinterpret_cast<const float *>(values.data()), reinterpret_cast<float *>(out.data()),
+                                 values.size(), 3, &min.x, &max.x);
+        }
+
+        inline void clamp(span<Vector3f> values, const Vector3f &min, const Vector3f &max) { clamp(values, min, max, values); }
+
+        /**
+         * @brief The component-wise minimum of every pair, std::min per component, so lhs wins ties and unordered pairs
+         */
+        inline void min(span<const Vector2f> lhs, span<const Vector2f> rhs, span<Vector2f> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            detail::minimumFloats(reinterpret_cast<const float *>(lhs.data()), reinterpret_cast<const float *>(rhs.data()),
+                                  reinterpret_cast<float *>(out.data()), lhs.size() * 2);
+        }
+
+        inline void min(span<const Vector3f> lhs, span<const Vector3f> rhs, span<Vector3f> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            detail::minimumFloats(reinterpret_cast<const float *>(lhs.data()), reinterpret_cast<const float *>(rhs.data()),
+                                  reinterpret_cast<float *>(out.data()), lhs.size() * 3);
+        }
+
+        /**
+         * @brief The component-wise maximum of every pair, std::max per component
+         */
+        inline void max(span<const Vector2f> lhs, span<const Vector2f> rhs, span<Vector2f> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            detail::maximumFloats(reinterpret_cast<const float *>(lhs.data()), reinterpret_cast<const float *>(rhs.data()),
+                                  reinterpret_cast<float *>(out.data()), lhs.size() * 2);
+        }
+
+        inline void max(span<const Vector3f> lhs, span<const Vector3f> rhs, span<Vector3f> out)
+        {
+            assert(lhs.size() == rhs.size() && lhs.size() == out.size());
+            detail::maximumFloats(reinterpret_cast<const float *>(lhs.data()), reinterpret_cast<const float *>(rhs.data()),
+                                  reinterpret_cast<float *>(out.data()), lhs.size() * 3);
+        }
+
+        /**
+         * @brief The absolute value of every component, clearing the sign bit like std::fabs
+         */
+        inline void abs(span<const Vector2f> values, span<Vector2f> out)
+        {
+            assert(values.size() == out.size());
+            detail::absFloats(reinterpret_cast<const float *>(values.data()), reinterpret_cast<float *>(out.data()),
+                              values.size() * 2);
+        }
+
+        inline void abs(span<Vector2f> values) { abs(values, values); }
+
+        inline void abs(span<const Vector3f> values, span<Vector3f> out)
+        {
+            assert(values.size() == out.size());
+            detail::absFloats(reinterpret_cast<const float *>(values.data()), reinterpret_cast<float *>(out.data()),
+                              values.size() * 3);
+        }
+
+        inline void abs(span<Vector3f> values) { abs(values, values); }
+    }
+}
+
+#endif /* end of include guard: FZOLV_BATCH_vk8ynd */
@@ -0,0 +1,575 @@
+#ifndef FZOLV_BVH_2aaltl
+#define FZOLV_BVH_2aaltl
+
+#include <aabb.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <parallel.hpp>
+#include <profile.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector.hpp>
+#include <vector>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        ///< The surface area heuristic cost of a box, the perimeter in 2D and the surface area in 3D, halved
+
+        template <typename T>
+        constexpr auto surfaceCost(const AABB2<T> &box) -> T
+        {
+            return box.halfPerimeter();
+        }
+
+        template <typename T>
+        constexpr auto surfaceCost(const AABB3<T> &box) -> T
+        {
+            return box.halfSurfaceArea();
+        }
+
+        /**
+         * @brief Clip the ray parameter range [enter, exit] against one slab, false once the range is empty
+         *
+         * Axis-parallel rays are tested by their origin, so no infinities or NaNs enter the comparisons.
+         */
+        template <typename T>
+        constexpr auto clipSlab(T origin, T direction, T low, T high, T &enter, T &exit) -> bool
+        {
+            if (direction == T(0))
+            {
+                return origin >= low && origin <= high;
+            }
+            const T inverse = T(1) / direction;
+            T t1 = (low - origin) * inverse;
+            T t2 = (high - origin) * inverse;
+            if (t1 > t2)
+            {
+                std::swap(t1, t2);
+            }
+            enter = t1 > enter ? t1 : enter;
+            exit = t2 < exit ? t2 : exit;
+            return enter <= exit;
+        }
+
+        template <typename T>
+        constexpr auto rayHits(const AABB2<T> &box, const Vector2<T> &origin, const Vector2<T> &direction, T maxFraction)
+            -> bool
+        {
+            T enter = T(0);
+            T exit = maxFraction;
+            return clipSlab(origin.x, direction.x, box.min.x, box.max.x, enter, exit) &&
+                   clipSlab(origin.y, direction.y, box.min.y, box.max.y, enter, exit);
+        }
+
+        template <typename T>
+        constexpr auto rayHits(const AABB3<T> &box, const Vector3<T> &origin, const Vector3<T> &direction, T maxFraction)
+            -> bool
+        {
+            T enter = T(0);
+            T exit = maxFraction;
+            return clipSlab(origin.x, direction.x, box.min.x, box.max.x, enter, exit) &&
+                   clipSlab(origin.y, direction.y, box.min.y, box.max.y, enter, exit) &&
+                   clipSlab(origin.z, direction.z, box.min.z, box.max.z, enter, exit);
+        }
+    }
+
+    /**
+     * @brief A dynamic bounding volume hierarchy for broad-phase collision detection
+     *
+     * Every object is a leaf holding a fattened copy of its box, so objects that move a little stay in place and only
+     * objects that leave their fat box are removed and reinserted. Insertion picks the sibling with the surface area
+     * heuristic and every insertion and removal rebalances the path to the root with AVL-style tree rotations, keeping
+     * the height logarithmic whatever the insertion order.
+     *
+     * All nodes live in one flat array with an intrusive free list, so inserting and removing objects does not
+     * allocate once the array has grown to its working size. Box and ray queries walk the tree with a fixed-size stack
+     * and never allocate unless a tree is deeper than it, where the stack moves to the heap; findPairs spreads its work
+     * over several threads with parallelForWeighted, weighting every node by the height of the tree.
+     *
+     * @tparam Box The box type, AABB2<T> or AABB3<T>
+     */
+    template <typename Box>
+    class DynamicBVH
+    {
+    public:
+        using box_type = Box;
+        using value_type = typename Box::value_type;
+        using vector_type = typename Box::vector_type;
+        using proxy_type = std::int32_t;
+        using user_type = std::uint32_t;
+
+        ///< The proxy that does not refer to any object
+        static constexpr proxy_type nullProxy = -1;
+
+        /**
+         * @brief Create an empty hierarchy
+         *
+         * @param fatMargin How far the stored boxes extend past the real boxes on every side
+         */
+        explicit DynamicBVH(value_type fatMargin = value_type(0)) : margin{fatMargin} {}
+
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return proxies; }
+
+        [[nodiscard]] auto empty() const noexcept -> bool { return proxies == 0; }
+
+        /**
+         * @brief The height of the tree, 0 for a single object and -1 when empty
+         */
+        [[nodiscard]] auto height() const -> std::int32_t { return root == nullProxy ? -1 : nodes[root].height; }
+
+        [[nodiscard]] auto fatBox(proxy_type proxy) const -> const Box & { return nodes[proxy].box; }
+
+        [[nodiscard]] auto userData(proxy_type proxy) const -> user_type { return nodes[proxy].userData; }
+
+        /**
+         * @brief Reserve space for the nodes of count objects, so that inserting them does not allocate
+         */
+        void reserve(std::size_t count) { nodes.reserve(count * 2); }
+
+        /**
+         * @brief Insert an object
+         *
+         * @param box The bounds of the object
+         * @param userData A value reported back by queries, typically the index of the object
+         * @return proxy_type The proxy of the object, valid until it is removed
+         */
+        auto insert(const Box &box, user_type userData) -> proxy_type
+        {
+            const proxy_type leaf = allocateNode();
+            nodes[leaf].box = Box(box).inflate(margin);
+            nodes[leaf].userData = userData;
+            nodes[leaf].height = 0;
+            insertLeaf(leaf);
+            ++proxies;
+            return leaf;
+        }
+
+        /**
+         * @brief Remove an object, its proxy may be reused by later insertions
+         */
+        void remove(proxy_type proxy)
+        {
+            assert(isLeaf(proxy) && "the proxy does not refer to an object");
+            removeLeaf(proxy);
+            freeNode(proxy);
+            --proxies;
+        }
+
+        /**
+         * @brief Update the bounds of an object
+         *
+         * @param proxy The proxy of the object
+         * @param box The new bounds of the object
+         * @return bool Whether the object left its fat box and was reinserted
+         */
+        auto move(proxy_type proxy, const Box &box) -> bool
+        {
+            assert(isLeaf(proxy) && "the proxy does not refer to an object");
+            if (nodes[proxy].box.contains(box))
+            {
+                return false;
+            }
+            FZOLV_PROFILE_ZONE("DynamicBVH::reinsert", 1);
+            removeLeaf(proxy);
+            nodes[proxy].box = Box(box).inflate(margin);
+            insertLeaf(proxy);
+            return true;
+        }
+
+        /**
+         * @brief Call fn(userData, proxy) for every object whose fat box overlaps box, until fn returns false
+         */
+        template <typename Fn>
+        void query(const Box &box, Fn &&fn) const
+        {
+            traverse([&](const Node &node) { return node.box.overlaps(box); },
+                     [&](proxy_type proxy) { return fn(nodes[proxy].userData, proxy); });
+        }
+
+        /**
+         * @brief Cast the ray origin + t * direction for t in [0, maxFraction] against the fat boxes
+         *
+         * fn(userData, proxy) is called for every hit box and returns the new maxFraction: return it unchanged to keep
+         * going, a smaller value to clip the ray to the closest hit found so far, or zero to stop.
+         */
+        template <typename Fn>
+        void raycast(const vector_type &origin, const vector_type &direction, value_type maxFraction, Fn &&fn) const
+        {
+            static_assert(std::is_floating_point<value_type>::value, "raycast needs floating point boxes");
+            traverse([&](const Node &node) { return detail::rayHits(node.box, origin, direction, maxFraction); },
+                     [&](proxy_type proxy)
+                     {
+                         maxFraction = fn(nodes[proxy].userData, proxy);
+                         return maxFraction > value_type(0);
+                     });
+        }
+
+        /**
+         * @brief Call fn(userA, userB) once for every pair of objects whose fat boxes overlap
+         */
+        template <typename Fn>
+        void forEachPair(Fn &&fn) const
+        {
+            for (proxy_type leaf = 0; leaf < static_cast<proxy_type>(nodes.size()); ++leaf)
+            {
+                pairsOf(leaf, fn);
+            }
+        }
+
+        /**
+         * @brief Collect every pair of objects whose fat boxes overlap, in the order of forEachPair, using several threads
+         *
+         * @param pairs Receives the pairs of user data, previous contents are replaced
+         */
+        void findPairs(std::vector<std::pair<user_type, user_type>> &pairs) const
+        {
+            FZOLV_PROFILE_ZONE("DynamicBVH::findPairs", nodes.size());
+            using Pairs = std::vector<std::pair<user_type, user_type>>;
+            std::vector<std::pair<std::size_t, Pairs>> chunks;
+            std::mutex lock;
+            ///< Every node costs a query down the tree, so the threshold counts about height() + 1 units per node
+            parallelForWeighted(nodes.size(), static_cast<std::size_t>(height() + 1), pairGrain,
+                                [&](std::size_t begin, std::size_t end)
+                                {
+                                    Pairs local;
+                                    for (std::size_t leaf = begin; leaf < end; ++leaf)
+                                    {
+                                        pairsOf(static_cast<proxy_type>(leaf),
+                                                [&](user_type a, user_type b) { local.emplace_back(a, b); });
+                                    }
+                                    const std::lock_guard<std::mutex> guard{lock};
+                                    chunks.emplace_back(begin, std::move(local));
+                                });
+
+            ///< Chunks finish in any order, sorting them by their first node keeps the result deterministic
+            std::sort(chunks.begin(), chunks.end(),
+                      [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+            pairs.clear();
+            for (const auto &chunk : chunks)
+            {
+                pairs.insert(pairs.end(), chunk.second.begin(), chunk.second.end());
+            }
+        }
+
+    private:
+        struct Node
+        {
+            Box box;
+            proxy_type parent = nullProxy; ///< The next free node while the node is on the free list
+            proxy_type child1 = nullProxy;
+            proxy_type child2 = nullProxy;
+            std::int32_t height = -1;      ///< 0 for leaves, -1 for free nodes
+            user_type userData = 0;
+        };
+
+        ///< Enough for any tree the rotations keep balanced, AVL trees of 2^31 nodes are less than 45 levels deep
+        static constexpr std::size_t stackCapacity = 128;
+        static_assert(stackCapacity >= 2, "a traversal pushes two children at a time");
+
+        ///< The number of nodes per findPairs chunk, each one costs a whole tree query
+        static constexpr std::size_t pairGrain = 256;
+
+        [[nodiscard]] auto isLeaf(proxy_type index) const -> bool { return nodes[index].height == 0; }
+
+        auto allocateNode() -> proxy_type
+        {
+            if (freeList == nullProxy)
+            {
+                nodes.emplace_back();
+                return static_cast<proxy_type>(nodes.size() - 1);
+            }
+            const proxy_type index = freeList;
+            freeList = nodes[index].parent;
+            nodes[index] = Node{};
+            return index;
+        }
+
+        void freeNode(proxy_type index)
+        {
+            nodes[index].parent = freeList;
+            nodes[index].height = -1;
+            freeList = index;
+        }
+
+        /**
+         * @brief Walk the tree depth first, descending into nodes that pass visit and calling leaf for leaves
+         */
+        template <typename Visit, typename Leaf>
+        void traverse(Visit &&visit, Leaf &&leaf) const
+        {
+            if (root == nullProxy)
+            {
+                return;
+            }
+            proxy_type local[stackCapacity];
+            std::vector<proxy_type> spill;
+            proxy_type *stack = local;
+            std::size_t capacity = stackCapacity;
+            std::size_t top = 0;
+            stack[top++] = root;
+            while (top > 0)
+            {
+                const proxy_type index = stack[--top];
+                const Node &node = nodes[index];
+                if (!visit(node))
+                {
+                    continue;
+                }
+                if (node.height == 0)
+                {
+                    if (!leaf(index))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    if (top + 2 > capacity)
+                    {
+                        ///< Only a tree the rotations failed to balance gets here, the stack doubles on the heap
+                        spill.resize(capacity * 2);
+                        if (stack == local)
+                        {
+                            std::copy(local, local + top, spill.begin());
+                        }
+                        stack = spill.data();
+                        capacity = spill.size();
+                    }
+                    stack[top++] = node.child1;
+                    stack[top++] = node.child2;
+                }
+            }
+        }
+
+        ///< Report the pairs of leaf with every overlapping leaf stored after it, so that each pair appears once
+        template <typename Fn>
+        void pairsOf(proxy_type leaf, Fn &&fn) const
+        {
+            if (!isLeaf(leaf))
+            {
+                return;
+            }
+            const Node &self = nodes[leaf];
+            traverse([&](const Node &node) { return node.box.overlaps(self.box); },
+                     [&](proxy_type other)
+                     {
+                         if (other > leaf)
+                         {
+                             fn(self.userData, nodes[other].userData);
+                         }
+                         return true;
+                     });
+        }
+
+        void insertLeaf(proxy_type leaf)
+        {
+            if (root == nullProxy)
+            {
+                root = leaf;
+                nodes[root].parent = nullProxy;
+                return;
+            }
+
+            ///< Descend towards the sibling with the lowest surface area cost, see Catto, "Dynamic Bounding Volume Hierarchies"
+            const Box leafBox = nodes[leaf].box;
+            proxy_type index = root;
+            while (!isLeaf(index))
+            {
+                const Node &node = nodes[index];
+                const value_type area = detail::surfaceCost(node.box);
+                const value_type combinedArea = detail::surfaceCost(Box::Union(node.box, leafBox));
+
+                ///< Pairing with this node creates a parent covering both, pushing down adds the growth to every ancestor
+                const value_type cost = value_type(2) * combinedArea;
+                const value_type inheritance = value_type(2) * (combinedArea - area);
+                const value_type cost1 = descendCost(node.child1, leafBox) + inheritance;
+                const value_type cost2 = descendCost(node.child2, leafBox) + inheritance;
+
+                if (cost < cost1 && cost < cost2)
+                {
+                    break;
+                }
+                index = cost1 < cost2 ? node.child1 : node.child2;
+            }
+            const proxy_type sibling = index;
+
+            const proxy_type oldParent = nodes[sibling].parent;
+            const proxy_type newParent = allocateNode();
+            nodes[newParent].parent = oldParent;
+            nodes[newParent].box = Box::Union(leafBox, nodes[sibling].box);
+            nodes[newParent].height = nodes[sibling].height + 1;
+            nodes[newParent].child1 = sibling;
+            nodes[newParent].child2 = leaf;
+            nodes[sibling].parent = newParent;
+            nodes[leaf].parent = newParent;
+
+            if (oldParent == nullProxy)
+            {
+                root = newParent;
+            }
+            else if (nodes[oldParent].child1 == sibling)
+            {
+                nodes[oldParent].child1 = newParent;
+            }
+            else
+            {
+                nodes[oldParent].child2 = newParent;
+            }
+
+            refit(nodes[leaf].parent);
+        }
+
+        ///< The cost of descending into child to insert a box of leafBox, not counting the ancestors
+        auto descendCost(proxy_type child, const Box &leafBox) const -> value_type
+        {
+            const value_type combined = detail::surfaceCost(Box::Union(leafBox, nodes[child].box));
+            return isLeaf(child) ? combined : combined - detail::surfaceCost(nodes[child].box);
+        }
+
+        void removeLeaf(proxy_type leaf)
+        {
+            if (leaf == root)
+            {
+                root = nullProxy;
+                return;
+            }
+
+            const proxy_type parent = nodes[leaf].parent;
+            const proxy_type grandParent = nodes[parent].parent;
+            const proxy_type sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+            if (grandParent == nullProxy)
+            {
+                root = sibling;
+                nodes[sibling].parent = nullProxy;
+                freeNode(parent);
+                return;
+            }
+
+            if (nodes[grandParent].child1 == parent)
+            {
+                nodes[grandParent].child1 = sibling;
+            }
+            else
+            {
+                nodes[grandParent].child2 = sibling;
+            }
+            nodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refit(grandParent);
+        }
+
+        ///< Rebalance and recompute the boxes and heights from index up to the root
+        void refit(proxy_type index)
+        {
+            while (index != nullProxy)
+            {
+                index = balance(index);
+                Node &node = nodes[index];
+                node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+                node.box = Box::Union(nodes[node.child1].box, nodes[node.child2].box);
+                index = node.parent;
+            }
+        }
+
+        ///< Point whatever referred to from at to instead, the parent or the root
+        void replaceChild(proxy_type parent, proxy_type from, proxy_type to)
+        {
+            if (parent == nullProxy)
+            {
+                root = to;
+            }
+            else if (nodes[parent].child1 == from)
+            {
+                nodes[parent].child1 = to;
+            }
+            else
+            {
+                nodes[parent].child2 = to;
+            }
+        }
+
+        /**
+         * @brief Rotate the taller child of a up when the heights of its children differ by more than one
+         *
+         * @return proxy_type The node now at the position of a
+         */
+        auto balance(proxy_type a) -> proxy_type
+        {
+            if (isLeaf(a) || nodes[a].height < 2)
+            {
+                return a;
+            }
+
+            const proxy_type b = nodes[a].child1;
+            const proxy_type c = nodes[a].child2;
+            const std::int32_t difference = nodes[c].height - nodes[b].height;
+            if (difference > 1)
+            {
+                rotateUp(a, c, b, false);
+                return c;
+            }
+            if (difference < -1)
+            {
+                rotateUp(a, b, c, true);
+                return b;
+            }
+            return a;
+        }
+
+        /**
+         * @brief Make child the parent of a, a keeps other and the shorter child of child
+         *
+         * @param a The unbalanced node
+         * @param child The taller child of a, the one moving up
+         * @param other The shorter child of a
+         * @param childIsFirst Whether child is the first child of a
+         */
+        void rotateUp(proxy_type a, proxy_type child, proxy_type other, bool childIsFirst)
+        {
+            const proxy_type f = nodes[child].child1;
+            const proxy_type g = nodes[child].child2;
+
+            nodes[child].child1 = a;
+            nodes[child].parent = nodes[a].parent;
+            nodes[a].parent = child;
+            replaceChild(nodes[child].parent, a, child);
+
+            const bool keepFirst = nodes[f].height > nodes[g].height;
+            const proxy_type kept = keepFirst ? f : g;
+            const proxy_type moved = keepFirst ? g : f;
+
+            nodes[child].child2 = kept;
+            if (childIsFirst)
+            {
+                nodes[a].child1 = moved;
+            }
+            else
+            {
+                nodes[a].child2 = moved;
+            }
+            nodes[moved].parent = a;
+
+            nodes[a].box = Box::Union(nodes[other].box, nodes[moved].box);
+            nodes[a].height = 1 + std::max(nodes[other].height, nodes[moved].height);
+            nodes[child].box = Box::Union(nodes[a].box, nodes[kept].box);
+            nodes[child].height = 1 + std::max(nodes[a].height, nodes[kept].height);
+        }
+
+        value_type margin;
+        std::vector<Node> nodes;
+        proxy_type root = nullProxy;
+        proxy_type freeList = nullProxy;
+        std::size_t proxies = 0;
+    };
+
+    using DynamicBVH2f = DynamicBVH<AABB2f>;
+    using DynamicBVH3f = DynamicBVH<AABB3f>;
+}
+
+#endif /* end of include guard: FZOLV_BVH_2aaltl */
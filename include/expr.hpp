@@ -0,0 +1,467 @@
+#ifndef FZOLV_EXPR_p4oilq
+#define FZOLV_EXPR_p4oilq
+
+#include <cassert>
+#include <cstddef>
+#include <soa.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <util.hpp>
+#include <vector.hpp>
+#include <vector>
+
+namespace Fzolv
+{
+    /**
+     * @brief Opt-in expression templates for fused component-wise Vector2 arithmetic
+     *
+     * Wrapping an operand with lazy() turns the following +, -, * and / into expression nodes instead of Vector2
+     * temporaries. The whole expression is evaluated once per component when it is converted to a Vector2 or
+     * assigned into a container, so `positions += lazy(velocities) * dt` is a single loop over the arrays. Every
+     * component is computed in the same order as the eager operators, which keeps results identical.
+     *
+     * Lazy terminals only reference containers, so an expression must not outlive the data it was built from.
+     */
+    namespace expr
+    {
+        /**
+         * @brief Base class of every expression node
+         *
+         * @tparam E The derived expression type
+         * @tparam T The component type the expression produces
+         */
+        template <typename E, typename T>
+        class Expression
+        {
+        public:
+            using value_type = T;
+
+            [[nodiscard]] constexpr auto self() const noexcept -> const E & { return static_cast<const E &>(*this); }
+
+            /**
+             * @brief Evaluate a single-vector expression
+             *
+             * @return Vector2<T> The value of the expression
+             */
+            constexpr operator Vector2<T>() const
+            {
+                static_assert(!E::isBatch, "a batch expression has to be assigned into a container");
+                return {self().template value<0>(0), self().template value<1>(0)};
+            }
+        };
+
+        namespace detail
+        {
+            struct Assign
+            {
+                template <typename T>
+                static constexpr auto apply(T, T rhs) -> T { return rhs; }
+            };
+
+            struct Add
+            {
+                template <typename T>
+                static constexpr auto apply(T lhs, T rhs) -> T { return lhs + rhs; }
+            };
+
+            struct Sub
+            {
+                template <typename T>
+                static constexpr auto apply(T lhs, T rhs) -> T { return lhs - rhs; }
+            };
+
+            struct Mul
+            {
+                template <typename T>
+                static constexpr auto apply(T lhs, T rhs) -> T { return lhs * rhs; }
+            };
+
+            struct Div
+            {
+                template <typename T>
+                static constexpr auto apply(T lhs, T rhs) -> T { return lhs / rhs; }
+            };
+        }
+
+        /**
+         * @brief A single vector, captured by value and broadcast over every element of a batch
+         */
+        template <typename T>
+        class VectorTerminal : public Expression<VectorTerminal<T>, T>
+        {
+        public:
+            static constexpr bool isBatch = false;
+
+            constexpr explicit VectorTerminal(const Vector2<T> &v) : x{v.x}, y{v.y} {}
+
+            template <std::size_t C>
+            [[nodiscard]] constexpr auto value(std::size_t) const -> T
+            {
+                if constexpr (C == 0)
+                {
+                    return x;
+                }
+                else
+                {
+                    return y;
+                }
+            }
+
+            [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return 0; }
+
+        private:
+            T x;
+            T y;
+        };
+
+        /**
+         * @brief A scalar used by * and /, broadcast over both components
+         */
+        template <typename T>
+        class ScalarTerminal : public Expression<ScalarTerminal<T>, T>
+        {
+        public:
+            static constexpr bool isBatch = false;
+
+            constexpr explicit ScalarTerminal(T s) : scalar{s} {}
+
+            template <std::size_t C>
+            [[nodiscard]] constexpr auto value(std::size_t) const -> T { return scalar; }
+
+            [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return 0; }
+
+        private:
+            T scalar;
+        };
+
+        /**
+         * @brief A contiguous array of vectors
+         */
+        template <typename T>
+        class SpanTerminal : public Expression<SpanTerminal<T>, T>
+        {
+        public:
+            static constexpr bool isBatch = true;
+
+            constexpr explicit SpanTerminal(span<const Vector2<T>> vectors) : data{vectors.data()}, count{vectors.size()} {}
+
+            template <std::size_t C>
+            [[nodiscard]] constexpr auto value(std::size_t i) const -> T
+            {
+                if constexpr (C == 0)
+                {
+                    return data[i].x;
+                }
+                else
+                {
+                    return data[i].y;
+                }
+            }
+
+            [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return count; }
+
+        private:
+            const Vector2<T> *data;
+            std::size_t count;
+        };
+
+        /**
+         * @brief The component lanes of a structure-of-arrays container
+         */
+        template <typename T>
+        class LanesTerminal : public Expression<LanesTerminal<T>, T>
+        {
+        public:
+            static constexpr bool isBatch = true;
+
+            explicit LanesTerminal(const Vector2SoA<T> &vectors)
+                : xs{vectors.xData()}, ys{vectors.yData()}, count{vectors.size()}
+            {
+            }
+
+            template <std::size_t C>
+            [[nodiscard]] constexpr auto value(std::size_t i) const -> T
+            {
+                if constexpr (C == 0)
+                {
+                    return xs[i];
+                }
+                else
+                {
+                    return ys[i];
+                }
+            }
+
+            [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return count; }
+
+        private:
+            const T *xs;
+            const T *ys;
+            std::size_t count;
+        };
+
+        /**
+         * @brief A component-wise binary operation on two expressions
+         *
+         * @tparam Op One of the detail operation types
+         */
+        template <typename Op, typename L, typename R>
+        class Binary : public Expression<Binary<Op, L, R>, typename L::value_type>
+        {
+        public:
+            using value_type = typename L::value_type;
+
+            static constexpr bool isBatch = L::isBatch || R::isBatch;
+
+            constexpr Binary(const L &l, const R &r) : lhs{l}, rhs{r} {}
+
+            template <std::size_t C>
+            [[nodiscard]] constexpr auto value(std::size_t i) const -> value_type
+            {
+                return Op::apply(lhs.template value<C>(i), rhs.template value<C>(i));
+            }
+
+            /**
+             * @brief The number of elements of a batch expression, zero for a single-vector expression
+             */
+            [[nodiscard]] constexpr auto size() const noexcept -> std::size_t
+            {
+                if constexpr (L::isBatch && R::isBatch)
+                {
+                    assert(lhs.size() == rhs.size());
+                    return lhs.size();
+                }
+                else if constexpr (L::isBatch)
+                {
+                    return lhs.size();
+                }
+                else
+                {
+                    return rhs.size();
+                }
+            }
+
+        private:
+            L lhs;
+            R rhs;
+        };
+
+        ///< Entry points that start an expression
+
+        template <typename T>
+        constexpr auto lazy(const Vector2<T> &v) -> VectorTerminal<T>
+        {
+            return VectorTerminal<T>{v};
+        }
+
+        template <typename T>
+        constexpr auto lazy(span<const Vector2<T>> vectors) -> SpanTerminal<T>
+        {
+            return SpanTerminal<T>{vectors};
+        }
+
+        template <typename T>
+        constexpr auto lazy(span<Vector2<T>> vectors) -> SpanTerminal<T>
+        {
+            return SpanTerminal<T>{vectors};
+        }
+
+        template <typename T, typename A>
+        auto lazy(const std::vector<Vector2<T>, A> &vectors) -> SpanTerminal<T>
+        {
+            return SpanTerminal<T>{span<const Vector2<T>>{vectors}};
+        }
+
+        template <typename T>
+        auto lazy(const Vector2SoA<T> &vectors) -> LanesTerminal<T>
+        {
+            return LanesTerminal<T>{vectors};
+        }
+
+        ///< Temporaries would dangle before the expression is evaluated
+        template <typename T, typename A>
+        auto lazy(std::vector<Vector2<T>, A> &&) -> SpanTerminal<T> = delete;
+        template <typename T>
+        auto lazy(Vector2SoA<T> &&) -> LanesTerminal<T> = delete;
+
+        ///< Operators, a plain Vector2 operand is captured as a single-vector terminal
+
+        template <typename L, typename R, typename T>
+        constexpr auto operator+(const Expression<L, T> &lhs, const Expression<R, T> &rhs) -> Binary<detail::Add, L, R>
+        {
+            return {lhs.self(), rhs.self()};
+        }
+
+        template <typename L, typename T>
+        constexpr auto operator+(const Expression<L, T> &lhs, const Vector2<T> &rhs)
+            -> Binary<detail::Add, L, VectorTerminal<T>>
+        {
+            return {lhs.self(), VectorTerminal<T>{rhs}};
+        }
+
+        template <typename R, typename T>
+        constexpr auto operator+(const Vector2<T> &lhs, const Expression<R, T> &rhs)
+            -> Binary<detail::Add, VectorTerminal<T>, R>
+        {
+            return {VectorTerminal<T>{lhs}, rhs.self()};
+        }
+
+        template <typename L, typename R, typename T>
+        constexpr auto operator-(const Expression<L, T> &lhs, const Expression<R, T> &rhs) -> Binary<detail::Sub, L, R>
+        {
+            return {lhs.self(), rhs.self()};
+        }
+
+        template <typename L, typename T>
+        constexpr auto operator-(const Expression<L, T> &lhs, const Vector2<T> &rhs)
+            -> Binary<detail::Sub, L, VectorTerminal<T>>
+        {
+            return {lhs.self(), VectorTerminal<T>{rhs}};
+        }
+
+        template <typename R, typename T>
+        constexpr auto operator-(const Vector2<T> &lhs, const Expression<R, T> &rhs)
+            -> Binary<detail::Sub, VectorTerminal<T>, R>
+        {
+            return {VectorTerminal<T>{lhs}, rhs.self()};
+        }
+
+        template <typename L, typename T, typename S, typename = std::enable_if_t<is_numeric<S>::value>>
+        constexpr auto operator*(const Expression<L, T> &lhs, S scalar) -> Binary<detail::Mul, L, ScalarTerminal<T>>
+        {
+            return {lhs.self(), ScalarTerminal<T>{static_cast<T>(scalar)}};
+        }
+
+        template <typename R, typename T, typename S, typename = std::enable_if_t<is_numeric<S>::value>>
+        constexpr auto operator*(S scalar, const Expression<R, T> &rhs) -> Binary<detail::Mul, ScalarTerminal<T>, R>
+        {
+            return {ScalarTerminal<T>{static_cast<T>(scalar)}, rhs.self()};
+        }
+
+        template <typename L, typename T, typename S, typename = std::enable_if_t<is_numeric<S>::value>>
+        constexpr auto operator/(const Expression<L, T> &lhs, S scalar) -> Binary<detail::Div, L, ScalarTerminal<T>>
+        {
+            return {lhs.self(), ScalarTerminal<T>{static_cast<T>(scalar)}};
+        }
+
+        namespace detail
+        {
+            template <typename Op, typename T, typename E>
+            void evaluate(Vector2<T> *out, std::size_t count, const Expression<E, T> &e)
+            {
+                const E &expression = e.self();
+                if constexpr (E::isBatch)
+                {
+                    assert(expression.size() == count);
+                }
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const T x = expression.template value<0>(i);
+                    const T y = expression.template value<1>(i);
+                    out[i].x = Op::apply(out[i].x, x);
+                    out[i].y = Op::apply(out[i].y, y);
+                }
+            }
+
+            template <typename Op, typename T, typename E>
+            void evaluate(Vector2SoA<T> &out, const Expression<E, T> &e)
+            {
+                const E &expression = e.self();
+                if constexpr (E::isBatch)
+                {
+                    assert(expression.size() == out.size());
+                }
+                T *xs = out.xData();
+                T *ys = out.yData();
+                for (std::size_t i = 0, count = out.size(); i < count; ++i)
+                {
+                    xs[i] = Op::apply(xs[i], expression.template value<0>(i));
+                    ys[i] = Op::apply(ys[i], expression.template value<1>(i));
+                }
+            }
+        }
+
+        /**
+         * @brief Evaluate an expression into every element of a span, out[i] = e[i]
+         *
+         * The output may alias any array the expression reads, since every element only reads its own index.
+         *
+         * @param out The destination, must have the size of a batch expression
+         * @param e The expression to evaluate
+         */
+        template <typename T, typename E>
+        void assign(span<Vector2<T>> out, const Expression<E, T> &e)
+        {
+            detail::evaluate<detail::Assign>(out.data(), out.size(), e);
+        }
+
+        /**
+         * @brief Evaluate an expression into a container, resized to the expression's size when it is a batch
+         */
+        template <typename T, typename A, typename E>
+        void assign(std::vector<Vector2<T>, A> &out, const Expression<E, T> &e)
+        {
+            if constexpr (E::isBatch)
+            {
+                out.resize(e.self().size());
+            }
+            detail::evaluate<detail::Assign>(out.data(), out.size(), e);
+        }
+
+        template <typename T, typename E>
+        void assign(Vector2SoA<T> &out, const Expression<E, T> &e)
+        {
+            if constexpr (E::isBatch)
+            {
+                out.resize(e.self().size());
+            }
+            detail::evaluate<detail::Assign>(out, e);
+        }
+
+        ///< Fused compound assignment into vectors and containers
+
+        template <typename T, typename E>
+        auto operator+=(Vector2<T> &lhs, const Expression<E, T> &rhs) -> Vector2<T> &
+        {
+            detail::evaluate<detail::Add>(&lhs, 1, rhs);
+            return lhs;
+        }
+
+        template <typename T, typename E>
+        auto operator-=(Vector2<T> &lhs, const Expression<E, T> &rhs) -> Vector2<T> &
+        {
+            detail::evaluate<detail::Sub>(&lhs, 1, rhs);
+            return lhs;
+        }
+
+        template <typename T, typename A, typename E>
+        auto operator+=(std::vector<Vector2<T>, A> &lhs, const Expression<E, T> &rhs) -> std::vector<Vector2<T>, A> &
+        {
+            detail::evaluate<detail::Add>(lhs.data(), lhs.size(), rhs);
+            return lhs;
+        }
+
+        template <typename T, typename A, typename E>
+        auto operator-=(std::vector<Vector2<T>, A> &lhs, const Expression<E, T> &rhs) -> std::vector<Vector2<T>, A> &
+        {
+            detail::evaluate<detail::Sub>(lhs.data(), lhs.size(), rhs);
+            return lhs;
+        }
+
+        template <typename T, typename E>
+        auto operator+=(Vector2SoA<T> &lhs, const Expression<E, T> &rhs) -> Vector2SoA<T> &
+        {
+            detail::evaluate<detail::Add>(lhs, rhs);
+            return lhs;
+        }
+
+        template <typename T, typename E>
+        auto operator-=(Vector2SoA<T> &lhs, const Expression<E, T> &rhs) -> Vector2SoA<T> &
+        {
+            detail::evaluate<detail::Sub>(lhs, rhs);
+            return lhs;
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_EXPR_p4oilq */
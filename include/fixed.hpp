@@ -0,0 +1,356 @@
+#ifndef FZOLV_FIXED_c41cfk
+#define FZOLV_FIXED_c41cfk
+
+#include <cstdint>
+#include <limits>
+#include <math.hpp>
+#include <type_traits>
+#include <util.hpp>
+#include <vector.hpp>
+
+/**
+ * @brief Whether the compiler provides a 128-bit integer, which Fixed<32> needs for its intermediate products
+ */
+#if defined(__SIZEOF_INT128__)
+#define FZOLV_HAS_INT128 1
+#else
+#define FZOLV_HAS_INT128 0
+#endif
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        ///< The storage of a fixed-point number and the integer type that holds the product of two of them
+        template <unsigned Bits>
+        struct fixed_storage;
+
+        template <>
+        struct fixed_storage<16>
+        {
+            using raw_type = std::int32_t;
+            using wide_type = std::int64_t;
+            using unsigned_wide_type = std::uint64_t;
+        };
+
+#if FZOLV_HAS_INT128
+        template <>
+        struct fixed_storage<32>
+        {
+            using raw_type = std::int64_t;
+            __extension__ typedef __int128 wide_type;
+            __extension__ typedef unsigned __int128 unsigned_wide_type;
+        };
+#endif
+
+        /**
+         * @brief The integer square root of n rounded to the nearest integer
+         *
+         * The hardware square root only provides the first estimate, the integer corrections after it make the result
+         * exact, so it is the same on every platform whatever the floating point unit rounds to.
+         */
+        template <typename U>
+        constexpr auto isqrtRounded(U n) -> U
+        {
+            U result = static_cast<U>(math::sqrt(static_cast<double>(n)));
+            while (result * result > n)
+            {
+                --result;
+            }
+            while ((result + 1) * (result + 1) <= n)
+            {
+                ++result;
+            }
+            ///< Round up when n reaches past (result + 1/2)^2 = result^2 + result + 1/4
+            return n - result * result > result ? result + 1 : result;
+        }
+    }
+
+    /**
+     * @brief A signed fixed-point number with Bits integer bits and Bits fractional bits
+     *
+     * Fixed<16> is Q16.16 stored in 32 bits and Fixed<32> is Q32.32 stored in 64 bits. Every operation is integer
+     * arithmetic with fully specified rounding, so results are bitwise identical on every compiler and processor,
+     * which makes Vector2<Fixed16> suitable for lockstep simulation. Overflow wraps around in two's complement.
+     *
+     * Multiplication rounds to the nearest representable value with ties towards positive infinity, division with ties
+     * away from zero. Division by zero saturates to the largest value of the dividend's sign, or gives zero for 0 / 0.
+     * Integers convert implicitly and exactly, floating point values only explicitly.
+     *
+     * @tparam Bits The number of integer and of fractional bits, 16 or 32
+     */
+    template <unsigned Bits>
+    class Fixed
+    {
+    public:
+        using raw_type = typename detail::fixed_storage<Bits>::raw_type;
+        using wide_type = typename detail::fixed_storage<Bits>::wide_type;
+
+        ///< The number of fractional bits
+        static constexpr unsigned fractionBits = Bits;
+
+        /**
+         * @brief Default constructor, initializes the number to zero
+         */
+        constexpr Fixed() : value() {}
+
+        /**
+         * @brief Construct from an integer, exact as long as it fits in Bits integer bits
+         *
+         * @param integer The integer value
+         */
+        template <typename I, std::enable_if_t<std::is_integral<I>::value, int> = 0>
+        constexpr Fixed(I integer) : value{wrap(static_cast<wide_type>(integer) * oneRaw)}
+        {
+        }
+
+        /**
+         * @brief Construct from a floating point value, rounded to the nearest representable value
+         *
+         * @param real The floating point value, must be within the range of the type
+         */
+        template <typename F, std::enable_if_t<std::is_floating_point<F>::value, int> = 0>
+        constexpr explicit Fixed(F real)
+            : value{static_cast<raw_type>(static_cast<F>(real * static_cast<F>(oneRaw)) + (real < 0 ? F(-0.5) : F(0.5)))}
+        {
+        }
+
+        /**
+         * @brief Widen a fixed-point number with fewer bits, always exact
+         */
+        template <unsigned OtherBits, std::enable_if_t<(OtherBits < Bits), int> = 0>
+        constexpr Fixed(Fixed<OtherBits> other)
+            : value{static_cast<raw_type>(static_cast<raw_type>(other.raw()) * (raw_type(1) << (Bits - OtherBits)))}
+        {
+        }
+
+        /**
+         * @brief Narrow a fixed-point number with more bits, rounded to the nearest value
+         */
+        template <unsigned OtherBits, std::enable_if_t<(OtherBits > Bits), int> = 0>
+        constexpr explicit Fixed(Fixed<OtherBits> other)
+            : value{wrap((static_cast<wide_type>(other.raw()) + (wide_type(1) << (OtherBits - Bits - 1))) >>
+                         (OtherBits - Bits))}
+        {
+        }
+
+        /**
+         * @brief Construct a number from its raw two's complement representation
+         *
+         * @param raw The raw value, the number multiplied by 2^Bits
+         * @return constexpr Fixed The number
+         */
+        static constexpr auto FromRaw(raw_type raw) -> Fixed
+        {
+            Fixed result;
+            result.value = raw;
+            return result;
+        }
+
+        [[nodiscard]] constexpr auto raw() const noexcept -> raw_type { return value; }
+
+        /**
+         * @brief Convert to a floating point type exactly when it has enough bits, or to an integer truncating towards
+         * zero
+         */
+        template <typename A, std::enable_if_t<std::is_arithmetic<A>::value, int> = 0>
+        constexpr explicit operator A() const
+        {
+            if constexpr (std::is_floating_point<A>::value)
+            {
+                return static_cast<A>(value) / static_cast<A>(oneRaw);
+            }
+            else
+            {
+                return static_cast<A>(value / oneRaw);
+            }
+        }
+
+        ///< Functions used through math::sqrt, floor, ceil and round
+
+        /**
+         * @brief The square root rounded to the nearest representable value, zero for negative numbers
+         */
+        [[nodiscard]] constexpr auto sqrt() const -> Fixed
+        {
+            using U = typename detail::fixed_storage<Bits>::unsigned_wide_type;
+            if (value <= 0)
+            {
+                return Fixed{};
+            }
+            return FromRaw(static_cast<raw_type>(detail::isqrtRounded(static_cast<U>(value) << Bits)));
+        }
+
+        [[nodiscard]] constexpr auto floor() const -> Fixed { return FromRaw(static_cast<raw_type>(value & ~(oneRaw - 1))); }
+
+        [[nodiscard]] constexpr auto ceil() const -> Fixed
+        {
+            return FromRaw(static_cast<raw_type>(wrap(static_cast<wide_type>(value) + (oneRaw - 1)) & ~(oneRaw - 1)));
+        }
+
+        ///< Halfway cases round away from zero, like std::round
+        [[nodiscard]] constexpr auto round() const -> Fixed
+        {
+            const raw_type half = oneRaw / 2;
+            if (value < 0)
+            {
+                return -FromRaw(static_cast<raw_type>(wrap(-static_cast<wide_type>(value) + half) & ~(oneRaw - 1)));
+            }
+            return FromRaw(static_cast<raw_type>(wrap(static_cast<wide_type>(value) + half) & ~(oneRaw - 1)));
+        }
+
+        ///< Arithmetic operators
+
+        constexpr auto operator-() const -> Fixed { return FromRaw(wrap(-static_cast<wide_type>(value))); }
+
+        constexpr auto operator+() const -> Fixed { return *this; }
+
+        friend constexpr auto operator+(Fixed lhs, Fixed rhs) -> Fixed
+        {
+            return FromRaw(wrap(static_cast<wide_type>(lhs.value) + rhs.value));
+        }
+
+        friend constexpr auto operator-(Fixed lhs, Fixed rhs) -> Fixed
+        {
+            return FromRaw(wrap(static_cast<wide_type>(lhs.value) - rhs.value));
+        }
+
+        friend constexpr auto operator*(Fixed lhs, Fixed rhs) -> Fixed
+        {
+            const wide_type product = static_cast<wide_type>(lhs.value) * rhs.value;
+            return FromRaw(wrap((product + (wide_type(1) << (Bits - 1))) >> Bits));
+        }
+
+        friend constexpr auto operator/(Fixed lhs, Fixed rhs) -> Fixed
+        {
+            if (rhs.value == 0)
+            {
+                if (lhs.value == 0)
+                {
+                    return Fixed{};
+                }
+                return FromRaw(lhs.value > 0 ? std::numeric_limits<raw_type>::max() : std::numeric_limits<raw_type>::min());
+            }
+            const wide_type dividend = static_cast<wide_type>(lhs.value) * oneRaw;
+            const wide_type quotient = dividend / rhs.value;
+            const wide_type remainder = dividend % rhs.value;
+            const wide_type twice = remainder < 0 ? -2 * remainder : 2 * remainder;
+            const wide_type divisor = rhs.value < 0 ? -static_cast<wide_type>(rhs.value) : rhs.value;
+            if (twice < divisor)
+            {
+                return FromRaw(wrap(quotient));
+            }
+            return FromRaw(wrap((dividend < 0) == (rhs.value < 0) ? quotient + 1 : quotient - 1));
+        }
+
+        constexpr auto operator+=(Fixed other) -> Fixed & { return *this = *this + other; }
+
+        constexpr auto operator-=(Fixed other) -> Fixed & { return *this = *this - other; }
+
+        constexpr auto operator*=(Fixed other) -> Fixed & { return *this = *this * other; }
+
+        constexpr auto operator/=(Fixed other) -> Fixed & { return *this = *this / other; }
+
+        ///< Comparison operators
+
+        friend constexpr auto operator==(Fixed lhs, Fixed rhs) -> bool { return lhs.value == rhs.value; }
+
+        friend constexpr auto operator!=(Fixed lhs, Fixed rhs) -> bool { return lhs.value != rhs.value; }
+
+        friend constexpr auto operator<(Fixed lhs, Fixed rhs) -> bool { return lhs.value < rhs.value; }
+
+        friend constexpr auto operator<=(Fixed lhs, Fixed rhs) -> bool { return lhs.value <= rhs.value; }
+
+        friend constexpr auto operator>(Fixed lhs, Fixed rhs) -> bool { return lhs.value > rhs.value; }
+
+        friend constexpr auto operator>=(Fixed lhs, Fixed rhs) -> bool { return lhs.value >= rhs.value; }
+
+    private:
+        static constexpr raw_type oneRaw = raw_type(1) << Bits;
+
+        ///< Reduce a wide intermediate to the raw type modulo 2^(2 * Bits), without signed overflow
+        static constexpr auto wrap(wide_type wide) -> raw_type
+        {
+            using U = std::make_unsigned_t<raw_type>;
+            return static_cast<raw_type>(static_cast<U>(wide));
+        }
+
+        raw_type value;
+    };
+
+    using Fixed16 = Fixed<16>;
+#if FZOLV_HAS_INT128
+    using Fixed32 = Fixed<32>;
+#endif
+
+    ///< Fixed-point numbers are numeric, and vectors of them measure lengths without leaving fixed point
+
+    template <unsigned Bits>
+    struct is_numeric<Fixed<Bits>> : std::true_type
+    {
+    };
+
+    template <unsigned Bits>
+    struct precision_type<Fixed<Bits>>
+    {
+        using type = Fixed<Bits>;
+    };
+
+    template <>
+    struct high_precision_type<Fixed16>
+    {
+#if FZOLV_HAS_INT128
+        using type = Fixed32;
+#else
+        using type = Fixed16;
+#endif
+    };
+
+#if FZOLV_HAS_INT128
+    template <>
+    struct high_precision_type<Fixed32>
+    {
+        using type = Fixed32;
+    };
+#endif
+
+    using Vector2q16 = Vector2<Fixed16>;
+    using Vector3q16 = Vector3<Fixed16>;
+#if FZOLV_HAS_INT128
+    using Vector2q32 = Vector2<Fixed32>;
+    using Vector3q32 = Vector3<Fixed32>;
+#endif
+
+    static_assert(std::is_trivially_copyable<Fixed16>::value, "Fixed16 must be trivially copyable");
+    static_assert(sizeof(Vector2q16) == 2 * sizeof(std::int32_t), "Vector2q16 must not contain padding");
+}
+
+namespace std
+{
+    template <unsigned Bits>
+    class numeric_limits<Fzolv::Fixed<Bits>>
+    {
+        using F = Fzolv::Fixed<Bits>;
+        using raw = typename F::raw_type;
+
+    public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = false;
+        static constexpr bool is_exact = true;
+        static constexpr bool has_infinity = false;
+        static constexpr bool has_quiet_NaN = false;
+        static constexpr bool is_modulo = true;
+        static constexpr int digits = numeric_limits<raw>::digits;
+        static constexpr int radix = 2;
+
+        ///< The smallest positive value, like min() of an integer type there is nothing closer to zero
+        static constexpr auto min() noexcept -> F { return F::FromRaw(1); }
+        static constexpr auto max() noexcept -> F { return F::FromRaw(numeric_limits<raw>::max()); }
+        static constexpr auto lowest() noexcept -> F { return F::FromRaw(numeric_limits<raw>::min()); }
+        static constexpr auto epsilon() noexcept -> F { return F::FromRaw(1); }
+        static constexpr auto round_error() noexcept -> F { return F::FromRaw(raw(1) << (Bits - 1)); }
+    };
+}
+
+#endif /* end of include guard: FZOLV_FIXED_c41cfk */
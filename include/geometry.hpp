@@ -0,0 +1,1001 @@
+#ifndef FZOLV_GEOMETRY_3p7385
+#define FZOLV_GEOMETRY_3p7385
+
+#include <aabb.hpp>
+#include <batch.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <parallel.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        /**
+         * @brief The fraction t at which the ray o + t * d crosses the segment from a to b, infinity on a miss
+         *
+         * Both cross products are divided by d x (b - a), so parallel and degenerate segments miss, including
+         * collinear ones. Every batch kernel evaluates this exact sequence of operations.
+         */
+        template <typename T>
+        inline auto raySegmentFraction(T ox, T oy, T dx, T dy, T ax, T ay, T bx, T by) -> T
+        {
+            const T ex = bx - ax;
+            const T ey = by - ay;
+            const T fx = ax - ox;
+            const T fy = ay - oy;
+            const T denominator = dx * ey - dy * ex;
+            const T t = (fx * ey - fy * ex) / denominator;
+            const T s = (fx * dy - fy * dx) / denominator;
+            const bool hit = denominator != T(0) && t >= T(0) && s >= T(0) && s <= T(1);
+            return hit ? t : std::numeric_limits<T>::infinity();
+        }
+
+        /**
+         * @brief The fraction t at which the ray o + t * d enters the circle around c, 0 from inside, infinity on a miss
+         *
+         * A direction whose squared length is zero never moves, it hits at 0 when the origin is inside or on the circle
+         * and misses otherwise.
+         */
+        template <typename T>
+        inline auto rayCircleFraction(T ox, T oy, T dx, T dy, T cx, T cy, T radius) -> T
+        {
+            const T mx = ox - cx;
+            const T my = oy - cy;
+            const T a = dx * dx + dy * dy;
+            const T b = mx * dx + my * dy;
+            const T c = (mx * mx + my * my) - radius * radius;
+            const T discriminant = b * b - a * c;
+            const T root = std::sqrt(discriminant);
+            const T nearT = (-b - root) / a;
+            const T farT = (-b + root) / a;
+            ///< Both roots divide by zero when a is, so that case is decided by c alone
+            const bool still = a == T(0);
+            const bool hit = still ? c <= T(0) : discriminant >= T(0) && farT >= T(0);
+            const T entry = !still && nearT > T(0) ? nearT : T(0);
+            return hit ? entry : std::numeric_limits<T>::infinity();
+        }
+    }
+
+    /**
+     * @brief A 2D line segment between two points, both included
+     *
+     * @tparam T The type of the vector components, must be floating-point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Segment2
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector2<T>;
+
+        constexpr Segment2() = default;
+
+        constexpr Segment2(const Vector2<T> &startPoint, const Vector2<T> &endPoint) : start{startPoint}, end{endPoint} {}
+
+        [[nodiscard]] constexpr auto direction() const -> Vector2<T> { return end - start; }
+
+        [[nodiscard]] constexpr auto lengthSquared() const -> T { return direction().lengthSquared(); }
+
+        [[nodiscard]] auto length() const -> T { return std::sqrt(lengthSquared()); }
+
+        /**
+         * @brief The point of the segment closest to point, start for degenerate segments
+         */
+        [[nodiscard]] constexpr auto closestPoint(const Vector2<T> &point) const -> Vector2<T>
+        {
+            const Vector2<T> along = direction();
+            const T squared = along.lengthSquared();
+            if (!(squared > T(0)))
+            {
+                return start;
+            }
+            const T t = (point - start).dot(along) / squared;
+            return start + along * (t < T(0) ? T(0) : (t > T(1) ? T(1) : t));
+        }
+
+        [[nodiscard]] constexpr auto distanceSquared(const Vector2<T> &point) const -> T
+        {
+            return (point - closestPoint(point)).lengthSquared();
+        }
+
+        /**
+         * @brief Whether the segments cross, parallel segments never do
+         */
+        [[nodiscard]] auto intersects(const Segment2 &other) const -> bool
+        {
+            const Vector2<T> along = direction();
+            return detail::raySegmentFraction(start.x, start.y, along.x, along.y, other.start.x, other.start.y,
+                                              other.end.x, other.end.y) <= T(1);
+        }
+
+        constexpr auto operator==(const Segment2 &other) const -> bool { return start == other.start && end == other.end; }
+
+        constexpr auto operator!=(const Segment2 &other) const -> bool { return !(*this == other); }
+
+        Vector2<T> start;
+        Vector2<T> end;
+    };
+
+    /**
+     * @brief A circle given by its center and radius, boundary included
+     *
+     * @tparam T The type of the vector components, must be floating-point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Circle
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector2<T>;
+
+        constexpr Circle() = default;
+
+        constexpr Circle(const Vector2<T> &circleCenter, T circleRadius) : center{circleCenter}, radius{circleRadius} {}
+
+        [[nodiscard]] constexpr auto contains(const Vector2<T> &point) const -> bool
+        {
+            return (point - center).lengthSquared() <= radius * radius;
+        }
+
+        [[nodiscard]] constexpr auto overlaps(const Circle &other) const -> bool
+        {
+            const T reach = radius + other.radius;
+            return (other.center - center).lengthSquared() <= reach * reach;
+        }
+
+        [[nodiscard]] constexpr auto overlaps(const Segment2<T> &segment) const -> bool
+        {
+            return segment.distanceSquared(center) <= radius * radius;
+        }
+
+        [[nodiscard]] constexpr auto bounds() const -> AABB2<T>
+        {
+            return {center - Vector2<T>{radius, radius}, center + Vector2<T>{radius, radius}};
+        }
+
+        constexpr auto operator==(const Circle &other) const -> bool { return center == other.center && radius == other.radius; }
+
+        constexpr auto operator!=(const Circle &other) const -> bool { return !(*this == other); }
+
+        Vector2<T> center;
+        T radius = T(0);
+    };
+
+    /**
+     * @brief A 2D ray origin + t * direction for t >= 0
+     *
+     * Intersections report t, so distances are in units of the direction's length and FromPoints rays reach their
+     * target at t = 1. A miss is reported as infinity.
+     *
+     * @tparam T The type of the vector components, must be floating-point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Ray2
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector2<T>;
+
+        constexpr Ray2() = default;
+
+        constexpr Ray2(const Vector2<T> &rayOrigin, const Vector2<T> &rayDirection) : origin{rayOrigin}, direction{rayDirection} {}
+
+        /**
+         * @brief The ray from one point through another, which is reached at t = 1, e.g. for line-of-sight checks
+         */
+        static constexpr auto FromPoints(const Vector2<T> &from, const Vector2<T> &to) -> Ray2 { return {from, to - from}; }
+
+        [[nodiscard]] constexpr auto pointAt(T t) const -> Vector2<T> { return origin + direction * t; }
+
+        /**
+         * @brief The t at which the ray crosses segment, infinity when it misses or runs parallel to it
+         */
+        [[nodiscard]] auto intersect(const Segment2<T> &segment) const -> T
+        {
+            return detail::raySegmentFraction(origin.x, origin.y, direction.x, direction.y, segment.start.x,
+                                              segment.start.y, segment.end.x, segment.end.y);
+        }
+
+        /**
+         * @brief The t at which the ray enters circle, 0 when it starts inside, infinity when it misses
+         */
+        [[nodiscard]] auto intersect(const Circle<T> &circle) const -> T
+        {
+            return detail::rayCircleFraction(origin.x, origin.y, direction.x, direction.y, circle.center.x,
+                                             circle.center.y, circle.radius);
+        }
+
+        constexpr auto operator==(const Ray2 &other) const -> bool { return origin == other.origin && direction == other.direction; }
+
+        constexpr auto operator!=(const Ray2 &other) const -> bool { return !(*this == other); }
+
+        Vector2<T> origin;
+        Vector2<T> direction;
+    };
+
+    /**
+     * @brief The plane of points p with normal.dot(p) == distance
+     *
+     * The factories produce a unit normal, so signedDistance is the Euclidean distance, positive on the side the
+     * normal points to.
+     *
+     * @tparam T The type of the vector components, must be floating-point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Plane
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector3<T>;
+
+        constexpr Plane() = default;
+
+        constexpr Plane(const Vector3<T> &planeNormal, T planeDistance) : normal{planeNormal}, distance{planeDistance} {}
+
+        /**
+         * @brief The plane through point with the given normal, which is normalized
+         */
+        static auto FromPointNormal(const Vector3<T> &point, const Vector3<T> &planeNormal) -> Plane
+        {
+            const Vector3<T> unit = planeNormal.normalized();
+            return {unit, unit.dot(point)};
+        }
+
+        /**
+         * @brief The plane through three points, the normal follows (b - a) x (c - a)
+         */
+        static auto FromPoints(const Vector3<T> &a, const Vector3<T> &b, const Vector3<T> &c) -> Plane
+        {
+            return FromPointNormal(a, (b - a).cross(c - a));
+        }
+
+        [[nodiscard]] constexpr auto signedDistance(const Vector3<T> &point) const -> T { return normal.dot(point) - distance; }
+
+        ///< The closest point of the plane, exact for unit normals
+        [[nodiscard]] constexpr auto project(const Vector3<T> &point) const -> Vector3<T>
+        {
+            return point - normal * signedDistance(point);
+        }
+
+        constexpr auto operator==(const Plane &other) const -> bool { return normal == other.normal && distance == other.distance; }
+
+        constexpr auto operator!=(const Plane &other) const -> bool { return !(*this == other); }
+
+        Vector3<T> normal;
+        T distance = T(0);
+    };
+
+    /**
+     * @brief A 3D ray origin + t * direction for t >= 0, intersections report t like Ray2
+     *
+     * @tparam T The type of the vector components, must be floating-point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Ray3
+    {
+    public:
+        using value_type = T;
+        using vector_type = Vector3<T>;
+
+        constexpr Ray3() = default;
+
+        constexpr Ray3(const Vector3<T> &rayOrigin, const Vector3<T> &rayDirection) : origin{rayOrigin}, direction{rayDirection} {}
+
+        static constexpr auto FromPoints(const Vector3<T> &from, const Vector3<T> &to) -> Ray3 { return {from, to - from}; }
+
+        [[nodiscard]] constexpr auto pointAt(T t) const -> Vector3<T> { return origin + direction * t; }
+
+        /**
+         * @brief The t at which the ray meets plane, infinity when it runs parallel to it or points away
+         */
+        [[nodiscard]] auto intersect(const Plane<T> &plane) const -> T
+        {
+            const T denominator = plane.normal.dot(direction);
+            const T t = (plane.distance - plane.normal.dot(origin)) / denominator;
+            return denominator != T(0) && t >= T(0) ? t : std::numeric_limits<T>::infinity();
+        }
+
+        /**
+         * @brief The t at which the ray enters box, 0 when it starts inside, infinity when it misses
+         */
+        [[nodiscard]] auto intersect(const AABB3<T> &box) const -> T
+        {
+            T enter = T(0);
+            T exit = std::numeric_limits<T>::infinity();
+            const T origins[3] = {origin.x, origin.y, origin.z};
+            const T directions[3] = {direction.x, direction.y, direction.z};
+            const T lows[3] = {box.min.x, box.min.y, box.min.z};
+            const T highs[3] = {box.max.x, box.max.y, box.max.z};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (directions[axis] == T(0))
+                {
+                    if (origins[axis] < lows[axis] || origins[axis] > highs[axis])
+                    {
+                        return std::numeric_limits<T>::infinity();
+                    }
+                    continue;
+                }
+                const T inverse = T(1) / directions[axis];
+                T nearT = (lows[axis] - origins[axis]) * inverse;
+                T farT = (highs[axis] - origins[axis]) * inverse;
+                if (nearT > farT)
+                {
+                    const T swapped = nearT;
+                    nearT = farT;
+                    farT = swapped;
+                }
+                enter = nearT > enter ? nearT : enter;
+                exit = farT < exit ? farT : exit;
+                if (enter > exit)
+                {
+                    return std::numeric_limits<T>::infinity();
+                }
+            }
+            return enter;
+        }
+
+        constexpr auto operator==(const Ray3 &other) const -> bool { return origin == other.origin && direction == other.direction; }
+
+        constexpr auto operator!=(const Ray3 &other) const -> bool { return !(*this == other); }
+
+        Vector3<T> origin;
+        Vector3<T> direction;
+    };
+
+    using Segment2f = Segment2<float>;
+    using Circlef = Circle<float>;
+    using Ray2f = Ray2<float>;
+    using Planef = Plane<float>;
+    using Ray3f = Ray3<float>;
+
+    static_assert(sizeof(Segment2f) == 4 * sizeof(float), "Segment2f must load as one SIMD register");
+    static_assert(sizeof(Ray2f) == 4 * sizeof(float), "Ray2f must load as one SIMD register");
+    static_assert(std::is_trivially_copyable<Segment2f>::value, "Segment2f must be trivially copyable");
+
+    namespace batch
+    {
+        ///< The index closestHits reports for rays that hit nothing
+        constexpr std::uint32_t noHit = 0xFFFFFFFFU;
+
+        namespace detail
+        {
+            ///< The smallest chunk of rays handed to one thread by closestHits
+            constexpr std::size_t rayGrain = 64;
+
+            namespace scalar
+            {
+                inline void intersect(const Ray2f &ray, const Segment2f *segments, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 distances[i] = ray.intersect(segments[i]);
+                                 return distances[i] < std::numeric_limits<float>::infinity();
+                             });
+                }
+
+                inline void intersect(const Ray2f *rays, const Circlef &circle, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    fillMask(mask, count,
+                             [&](std::size_t i)
+                             {
+                                 distances[i] = rays[i].intersect(circle);
+                                 return distances[i] < std::numeric_limits<float>::infinity();
+                             });
+                }
+
+                ///< Continues the search of a SIMD kernel from first on, keeping the first of equal distances
+                inline void closestHit(const Ray2f &ray, const Segment2f *segments, std::size_t first, std::size_t count,
+                                       float &distance, std::uint32_t &index)
+                {
+                    for (std::size_t i = first; i < count; ++i)
+                    {
+                        const float t = ray.intersect(segments[i]);
+                        if (t < distance)
+                        {
+                            distance = t;
+                            index = static_cast<std::uint32_t>(i);
+                        }
+                    }
+                }
+
+                inline void closestHits(const Ray2f *rays, const Segment2f *segments, std::size_t segmentCount,
+                                        float *distances, std::uint32_t *indices, std::size_t count)
+                {
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        distances[r] = std::numeric_limits<float>::infinity();
+                        indices[r] = noHit;
+                        closestHit(rays[r], segments, 0, segmentCount, distances[r], indices[r]);
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                ///< Four records of four floats transposed into one register per field
+                inline void load4x4(const float *data, __m128 &a, __m128 &b, __m128 &c, __m128 &d)
+                {
+                    a = _mm_loadu_ps(data);
+                    b = _mm_loadu_ps(data + 4);
+                    c = _mm_loadu_ps(data + 8);
+                    d = _mm_loadu_ps(data + 12);
+                    _MM_TRANSPOSE4_PS(a, b, c, d);
+                }
+
+                ///< raySegmentFraction on four lanes
+                inline auto raySegment4(__m128 ox, __m128 oy, __m128 dx, __m128 dy, __m128 ax, __m128 ay, __m128 bx,
+                                        __m128 by) -> __m128
+                {
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 ex = _mm_sub_ps(bx, ax);
+                    const __m128 ey = _mm_sub_ps(by, ay);
+                    const __m128 fx = _mm_sub_ps(ax, ox);
+                    const __m128 fy = _mm_sub_ps(ay, oy);
+                    const __m128 denominator = _mm_sub_ps(_mm_mul_ps(dx, ey), _mm_mul_ps(dy, ex));
+                    const __m128 t = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(fx, ey), _mm_mul_ps(fy, ex)), denominator);
+                    const __m128 s = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(fx, dy), _mm_mul_ps(fy, dx)), denominator);
+                    const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmpneq_ps(denominator, zero), _mm_cmpge_ps(t, zero)),
+                                                  _mm_and_ps(_mm_cmpge_ps(s, zero), _mm_cmple_ps(s, _mm_set1_ps(1.0F))));
+                    return select(hit, t, _mm_set1_ps(std::numeric_limits<float>::infinity()));
+                }
+
+                ///< rayCircleFraction on four lanes
+                inline auto rayCircle4(__m128 ox, __m128 oy, __m128 dx, __m128 dy, __m128 cx, __m128 cy, __m128 radius)
+                    -> __m128
+                {
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 mx = _mm_sub_ps(ox, cx);
+                    const __m128 my = _mm_sub_ps(oy, cy);
+                    const __m128 a = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                    const __m128 b = _mm_add_ps(_mm_mul_ps(mx, dx), _mm_mul_ps(my, dy));
+                    const __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(mx, mx), _mm_mul_ps(my, my)), _mm_mul_ps(radius, radius));
+                    const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(a, c));
+                    const __m128 root = _mm_sqrt_ps(discriminant);
+                    const __m128 negB = _mm_xor_ps(b, _mm_set1_ps(-0.0F));
+                    const __m128 nearT = _mm_div_ps(_mm_sub_ps(negB, root), a);
+                    const __m128 farT = _mm_div_ps(_mm_add_ps(negB, root), a);
+                    const __m128 crossing = _mm_and_ps(_mm_cmpge_ps(discriminant, zero), _mm_cmpge_ps(farT, zero));
+                    const __m128 still = _mm_cmpeq_ps(a, zero);
+                    const __m128 hit = select(still, _mm_cmple_ps(c, zero), crossing);
+                    ///< maxps returns the second operand unless nearT > 0, as nearT > 0 ? nearT : 0 does
+                    const __m128 entry = _mm_andnot_ps(still, _mm_max_ps(nearT, zero));
+                    return select(hit, entry, _mm_set1_ps(std::numeric_limits<float>::infinity()));
+                }
+
+                inline void intersect(const Ray2f &ray, const Segment2f *segments, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    const __m128 ox = _mm_set1_ps(ray.origin.x);
+                    const __m128 oy = _mm_set1_ps(ray.origin.y);
+                    const __m128 dx = _mm_set1_ps(ray.direction.x);
+                    const __m128 dy = _mm_set1_ps(ray.direction.y);
+                    const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    for (std::size_t base = 0; base < count; base += 64)
+                    {
+                        const std::size_t end = count - base < 64 ? count - base : 64;
+                        std::uint64_t word = 0;
+                        std::size_t bit = 0;
+                        for (; bit + 4 <= end; bit += 4)
+                        {
+                            __m128 ax, ay, bx, by;
+                            load4x4(data + 4 * (base + bit), ax, ay, bx, by);
+                            const __m128 t = raySegment4(ox, oy, dx, dy, ax, ay, bx, by);
+                            _mm_storeu_ps(distances + base + bit, t);
+                            word |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(t, inf))) << bit;
+                        }
+                        for (; bit < end; ++bit)
+                        {
+                            const float t = ray.intersect(segments[base + bit]);
+                            distances[base + bit] = t;
+                            word |= static_cast<std::uint64_t>(t < std::numeric_limits<float>::infinity()) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                }
+
+                inline void intersect(const Ray2f *rays, const Circlef &circle, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    const __m128 cx = _mm_set1_ps(circle.center.x);
+                    const __m128 cy = _mm_set1_ps(circle.center.y);
+                    const __m128 radius = _mm_set1_ps(circle.radius);
+                    const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+                    const auto *data = reinterpret_cast<const float *>(rays);
+                    for (std::size_t base = 0; base < count; base += 64)
+                    {
+                        const std::size_t end = count - base < 64 ? count - base : 64;
+                        std::uint64_t word = 0;
+                        std::size_t bit = 0;
+                        for (; bit + 4 <= end; bit += 4)
+                        {
+                            __m128 ox, oy, dx, dy;
+                            load4x4(data + 4 * (base + bit), ox, oy, dx, dy);
+                            const __m128 t = rayCircle4(ox, oy, dx, dy, cx, cy, radius);
+                            _mm_storeu_ps(distances + base + bit, t);
+                            word |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(t, inf))) << bit;
+                        }
+                        for (; bit < end; ++bit)
+                        {
+                            const float t = rays[base + bit].intersect(circle);
+                            distances[base + bit] = t;
+                            word |= static_cast<std::uint64_t>(t < std::numeric_limits<float>::infinity()) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                }
+
+                /**
+                 * @brief The nearest of four lanes of distances and indices, the lower index on equal distances
+                 *
+                 * Each lane saw its segments in order and kept the first of equal distances, so this yields the same
+                 * segment as a sequential search.
+                 */
+                inline void reduceClosest(const float (&lanes)[4], const std::uint32_t (&lanesIndex)[4], float &distance,
+                                          std::uint32_t &index)
+                {
+                    distance = lanes[0];
+                    index = lanesIndex[0];
+                    for (int k = 1; k < 4; ++k)
+                    {
+                        if (lanes[k] < distance || (lanes[k] == distance && lanesIndex[k] < index))
+                        {
+                            distance = lanes[k];
+                            index = lanesIndex[k];
+                        }
+                    }
+                }
+
+                inline void closestHits(const Ray2f *rays, const Segment2f *segments, std::size_t segmentCount,
+                                        float *distances, std::uint32_t *indices, std::size_t count)
+                {
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    const std::size_t full = segmentCount & ~std::size_t{3};
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        const __m128 ox = _mm_set1_ps(rays[r].origin.x);
+                        const __m128 oy = _mm_set1_ps(rays[r].origin.y);
+                        const __m128 dx = _mm_set1_ps(rays[r].direction.x);
+                        const __m128 dy = _mm_set1_ps(rays[r].direction.y);
+                        __m128 best = _mm_set1_ps(std::numeric_limits<float>::infinity());
+                        __m128i bestIndex = _mm_set1_epi32(-1);
+                        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+                        for (std::size_t i = 0; i < full; i += 4)
+                        {
+                            __m128 ax, ay, bx, by;
+                            load4x4(data + 4 * i, ax, ay, bx, by);
+                            const __m128 t = raySegment4(ox, oy, dx, dy, ax, ay, bx, by);
+                            const __m128 closer = _mm_cmplt_ps(t, best);
+                            best = select(closer, t, best);
+                            bestIndex = select(_mm_castps_si128(closer), index, bestIndex);
+                            index = _mm_add_epi32(index, _mm_set1_epi32(4));
+                        }
+                        float lanes[4];
+                        std::uint32_t lanesIndex[4];
+                        _mm_storeu_ps(lanes, best);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanesIndex), bestIndex);
+                        reduceClosest(lanes, lanesIndex, distances[r], indices[r]);
+                        scalar::closestHit(rays[r], segments, full, segmentCount, distances[r], indices[r]);
+                    }
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                /**
+                 * @brief Eight records of four floats transposed into one register per field, records 0 to 3 in the
+                 * low half and 4 to 7 in the high half so that lanes stay in order
+                 */
+                FZOLV_TARGET_AVX2 inline void load8x4(const float *data, __m256 &a, __m256 &b, __m256 &c, __m256 &d)
+                {
+                    const __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data)), _mm_loadu_ps(data + 16), 1);
+                    const __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 4)), _mm_loadu_ps(data + 20), 1);
+                    const __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 8)), _mm_loadu_ps(data + 24), 1);
+                    const __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(data + 12)), _mm_loadu_ps(data + 28), 1);
+                    const __m256 low01 = _mm256_unpacklo_ps(r0, r1);
+                    const __m256 low23 = _mm256_unpacklo_ps(r2, r3);
+                    const __m256 high01 = _mm256_unpackhi_ps(r0, r1);
+                    const __m256 high23 = _mm256_unpackhi_ps(r2, r3);
+                    a = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0));
+                    b = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2));
+                    c = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0));
+                    d = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2));
+                }
+
+                FZOLV_TARGET_AVX2 inline auto raySegment8(__m256 ox, __m256 oy, __m256 dx, __m256 dy, __m256 ax, __m256 ay,
+                                                          __m256 bx, __m256 by) -> __m256
+                {
+                    const __m256 zero = _mm256_setzero_ps();
+                    const __m256 ex = _mm256_sub_ps(bx, ax);
+                    const __m256 ey = _mm256_sub_ps(by, ay);
+                    const __m256 fx = _mm256_sub_ps(ax, ox);
+                    const __m256 fy = _mm256_sub_ps(ay, oy);
+                    const __m256 denominator = _mm256_sub_ps(_mm256_mul_ps(dx, ey), _mm256_mul_ps(dy, ex));
+                    const __m256 t = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(fx, ey), _mm256_mul_ps(fy, ex)), denominator);
+                    const __m256 s = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(fx, dy), _mm256_mul_ps(fy, dx)), denominator);
+                    const __m256 hit = _mm256_and_ps(
+                        _mm256_and_ps(_mm256_cmp_ps(denominator, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(t, zero, _CMP_GE_OQ)),
+                        _mm256_and_ps(_mm256_cmp_ps(s, zero, _CMP_GE_OQ), _mm256_cmp_ps(s, _mm256_set1_ps(1.0F), _CMP_LE_OQ)));
+                    return _mm256_blendv_ps(_mm256_set1_ps(std::numeric_limits<float>::infinity()), t, hit);
+                }
+
+                FZOLV_TARGET_AVX2 inline auto rayCircle8(__m256 ox, __m256 oy, __m256 dx, __m256 dy, __m256 cx, __m256 cy,
+                                                         __m256 radius) -> __m256
+                {
+                    const __m256 zero = _mm256_setzero_ps();
+                    const __m256 mx = _mm256_sub_ps(ox, cx);
+                    const __m256 my = _mm256_sub_ps(oy, cy);
+                    const __m256 a = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+                    const __m256 b = _mm256_add_ps(_mm256_mul_ps(mx, dx), _mm256_mul_ps(my, dy));
+                    const __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(mx, mx), _mm256_mul_ps(my, my)),
+                                                   _mm256_mul_ps(radius, radius));
+                    const __m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(a, c));
+                    const __m256 root = _mm256_sqrt_ps(discriminant);
+                    const __m256 negB = _mm256_xor_ps(b, _mm256_set1_ps(-0.0F));
+                    const __m256 nearT = _mm256_div_ps(_mm256_sub_ps(negB, root), a);
+                    const __m256 farT = _mm256_div_ps(_mm256_add_ps(negB, root), a);
+                    const __m256 crossing =
+                        _mm256_and_ps(_mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ), _mm256_cmp_ps(farT, zero, _CMP_GE_OQ));
+                    const __m256 still = _mm256_cmp_ps(a, zero, _CMP_EQ_OQ);
+                    const __m256 hit = _mm256_blendv_ps(crossing, _mm256_cmp_ps(c, zero, _CMP_LE_OQ), still);
+                    const __m256 entry = _mm256_andnot_ps(still, _mm256_max_ps(nearT, zero));
+                    return _mm256_blendv_ps(_mm256_set1_ps(std::numeric_limits<float>::infinity()), entry, hit);
+                }
+
+                FZOLV_TARGET_AVX2 inline void intersect(const Ray2f &ray, const Segment2f *segments, std::uint64_t *mask,
+                                                        float *distances, std::size_t count)
+                {
+                    const __m256 ox = _mm256_set1_ps(ray.origin.x);
+                    const __m256 oy = _mm256_set1_ps(ray.origin.y);
+                    const __m256 dx = _mm256_set1_ps(ray.direction.x);
+                    const __m256 dy = _mm256_set1_ps(ray.direction.y);
+                    const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    const std::size_t full = count & ~std::size_t{63};
+                    for (std::size_t base = 0; base < full; base += 64)
+                    {
+                        std::uint64_t word = 0;
+                        for (std::size_t bit = 0; bit < 64; bit += 8)
+                        {
+                            __m256 ax, ay, bx, by;
+                            load8x4(data + 4 * (base + bit), ax, ay, bx, by);
+                            const __m256 t = raySegment8(ox, oy, dx, dy, ax, ay, bx, by);
+                            _mm256_storeu_ps(distances + base + bit, t);
+                            word |= static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(t, inf, _CMP_LT_OQ))) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                    if (full < count)
+                    {
+                        sse2::intersect(ray, segments + full, mask + full / 64, distances + full, count - full);
+                    }
+                }
+
+                FZOLV_TARGET_AVX2 inline void intersect(const Ray2f *rays, const Circlef &circle, std::uint64_t *mask,
+                                                        float *distances, std::size_t count)
+                {
+                    const __m256 cx = _mm256_set1_ps(circle.center.x);
+                    const __m256 cy = _mm256_set1_ps(circle.center.y);
+                    const __m256 radius = _mm256_set1_ps(circle.radius);
+                    const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+                    const auto *data = reinterpret_cast<const float *>(rays);
+                    const std::size_t full = count & ~std::size_t{63};
+                    for (std::size_t base = 0; base < full; base += 64)
+                    {
+                        std::uint64_t word = 0;
+                        for (std::size_t bit = 0; bit < 64; bit += 8)
+                        {
+                            __m256 ox, oy, dx, dy;
+                            load8x4(data + 4 * (base + bit), ox, oy, dx, dy);
+                            const __m256 t = rayCircle8(ox, oy, dx, dy, cx, cy, radius);
+                            _mm256_storeu_ps(distances + base + bit, t);
+                            word |= static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(t, inf, _CMP_LT_OQ))) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                    if (full < count)
+                    {
+                        sse2::intersect(rays + full, circle, mask + full / 64, distances + full, count - full);
+                    }
+                }
+
+                FZOLV_TARGET_AVX2 inline void closestHits(const Ray2f *rays, const Segment2f *segments,
+                                                          std::size_t segmentCount, float *distances,
+                                                          std::uint32_t *indices, std::size_t count)
+                {
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    const std::size_t full = segmentCount & ~std::size_t{7};
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        const __m256 ox = _mm256_set1_ps(rays[r].origin.x);
+                        const __m256 oy = _mm256_set1_ps(rays[r].origin.y);
+                        const __m256 dx = _mm256_set1_ps(rays[r].direction.x);
+                        const __m256 dy = _mm256_set1_ps(rays[r].direction.y);
+                        __m256 best = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+                        __m256i bestIndex = _mm256_set1_epi32(-1);
+                        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                        for (std::size_t i = 0; i < full; i += 8)
+                        {
+                            __m256 ax, ay, bx, by;
+                            load8x4(data + 4 * i, ax, ay, bx, by);
+                            const __m256 t = raySegment8(ox, oy, dx, dy, ax, ay, bx, by);
+                            const __m256 closer = _mm256_cmp_ps(t, best, _CMP_LT_OQ);
+                            best = _mm256_blendv_ps(best, t, closer);
+                            bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(closer));
+                            index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+                        }
+                        float lanes[8];
+                        std::uint32_t lanesIndex[8];
+                        _mm256_storeu_ps(lanes, best);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanesIndex), bestIndex);
+                        float distance = lanes[0];
+                        std::uint32_t hit = lanesIndex[0];
+                        for (int k = 1; k < 8; ++k)
+                        {
+                            if (lanes[k] < distance || (lanes[k] == distance && lanesIndex[k] < hit))
+                            {
+                                distance = lanes[k];
+                                hit = lanesIndex[k];
+                            }
+                        }
+                        distances[r] = distance;
+                        indices[r] = hit;
+                        scalar::closestHit(rays[r], segments, full, segmentCount, distances[r], indices[r]);
+                    }
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                inline auto raySegment4(float32x4_t ox, float32x4_t oy, float32x4_t dx, float32x4_t dy, float32x4_t ax,
+                                        float32x4_t ay, float32x4_t bx, float32x4_t by) -> float32x4_t
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    const float32x4_t ex = vsubq_f32(bx, ax);
+                    const float32x4_t ey = vsubq_f32(by, ay);
+                    const float32x4_t fx = vsubq_f32(ax, ox);
+                    const float32x4_t fy = vsubq_f32(ay, oy);
+                    const float32x4_t denominator = vsubq_f32(vmulq_f32(dx, ey), vmulq_f32(dy, ex));
+                    const float32x4_t t = vdivq_f32(vsubq_f32(vmulq_f32(fx, ey), vmulq_f32(fy, ex)), denominator);
+                    const float32x4_t s = vdivq_f32(vsubq_f32(vmulq_f32(fx, dy), vmulq_f32(fy, dx)), denominator);
+                    const uint32x4_t hit = vandq_u32(vandq_u32(vmvnq_u32(vceqq_f32(denominator, zero)), vcgeq_f32(t, zero)),
+                                                     vandq_u32(vcgeq_f32(s, zero), vcleq_f32(s, vdupq_n_f32(1.0F))));
+                    return vbslq_f32(hit, t, vdupq_n_f32(std::numeric_limits<float>::infinity()));
+                }
+
+                inline auto rayCircle4(float32x4_t ox, float32x4_t oy, float32x4_t dx, float32x4_t dy, float32x4_t cx,
+                                       float32x4_t cy, float32x4_t radius) -> float32x4_t
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    const float32x4_t mx = vsubq_f32(ox, cx);
+                    const float32x4_t my = vsubq_f32(oy, cy);
+                    const float32x4_t a = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+                    const float32x4_t b = vaddq_f32(vmulq_f32(mx, dx), vmulq_f32(my, dy));
+                    const float32x4_t c = vsubq_f32(vaddq_f32(vmulq_f32(mx, mx), vmulq_f32(my, my)), vmulq_f32(radius, radius));
+                    const float32x4_t discriminant = vsubq_f32(vmulq_f32(b, b), vmulq_f32(a, c));
+                    const float32x4_t root = vsqrtq_f32(discriminant);
+                    const float32x4_t negB = vnegq_f32(b);
+                    const float32x4_t nearT = vdivq_f32(vsubq_f32(negB, root), a);
+                    const float32x4_t farT = vdivq_f32(vaddq_f32(negB, root), a);
+                    const uint32x4_t crossing = vandq_u32(vcgeq_f32(discriminant, zero), vcgeq_f32(farT, zero));
+                    const uint32x4_t still = vceqq_f32(a, zero);
+                    const uint32x4_t hit = vbslq_u32(still, vcleq_f32(c, zero), crossing);
+                    const float32x4_t entered = vbslq_f32(vbicq_u32(vcgtq_f32(nearT, zero), still), nearT, zero);
+                    return vbslq_f32(hit, entered, vdupq_n_f32(std::numeric_limits<float>::infinity()));
+                }
+
+                inline auto hitBits(float32x4_t t) -> std::uint64_t
+                {
+                    const uint32x4_t hit = vcltq_f32(t, vdupq_n_f32(std::numeric_limits<float>::infinity()));
+                    const uint32x4_t weights = {1U, 2U, 4U, 8U};
+                    return vaddvq_u32(vandq_u32(hit, weights));
+                }
+
+                inline void intersect(const Ray2f &ray, const Segment2f *segments, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    const float32x4_t ox = vdupq_n_f32(ray.origin.x);
+                    const float32x4_t oy = vdupq_n_f32(ray.origin.y);
+                    const float32x4_t dx = vdupq_n_f32(ray.direction.x);
+                    const float32x4_t dy = vdupq_n_f32(ray.direction.y);
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    for (std::size_t base = 0; base < count; base += 64)
+                    {
+                        const std::size_t end = count - base < 64 ? count - base : 64;
+                        std::uint64_t word = 0;
+                        std::size_t bit = 0;
+                        for (; bit + 4 <= end; bit += 4)
+                        {
+                            const float32x4x4_t s = vld4q_f32(data + 4 * (base + bit));
+                            const float32x4_t t = raySegment4(ox, oy, dx, dy, s.val[0], s.val[1], s.val[2], s.val[3]);
+                            vst1q_f32(distances + base + bit, t);
+                            word |= hitBits(t) << bit;
+                        }
+                        for (; bit < end; ++bit)
+                        {
+                            const float t = ray.intersect(segments[base + bit]);
+                            distances[base + bit] = t;
+                            word |= static_cast<std::uint64_t>(t < std::numeric_limits<float>::infinity()) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                }
+
+                inline void intersect(const Ray2f *rays, const Circlef &circle, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    const float32x4_t cx = vdupq_n_f32(circle.center.x);
+                    const float32x4_t cy = vdupq_n_f32(circle.center.y);
+                    const float32x4_t radius = vdupq_n_f32(circle.radius);
+                    const auto *data = reinterpret_cast<const float *>(rays);
+                    for (std::size_t base = 0; base < count; base += 64)
+                    {
+                        const std::size_t end = count - base < 64 ? count - base : 64;
+                        std::uint64_t word = 0;
+                        std::size_t bit = 0;
+                        for (; bit + 4 <= end; bit += 4)
+                        {
+                            const float32x4x4_t r = vld4q_f32(data + 4 * (base + bit));
+                            const float32x4_t t = rayCircle4(r.val[0], r.val[1], r.val[2], r.val[3], cx, cy, radius);
+                            vst1q_f32(distances + base + bit, t);
+                            word |= hitBits(t) << bit;
+                        }
+                        for (; bit < end; ++bit)
+                        {
+                            const float t = rays[base + bit].intersect(circle);
+                            distances[base + bit] = t;
+                            word |= static_cast<std::uint64_t>(t < std::numeric_limits<float>::infinity()) << bit;
+                        }
+                        mask[base / 64] = word;
+                    }
+                }
+
+                inline void closestHits(const Ray2f *rays, const Segment2f *segments, std::size_t segmentCount,
+                                        float *distances, std::uint32_t *indices, std::size_t count)
+                {
+                    const auto *data = reinterpret_cast<const float *>(segments);
+                    const std::size_t full = segmentCount & ~std::size_t{3};
+                    const uint32x4_t first = {0U, 1U, 2U, 3U};
+                    for (std::size_t r = 0; r < count; ++r)
+                    {
+                        const float32x4_t ox = vdupq_n_f32(rays[r].origin.x);
+                        const float32x4_t oy = vdupq_n_f32(rays[r].origin.y);
+                        const float32x4_t dx = vdupq_n_f32(rays[r].direction.x);
+                        const float32x4_t dy = vdupq_n_f32(rays[r].direction.y);
+                        float32x4_t best = vdupq_n_f32(std::numeric_limits<float>::infinity());
+                        uint32x4_t bestIndex = vdupq_n_u32(noHit);
+                        uint32x4_t index = first;
+                        for (std::size_t i = 0; i < full; i += 4)
+                        {
+                            const float32x4x4_t s = vld4q_f32(data + 4 * i);
+                            const float32x4_t t = raySegment4(ox, oy, dx, dy, s.val[0], s.val[1], s.val[2], s.val[3]);
+                            const uint32x4_t closer = vcltq_f32(t, best);
+                            best = vbslq_f32(closer, t, best);
+                            bestIndex = vbslq_u32(closer, index, bestIndex);
+                            index = vaddq_u32(index, vdupq_n_u32(4U));
+                        }
+                        float lanes[4];
+                        std::uint32_t lanesIndex[4];
+                        vst1q_f32(lanes, best);
+                        vst1q_u32(lanesIndex, bestIndex);
+                        distances[r] = lanes[0];
+                        indices[r] = lanesIndex[0];
+                        for (int k = 1; k < 4; ++k)
+                        {
+                            if (lanes[k] < distances[r] || (lanes[k] == distances[r] && lanesIndex[k] < indices[r]))
+                            {
+                                distances[r] = lanes[k];
+                                indices[r] = lanesIndex[k];
+                            }
+                        }
+                        scalar::closestHit(rays[r], segments, full, segmentCount, distances[r], indices[r]);
+                    }
+                }
+            }
+#endif
+
+            namespace best
+            {
+                inline void intersect(const Ray2f &ray, const Segment2f *segments, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    FZOLV_DISPATCH(intersect, (ray, segments, mask, distances, count))
+                }
+
+                inline void intersect(const Ray2f *rays, const Circlef &circle, std::uint64_t *mask, float *distances,
+                                      std::size_t count)
+                {
+                    FZOLV_DISPATCH(intersect, (rays, circle, mask, distances, count))
+                }
+
+                inline void closestHits(const Ray2f *rays, const Segment2f *segments, std::size_t segmentCount,
+                                        float *distances, std::uint32_t *indices, std::size_t count)
+                {
+                    FZOLV_DISPATCH(closestHits, (rays, segments, segmentCount, distances, indices, count))
+                }
+            }
+        }
+
+        /**
+         * @brief Cast one ray against every segment, distances[i] = ray.intersect(segments[i])
+         *
+         * Bit i % 64 of mask[i / 64] is set when the ray hits segments[i], like batch::overlaps. Misses have an
+         * infinite distance. Every level produces the same results as Ray2::intersect, as long as multiply-adds are not
+         * fused, see simd.hpp.
+         *
+         * @param ray The ray to cast
+         * @param segments The segments to test
+         * @param mask The hit bits, must hold exactly maskWords(segments.size()) words
+         * @param distances The ray parameter of every hit, must have the same size as segments
+         */
+        inline void intersect(const Ray2f &ray, span<const Segment2f> segments, span<std::uint64_t> mask,
+                              span<float> distances)
+        {
+            assert(mask.size() == maskWords(segments.size()) && distances.size() == segments.size());
+            parallelFor(segments.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            detail::best::intersect(ray, segments.data() + begin, mask.data() + begin / 64,
+                                                    distances.data() + begin, end - begin);
+                        });
+        }
+
+        /**
+         * @brief Cast every ray against one circle, distances[i] = rays[i].intersect(circle), with hit bits like above
+         */
+        inline void intersect(span<const Ray2f> rays, const Circlef &circle, span<std::uint64_t> mask, span<float> distances)
+        {
+            assert(mask.size() == maskWords(rays.size()) && distances.size() == rays.size());
+            parallelFor(rays.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            detail::best::intersect(rays.data() + begin, circle, mask.data() + begin / 64,
+                                                    distances.data() + begin, end - begin);
+                        });
+        }
+
+        /**
+         * @brief Find the first segment every ray hits, e.g. the wall that blocks a line of sight
+         *
+         * For rays made with Ray2::FromPoints the target is visible when distances[r] > 1. Equal distances report the
+         * lower segment index. Large batches split the rays across threads.
+         *
+         * @param rays The rays to cast
+         * @param segments The segments every ray is tested against
+         * @param distances The ray parameter of the nearest hit, infinity for none, must have the same size as rays
+         * @param indices The index of the nearest segment, noHit for none, must have the same size as rays
+         */
+        inline void closestHits(span<const Ray2f> rays, span<const Segment2f> segments, span<float> distances,
+                                span<std::uint32_t> indices)
+        {
+            assert(distances.size() == rays.size() && indices.size() == rays.size());
+            assert(segments.size() < noHit && "too many segments for 32-bit indices");
+            parallelForWeighted(rays.size(), segments.size(), detail::rayGrain,
+                                [&](std::size_t begin, std::size_t end)
+                                {
+                                    detail::best::closestHits(rays.data() + begin, segments.data(), segments.size(),
+                                                              distances.data() + begin, indices.data() + begin,
+                                                              end - begin);
+                                });
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_GEOMETRY_3p7385 */
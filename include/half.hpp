@@ -0,0 +1,392 @@
+#ifndef FZOLV_HALF_rjvww6
+#define FZOLV_HALF_rjvww6
+
+#include <batch.hpp>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <parallel.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        /**
+         * @brief Convert a float to the nearest IEEE binary16 value, ties to even
+         *
+         * Values beyond the half range become infinities and NaNs stay NaNs with the top of their payload and the quiet
+         * bit set, exactly like the F16C and NEON conversion instructions.
+         */
+        inline auto floatToHalf(float value) noexcept -> std::uint16_t
+        {
+            constexpr std::uint32_t halfOverflow = (127U + 16U) << 23; ///< Every magnitude from here on rounds to infinity
+            constexpr std::uint32_t halfNormal = (127U - 14U) << 23;   ///< The smallest magnitude giving a normal half
+            constexpr std::uint32_t subnormalMagic = ((127U - 15U) + (23U - 10U) + 1U) << 23;
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const std::uint32_t sign = bits & 0x80000000U;
+            bits ^= sign;
+
+            std::uint32_t half;
+            if (bits >= halfOverflow)
+            {
+                half = bits > 0x7F800000U ? 0x7E00U | ((bits >> 13) & 0x3FFU) : 0x7C00U;
+            }
+            else if (bits < halfNormal)
+            {
+                ///< Adding the magic value lines the ten mantissa bits up at the bottom, rounded by the FPU
+                float magnitude;
+                std::memcpy(&magnitude, &bits, sizeof(magnitude));
+                float magic;
+                std::memcpy(&magic, &subnormalMagic, sizeof(magic));
+                magnitude += magic;
+                std::memcpy(&bits, &magnitude, sizeof(bits));
+                half = bits - subnormalMagic;
+            }
+            else
+            {
+                const std::uint32_t odd = (bits >> 13) & 1U;
+                half = (bits + (0xFFFU - ((127U - 15U) << 23)) + odd) >> 13;
+            }
+            return static_cast<std::uint16_t>(half | (sign >> 16));
+        }
+
+        /**
+         * @brief Convert an IEEE binary16 value to float, which is exact, signaling NaNs become quiet
+         */
+        inline auto halfToFloat(std::uint16_t half) noexcept -> float
+        {
+            constexpr std::uint32_t exponentMask = 0x7C00U << 13;
+            constexpr std::uint32_t renormalize = 113U << 23;
+
+            std::uint32_t bits = (static_cast<std::uint32_t>(half) & 0x7FFFU) << 13;
+            const std::uint32_t exponent = bits & exponentMask;
+            bits += (127U - 15U) << 23;
+            if (exponent == exponentMask)
+            {
+                bits += (128U - 16U) << 23;
+                bits |= (half & 0x3FFU) != 0 ? 0x400000U : 0U;
+            }
+            else if (exponent == 0)
+            {
+                bits += 1U << 23;
+                float value;
+                std::memcpy(&value, &bits, sizeof(value));
+                float magic;
+                std::memcpy(&magic, &renormalize, sizeof(magic));
+                value -= magic;
+                std::memcpy(&bits, &value, sizeof(bits));
+            }
+            bits |= (static_cast<std::uint32_t>(half) & 0x8000U) << 16;
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    /**
+     * @brief An IEEE binary16 value for storage, computations convert it to float
+     *
+     * Half keeps 11 significant bits, about three decimal digits, and covers magnitudes up to 65504. Conversions from
+     * float round to the nearest value, so a round trip is off by at most 2^-11 relative.
+     */
+    class Half
+    {
+    public:
+        Half() noexcept = default;
+
+        explicit Half(float value) noexcept : bits{detail::floatToHalf(value)} {}
+
+        /**
+         * @brief A half with the given bit pattern
+         */
+        [[nodiscard]] static constexpr auto FromBits(std::uint16_t bits) noexcept -> Half
+        {
+            Half half;
+            half.bits = bits;
+            return half;
+        }
+
+        [[nodiscard]] constexpr auto toBits() const noexcept -> std::uint16_t { return bits; }
+
+        operator float() const noexcept { return detail::halfToFloat(bits); } // NOLINT: computes as float
+
+    private:
+        std::uint16_t bits = 0;
+    };
+
+    /**
+     * @brief Storage for a Vector2f at half precision, 4 bytes instead of 8
+     */
+    struct Vector2h
+    {
+        Half x;
+        Half y;
+
+        Vector2h() noexcept = default;
+
+        Vector2h(Half x, Half y) noexcept : x{x}, y{y} {}
+
+        explicit Vector2h(const Vector2f &value) noexcept : x{value.x}, y{value.y} {}
+
+        operator Vector2f() const noexcept { return {x, y}; } // NOLINT: computes as float
+    };
+
+    /**
+     * @brief Storage for a Vector3f at half precision, 6 bytes instead of 12
+     */
+    struct Vector3h
+    {
+        Half x;
+        Half y;
+        Half z;
+
+        Vector3h() noexcept = default;
+
+        Vector3h(Half x, Half y, Half z) noexcept : x{x}, y{y}, z{z} {}
+
+        explicit Vector3h(const Vector3f &value) noexcept : x{value.x}, y{value.y}, z{value.z} {}
+
+        operator Vector3f() const noexcept { return {x, y, z}; } // NOLINT: computes as float
+    };
+
+    static_assert(sizeof(Half) == 2 && sizeof(Vector2h) == 4 && sizeof(Vector3h) == 6, "half types must be packed");
+    static_assert(std::is_trivially_copyable<Vector2h>::value && std::is_trivially_copyable<Vector3h>::value,
+                  "half types must be trivially copyable");
+
+    namespace batch
+    {
+        namespace detail
+        {
+            namespace scalar
+            {
+                inline void toHalf(const float *in, std::uint16_t *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::floatToHalf(in[i]);
+                    }
+                }
+
+                inline void toFloat(const std::uint16_t *in, float *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::halfToFloat(in[i]);
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                ///< floatToHalf on four lanes, the halves end up in the low 16 bits of each lane
+                inline auto toHalf4(__m128 value) -> __m128i
+                {
+                    const __m128i sign = _mm_and_si128(_mm_castps_si128(value), _mm_set1_epi32(static_cast<int>(0x80000000U)));
+                    const __m128i bits = _mm_xor_si128(_mm_castps_si128(value), sign);
+                    const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+                    const __m128i regular = _mm_cmpgt_epi32(_mm_set1_epi32((127 + 16) << 23), bits);
+                    const __m128i nan = _mm_cmpgt_epi32(bits, _mm_set1_epi32(0x7F800000));
+                    const __m128i payload = _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(0x3FF)));
+                    const __m128i special = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(nan, payload));
+
+                    const __m128i subnormal = _mm_cmpgt_epi32(_mm_set1_epi32((127 - 14) << 23), bits);
+                    const __m128 shifted = _mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(subnormalMagic));
+                    const __m128i small = _mm_sub_epi32(_mm_castps_si128(shifted), subnormalMagic);
+
+                    const __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+                    const __m128i bias = _mm_set1_epi32(static_cast<int>(0xFFFU - ((127U - 15U) << 23)));
+                    const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, bias), odd), 13);
+
+                    const __m128i finite = select(subnormal, small, normal);
+                    return _mm_or_si128(select(regular, finite, special), _mm_srli_epi32(sign, 16));
+                }
+
+                ///< halfToFloat on four lanes holding a half in their low 16 bits
+                inline auto toFloat4(__m128i half) -> __m128
+                {
+                    const __m128i exponentMask = _mm_set1_epi32(0x7C00 << 13);
+                    __m128i bits = _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x7FFF)), 13);
+                    const __m128i exponent = _mm_and_si128(bits, exponentMask);
+                    bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+                    const __m128i special = _mm_cmpeq_epi32(exponent, exponentMask);
+                    const __m128i nan = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(half, _mm_set1_epi32(0x3FF)),
+                                                                         _mm_setzero_si128()),
+                                                         special);
+                    bits = _mm_add_epi32(bits, _mm_and_si128(special, _mm_set1_epi32((128 - 16) << 23)));
+                    bits = _mm_or_si128(bits, _mm_and_si128(nan, _mm_set1_epi32(0x400000)));
+
+                    const __m128i subnormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+                    const __m128 renormalized = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))),
+                                                           _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+                    bits = select(subnormal, _mm_castps_si128(renormalized), bits);
+                    return _mm_castsi128_ps(
+                        _mm_or_si128(bits, _mm_slli_epi32(_mm_and_si128(half, _mm_set1_epi32(0x8000)), 16)));
+                }
+
+                inline void toHalf(const float *in, std::uint16_t *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        ///< SSE2 has no unsigned 32 to 16 bit pack, sign-extending first keeps packs from saturating
+                        const __m128i low = _mm_srai_epi32(_mm_slli_epi32(toHalf4(_mm_loadu_ps(in + i)), 16), 16);
+                        const __m128i high = _mm_srai_epi32(_mm_slli_epi32(toHalf4(_mm_loadu_ps(in + i + 4)), 16), 16);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(low, high));
+                    }
+                    scalar::toHalf(in + i, out + i, count - i);
+                }
+
+                inline void toFloat(const std::uint16_t *in, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                        _mm_storeu_ps(out + i, toFloat4(_mm_unpacklo_epi16(halves, _mm_setzero_si128())));
+                        _mm_storeu_ps(out + i + 4, toFloat4(_mm_unpackhi_epi16(halves, _mm_setzero_si128())));
+                    }
+                    scalar::toFloat(in + i, out + i, count - i);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                FZOLV_TARGET_AVX2 inline void toHalf(const float *in, std::uint16_t *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), halves);
+                    }
+                    scalar::toHalf(in + i, out + i, count - i);
+                }
+
+                FZOLV_TARGET_AVX2 inline void toFloat(const std::uint16_t *in, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(halves));
+                    }
+                    scalar::toFloat(in + i, out + i, count - i);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                inline void toHalf(const float *in, std::uint16_t *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const float16x8_t halves = vcvt_high_f16_f32(vcvt_f16_f32(vld1q_f32(in + i)), vld1q_f32(in + i + 4));
+                        vst1q_u16(out + i, vreinterpretq_u16_f16(halves));
+                    }
+                    scalar::toHalf(in + i, out + i, count - i);
+                }
+
+                inline void toFloat(const std::uint16_t *in, float *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        const float16x8_t halves = vreinterpretq_f16_u16(vld1q_u16(in + i));
+                        vst1q_f32(out + i, vcvt_f32_f16(vget_low_f16(halves)));
+                        vst1q_f32(out + i + 4, vcvt_high_f32_f16(halves));
+                    }
+                    scalar::toFloat(in + i, out + i, count - i);
+                }
+            }
+#endif
+
+            namespace best
+            {
+                inline void toHalf(const float *in, std::uint16_t *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(toHalf, (in, out, count))
+                }
+
+                inline void toFloat(const std::uint16_t *in, float *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(toFloat, (in, out, count))
+                }
+            }
+
+            inline void toHalf(const float *in, Half *out, std::size_t count)
+            {
+                auto *halves = reinterpret_cast<std::uint16_t *>(out);
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::toHalf(in + begin, halves + begin, end - begin); });
+            }
+
+            inline void toFloat(const Half *in, float *out, std::size_t count)
+            {
+                const auto *halves = reinterpret_cast<const std::uint16_t *>(in);
+                parallelFor(count, batchGrain, [&](std::size_t begin, std::size_t end)
+                            { best::toFloat(halves + begin, out + begin, end - begin); });
+            }
+        }
+
+        /**
+         * @brief Round every float to half precision, out[i] = Half{in[i]}
+         *
+         * Runs on F16C or NEON conversions where available, every level gives the same bits.
+         */
+        inline void toHalf(span<const float> in, span<Half> out)
+        {
+            assert(in.size() == out.size());
+            detail::toHalf(in.data(), out.data(), in.size());
+        }
+
+        inline void toHalf(span<const Vector2f> in, span<Vector2h> out)
+        {
+            assert(in.size() == out.size());
+            detail::toHalf(reinterpret_cast<const float *>(in.data()), reinterpret_cast<Half *>(out.data()), in.size() * 2);
+        }
+
+        inline void toHalf(span<const Vector3f> in, span<Vector3h> out)
+        {
+            assert(in.size() == out.size());
+            detail::toHalf(reinterpret_cast<const float *>(in.data()), reinterpret_cast<Half *>(out.data()), in.size() * 3);
+        }
+
+        /**
+         * @brief Widen every half to float, out[i] = float(in[i]), which is exact
+         */
+        inline void toFloat(span<const Half> in, span<float> out)
+        {
+            assert(in.size() == out.size());
+            detail::toFloat(in.data(), out.data(), in.size());
+        }
+
+        inline void toFloat(span<const Vector2h> in, span<Vector2f> out)
+        {
+            assert(in.size() == out.size());
+            detail::toFloat(reinterpret_cast<const Half *>(in.data()), reinterpret_cast<float *>(out.data()), in.size() * 2);
+        }
+
+        inline void toFloat(span<const Vector3h> in, span<Vector3f> out)
+        {
+            assert(in.size() == out.size());
+            detail::toFloat(reinterpret_cast<const Half *>(in.data()), reinterpret_cast<float *>(out.data()), in.size() * 3);
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_HALF_rjvww6 */
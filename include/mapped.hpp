@@ -0,0 +1,386 @@
+#ifndef FZOLV_MAPPED_uwqluy
+#define FZOLV_MAPPED_uwqluy
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector.hpp>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Fzolv
+{
+    /**
+     * @brief Thrown when a vector array file cannot be opened, mapped, written or is not in the expected format
+     */
+    class MappedFileError : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    ///< Bumped whenever the layout of MappedFileHeader changes
+    constexpr std::uint32_t mappedFormatVersion = 1;
+
+    /**
+     * @brief The first 64 bytes of a vector array file, followed by the elements at dataOffset
+     *
+     * Elements are stored exactly as they are laid out in memory, so a file is only readable on machines with the
+     * same byte order. byteOrder holds 0x01020304 as written by the producer, which makes a swapped file detectable.
+     */
+    struct MappedFileHeader
+    {
+        char magic[4];              ///< "FZVA"
+        std::uint32_t byteOrder;    ///< 0x01020304 in the byte order of the writer
+        std::uint32_t version;      ///< mappedFormatVersion
+        std::uint8_t scalarKind;    ///< 'f' for floating point, 'i' for signed and 'u' for unsigned integers
+        std::uint8_t scalarSize;    ///< sizeof the scalar type
+        std::uint8_t components;    ///< The number of scalars per element
+        std::uint8_t reserved;      ///< Always 0
+        std::uint32_t elementSize;  ///< sizeof the element type, padding included
+        std::uint32_t reserved2;    ///< Always 0
+        std::uint64_t count;        ///< The number of elements
+        std::uint64_t dataOffset;   ///< The offset of the first element from the start of the file
+        std::uint8_t padding[24];
+    };
+
+    static_assert(sizeof(MappedFileHeader) == 64, "the file header must stay 64 bytes");
+    static_assert(std::is_trivially_copyable<MappedFileHeader>::value, "the file header is written as raw bytes");
+
+    namespace detail
+    {
+        template <typename V>
+        struct MappedLayout;
+
+        template <typename T>
+        struct MappedLayout<Vector2<T>>
+        {
+            using scalar_type = T;
+            static constexpr std::uint8_t components = 2;
+        };
+
+        template <typename T>
+        struct MappedLayout<Vector3<T>>
+        {
+            using scalar_type = T;
+            static constexpr std::uint8_t components = 3;
+        };
+
+        template <typename T>
+        struct MappedLayout<Vector4<T>>
+        {
+            using scalar_type = T;
+            static constexpr std::uint8_t components = 4;
+        };
+
+        template <typename V>
+        auto mappedHeaderFor(std::uint64_t count) -> MappedFileHeader
+        {
+            using T = typename MappedLayout<V>::scalar_type;
+            static_assert(std::is_arithmetic<T>::value, "only vectors of arithmetic scalars can be mapped");
+            static_assert(std::is_trivially_copyable<V>::value && std::is_standard_layout<V>::value,
+                          "mapped elements are used in place and need a fixed layout");
+
+            MappedFileHeader header{};
+            std::memcpy(header.magic, "FZVA", 4);
+            header.byteOrder = 0x01020304U;
+            header.version = mappedFormatVersion;
+            header.scalarKind = std::is_floating_point<T>::value ? 'f' : (std::is_signed<T>::value ? 'i' : 'u');
+            header.scalarSize = static_cast<std::uint8_t>(sizeof(T));
+            header.components = MappedLayout<V>::components;
+            header.elementSize = static_cast<std::uint32_t>(sizeof(V));
+            header.count = count;
+            header.dataOffset = sizeof(MappedFileHeader);
+            return header;
+        }
+
+        /**
+         * @brief Check a header read from a file of fileSize bytes against the one V would be written with
+         */
+        template <typename V>
+        void validateMappedHeader(const MappedFileHeader &header, std::uint64_t fileSize, const std::string &path)
+        {
+            const MappedFileHeader expected = mappedHeaderFor<V>(0);
+            auto fail = [&path](const char *reason) { throw MappedFileError{path + ": " + reason}; };
+            if (std::memcmp(header.magic, expected.magic, 4) != 0)
+            {
+                fail("not a vector array file");
+            }
+            if (header.byteOrder != expected.byteOrder)
+            {
+                fail("written on a machine with a different byte order");
+            }
+            if (header.version != expected.version)
+            {
+                fail("unsupported format version");
+            }
+            if (header.scalarKind != expected.scalarKind || header.scalarSize != expected.scalarSize ||
+                header.components != expected.components || header.elementSize != expected.elementSize)
+            {
+                fail("holds a different element type");
+            }
+            if (header.dataOffset < sizeof(MappedFileHeader) || header.dataOffset % alignof(V) != 0 ||
+                header.dataOffset > fileSize)
+            {
+                fail("invalid data offset");
+            }
+            if (header.count > (fileSize - header.dataOffset) / header.elementSize)
+            {
+                fail("truncated");
+            }
+        }
+    }
+
+    /**
+     * @brief A read-only view of a vector array file, mapped into memory instead of read
+     *
+     * Opening a file maps it and checks its header, the elements are never parsed or copied: pages are loaded on first
+     * access and shared with every other process mapping the same file. The view stays valid until the array is
+     * destroyed or moved from. Files come from writeVectorArray() with the same element type.
+     *
+     * @tparam V The element type, a Vector2, Vector3 or Vector4 of an arithmetic type
+     */
+    template <typename V>
+    class MappedVectorArray
+    {
+    public:
+        using value_type = V;
+        using size_type = std::size_t;
+        using const_iterator = const V *;
+
+        MappedVectorArray() noexcept = default;
+
+        /**
+         * @brief Map a file
+         *
+         * @param path The file to map
+         * @throws MappedFileError If the file cannot be mapped or does not hold elements of type V
+         */
+        explicit MappedVectorArray(const std::string &path) { open(path); }
+
+        MappedVectorArray(const MappedVectorArray &) = delete;
+        auto operator=(const MappedVectorArray &) -> MappedVectorArray & = delete;
+
+        MappedVectorArray(MappedVectorArray &&other) noexcept { swap(other); }
+
+        auto operator=(MappedVectorArray &&other) noexcept -> MappedVectorArray &
+        {
+            MappedVectorArray moved{std::move(other)};
+            swap(moved);
+            return *this;
+        }
+
+        ~MappedVectorArray() { close(); }
+
+        /**
+         * @brief Unmap the current file, if any, and map another one
+         *
+         * @throws MappedFileError If the file cannot be mapped or does not hold elements of type V, the array is then
+         * left closed
+         */
+        void open(const std::string &path)
+        {
+            close();
+            const std::uint64_t fileSize = mapFile(path);
+            try
+            {
+                MappedFileHeader header;
+                if (fileSize < sizeof(header))
+                {
+                    throw MappedFileError{path + ": too small for a vector array file"};
+                }
+                std::memcpy(&header, base, sizeof(header));
+                detail::validateMappedHeader<V>(header, fileSize, path);
+                elements = reinterpret_cast<const V *>(static_cast<const std::byte *>(base) + header.dataOffset);
+                count = static_cast<std::size_t>(header.count);
+            }
+            catch (...)
+            {
+                close();
+                throw;
+            }
+        }
+
+        /**
+         * @brief Unmap the file, the array is empty afterwards
+         */
+        void close() noexcept
+        {
+            if (base != nullptr)
+            {
+#if defined(_WIN32)
+                UnmapViewOfFile(base);
+#else
+                munmap(const_cast<void *>(base), mappedBytes);
+#endif
+            }
+            base = nullptr;
+            mappedBytes = 0;
+            elements = nullptr;
+            count = 0;
+        }
+
+        [[nodiscard]] auto isOpen() const noexcept -> bool { return base != nullptr; }
+
+        [[nodiscard]] auto data() const noexcept -> const V * { return elements; }
+
+        [[nodiscard]] auto size() const noexcept -> size_type { return count; }
+
+        [[nodiscard]] auto empty() const noexcept -> bool { return count == 0; }
+
+        [[nodiscard]] auto begin() const noexcept -> const_iterator { return elements; }
+
+        [[nodiscard]] auto end() const noexcept -> const_iterator { return elements + count; }
+
+        [[nodiscard]] auto operator[](size_type index) const noexcept -> const V & { return elements[index]; }
+
+        /**
+         * @brief The elements, usable with every batch operation
+         */
+        [[nodiscard]] auto view() const noexcept -> span<const V> { return {elements, count}; }
+
+        operator span<const V>() const noexcept { return view(); } // NOLINT: implicit like a container
+
+        void swap(MappedVectorArray &other) noexcept
+        {
+            std::swap(base, other.base);
+            std::swap(mappedBytes, other.mappedBytes);
+            std::swap(elements, other.elements);
+            std::swap(count, other.count);
+        }
+
+    private:
+        ///< Map the whole file read-only and return its size, an empty file is not mapped
+        auto mapFile(const std::string &path) -> std::uint64_t
+        {
+#if defined(_WIN32)
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw MappedFileError{path + ": cannot open"};
+            }
+            LARGE_INTEGER size{};
+            if (!GetFileSizeEx(file, &size))
+            {
+                CloseHandle(file);
+                throw MappedFileError{path + ": cannot read the file size"};
+            }
+            const auto fileSize = static_cast<std::uint64_t>(size.QuadPart);
+            if (fileSize == 0)
+            {
+                CloseHandle(file);
+                return 0;
+            }
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (mapping == nullptr)
+            {
+                throw MappedFileError{path + ": cannot map"};
+            }
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); ///< The view keeps the mapping alive
+            if (base == nullptr)
+            {
+                throw MappedFileError{path + ": cannot map"};
+            }
+#else
+            const int file = ::open(path.c_str(), O_RDONLY);
+            if (file < 0)
+            {
+                throw MappedFileError{path + ": cannot open"};
+            }
+            struct stat status{};
+            if (fstat(file, &status) != 0)
+            {
+                ::close(file);
+                throw MappedFileError{path + ": cannot read the file size"};
+            }
+            const auto fileSize = static_cast<std::uint64_t>(status.st_size);
+            if (fileSize == 0)
+            {
+                ::close(file);
+                return 0;
+            }
+            void *memory = mmap(nullptr, static_cast<std::size_t>(fileSize), PROT_READ, MAP_PRIVATE, file, 0);
+            ::close(file); ///< The mapping keeps the file alive
+            if (memory == MAP_FAILED)
+            {
+                throw MappedFileError{path + ": cannot map"};
+            }
+            base = memory;
+            mappedBytes = static_cast<std::size_t>(fileSize);
+#endif
+            return fileSize;
+        }
+
+        const void *base = nullptr;
+        std::size_t mappedBytes = 0;
+        const V *elements = nullptr;
+        std::size_t count = 0;
+    };
+
+    using MappedVector2fArray = MappedVectorArray<Vector2f>;
+    using MappedVector3fArray = MappedVectorArray<Vector3f>;
+
+    /**
+     * @brief Write values in the format MappedVectorArray<V> maps
+     *
+     * @param path The file to create or replace
+     * @param values The elements, written as they are laid out in memory
+     * @throws MappedFileError If the file cannot be written
+     */
+    template <typename V>
+    void writeVectorArray(const std::string &path, span<const V> values)
+    {
+        const MappedFileHeader header = detail::mappedHeaderFor<V>(values.size());
+        std::FILE *file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr)
+        {
+            throw MappedFileError{path + ": cannot create"};
+        }
+        bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        if (written && !values.empty())
+        {
+            written = std::fwrite(values.data(), sizeof(V), values.size(), file) == values.size();
+        }
+        if (std::fclose(file) != 0 || !written)
+        {
+            std::remove(path.c_str());
+            throw MappedFileError{path + ": cannot write"};
+        }
+    }
+
+    ///< Non-template overloads so that containers convert to spans implicitly
+
+    inline void writeVectorArray(const std::string &path, span<const Vector2f> values)
+    {
+        writeVectorArray<Vector2f>(path, values);
+    }
+
+    inline void writeVectorArray(const std::string &path, span<const Vector3f> values)
+    {
+        writeVectorArray<Vector3f>(path, values);
+    }
+}
+
+#endif /* end of include guard: FZOLV_MAPPED_uwqluy */
@@ -0,0 +1,270 @@
+#ifndef FZOLV_MATH_vsa9aj
+#define FZOLV_MATH_vsa9aj
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief Whether the current evaluation happens inside a constant expression
+ *
+ * Uses std::is_constant_evaluated in C++20 and the equivalent builtin of GCC, Clang and MSVC in C++17. Compilers
+ * without either always report runtime evaluation, so the math functions below silently lose their constexpr support.
+ */
+#if defined(__cpp_lib_is_constant_evaluated)
+#define FZOLV_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#define FZOLV_HAS_CONSTANT_EVALUATED 1
+#elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define FZOLV_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define FZOLV_HAS_CONSTANT_EVALUATED 1
+#else
+#define FZOLV_IS_CONSTANT_EVALUATED() false
+#define FZOLV_HAS_CONSTANT_EVALUATED 0
+#endif
+
+namespace Fzolv
+{
+    /**
+     * @brief constexpr versions of the <cmath> functions used by the vector types
+     *
+     * At runtime every function forwards to its std counterpart, so results and speed do not change. Inside constant
+     * expressions they use portable algorithms instead: floor, ceil and round are exact, and sqrt is correctly rounded
+     * for float and within one ulp of std::sqrt for double. Integral arguments are returned unchanged by the rounding
+     * functions and converted to double by sqrt, like <cmath>.
+     */
+    namespace math
+    {
+        namespace detail
+        {
+            /**
+             * @brief Split a double into two halves with 26 significant bits each, so that their products are exact
+             */
+            constexpr void split(double value, double &hi, double &lo)
+            {
+                const double c = 134217729.0 * value;
+                hi = c - (c - value);
+                lo = value - hi;
+            }
+
+            /**
+             * @brief Compute x - (r + h)^2 for a power of two h, with r * r expanded exactly so that the sign is reliable
+             */
+            constexpr auto midpointResidual(double x, double r, double h) -> double
+            {
+                double hi = 0;
+                double lo = 0;
+                split(r, hi, lo);
+                const double p = r * r;
+                const double q = ((hi * hi - p) + 2.0 * hi * lo) + lo * lo;
+                return (((x - p) - q) - 2.0 * r * h) - h * h;
+            }
+
+            /**
+             * @brief sqrt for finite, positive doubles, evaluated with Newton-Raphson and corrected to the nearest value
+             */
+            constexpr auto sqrtNewton(double value) -> double
+            {
+                ///< Scale by powers of four into [0.25, 1), where the iteration converges quickly from 1
+                double scale = 1.0;
+                while (value >= 1.0)
+                {
+                    value *= 0.25;
+                    scale *= 2.0;
+                }
+                while (value < 0.25)
+                {
+                    value *= 4.0;
+                    scale *= 0.5;
+                }
+
+                double r = 1.0;
+                for (int i = 0; i < 8; ++i)
+                {
+                    r = 0.5 * (r + value / r);
+                }
+
+                ///< Newton-Raphson can stop one ulp away, check the midpoints on both sides
+                constexpr double ulp = std::numeric_limits<double>::epsilon() / 2;
+                if (midpointResidual(value, r, ulp / 2) > 0)
+                {
+                    r += ulp;
+                }
+                else if (midpointResidual(value, r, -ulp / 2) < 0)
+                {
+                    r -= ulp;
+                }
+                return r * scale;
+            }
+
+            /**
+             * @brief Whether value is a NaN, an infinity or a zero, which every rounding function returns unchanged
+             */
+            template <typename T>
+            constexpr auto isSpecial(T value) -> bool
+            {
+                return value != value || value == 0 || value == std::numeric_limits<T>::infinity() ||
+                       value == -std::numeric_limits<T>::infinity();
+            }
+
+            /**
+             * @brief Whether value is large enough that it has no fractional part
+             */
+            template <typename T>
+            constexpr auto isIntegralMagnitude(T value) -> bool
+            {
+                constexpr T limit = T(1) / std::numeric_limits<T>::epsilon();
+                return value >= limit || value <= -limit;
+            }
+
+            template <typename T>
+            constexpr auto trunc(T value) -> T
+            {
+                const T result = static_cast<T>(static_cast<long long>(value));
+                return result == 0 && value < 0 ? -T(0) : result;
+            }
+        }
+
+        /**
+         * @brief Compute the square root of a value, usable in constant expressions
+         *
+         * @param value The value to take the square root of
+         * @return The square root, in the floating point type of value or double for integral values
+         */
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+        constexpr auto sqrt(T value) -> std::conditional_t<std::is_floating_point<T>::value, T, double>
+        {
+            using R = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+            if (!FZOLV_IS_CONSTANT_EVALUATED())
+            {
+                return std::sqrt(static_cast<R>(value));
+            }
+
+            const R x = static_cast<R>(value);
+            if (x != x || x < 0)
+            {
+                return std::numeric_limits<R>::quiet_NaN();
+            }
+            if (x == 0 || x == std::numeric_limits<R>::infinity())
+            {
+                return x;
+            }
+            ///< Double has more than twice the bits of float, so rounding the double result is correct for float
+            return static_cast<R>(detail::sqrtNewton(static_cast<double>(x)));
+        }
+
+        /**
+         * @brief Round a value down to an integral value, usable in constant expressions
+         */
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+        constexpr auto floor(T value) -> T
+        {
+            if constexpr (std::is_integral<T>::value)
+            {
+                return value;
+            }
+            else
+            {
+                if (!FZOLV_IS_CONSTANT_EVALUATED())
+                {
+                    return std::floor(value);
+                }
+                if (detail::isSpecial(value) || detail::isIntegralMagnitude(value))
+                {
+                    return value;
+                }
+                const T t = detail::trunc(value);
+                return t > value ? t - T(1) : t;
+            }
+        }
+
+        /**
+         * @brief Round a value up to an integral value, usable in constant expressions
+         */
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+        constexpr auto ceil(T value) -> T
+        {
+            if constexpr (std::is_integral<T>::value)
+            {
+                return value;
+            }
+            else
+            {
+                if (!FZOLV_IS_CONSTANT_EVALUATED())
+                {
+                    return std::ceil(value);
+                }
+                if (detail::isSpecial(value) || detail::isIntegralMagnitude(value))
+                {
+                    return value;
+                }
+                const T t = detail::trunc(value);
+                return t < value ? t + T(1) : t;
+            }
+        }
+
+        /**
+         * @brief Round a value to the nearest integral value, halfway cases away from zero, usable in constant
+         * expressions
+         */
+        template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+        constexpr auto round(T value) -> T
+        {
+            if constexpr (std::is_integral<T>::value)
+            {
+                return value;
+            }
+            else
+            {
+                if (!FZOLV_IS_CONSTANT_EVALUATED())
+                {
+                    return std::round(value);
+                }
+                if (detail::isSpecial(value) || detail::isIntegralMagnitude(value))
+                {
+                    return value;
+                }
+                const T t = detail::trunc(value);
+                const T fraction = value - t;
+                if (fraction >= T(0.5))
+                {
+                    return t + T(1);
+                }
+                if (fraction <= T(-0.5))
+                {
+                    return t - T(1);
+                }
+                return t;
+            }
+        }
+
+        /**
+         * @brief Overloads for numeric class types such as Fixed, which provide sqrt, floor, ceil and round as const
+         * members with the same semantics
+         */
+        template <typename T, std::enable_if_t<std::is_class<T>::value, int> = 0>
+        constexpr auto sqrt(const T &value) -> T
+        {
+            return value.sqrt();
+        }
+
+        template <typename T, std::enable_if_t<std::is_class<T>::value, int> = 0>
+        constexpr auto floor(const T &value) -> T
+        {
+            return value.floor();
+        }
+
+        template <typename T, std::enable_if_t<std::is_class<T>::value, int> = 0>
+        constexpr auto ceil(const T &value) -> T
+        {
+            return value.ceil();
+        }
+
+        template <typename T, std::enable_if_t<std::is_class<T>::value, int> = 0>
+        constexpr auto round(const T &value) -> T
+        {
+            return value.round();
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_MATH_vsa9aj */
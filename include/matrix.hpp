@@ -0,0 +1,427 @@
+#ifndef FZOLV_MATRIX_rm4x8p
+#define FZOLV_MATRIX_rm4x8p
+
+#include <cassert>
+#include <cstddef>
+#include <simd.hpp>
+#include <type_traits>
+#include <util.hpp>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    /**
+     * @brief A generic 4x4 matrix with numeric types, stored as four column vectors
+     *
+     * Matrix4 follows the column-vector convention: a matrix transforms a vector with m * v, and a * b applies b
+     * first. For float components every column is one SIMD register and multiplication, transposition and inversion
+     * are vectorized with SSE2, or NEON for everything except the inverse. Multiplication accumulates the columns in
+     * the same order as the scalar code used for other types, so both produce the same results.
+     *
+     * @tparam T The type of the matrix elements, must be arithmetic
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class Matrix4
+    {
+        static constexpr bool simdFloat = std::is_same<T, float>::value && (FZOLV_SIMD_SSE2 || FZOLV_SIMD_NEON);
+
+    public:
+        /**
+         * @brief Default constructor, initializes every element to zero
+         */
+        constexpr Matrix4() : columns{} {}
+
+        /**
+         * @brief Constructor from four column vectors
+         *
+         * @param c0 The first column
+         * @param c1 The second column
+         * @param c2 The third column
+         * @param c3 The fourth column, holding the translation of an affine transform
+         */
+        constexpr Matrix4(const Vector4<T> &c0, const Vector4<T> &c1, const Vector4<T> &c2, const Vector4<T> &c3)
+            : columns{c0, c1, c2, c3}
+        {
+        }
+
+        /**
+         * @brief Static factory method for a matrix given row by row, which reads like the written-out matrix
+         *
+         * @return constexpr Matrix4 The matrix with the given rows
+         */
+        static constexpr auto FromRows(const Vector4<T> &r0, const Vector4<T> &r1, const Vector4<T> &r2, const Vector4<T> &r3)
+            -> Matrix4
+        {
+            return {{r0.x, r1.x, r2.x, r3.x}, {r0.y, r1.y, r2.y, r3.y}, {r0.z, r1.z, r2.z, r3.z}, {r0.w, r1.w, r2.w, r3.w}};
+        }
+
+        static constexpr auto Zero() -> Matrix4 { return {}; }
+
+        static constexpr auto Identity() -> Matrix4
+        {
+            return {Vector4<T>::UnitX(), Vector4<T>::UnitY(), Vector4<T>::UnitZ(), Vector4<T>::UnitW()};
+        }
+
+        /**
+         * @brief Static factory method for a translation
+         *
+         * @param offset The translation
+         * @return constexpr Matrix4 A matrix that moves points by offset and leaves directions unchanged
+         */
+        static constexpr auto Translation(const Vector3<T> &offset) -> Matrix4
+        {
+            return {Vector4<T>::UnitX(), Vector4<T>::UnitY(), Vector4<T>::UnitZ(), Vector4<T>{offset, T(1)}};
+        }
+
+        /**
+         * @brief Static factory method for a non-uniform scale
+         *
+         * @param factors The scale factor along each axis
+         * @return constexpr Matrix4 A matrix that scales along the axes
+         */
+        static constexpr auto Scale(const Vector3<T> &factors) -> Matrix4
+        {
+            return {{factors.x, T(0), T(0), T(0)}, {T(0), factors.y, T(0), T(0)}, {T(0), T(0), factors.z, T(0)},
+                    Vector4<T>::UnitW()};
+        }
+
+        /**
+         * @brief Access the element at a row and column
+         *
+         * @param row The row index, 0 to 3
+         * @param column The column index, 0 to 3
+         * @return T& A reference to the element
+         */
+        constexpr auto operator()(std::size_t row, std::size_t column) -> T &
+        {
+            assert(row < 4 && column < 4);
+            return element(columns[column], row);
+        }
+
+        constexpr auto operator()(std::size_t row, std::size_t column) const -> const T &
+        {
+            assert(row < 4 && column < 4);
+            return element(columns[column], row);
+        }
+
+        /**
+         * @brief Get the transposed matrix, which swaps rows and columns
+         *
+         * @return Matrix4 The transposed matrix
+         */
+        [[nodiscard]] auto transposed() const -> Matrix4
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                __m128 c0 = columns[0].load();
+                __m128 c1 = columns[1].load();
+                __m128 c2 = columns[2].load();
+                __m128 c3 = columns[3].load();
+                _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+                return fromRegisters(c0, c1, c2, c3);
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                const float32x4x2_t t01 = vtrnq_f32(columns[0].load(), columns[1].load());
+                const float32x4x2_t t23 = vtrnq_f32(columns[2].load(), columns[3].load());
+                return fromRegisters(vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])),
+                                     vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])),
+                                     vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])),
+                                     vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+            }
+#endif
+            return FromRows(columns[0], columns[1], columns[2], columns[3]);
+        }
+
+        /**
+         * @brief Get the determinant of the matrix
+         *
+         * @return T The determinant, zero for singular matrices
+         */
+        [[nodiscard]] auto determinant() const -> T
+        {
+            const Cofactors c = cofactors();
+            return c.det;
+        }
+
+        /**
+         * @brief Get the inverse of the matrix
+         *
+         * For float components on SSE2 this uses the 2x2 block decomposition, otherwise the classical adjugate divided
+         * by the determinant. The matrix must not be singular, singular matrices produce non-finite elements.
+         *
+         * @return Matrix4 The inverse matrix, so that m * m.inverse() is the identity up to rounding
+         */
+        [[nodiscard]] auto inverse() const -> Matrix4
+        {
+            static_assert(std::is_floating_point<T>::value, "Only matrices of floating point elements can be inverted");
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return inverseSse2();
+            }
+#endif
+            const Cofactors c = cofactors();
+            const T inv = T(1) / c.det;
+            Matrix4 result;
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                result(i % 4, i / 4) = c.adj[i] * inv;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Transform a point, treating it as (x, y, z, 1) and dropping w of the result
+         *
+         * @param point The point to transform
+         * @return Vector3<T> The transformed point, without perspective division
+         */
+        [[nodiscard]] auto transformPoint(const Vector3<T> &point) const -> Vector3<T>
+        {
+            return (*this * Vector4<T>{point, T(1)}).xyz();
+        }
+
+        /**
+         * @brief Transform a direction, treating it as (x, y, z, 0) so that translation does not apply
+         *
+         * @param direction The direction to transform
+         * @return Vector3<T> The transformed direction
+         */
+        [[nodiscard]] auto transformDirection(const Vector3<T> &direction) const -> Vector3<T>
+        {
+            return (*this * Vector4<T>{direction, T(0)}).xyz();
+        }
+
+        /**
+         * @brief Overload multiplication for matrix-vector and matrix-matrix products
+         *
+         * The product with a vector is the sum of the columns scaled by the vector components, accumulated from the
+         * first to the last column. The product of two matrices applies the right-hand side first.
+         *
+         * @param lhs The left-hand side operand of the operator
+         * @param rhs The right-hand side operand of the operator
+         * @return friend The result of the product
+         */
+        friend auto operator*(const Matrix4 &lhs, const Vector4<T> &rhs) -> Vector4<T>
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return lhs.mulVector(rhs);
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return lhs.mulVector(rhs);
+            }
+#endif
+            const auto row = [&](std::size_t i)
+            {
+                return lhs(i, 0) * rhs.x + lhs(i, 1) * rhs.y + lhs(i, 2) * rhs.z + lhs(i, 3) * rhs.w;
+            };
+            return {row(0), row(1), row(2), row(3)};
+        }
+
+        friend auto operator*(const Matrix4 &lhs, const Matrix4 &rhs) -> Matrix4
+        {
+            return {lhs * rhs.columns[0], lhs * rhs.columns[1], lhs * rhs.columns[2], lhs * rhs.columns[3]};
+        }
+
+        auto operator*=(const Matrix4 &other) -> Matrix4 & { return *this = *this * other; }
+
+        friend auto operator==(const Matrix4 &lhs, const Matrix4 &rhs) -> bool
+        {
+            return lhs.columns[0] == rhs.columns[0] && lhs.columns[1] == rhs.columns[1] &&
+                   lhs.columns[2] == rhs.columns[2] && lhs.columns[3] == rhs.columns[3];
+        }
+
+        friend auto operator!=(const Matrix4 &lhs, const Matrix4 &rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+#if FZOLV_SIMD_SSE2
+        /**
+         * @brief Multiply a vector held in a SIMD register, only available for float elements
+         *
+         * @param vector The vector to transform
+         * @return __m128 The transformed vector
+         */
+        [[nodiscard]] auto mulRegister(__m128 vector) const -> __m128
+        {
+            __m128 result = _mm_mul_ps(columns[0].load(), _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0)));
+            result = _mm_add_ps(result, _mm_mul_ps(columns[1].load(), _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1))));
+            result = _mm_add_ps(result, _mm_mul_ps(columns[2].load(), _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2))));
+            return _mm_add_ps(result, _mm_mul_ps(columns[3].load(), _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3))));
+        }
+#elif FZOLV_SIMD_NEON
+        [[nodiscard]] auto mulRegister(float32x4_t vector) const -> float32x4_t
+        {
+            float32x4_t result = vmulq_laneq_f32(columns[0].load(), vector, 0);
+            result = vaddq_f32(result, vmulq_laneq_f32(columns[1].load(), vector, 1));
+            result = vaddq_f32(result, vmulq_laneq_f32(columns[2].load(), vector, 2));
+            return vaddq_f32(result, vmulq_laneq_f32(columns[3].load(), vector, 3));
+        }
+#endif
+
+        /**
+         * @brief The columns of the matrix
+         */
+        Vector4<T> columns[4];
+
+    private:
+        template <typename V>
+        static constexpr auto element(V &vector, std::size_t index) -> decltype((vector.x))
+        {
+            return index == 0 ? vector.x : (index == 1 ? vector.y : (index == 2 ? vector.z : vector.w));
+        }
+
+        ///< The adjugate, stored column by column like the matrix, and the determinant
+        struct Cofactors
+        {
+            T adj[16];
+            T det;
+        };
+
+        [[nodiscard]] auto cofactors() const -> Cofactors
+        {
+            T m[16];
+            for (std::size_t i = 0; i < 16; ++i)
+            {
+                m[i] = (*this)(i % 4, i / 4);
+            }
+            Cofactors c{};
+            T *inv = c.adj;
+
+            inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+            inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+            inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+            inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+            inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+            inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+            inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+            inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+            inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+            inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+            inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+            inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+            inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+            inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+            inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+            inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+            c.det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+            return c;
+        }
+
+#if FZOLV_SIMD_SSE2
+        [[nodiscard]] auto mulVector(const Vector4<T> &vector) const -> Vector4<T>
+        {
+            return Vector4<T>::fromRegister(mulRegister(vector.load()));
+        }
+
+        static auto fromRegisters(__m128 c0, __m128 c1, __m128 c2, __m128 c3) -> Matrix4
+        {
+            return {Vector4<T>::fromRegister(c0), Vector4<T>::fromRegister(c1), Vector4<T>::fromRegister(c2),
+                    Vector4<T>::fromRegister(c3)};
+        }
+
+        ///< Products of 2x2 matrices packed as (m00, m01, m10, m11) in one register, used by inverseSse2
+        static auto mat2Mul(__m128 a, __m128 b) -> __m128
+        {
+            return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        ///< adj(a) * b
+        static auto mat2AdjMul(__m128 a, __m128 b) -> __m128
+        {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        ///< a * adj(b)
+        static auto mat2MulAdj(__m128 a, __m128 b) -> __m128
+        {
+            return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+                              _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        /**
+         * @brief Invert with the 2x2 block method on SSE2 registers
+         *
+         * The method is written for rows, so it runs on the columns and inverts the transpose. Writing the resulting
+         * rows back as columns yields the inverse of the matrix itself.
+         */
+        [[nodiscard]] auto inverseSse2() const -> Matrix4
+        {
+            const __m128 r0 = columns[0].load();
+            const __m128 r1 = columns[1].load();
+            const __m128 r2 = columns[2].load();
+            const __m128 r3 = columns[3].load();
+
+            ///< The 2x2 sub-matrices A B / C D
+            const __m128 a = _mm_movelh_ps(r0, r1);
+            const __m128 b = _mm_movehl_ps(r1, r0);
+            const __m128 c = _mm_movelh_ps(r2, r3);
+            const __m128 d = _mm_movehl_ps(r3, r2);
+
+            ///< The determinants of the sub-matrices as (|A|, |B|, |C|, |D|)
+            const __m128 detSub =
+                _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+                           _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+            const __m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+            const __m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+            const __m128 dc = mat2AdjMul(d, c);
+            const __m128 ab = mat2AdjMul(a, b);
+
+            __m128 xBlock = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Mul(b, dc));
+            __m128 wBlock = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Mul(c, ab));
+            __m128 yBlock = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MulAdj(d, ab));
+            __m128 zBlock = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MulAdj(a, dc));
+
+            ///< |M| = |A||D| + |B||C| - tr((A#B)(D#C)), with the trace summed across all lanes
+            __m128 trace = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+            trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+            trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+            const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+
+            const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0F, -1.0F, -1.0F, 1.0F), detM);
+            xBlock = _mm_mul_ps(xBlock, rDetM);
+            yBlock = _mm_mul_ps(yBlock, rDetM);
+            zBlock = _mm_mul_ps(zBlock, rDetM);
+            wBlock = _mm_mul_ps(wBlock, rDetM);
+
+            return fromRegisters(_mm_shuffle_ps(xBlock, yBlock, _MM_SHUFFLE(1, 3, 1, 3)),
+                                 _mm_shuffle_ps(xBlock, yBlock, _MM_SHUFFLE(0, 2, 0, 2)),
+                                 _mm_shuffle_ps(zBlock, wBlock, _MM_SHUFFLE(1, 3, 1, 3)),
+                                 _mm_shuffle_ps(zBlock, wBlock, _MM_SHUFFLE(0, 2, 0, 2)));
+        }
+#elif FZOLV_SIMD_NEON
+        [[nodiscard]] auto mulVector(const Vector4<T> &vector) const -> Vector4<T>
+        {
+            return Vector4<T>::fromRegister(mulRegister(vector.load()));
+        }
+
+        static auto fromRegisters(float32x4_t c0, float32x4_t c1, float32x4_t c2, float32x4_t c3) -> Matrix4
+        {
+            return {Vector4<T>::fromRegister(c0), Vector4<T>::fromRegister(c1), Vector4<T>::fromRegister(c2),
+                    Vector4<T>::fromRegister(c3)};
+        }
+#endif
+    };
+
+    using Matrix4f = Matrix4<float>;
+    using Matrix4d = Matrix4<double>;
+
+    static_assert(std::is_trivially_copyable<Matrix4f>::value, "Matrix4f must be trivially copyable");
+    static_assert(sizeof(Matrix4f) == 16 * sizeof(float), "Matrix4f must not contain padding");
+}
+
+#endif /* end of include guard: FZOLV_MATRIX_rm4x8p */
@@ -0,0 +1,377 @@
+#ifndef FZOLV_PARALLEL_rlqlce
+#define FZOLV_PARALLEL_rlqlce
+
+#include <algorithm>
+#include <allocator.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        inline std::atomic<std::size_t> parallelThreshold{std::size_t{1} << 16};
+    }
+
+    /**
+     * @brief The number of elements below which batch operations run on the calling thread, 2^16 by default
+     *
+     * Waking the pool and waiting for the last chunk costs a few microseconds, which only pays off for large arrays.
+     */
+    inline auto parallelThreshold() noexcept -> std::size_t
+    {
+        return detail::parallelThreshold.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Change parallelThreshold(), safe while other threads run batch operations, which see either value
+     */
+    inline void setParallelThreshold(std::size_t count) noexcept
+    {
+        detail::parallelThreshold.store(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Chunk boundaries are rounded to multiples of this many elements
+     *
+     * Any element type of at least one byte then starts every chunk on a cache line boundary of a cache line aligned
+     * array, so two threads never write to the same line.
+     */
+    constexpr std::size_t parallelChunkAlignment = cacheLineSize;
+
+    /**
+     * @brief A non-owning reference to a callable taking a task index, cheap to copy and never allocating
+     *
+     * The referenced callable must outlive every call through the reference.
+     */
+    class TaskRef
+    {
+    public:
+        template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, TaskRef>::value>>
+        TaskRef(F &&fn) noexcept // NOLINT: implicit like std::function
+            : object{const_cast<void *>(static_cast<const void *>(std::addressof(fn)))},
+              call{[](void *target, std::size_t index) { (*static_cast<std::remove_reference_t<F> *>(target))(index); }}
+        {
+        }
+
+        void operator()(std::size_t index) const { call(object, index); }
+
+    private:
+        void *object;
+        void (*call)(void *, std::size_t);
+    };
+
+    /**
+     * @brief The interface parallelFor hands its chunks to, implement it to run Fzolv on an existing job system
+     *
+     * An implementation calls task(i) exactly once for every i in [0, tasks), in any order and on any thread, and
+     * returns once every call has finished. The calling thread may run tasks itself. A task may call parallelFor
+     * again, so executors that block on their own workers must run such nested calls inline. Wrapping
+     * std::for_each(std::execution::par, ...) over the task indices is a valid implementation as well.
+     */
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        /**
+         * @brief The number of threads, the caller included, that can run tasks at the same time
+         */
+        [[nodiscard]] virtual auto concurrency() const noexcept -> std::size_t = 0;
+
+        /**
+         * @brief Run task(i) for every i in [0, tasks) and wait for all of them
+         */
+        virtual void run(std::size_t tasks, TaskRef task) = 0;
+    };
+
+    /**
+     * @brief An executor that runs every task on the calling thread, in order
+     */
+    class InlineExecutor final : public Executor
+    {
+    public:
+        [[nodiscard]] auto concurrency() const noexcept -> std::size_t override { return 1; }
+
+        void run(std::size_t tasks, TaskRef task) override
+        {
+            for (std::size_t i = 0; i < tasks; ++i)
+            {
+                task(i);
+            }
+        }
+    };
+
+    namespace detail
+    {
+        ///< The pool whose tasks the current thread is running, nested runs on the same pool execute inline
+        inline thread_local const void *runningPool = nullptr;
+    }
+
+    /**
+     * @brief A fixed set of worker threads that stay asleep between parallel runs
+     *
+     * Threads start once, in the constructor, instead of once per parallelFor. Tasks are claimed one by one from a
+     * shared atomic counter, so threads that finish early keep taking the remaining chunks and a slow thread never
+     * holds up the others. The calling thread works on the run too. Runs from different threads are serialized, and
+     * a run started from inside one of its own tasks executes inline. The first exception thrown by a task stops
+     * further tasks from starting and is rethrown by run().
+     */
+    class ThreadPool final : public Executor
+    {
+    public:
+        /**
+         * @brief Start the workers
+         *
+         * @param threads The number of threads taking part in a run, the caller included, so threads - 1 workers start
+         */
+        explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency())
+        {
+            threads = std::max<std::size_t>(1, threads);
+            workers.reserve(threads - 1);
+            for (std::size_t i = 1; i < threads; ++i)
+            {
+                workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool &) = delete;
+        auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+        ~ThreadPool() override
+        {
+            {
+                const std::lock_guard<std::mutex> guard{mutex};
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto &worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        [[nodiscard]] auto concurrency() const noexcept -> std::size_t override { return workers.size() + 1; }
+
+        void run(std::size_t tasks, TaskRef task) override
+        {
+            if (workers.empty() || tasks <= 1 || detail::runningPool == this)
+            {
+                for (std::size_t i = 0; i < tasks; ++i)
+                {
+                    task(i);
+                }
+                return;
+            }
+
+            const std::lock_guard<std::mutex> serial{runMutex};
+            {
+                const std::lock_guard<std::mutex> guard{mutex};
+                job.task = &task;
+                job.tasks = tasks;
+                job.next.store(0, std::memory_order_relaxed);
+                job.error = nullptr;
+                open = true;
+                ++generation;
+            }
+            wake.notify_all();
+
+            const void *outer = detail::runningPool;
+            detail::runningPool = this;
+            work();
+            detail::runningPool = outer;
+
+            std::unique_lock<std::mutex> lock{mutex};
+            ///< Closing the run under the same lock as the last check keeps late workers away from the next one
+            finished.wait(lock, [this]() { return active == 0; });
+            open = false;
+            if (job.error)
+            {
+                std::rethrow_exception(job.error);
+            }
+        }
+
+    private:
+        struct Job
+        {
+            const TaskRef *task = nullptr;
+            std::size_t tasks = 0;
+            alignas(cacheLineSize) std::atomic<std::size_t> next{0}; ///< On its own cache line, every thread hits it
+            std::exception_ptr error;
+        };
+
+        void work()
+        {
+            const std::size_t tasks = job.tasks;
+            for (std::size_t i = job.next.fetch_add(1, std::memory_order_relaxed); i < tasks;
+                 i = job.next.fetch_add(1, std::memory_order_relaxed))
+            {
+                try
+                {
+                    (*job.task)(i);
+                }
+                catch (...)
+                {
+                    const std::lock_guard<std::mutex> guard{mutex};
+                    if (!job.error)
+                    {
+                        job.error = std::current_exception();
+                    }
+                    job.next.store(tasks, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void workerLoop()
+        {
+            detail::runningPool = this;
+            std::size_t seen = 0;
+            std::unique_lock<std::mutex> lock{mutex};
+            for (;;)
+            {
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping)
+                {
+                    return;
+                }
+                seen = generation;
+                if (!open)
+                {
+                    continue;
+                }
+                ++active;
+                lock.unlock();
+                work();
+                lock.lock();
+                if (--active == 0)
+                {
+                    finished.notify_one();
+                }
+            }
+        }
+
+        Job job;
+        std::mutex runMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        std::size_t generation = 0;
+        std::size_t active = 0;
+        bool open = false;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+    };
+
+    namespace detail
+    {
+        inline std::atomic<Executor *> currentExecutor{nullptr};
+    }
+
+    /**
+     * @brief The pool used when no other executor is set, with one thread per hardware thread, started on first use
+     */
+    inline auto defaultThreadPool() -> ThreadPool &
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Make parallelFor, and every batch operation built on it, run on another executor
+     *
+     * @param executor The executor to use, it must outlive its use, or nullptr to go back to defaultThreadPool()
+     */
+    inline void setExecutor(Executor *executor) noexcept { detail::currentExecutor.store(executor, std::memory_order_release); }
+
+    /**
+     * @brief The executor parallelFor currently uses
+     */
+    inline auto currentExecutor() -> Executor &
+    {
+        Executor *executor = detail::currentExecutor.load(std::memory_order_acquire);
+        return executor != nullptr ? *executor : defaultThreadPool();
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Split [0, count) into chunks of at least grain elements and run them on the current executor
+         */
+        template <typename F>
+        void splitAcrossThreads(std::size_t count, std::size_t grain, F &fn)
+        {
+            Executor &executor = Fzolv::currentExecutor();
+            const std::size_t threads = executor.concurrency();
+            const std::size_t maxChunks = std::min(threads * 4, std::max<std::size_t>(1, count / std::max<std::size_t>(1, grain)));
+            if (threads <= 1 || maxChunks <= 1)
+            {
+                fn(std::size_t{0}, count);
+                return;
+            }
+
+            std::size_t chunkSize = (count + maxChunks - 1) / maxChunks;
+            chunkSize = (chunkSize + parallelChunkAlignment - 1) / parallelChunkAlignment * parallelChunkAlignment;
+            const std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+            executor.run(chunks,
+                         [&](std::size_t chunk)
+                         {
+                             const std::size_t begin = chunk * chunkSize;
+                             fn(begin, std::min(count, begin + chunkSize));
+                         });
+        }
+    }
+
+    /**
+     * @brief Run fn over [0, count) split into contiguous chunks on the threads of the current executor
+     *
+     * Ranges smaller than parallelThreshold(), or executors with a single thread, run inline on the calling thread.
+     * Otherwise the range is split into up to four chunks per thread, so that uneven chunks balance out, each at least
+     * grain elements long. Chunk boundaries are multiples of parallelChunkAlignment. Returns once every chunk is done.
+     *
+     * @tparam F A callable taking (std::size_t begin, std::size_t end)
+     * @param count The number of elements
+     * @param grain The minimum number of elements per chunk
+     * @param fn The function to run on every chunk
+     */
+    template <typename F>
+    void parallelFor(std::size_t count, std::size_t grain, F &&fn)
+    {
+        if (count < parallelThreshold())
+        {
+            fn(std::size_t{0}, count);
+            return;
+        }
+        detail::splitAcrossThreads(count, grain, fn);
+    }
+
+    /**
+     * @brief parallelFor for elements that each take about cost units of work, such as a ray tested against cost walls
+     *
+     * The threshold applies to count * cost instead of count, so that a few thousand expensive elements still spread
+     * across threads.
+     *
+     * @param count The number of elements
+     * @param cost The work per element, in the units parallelThreshold() counts
+     * @param grain The minimum number of elements per chunk
+     * @param fn The function to run on every chunk
+     */
+    template <typename F>
+    void parallelForWeighted(std::size_t count, std::size_t cost, std::size_t grain, F &&fn)
+    {
+        const std::size_t threshold = parallelThreshold();
+        if (cost == 0 || count < threshold / cost + (threshold % cost != 0 ? 1 : 0))
+        {
+            fn(std::size_t{0}, count);
+            return;
+        }
+        detail::splitAcrossThreads(count, grain, fn);
+    }
+}
+
+#endif /* end of include guard: FZOLV_PARALLEL_rlqlce */
@@ -0,0 +1,321 @@
+#ifndef FZOLV_PROFILE_u101fx
+#define FZOLV_PROFILE_u101fx
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Set to 1 to record every batch kernel, spatial structure rebuild and transform in the profile counters
+ *
+ * Without it FZOLV_PROFILE_ZONE expands to nothing, so the hot paths carry no instrumentation at all. The CMake
+ * option FZOLV_ENABLE_PROFILING defines it for every target linking Fzolv.
+ */
+#ifndef FZOLV_PROFILING
+#define FZOLV_PROFILING 0
+#endif
+
+namespace Fzolv
+{
+    namespace profile
+    {
+        ///< Whether this build records zones, the API below works either way and reports nothing when it does not
+        constexpr bool enabled = FZOLV_PROFILING != 0;
+
+        ///< The number of distinct zone names that get counters, later names are still passed to the hooks
+        constexpr std::size_t maxSites = 256;
+
+        /**
+         * @brief The totals of one zone name over every thread
+         */
+        struct KernelStats
+        {
+            std::string name;
+            std::uint64_t calls = 0;       ///< How often the zone was entered
+            std::uint64_t elements = 0;    ///< The number of elements processed over all calls
+            std::uint64_t nanoseconds = 0; ///< The time spent inside the zone, summed over threads
+        };
+
+        /**
+         * @brief Callbacks around every zone, to forward them to a frame profiler such as Tracy or Perfetto
+         *
+         * begin and end run on the thread executing the zone, in strictly nested order per thread, and must be
+         * thread-safe. Either may be null.
+         */
+        struct ZoneHooks
+        {
+            void (*begin)(const char *name, std::size_t elements, void *user) = nullptr;
+            void (*end)(const char *name, void *user) = nullptr;
+            void *user = nullptr;
+        };
+
+        namespace detail
+        {
+            struct SiteCounters
+            {
+                std::atomic<std::uint64_t> calls{0};
+                std::atomic<std::uint64_t> elements{0};
+                std::atomic<std::uint64_t> nanoseconds{0};
+            };
+
+            struct Totals
+            {
+                std::uint64_t calls = 0;
+                std::uint64_t elements = 0;
+                std::uint64_t nanoseconds = 0;
+            };
+
+            struct ThreadProfile;
+
+            struct Registry
+            {
+                std::mutex mutex;
+                std::vector<const char *> names;
+                std::vector<ThreadProfile *> threads;
+                Totals retired[maxSites];
+                Totals baseline[maxSites];
+                std::atomic<const ZoneHooks *> hooks{nullptr};
+            };
+
+            /**
+             * @brief The process-wide registry, never destroyed so that pool threads exiting late can still report
+             */
+            inline auto registry() -> Registry &
+            {
+                static Registry *instance = new Registry;
+                return *instance;
+            }
+
+            /**
+             * @brief The counters of one thread, written only by that thread and read by snapshot()
+             *
+             * Every thread registers its counters on first use and folds them into the retired totals on exit.
+             */
+            struct ThreadProfile
+            {
+                SiteCounters sites[maxSites];
+
+                ThreadProfile()
+                {
+                    Registry &shared = registry();
+                    const std::lock_guard<std::mutex> lock{shared.mutex};
+                    shared.threads.push_back(this);
+                }
+
+                ThreadProfile(const ThreadProfile &) = delete;
+                auto operator=(const ThreadProfile &) -> ThreadProfile & = delete;
+
+                ~ThreadProfile()
+                {
+                    Registry &shared = registry();
+                    const std::lock_guard<std::mutex> lock{shared.mutex};
+                    for (std::size_t id = 0; id < maxSites; ++id)
+                    {
+                        shared.retired[id].calls += sites[id].calls.load(std::memory_order_relaxed);
+                        shared.retired[id].elements += sites[id].elements.load(std::memory_order_relaxed);
+                        shared.retired[id].nanoseconds += sites[id].nanoseconds.load(std::memory_order_relaxed);
+                    }
+                    for (std::size_t i = 0; i < shared.threads.size(); ++i)
+                    {
+                        if (shared.threads[i] == this)
+                        {
+                            shared.threads[i] = shared.threads.back();
+                            shared.threads.pop_back();
+                            break;
+                        }
+                    }
+                }
+            };
+
+            inline auto threadProfile() -> ThreadProfile &
+            {
+                thread_local ThreadProfile instance;
+                return instance;
+            }
+
+            ///< Counters have a single writer, so a relaxed load and store is enough and avoids a locked add
+            inline void bump(std::atomic<std::uint64_t> &counter, std::uint64_t amount) noexcept
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief The id of a zone name, the same for every site using an equal name, maxSites when all are taken
+             */
+            inline auto registerSite(const char *name) -> std::size_t
+            {
+                Registry &shared = registry();
+                const std::lock_guard<std::mutex> lock{shared.mutex};
+                for (std::size_t id = 0; id < shared.names.size(); ++id)
+                {
+                    if (std::strcmp(shared.names[id], name) == 0)
+                    {
+                        return id;
+                    }
+                }
+                if (shared.names.size() == maxSites)
+                {
+                    return maxSites;
+                }
+                shared.names.push_back(name);
+                return shared.names.size() - 1;
+            }
+
+            ///< Requires the registry mutex
+            inline auto totalsOf(const Registry &shared, std::size_t id) -> Totals
+            {
+                Totals totals = shared.retired[id];
+                for (const ThreadProfile *thread : shared.threads)
+                {
+                    totals.calls += thread->sites[id].calls.load(std::memory_order_relaxed);
+                    totals.elements += thread->sites[id].elements.load(std::memory_order_relaxed);
+                    totals.nanoseconds += thread->sites[id].nanoseconds.load(std::memory_order_relaxed);
+                }
+                return totals;
+            }
+        }
+
+        /**
+         * @brief A named place in the code that zones are counted under, created once per site by FZOLV_PROFILE_ZONE
+         *
+         * @param name A string that lives as long as the program, usually a literal
+         */
+        class Site
+        {
+        public:
+            explicit Site(const char *name) : label{name}, id{detail::registerSite(name)} {}
+
+            [[nodiscard]] auto name() const noexcept -> const char * { return label; }
+
+            [[nodiscard]] auto index() const noexcept -> std::size_t { return id; }
+
+        private:
+            const char *label;
+            std::size_t id;
+        };
+
+        /**
+         * @brief Times the scope it lives in and adds one call and its elements to the counters of its site
+         */
+        class Zone
+        {
+        public:
+            Zone(const Site &site, std::size_t elements) noexcept
+                : where{site}, hooks{detail::registry().hooks.load(std::memory_order_acquire)}
+            {
+                if (where.index() < maxSites)
+                {
+                    detail::SiteCounters &counters = detail::threadProfile().sites[where.index()];
+                    detail::bump(counters.calls, 1);
+                    detail::bump(counters.elements, elements);
+                }
+                if (hooks != nullptr && hooks->begin != nullptr)
+                {
+                    hooks->begin(where.name(), elements, hooks->user);
+                }
+                start = std::chrono::steady_clock::now();
+            }
+
+            Zone(const Zone &) = delete;
+            auto operator=(const Zone &) -> Zone & = delete;
+
+            ~Zone()
+            {
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                if (where.index() < maxSites)
+                {
+                    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+                    detail::bump(detail::threadProfile().sites[where.index()].nanoseconds,
+                                 static_cast<std::uint64_t>(nanoseconds));
+                }
+                if (hooks != nullptr && hooks->end != nullptr)
+                {
+                    hooks->end(where.name(), hooks->user);
+                }
+            }
+
+        private:
+            const Site &where;
+            const ZoneHooks *hooks;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        /**
+         * @brief Install callbacks around every zone, or remove them with nullptr
+         *
+         * Zones that already started keep the hooks they saw, so the object must stay alive until those have ended.
+         *
+         * @param hooks The callbacks, not copied
+         */
+        inline void setZoneHooks(const ZoneHooks *hooks) noexcept
+        {
+            detail::registry().hooks.store(hooks, std::memory_order_release);
+        }
+
+        /**
+         * @brief The totals of every zone entered since the last reset(), summed over live and exited threads
+         *
+         * Counters of threads that are inside a zone right now may lag behind by that zone.
+         *
+         * @return std::vector<KernelStats> One entry per zone name, in the order the names were first seen
+         */
+        inline auto snapshot() -> std::vector<KernelStats>
+        {
+            detail::Registry &shared = detail::registry();
+            const std::lock_guard<std::mutex> lock{shared.mutex};
+            std::vector<KernelStats> stats;
+            for (std::size_t id = 0; id < shared.names.size(); ++id)
+            {
+                const detail::Totals totals = detail::totalsOf(shared, id);
+                const detail::Totals &base = shared.baseline[id];
+                if (totals.calls > base.calls)
+                {
+                    stats.push_back({shared.names[id], totals.calls - base.calls, totals.elements - base.elements,
+                                     totals.nanoseconds - base.nanoseconds});
+                }
+            }
+            return stats;
+        }
+
+        /**
+         * @brief Start counting from zero, for example at the beginning of a frame
+         *
+         * The counters themselves keep running, reset() only moves the baseline snapshot() subtracts.
+         */
+        inline void reset()
+        {
+            detail::Registry &shared = detail::registry();
+            const std::lock_guard<std::mutex> lock{shared.mutex};
+            for (std::size_t id = 0; id < shared.names.size(); ++id)
+            {
+                shared.baseline[id] = detail::totalsOf(shared, id);
+            }
+        }
+    }
+}
+
+#define FZOLV_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FZOLV_PROFILE_CONCAT(a, b) FZOLV_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Count and time the rest of the enclosing scope under name, processing elements elements
+ *
+ * Expands to nothing unless FZOLV_PROFILING is set, in which case elements is not evaluated either.
+ */
+#if FZOLV_PROFILING
+#define FZOLV_PROFILE_ZONE(name, elements)                                                                               \
+    static const ::Fzolv::profile::Site FZOLV_PROFILE_CONCAT(fzolvProfileSite, __LINE__){name};                         \
+    const ::Fzolv::profile::Zone FZOLV_PROFILE_CONCAT(fzolvProfileZone, __LINE__)                                        \
+    {                                                                                                                    \
+        FZOLV_PROFILE_CONCAT(fzolvProfileSite, __LINE__), static_cast<std::size_t>(elements)                             \
+    }
+#else
+#define FZOLV_PROFILE_ZONE(name, elements) static_cast<void>(0)
+#endif
+
+#endif /* end of include guard: FZOLV_PROFILE_u101fx */
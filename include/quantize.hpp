@@ -0,0 +1,1162 @@
+#ifndef FZOLV_QUANTIZE_0mrhg0
+#define FZOLV_QUANTIZE_0mrhg0
+
+#include <aabb.hpp>
+#include <algorithm>
+#include <array>
+#include <batch.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <parallel.hpp>
+#include <quaternion.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        /**
+         * @brief Map a value to the nearest code, clamping to [0, maxCode] and sending NaNs to 0
+         *
+         * The comparisons are written like the SIMD max and min instructions, so every kernel gets the same code.
+         */
+        inline auto quantizeComponent(float value, float minimum, float scale, float maxCode) -> std::uint32_t
+        {
+            float t = (value - minimum) * scale + 0.5F;
+            t = t > 0.0F ? t : 0.0F;
+            t = t < maxCode ? t : maxCode;
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(t));
+        }
+
+        inline auto dequantizeComponent(std::uint32_t code, float minimum, float step) -> float
+        {
+            return minimum + static_cast<float>(static_cast<std::int32_t>(code)) * step;
+        }
+
+        ///< The widest codes quantizeComponent computes in float, wider ones lose too much of the code to rounding
+        constexpr unsigned floatQuantizeBits = 16;
+
+        ///< quantizeComponent and dequantizeComponent in double for codes wider than floatQuantizeBits
+        inline auto quantizeComponentWide(float value, float minimum, double scale, double maxCode) -> std::uint32_t
+        {
+            double t = (static_cast<double>(value) - static_cast<double>(minimum)) * scale + 0.5;
+            t = t > 0.0 ? t : 0.0;
+            t = t < maxCode ? t : maxCode;
+            return static_cast<std::uint32_t>(static_cast<std::int32_t>(t));
+        }
+
+        inline auto dequantizeComponentWide(std::uint32_t code, float minimum, double step) -> float
+        {
+            const double value = static_cast<double>(static_cast<std::int32_t>(code)) * step;
+            return static_cast<float>(static_cast<double>(minimum) + value);
+        }
+
+        ///< Smallest-three packs components in [-1/sqrt(2), 1/sqrt(2)], the largest one is rebuilt from the others
+        constexpr float smallestRange = 0.70710678118654752F;
+
+        /**
+         * @brief The bit layout of a smallest-three word for N components
+         *
+         * Quaternions keep three components of 10 bits under a 2 bit index and flip their sign so that the dropped
+         * component is positive. Unit vectors keep two components of 14 bits and store the sign of the dropped one.
+         */
+        template <std::size_t N>
+        struct SmallestLayout
+        {
+            static_assert(N == 3 || N == 4, "smallest-three encodes unit Vector3 and quaternions");
+            static constexpr unsigned bits = N == 4 ? 10U : 14U;
+            static constexpr std::uint32_t codeMask = (1U << bits) - 1U;
+            static constexpr float maxCode = static_cast<float>(codeMask);
+            static constexpr float scale = maxCode / (2.0F * smallestRange);
+            static constexpr float step = (2.0F * smallestRange) / maxCode;
+        };
+
+        template <std::size_t N>
+        inline auto encodeSmallest(const float *v) -> std::uint32_t
+        {
+            using L = SmallestLayout<N>;
+            std::uint32_t index = 0;
+            float largest = std::fabs(v[0]);
+            for (std::uint32_t k = 1; k < N; ++k)
+            {
+                if (std::fabs(v[k]) > largest)
+                {
+                    largest = std::fabs(v[k]);
+                    index = k;
+                }
+            }
+            const bool negative = v[index] < 0.0F;
+
+            std::uint32_t word = index << 30;
+            if constexpr (N == 3)
+            {
+                word |= static_cast<std::uint32_t>(negative) << 29;
+            }
+            for (std::size_t j = 0; j + 1 < N; ++j)
+            {
+                float c = v[j < index ? j : j + 1];
+                if constexpr (N == 4)
+                {
+                    c = negative ? -c : c;
+                }
+                word |= quantizeComponent(c, -smallestRange, L::scale, L::maxCode) << (L::bits * (N - 2 - j));
+            }
+            return word;
+        }
+
+        template <std::size_t N>
+        inline void decodeSmallest(std::uint32_t word, float *v)
+        {
+            using L = SmallestLayout<N>;
+            ///< Words for three components have no index 3, malformed ones decode as index 2 instead of reading past kept
+            const std::uint32_t index = std::min<std::uint32_t>(word >> 30, N - 1);
+            float kept[N - 1];
+            float sum = 0.0F;
+            for (std::size_t j = 0; j + 1 < N; ++j)
+            {
+                kept[j] = dequantizeComponent((word >> (L::bits * (N - 2 - j))) & L::codeMask, -smallestRange, L::step);
+                sum = j == 0 ? kept[j] * kept[j] : sum + kept[j] * kept[j];
+            }
+            float rest = 1.0F - sum;
+            rest = rest > 0.0F ? rest : 0.0F;
+            float largest = std::sqrt(rest);
+            if constexpr (N == 3)
+            {
+                largest = ((word >> 29) & 1U) != 0 ? -largest : largest;
+            }
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                v[k] = k < index ? kept[k] : (k == index ? largest : kept[k - 1]);
+            }
+        }
+    }
+
+    /**
+     * @brief Maps every component of Vector2f or Vector3f positions inside a box to an unsigned code of a few bits
+     *
+     * Codes are the nearest of 2^bits evenly spaced values from bounds.min to bounds.max, so decoding is off by at
+     * most half of step() per component, plus one float rounding of the decoded value. Codes of up to 16 bits are
+     * computed in float, which can pick the neighbouring code of values close to the middle of two and adds up to
+     * 2^(bits - 20) of a step to the bound, 1/16 at 16 bits. Wider codes are computed and decoded in double. Values
+     * outside the bounds clamp to the nearest edge and NaNs encode as the minimum. Each code takes (bits + 7) / 8
+     * little-endian bytes in the encoded stream, see batch::encode.
+     *
+     * @tparam V Vector2f or Vector3f
+     */
+    template <typename V>
+    class Quantizer
+    {
+        static_assert(std::is_same<V, Vector2f>::value || std::is_same<V, Vector3f>::value,
+                      "Quantizer encodes Vector2f and Vector3f");
+
+    public:
+        using vector_type = V;
+        using box_type = std::conditional_t<std::is_same<V, Vector2f>::value, AABB2f, AABB3f>;
+        using code_type = std::uint32_t;
+
+        static constexpr std::size_t components = std::is_same<V, Vector2f>::value ? 2 : 3;
+
+        /**
+         * @brief Create a quantizer for positions inside bounds
+         *
+         * @param bounds The box positions are expected in, a flat axis always decodes to its minimum
+         * @param bits The number of bits per component, from 1 to 24
+         */
+        Quantizer(const box_type &bounds, unsigned bits)
+            : box{bounds}, width{bits}, maximum{static_cast<float>((std::uint32_t{1} << bits) - 1U)}
+        {
+            assert(bits >= 1 && bits <= 24 && "bits must be between 1 and 24");
+            assert(!bounds.isEmpty() && "the bounds must not be empty");
+            const float *low = &bounds.min.x;
+            const float *high = &bounds.max.x;
+            for (std::size_t k = 0; k < components; ++k)
+            {
+                const float extent = high[k] - low[k];
+                minimums[k] = low[k];
+                scales[k] = extent > 0.0F ? maximum / extent : 0.0F;
+                steps[k] = extent > 0.0F ? extent / maximum : 0.0F;
+                wideScales[k] = extent > 0.0F ? static_cast<double>(maximum) / static_cast<double>(extent) : 0.0;
+                wideSteps[k] = extent > 0.0F ? static_cast<double>(extent) / static_cast<double>(maximum) : 0.0;
+            }
+        }
+
+        [[nodiscard]] auto bounds() const noexcept -> const box_type & { return box; }
+
+        [[nodiscard]] auto bits() const noexcept -> unsigned { return width; }
+
+        [[nodiscard]] auto maxCode() const noexcept -> code_type { return static_cast<code_type>(maximum); }
+
+        [[nodiscard]] auto bytesPerComponent() const noexcept -> std::size_t { return (width + 7) / 8; }
+
+        [[nodiscard]] auto bytesPerVector() const noexcept -> std::size_t { return bytesPerComponent() * components; }
+
+        /**
+         * @brief The number of bytes batch::encode writes for count vectors
+         */
+        [[nodiscard]] auto encodedSize(std::size_t count) const noexcept -> std::size_t { return count * bytesPerVector(); }
+
+        /**
+         * @brief The distance between two neighbouring codes of a component, index 0 for x
+         */
+        [[nodiscard]] auto step(std::size_t component) const noexcept -> float { return steps[component]; }
+
+        [[nodiscard]] auto scale(std::size_t component) const noexcept -> float { return scales[component]; }
+
+        [[nodiscard]] auto minimum(std::size_t component) const noexcept -> float { return minimums[component]; }
+
+        /**
+         * @brief Whether codes are computed in double, for widths above 16 bits, with wideStep() and wideScale()
+         */
+        [[nodiscard]] auto isWide() const noexcept -> bool { return width > detail::floatQuantizeBits; }
+
+        [[nodiscard]] auto wideStep(std::size_t component) const noexcept -> double { return wideSteps[component]; }
+
+        [[nodiscard]] auto wideScale(std::size_t component) const noexcept -> double { return wideScales[component]; }
+
+        /**
+         * @brief The codes of every component of a value
+         */
+        [[nodiscard]] auto encode(const V &value) const -> std::array<code_type, components>
+        {
+            std::array<code_type, components> codes{};
+            const float *v = &value.x;
+            for (std::size_t k = 0; k < components; ++k)
+            {
+                codes[k] = isWide() ? detail::quantizeComponentWide(v[k], minimums[k], wideScales[k], maximum)
+                                    : detail::quantizeComponent(v[k], minimums[k], scales[k], maximum);
+            }
+            return codes;
+        }
+
+        [[nodiscard]] auto decode(const std::array<code_type, components> &codes) const -> V
+        {
+            V value;
+            float *v = &value.x;
+            for (std::size_t k = 0; k < components; ++k)
+            {
+                v[k] = isWide() ? detail::dequantizeComponentWide(codes[k], minimums[k], wideSteps[k])
+                                : detail::dequantizeComponent(codes[k], minimums[k], steps[k]);
+            }
+            return value;
+        }
+
+        /**
+         * @brief The value a receiver decodes for value, decode(encode(value))
+         */
+        [[nodiscard]] auto quantized(const V &value) const -> V { return decode(encode(value)); }
+
+    private:
+        box_type box;
+        unsigned width;
+        float maximum;
+        float minimums[components];
+        float scales[components];
+        float steps[components];
+        double wideScales[components];
+        double wideSteps[components];
+    };
+
+    using Quantizer2f = Quantizer<Vector2f>;
+    using Quantizer3f = Quantizer<Vector3f>;
+
+    /**
+     * @brief Pack a unit quaternion into 32 bits with the smallest-three encoding
+     *
+     * The largest component is dropped and the others are stored with 10 bits each, which keeps every component within
+     * 2e-3 of the original. q and -q are the same rotation, decoding may return either.
+     */
+    inline auto encodeRotation(const Quaternionf &rotation) -> std::uint32_t
+    {
+        const float v[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+        return detail::encodeSmallest<4>(v);
+    }
+
+    inline auto decodeRotation(std::uint32_t word) -> Quaternionf
+    {
+        float v[4];
+        detail::decodeSmallest<4>(word, v);
+        return {v[0], v[1], v[2], v[3]};
+    }
+
+    /**
+     * @brief Pack a unit Vector3f into 32 bits, the two smallest components with 14 bits each, within 1e-4 per component
+     *
+     * Decoding accepts any word. The two index bits of a malformed word can say 3, which is decoded as 2, so untrusted
+     * data gives the same finite result on every level, as long as multiply-adds are not fused, see simd.hpp.
+     */
+    inline auto encodeUnitVector(const Vector3f &direction) -> std::uint32_t
+    {
+        return detail::encodeSmallest<3>(&direction.x);
+    }
+
+    inline auto decodeUnitVector(std::uint32_t word) -> Vector3f
+    {
+        Vector3f v;
+        detail::decodeSmallest<3>(word, &v.x);
+        return v;
+    }
+
+    namespace batch
+    {
+        namespace detail
+        {
+            /**
+             * @brief The per-component constants of a quantizer repeated over 12 lanes, a multiple of 2, 3 and 4
+             *
+             * A run of floats starting at a vector boundary reads the constants of float i from lane i % 12.
+             */
+            struct QuantizeLanes
+            {
+                float minimum[12];
+                float scale[12];
+                float step[12];
+                double wideScale[12];
+                double wideStep[12];
+                float maxCode;
+                bool wide;
+            };
+
+            template <typename V>
+            auto lanesOf(const Quantizer<V> &quantizer) -> QuantizeLanes
+            {
+                QuantizeLanes lanes{};
+                for (std::size_t i = 0; i < 12; ++i)
+                {
+                    const std::size_t k = i % Quantizer<V>::components;
+                    lanes.minimum[i] = quantizer.minimum(k);
+                    lanes.scale[i] = quantizer.scale(k);
+                    lanes.step[i] = quantizer.step(k);
+                    lanes.wideScale[i] = quantizer.wideScale(k);
+                    lanes.wideStep[i] = quantizer.wideStep(k);
+                }
+                lanes.maxCode = static_cast<float>(quantizer.maxCode());
+                lanes.wide = quantizer.isWide();
+                return lanes;
+            }
+
+            namespace scalar
+            {
+                inline void quantize(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::quantizeComponent(in[i], lanes.minimum[i % 12], lanes.scale[i % 12],
+                                                                  lanes.maxCode);
+                    }
+                }
+
+                inline void dequantize(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::dequantizeComponent(in[i], lanes.minimum[i % 12], lanes.step[i % 12]);
+                    }
+                }
+
+                inline void quantizeWide(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::quantizeComponentWide(in[i], lanes.minimum[i % 12], lanes.wideScale[i % 12],
+                                                                      lanes.maxCode);
+                    }
+                }
+
+                inline void dequantizeWide(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Fzolv::detail::dequantizeComponentWide(in[i], lanes.minimum[i % 12], lanes.wideStep[i % 12]);
+                    }
+                }
+
+                inline void encodeRotations(const Quaternionf *in, std::uint32_t *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = encodeRotation(in[i]);
+                    }
+                }
+
+                inline void decodeRotations(const std::uint32_t *in, Quaternionf *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = decodeRotation(in[i]);
+                    }
+                }
+
+                inline void encodeUnitVectors(const Vector3f *in, std::uint32_t *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = encodeUnitVector(in[i]);
+                    }
+                }
+
+                inline void decodeUnitVectors(const std::uint32_t *in, Vector3f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = decodeUnitVector(in[i]);
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                ///< quantizeComponent on four lanes, max and min return their second operand for NaNs like the scalar code
+                inline auto quantize4(__m128 value, __m128 minimum, __m128 scale, __m128 maxCode) -> __m128i
+                {
+                    __m128 t = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(value, minimum), scale), _mm_set1_ps(0.5F));
+                    t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), maxCode);
+                    return _mm_cvttps_epi32(t);
+                }
+
+                inline auto dequantize4(__m128i code, __m128 minimum, __m128 step) -> __m128
+                {
+                    return _mm_add_ps(minimum, _mm_mul_ps(_mm_cvtepi32_ps(code), step));
+                }
+
+                inline void quantize(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    const __m128 maxCode = _mm_set1_ps(lanes.maxCode);
+                    __m128 minimum[3], scale[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        minimum[k] = _mm_loadu_ps(lanes.minimum + 4 * k);
+                        scale[k] = _mm_loadu_ps(lanes.scale + 4 * k);
+                    }
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const __m128i codes = quantize4(_mm_loadu_ps(in + i + 4 * k), minimum[k], scale[k], maxCode);
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4 * k), codes);
+                        }
+                    }
+                    scalar::quantize(in + i, out + i, count - i, lanes);
+                }
+
+                inline void dequantize(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    __m128 minimum[3], step[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        minimum[k] = _mm_loadu_ps(lanes.minimum + 4 * k);
+                        step[k] = _mm_loadu_ps(lanes.step + 4 * k);
+                    }
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4 * k));
+                            _mm_storeu_ps(out + i + 4 * k, dequantize4(codes, minimum[k], step[k]));
+                        }
+                    }
+                    scalar::dequantize(in + i, out + i, count - i, lanes);
+                }
+
+                ///< quantizeComponentWide on four lanes, as two registers of doubles
+                inline auto quantizeWide4(__m128 value, __m128 minimum, const double *scale, __m128d maxCode) -> __m128i
+                {
+                    __m128i codes[2];
+                    for (int h = 0; h < 2; ++h)
+                    {
+                        const __m128d v = _mm_cvtps_pd(h == 0 ? value : _mm_movehl_ps(value, value));
+                        const __m128d m = _mm_cvtps_pd(h == 0 ? minimum : _mm_movehl_ps(minimum, minimum));
+                        __m128d t = _mm_add_pd(_mm_mul_pd(_mm_sub_pd(v, m), _mm_loadu_pd(scale + 2 * h)), _mm_set1_pd(0.5));
+                        t = _mm_min_pd(_mm_max_pd(t, _mm_setzero_pd()), maxCode);
+                        codes[h] = _mm_cvttpd_epi32(t);
+                    }
+                    return _mm_unpacklo_epi64(codes[0], codes[1]);
+                }
+
+                inline auto dequantizeWide4(__m128i code, __m128 minimum, const double *step) -> __m128
+                {
+                    __m128 values[2];
+                    for (int h = 0; h < 2; ++h)
+                    {
+                        const __m128d m = _mm_cvtps_pd(h == 0 ? minimum : _mm_movehl_ps(minimum, minimum));
+                        const __m128d c = _mm_cvtepi32_pd(h == 0 ? code : _mm_unpackhi_epi64(code, code));
+                        values[h] = _mm_cvtpd_ps(_mm_add_pd(m, _mm_mul_pd(c, _mm_loadu_pd(step + 2 * h))));
+                    }
+                    return _mm_movelh_ps(values[0], values[1]);
+                }
+
+                inline void quantizeWide(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    const __m128d maxCode = _mm_set1_pd(lanes.maxCode);
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const __m128 value = _mm_loadu_ps(in + i + 4 * k);
+                            const __m128 minimum = _mm_loadu_ps(lanes.minimum + 4 * k);
+                            const __m128i codes = quantizeWide4(value, minimum, lanes.wideScale + 4 * k, maxCode);
+                            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4 * k), codes);
+                        }
+                    }
+                    scalar::quantizeWide(in + i, out + i, count - i, lanes);
+                }
+
+                inline void dequantizeWide(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4 * k));
+                            const __m128 minimum = _mm_loadu_ps(lanes.minimum + 4 * k);
+                            _mm_storeu_ps(out + i + 4 * k, dequantizeWide4(codes, minimum, lanes.wideStep + 4 * k));
+                        }
+                    }
+                    scalar::dequantizeWide(in + i, out + i, count - i, lanes);
+                }
+
+                ///< The index of the component with the largest magnitude, the first one on ties like encodeSmallest
+                template <std::size_t N>
+                inline auto largestIndex(const __m128 (&v)[N]) -> __m128i
+                {
+                    const __m128 abs = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+                    __m128 largest = _mm_and_ps(v[0], abs);
+                    __m128i index = _mm_setzero_si128();
+                    for (std::size_t k = 1; k < N; ++k)
+                    {
+                        const __m128 magnitude = _mm_and_ps(v[k], abs);
+                        const __m128 greater = _mm_cmpgt_ps(magnitude, largest);
+                        largest = select(greater, magnitude, largest);
+                        index = select(_mm_castps_si128(greater), _mm_set1_epi32(static_cast<int>(k)), index);
+                    }
+                    return index;
+                }
+
+                /**
+                 * @brief encodeSmallest on four lanes: v[j < index ? j : j + 1] becomes a chain of selects
+                 */
+                template <std::size_t N>
+                inline auto encodeSmallest4(const __m128 (&v)[N]) -> __m128i
+                {
+                    using L = Fzolv::detail::SmallestLayout<N>;
+                    const __m128i index = largestIndex(v);
+                    __m128 below[N]; ///< below[k] is set in lanes whose index is at most k
+                    __m128 equal[N];
+                    for (std::size_t k = 0; k < N; ++k)
+                    {
+                        equal[k] = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(static_cast<int>(k))));
+                        below[k] = k == 0 ? equal[0] : _mm_or_ps(below[k - 1], equal[k]);
+                    }
+                    __m128 largest = v[N - 1];
+                    for (std::size_t k = N - 1; k-- > 0;)
+                    {
+                        largest = select(equal[k], v[k], largest);
+                    }
+                    const __m128 negative = _mm_cmplt_ps(largest, _mm_setzero_ps());
+
+                    __m128i word = _mm_slli_epi32(index, 30);
+                    if constexpr (N == 3)
+                    {
+                        word = _mm_or_si128(word, _mm_slli_epi32(_mm_srli_epi32(_mm_castps_si128(negative), 31), 29));
+                    }
+                    const __m128 flip = N == 4 ? _mm_and_ps(negative, _mm_set1_ps(-0.0F)) : _mm_setzero_ps();
+                    const __m128 minimum = _mm_set1_ps(-Fzolv::detail::smallestRange);
+                    const __m128 scale = _mm_set1_ps(L::scale);
+                    const __m128 maxCode = _mm_set1_ps(L::maxCode);
+                    for (std::size_t j = 0; j + 1 < N; ++j)
+                    {
+                        const __m128 c = _mm_xor_ps(select(below[j], v[j + 1], v[j]), flip);
+                        const __m128i code = quantize4(c, minimum, scale, maxCode);
+                        word = _mm_or_si128(word, _mm_sll_epi32(code, _mm_cvtsi32_si128(static_cast<int>(L::bits * (N - 2 - j)))));
+                    }
+                    return word;
+                }
+
+                template <std::size_t N>
+                inline void decodeSmallest4(__m128i word, __m128 (&v)[N])
+                {
+                    using L = Fzolv::detail::SmallestLayout<N>;
+                    __m128i index = _mm_srli_epi32(word, 30);
+                    if constexpr (N == 3)
+                    {
+                        ///< Clamp index 3 to 2 like the scalar decode, subtracting one where the compare is all ones
+                        index = _mm_add_epi32(index, _mm_cmpgt_epi32(index, _mm_set1_epi32(2)));
+                    }
+                    const __m128 minimum = _mm_set1_ps(-Fzolv::detail::smallestRange);
+                    const __m128 step = _mm_set1_ps(L::step);
+                    const __m128i mask = _mm_set1_epi32(static_cast<int>(L::codeMask));
+                    __m128 kept[N - 1];
+                    __m128 sum = _mm_setzero_ps();
+                    for (std::size_t j = 0; j + 1 < N; ++j)
+                    {
+                        const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(L::bits * (N - 2 - j)));
+                        kept[j] = dequantize4(_mm_and_si128(_mm_srl_epi32(word, shift), mask), minimum, step);
+                        const __m128 square = _mm_mul_ps(kept[j], kept[j]);
+                        sum = j == 0 ? square : _mm_add_ps(sum, square);
+                    }
+                    __m128 largest = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0F), sum), _mm_setzero_ps()));
+                    if constexpr (N == 3)
+                    {
+                        const __m128i sign = _mm_slli_epi32(_mm_srli_epi32(word, 29), 31);
+                        largest = _mm_xor_ps(largest, _mm_castsi128_ps(sign));
+                    }
+                    for (std::size_t k = 0; k < N; ++k)
+                    {
+                        const __m128 equal = _mm_castsi128_ps(_mm_cmpeq_epi32(index, _mm_set1_epi32(static_cast<int>(k))));
+                        const __m128 after = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_set1_epi32(static_cast<int>(k)), index));
+                        ///< Both neighbours are read with clamped indices and the masks pick one, after is never set
+                        ///< for k == 0 and equal covers the last output whenever after is not set
+                        const __m128 previous = kept[k > 0 ? k - 1 : 0];
+                        const __m128 current = kept[k < N - 1 ? k : N - 2];
+                        v[k] = select(equal, largest, select(after, previous, current));
+                    }
+                }
+
+                inline void encodeRotations(const Quaternionf *in, std::uint32_t *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 v[4];
+                        load4(in + i, v[0], v[1], v[2], v[3]);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), encodeSmallest4(v));
+                    }
+                    scalar::encodeRotations(in + i, out + i, count - i);
+                }
+
+                inline void decodeRotations(const std::uint32_t *in, Quaternionf *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 v[4];
+                        decodeSmallest4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), v);
+                        store4(out + i, v[0], v[1], v[2], v[3]);
+                    }
+                    scalar::decodeRotations(in + i, out + i, count - i);
+                }
+
+                inline void encodeUnitVectors(const Vector3f *in, std::uint32_t *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 v[3];
+                        load4(in + i, v[0], v[1], v[2]);
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), encodeSmallest4(v));
+                    }
+                    scalar::encodeUnitVectors(in + i, out + i, count - i);
+                }
+
+                inline void decodeUnitVectors(const std::uint32_t *in, Vector3f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 v[3];
+                        decodeSmallest4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), v);
+                        store4(out + i, v[0], v[1], v[2]);
+                    }
+                    scalar::decodeUnitVectors(in + i, out + i, count - i);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                ///< Encoding is bound by the packing of the codes, the SSE2 kernels keep up with it
+                using sse2::decodeRotations;
+                using sse2::decodeUnitVectors;
+                using sse2::dequantize;
+                using sse2::dequantizeWide;
+                using sse2::encodeRotations;
+                using sse2::encodeUnitVectors;
+                using sse2::quantize;
+                using sse2::quantizeWide;
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                inline void quantize(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    const float32x4_t half = vdupq_n_f32(0.5F);
+                    const float32x4_t maxCode = vdupq_n_f32(lanes.maxCode);
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const float32x4_t minimum = vld1q_f32(lanes.minimum + 4 * k);
+                            const float32x4_t scale = vld1q_f32(lanes.scale + 4 * k);
+                            float32x4_t t = vaddq_f32(vmulq_f32(vsubq_f32(vld1q_f32(in + i + 4 * k), minimum), scale), half);
+                            ///< Selects instead of vmaxq and vminq, which return NaN instead of the second operand
+                            t = vbslq_f32(vcgtq_f32(t, zero), t, zero);
+                            t = vbslq_f32(vcltq_f32(t, maxCode), t, maxCode);
+                            vst1q_u32(out + i + 4 * k, vreinterpretq_u32_s32(vcvtq_s32_f32(t)));
+                        }
+                    }
+                    scalar::quantize(in + i, out + i, count - i, lanes);
+                }
+
+                inline void dequantize(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const float32x4_t code = vcvtq_f32_s32(vreinterpretq_s32_u32(vld1q_u32(in + i + 4 * k)));
+                            const float32x4_t minimum = vld1q_f32(lanes.minimum + 4 * k);
+                            vst1q_f32(out + i + 4 * k, vaddq_f32(minimum, vmulq_f32(code, vld1q_f32(lanes.step + 4 * k))));
+                        }
+                    }
+                    scalar::dequantize(in + i, out + i, count - i, lanes);
+                }
+
+                inline void quantizeWide(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    const float64x2_t zero = vdupq_n_f64(0.0);
+                    const float64x2_t half = vdupq_n_f64(0.5);
+                    const float64x2_t maxCode = vdupq_n_f64(lanes.maxCode);
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const float32x4_t value = vld1q_f32(in + i + 4 * k);
+                            const float32x4_t minimum = vld1q_f32(lanes.minimum + 4 * k);
+                            float64x2_t t[2] = {
+                                vsubq_f64(vcvt_f64_f32(vget_low_f32(value)), vcvt_f64_f32(vget_low_f32(minimum))),
+                                vsubq_f64(vcvt_high_f64_f32(value), vcvt_high_f64_f32(minimum))};
+                            for (int h = 0; h < 2; ++h)
+                            {
+                                t[h] = vaddq_f64(vmulq_f64(t[h], vld1q_f64(lanes.wideScale + 4 * k + 2 * h)), half);
+                                t[h] = vbslq_f64(vcgtq_f64(t[h], zero), t[h], zero);
+                                t[h] = vbslq_f64(vcltq_f64(t[h], maxCode), t[h], maxCode);
+                            }
+                            const int32x2_t low = vmovn_s64(vcvtq_s64_f64(t[0]));
+                            const int32x2_t high = vmovn_s64(vcvtq_s64_f64(t[1]));
+                            vst1q_u32(out + i + 4 * k, vreinterpretq_u32_s32(vcombine_s32(low, high)));
+                        }
+                    }
+                    scalar::quantizeWide(in + i, out + i, count - i, lanes);
+                }
+
+                inline void dequantizeWide(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    std::size_t i = 0;
+                    for (; i + 12 <= count; i += 12)
+                    {
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            const int32x4_t code = vreinterpretq_s32_u32(vld1q_u32(in + i + 4 * k));
+                            const float32x4_t minimum = vld1q_f32(lanes.minimum + 4 * k);
+                            const float64x2_t low = vaddq_f64(vcvt_f64_f32(vget_low_f32(minimum)),
+                                                              vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(code))),
+                                                                        vld1q_f64(lanes.wideStep + 4 * k)));
+                            const float64x2_t high = vaddq_f64(vcvt_high_f64_f32(minimum),
+                                                               vmulq_f64(vcvtq_f64_s64(vmovl_high_s32(code)),
+                                                                         vld1q_f64(lanes.wideStep + 4 * k + 2)));
+                            vst1q_f32(out + i + 4 * k, vcvt_high_f32_f64(vcvt_f32_f64(low), high));
+                        }
+                    }
+                    scalar::dequantizeWide(in + i, out + i, count - i, lanes);
+                }
+
+                using scalar::decodeRotations;
+                using scalar::decodeUnitVectors;
+                using scalar::encodeRotations;
+                using scalar::encodeUnitVectors;
+            }
+#endif
+
+            namespace best
+            {
+                inline void quantize(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    FZOLV_DISPATCH(quantize, (in, out, count, lanes))
+                }
+
+                inline void dequantize(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    FZOLV_DISPATCH(dequantize, (in, out, count, lanes))
+                }
+
+                inline void quantizeWide(const float *in, std::uint32_t *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    FZOLV_DISPATCH(quantizeWide, (in, out, count, lanes))
+                }
+
+                inline void dequantizeWide(const std::uint32_t *in, float *out, std::size_t count, const QuantizeLanes &lanes)
+                {
+                    FZOLV_DISPATCH(dequantizeWide, (in, out, count, lanes))
+                }
+
+                inline void encodeRotations(const Quaternionf *in, std::uint32_t *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(encodeRotations, (in, out, count))
+                }
+
+                inline void decodeRotations(const std::uint32_t *in, Quaternionf *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(decodeRotations, (in, out, count))
+                }
+
+                inline void encodeUnitVectors(const Vector3f *in, std::uint32_t *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(encodeUnitVectors, (in, out, count))
+                }
+
+                inline void decodeUnitVectors(const std::uint32_t *in, Vector3f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(decodeUnitVectors, (in, out, count))
+                }
+            }
+
+            ///< Floats per pass through the stack buffer of codes, a multiple of the 12 lanes
+            constexpr std::size_t codeChunk = 240;
+
+            inline void packCodes(const std::uint32_t *codes, std::uint8_t *out, std::size_t count, std::size_t width)
+            {
+                switch (width)
+                {
+                case 1:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = static_cast<std::uint8_t>(codes[i]);
+                    }
+                    break;
+                case 2:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[2 * i] = static_cast<std::uint8_t>(codes[i]);
+                        out[2 * i + 1] = static_cast<std::uint8_t>(codes[i] >> 8);
+                    }
+                    break;
+                default:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[3 * i] = static_cast<std::uint8_t>(codes[i]);
+                        out[3 * i + 1] = static_cast<std::uint8_t>(codes[i] >> 8);
+                        out[3 * i + 2] = static_cast<std::uint8_t>(codes[i] >> 16);
+                    }
+                    break;
+                }
+            }
+
+            inline auto readCode(const std::uint8_t *in, std::size_t width) -> std::uint32_t
+            {
+                std::uint32_t code = 0;
+                for (std::size_t b = 0; b < width; ++b)
+                {
+                    code |= static_cast<std::uint32_t>(in[b]) << (8 * b);
+                }
+                return code;
+            }
+
+            inline void unpackCodes(const std::uint8_t *in, std::uint32_t *codes, std::size_t count, std::size_t width)
+            {
+                switch (width)
+                {
+                case 1:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        codes[i] = in[i];
+                    }
+                    break;
+                case 2:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        codes[i] = static_cast<std::uint32_t>(in[2 * i]) | (static_cast<std::uint32_t>(in[2 * i + 1]) << 8);
+                    }
+                    break;
+                default:
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        codes[i] = readCode(in + 3 * i, 3);
+                    }
+                    break;
+                }
+            }
+
+            ///< The number of bytes of a LEB128 varint for a zigzag delta of 25 bits
+            constexpr std::size_t maxVarintSize = 4;
+        }
+
+        /**
+         * @brief Quantize every vector and write the codes as a packed little-endian stream
+         *
+         * The arithmetic runs on SIMD lanes, and large spans split across threads. Nothing is allocated.
+         *
+         * @param quantizer The bounds and precision of the encoding
+         * @param in The vectors to encode
+         * @param out Receives the stream, must hold at least quantizer.encodedSize(in.size()) bytes
+         * @return std::size_t The number of bytes written, quantizer.encodedSize(in.size())
+         */
+        template <typename V>
+        auto encode(const Quantizer<V> &quantizer, span<const V> in, span<std::uint8_t> out) -> std::size_t
+        {
+            assert(out.size() >= quantizer.encodedSize(in.size()));
+            const detail::QuantizeLanes lanes = detail::lanesOf(quantizer);
+            const std::size_t components = Quantizer<V>::components;
+            const std::size_t width = quantizer.bytesPerComponent();
+            parallelFor(in.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            const float *values = reinterpret_cast<const float *>(in.data()) + begin * components;
+                            std::uint8_t *bytes = out.data() + begin * components * width;
+                            const std::size_t floats = (end - begin) * components;
+                            std::uint32_t codes[detail::codeChunk];
+                            for (std::size_t i = 0; i < floats; i += detail::codeChunk)
+                            {
+                                const std::size_t n = std::min(detail::codeChunk, floats - i);
+                                if (lanes.wide)
+                                {
+                                    detail::best::quantizeWide(values + i, codes, n, lanes);
+                                }
+                                else
+                                {
+                                    detail::best::quantize(values + i, codes, n, lanes);
+                                }
+                                detail::packCodes(codes, bytes + i * width, n, width);
+                            }
+                        });
+            return quantizer.encodedSize(in.size());
+        }
+
+        /**
+         * @brief Decode a stream written by encode with the same quantizer
+         *
+         * @param quantizer The quantizer used to encode
+         * @param in The stream, must hold at least quantizer.encodedSize(out.size()) bytes
+         * @param out Receives the decoded vectors
+         */
+        template <typename V>
+        void decode(const Quantizer<V> &quantizer, span<const std::uint8_t> in, span<V> out)
+        {
+            assert(in.size() >= quantizer.encodedSize(out.size()));
+            const detail::QuantizeLanes lanes = detail::lanesOf(quantizer);
+            const std::size_t components = Quantizer<V>::components;
+            const std::size_t width = quantizer.bytesPerComponent();
+            parallelFor(out.size(), detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            float *values = reinterpret_cast<float *>(out.data()) + begin * components;
+                            const std::uint8_t *bytes = in.data() + begin * components * width;
+                            const std::size_t floats = (end - begin) * components;
+                            std::uint32_t codes[detail::codeChunk];
+                            for (std::size_t i = 0; i < floats; i += detail::codeChunk)
+                            {
+                                const std::size_t n = std::min(detail::codeChunk, floats - i);
+                                detail::unpackCodes(bytes + i * width, codes, n, width);
+                                if (lanes.wide)
+                                {
+                                    detail::best::dequantizeWide(codes, values + i, n, lanes);
+                                }
+                                else
+                                {
+                                    detail::best::dequantize(codes, values + i, n, lanes);
+                                }
+                            }
+                        });
+        }
+
+        /**
+         * @brief The largest number of bytes encodeDelta writes for count vectors
+         */
+        template <typename V>
+        auto maxDeltaSize(const Quantizer<V> &, std::size_t count) -> std::size_t
+        {
+            return (count + 7) / 8 + count * Quantizer<V>::components * detail::maxVarintSize;
+        }
+
+        /**
+         * @brief Encode a snapshot as the difference to a baseline snapshot both sides already have
+         *
+         * The output starts with one bit per vector, set when it changed, followed by the changed codes as zigzag
+         * LEB128 varints of their difference to the baseline codes. Vectors at rest cost one bit and small movements
+         * one byte per component, and decoding reproduces current exactly.
+         *
+         * @param quantizer The quantizer both snapshots were encoded with
+         * @param baseline The encoded baseline snapshot
+         * @param current The encoded snapshot to send, the same size as baseline
+         * @param out Receives the delta, must hold at least maxDeltaSize() bytes
+         * @return std::size_t The number of bytes written
+         */
+        template <typename V>
+        auto encodeDelta(const Quantizer<V> &quantizer, span<const std::uint8_t> baseline, span<const std::uint8_t> current,
+                         span<std::uint8_t> out) -> std::size_t
+        {
+            assert(baseline.size() == current.size() && current.size() % quantizer.bytesPerVector() == 0);
+            const std::size_t stride = quantizer.bytesPerVector();
+            const std::size_t width = quantizer.bytesPerComponent();
+            const std::size_t count = current.size() / stride;
+            assert(out.size() >= maxDeltaSize(quantizer, count));
+
+            const std::size_t maskBytes = (count + 7) / 8;
+            std::memset(out.data(), 0, maskBytes);
+            std::size_t position = maskBytes;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::uint8_t *a = baseline.data() + i * stride;
+                const std::uint8_t *b = current.data() + i * stride;
+                if (std::memcmp(a, b, stride) == 0)
+                {
+                    continue;
+                }
+                out[i / 8] = static_cast<std::uint8_t>(out[i / 8] | (1U << (i % 8)));
+                for (std::size_t k = 0; k < Quantizer<V>::components; ++k)
+                {
+                    const auto delta = static_cast<std::int32_t>(detail::readCode(b + k * width, width)) -
+                                       static_cast<std::int32_t>(detail::readCode(a + k * width, width));
+                    std::uint32_t zigzag = (static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31);
+                    while (zigzag >= 0x80U)
+                    {
+                        out[position++] = static_cast<std::uint8_t>(zigzag | 0x80U);
+                        zigzag >>= 7;
+                    }
+                    out[position++] = static_cast<std::uint8_t>(zigzag);
+                }
+            }
+            return position;
+        }
+
+        /**
+         * @brief Rebuild the encoded snapshot that encodeDelta compared against baseline
+         *
+         * The input is checked, so a truncated or corrupted delta never reads or writes out of bounds.
+         *
+         * @param quantizer The quantizer of both snapshots
+         * @param baseline The encoded baseline snapshot
+         * @param delta The output of encodeDelta
+         * @param current Receives the encoded snapshot, the same size as baseline, pass it to decode afterwards
+         * @return std::size_t The number of bytes of delta consumed, 0 if delta is malformed
+         */
+        template <typename V>
+        auto decodeDelta(const Quantizer<V> &quantizer, span<const std::uint8_t> baseline, span<const std::uint8_t> delta,
+                         span<std::uint8_t> current) -> std::size_t
+        {
+            assert(baseline.size() == current.size() && current.size() % quantizer.bytesPerVector() == 0);
+            const std::size_t stride = quantizer.bytesPerVector();
+            const std::size_t width = quantizer.bytesPerComponent();
+            const std::size_t count = current.size() / stride;
+            const std::size_t maskBytes = (count + 7) / 8;
+            if (delta.size() < maskBytes)
+            {
+                return 0;
+            }
+
+            std::size_t position = maskBytes;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const std::uint8_t *a = baseline.data() + i * stride;
+                std::uint8_t *b = current.data() + i * stride;
+                if ((delta[i / 8] & (1U << (i % 8))) == 0)
+                {
+                    std::memcpy(b, a, stride);
+                    continue;
+                }
+                for (std::size_t k = 0; k < Quantizer<V>::components; ++k)
+                {
+                    std::uint32_t zigzag = 0;
+                    for (unsigned shift = 0;; shift += 7)
+                    {
+                        if (position == delta.size() || shift >= 7 * detail::maxVarintSize)
+                        {
+                            return 0;
+                        }
+                        const std::uint8_t byte = delta[position++];
+                        zigzag |= static_cast<std::uint32_t>(byte & 0x7FU) << shift;
+                        if ((byte & 0x80U) == 0)
+                        {
+                            break;
+                        }
+                    }
+                    const auto difference = static_cast<std::int32_t>((zigzag >> 1) ^ (0U - (zigzag & 1U)));
+                    const std::int64_t code = static_cast<std::int64_t>(detail::readCode(a + k * width, width)) + difference;
+                    if (code < 0 || code > static_cast<std::int64_t>(quantizer.maxCode()))
+                    {
+                        return 0;
+                    }
+                    for (std::size_t byte = 0; byte < width; ++byte)
+                    {
+                        b[k * width + byte] = static_cast<std::uint8_t>(static_cast<std::uint32_t>(code) >> (8 * byte));
+                    }
+                }
+            }
+            return position;
+        }
+
+        /**
+         * @brief Pack every rotation with encodeRotation, out[i] = encodeRotation(in[i])
+         */
+        inline void encodeRotations(span<const Quaternionf> in, span<std::uint32_t> out)
+        {
+            assert(in.size() == out.size());
+            parallelFor(in.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                        { detail::best::encodeRotations(in.data() + begin, out.data() + begin, end - begin); });
+        }
+
+        inline void decodeRotations(span<const std::uint32_t> in, span<Quaternionf> out)
+        {
+            assert(in.size() == out.size());
+            parallelFor(in.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                        { detail::best::decodeRotations(in.data() + begin, out.data() + begin, end - begin); });
+        }
+
+        /**
+         * @brief Pack every unit vector with encodeUnitVector, out[i] = encodeUnitVector(in[i])
+         */
+        inline void encodeUnitVectors(span<const Vector3f> in, span<std::uint32_t> out)
+        {
+            assert(in.size() == out.size());
+            parallelFor(in.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                        { detail::best::encodeUnitVectors(in.data() + begin, out.data() + begin, end - begin); });
+        }
+
+        inline void decodeUnitVectors(span<const std::uint32_t> in, span<Vector3f> out)
+        {
+            assert(in.size() == out.size());
+            parallelFor(in.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                        { detail::best::decodeUnitVectors(in.data() + begin, out.data() + begin, end - begin); });
+        }
+
+        ///< Non-template overloads so that containers convert to spans implicitly
+
+        inline auto encode(const Quantizer2f &quantizer, span<const Vector2f> in, span<std::uint8_t> out) -> std::size_t
+        {
+            return encode<Vector2f>(quantizer, in, out);
+        }
+
+        inline auto encode(const Quantizer3f &quantizer, span<const Vector3f> in, span<std::uint8_t> out) -> std::size_t
+        {
+            return encode<Vector3f>(quantizer, in, out);
+        }
+
+        inline void decode(const Quantizer2f &quantizer, span<const std::uint8_t> in, span<Vector2f> out)
+        {
+            decode<Vector2f>(quantizer, in, out);
+        }
+
+        inline void decode(const Quantizer3f &quantizer, span<const std::uint8_t> in, span<Vector3f> out)
+        {
+            decode<Vector3f>(quantizer, in, out);
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_QUANTIZE_0mrhg0 */
@@ -0,0 +1,783 @@
+#ifndef FZOLV_QUATERNION_2x80s5
+#define FZOLV_QUATERNION_2x80s5
+
+#include <batch.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <math.hpp>
+#include <matrix.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        /**
+         * @brief The coefficients of the polynomial slerp of Eberly, "A Fast and Accurate Algorithm for Computing SLERP"
+         *
+         * sin(t * theta) / sin(theta) is expanded as a series in cos(theta) - 1 with u[i] = 1 / ((i + 1) (2i + 3)) and
+         * v[i] = (i + 1) / (2i + 3). The last pair is scaled by a correction factor that compensates for the truncated
+         * terms, fitted here for 12 terms to a maximum error of 7.2e-7 over the whole range of angles.
+         */
+        template <typename T>
+        struct SlerpSeries
+        {
+            static constexpr int terms = 12;
+            T u[terms];
+            T v[terms];
+        };
+
+        template <typename T>
+        constexpr auto makeSlerpSeries() -> SlerpSeries<T>
+        {
+            constexpr T correction = T(1.8937671012477315);
+            SlerpSeries<T> series{};
+            for (int i = 0; i < SlerpSeries<T>::terms; ++i)
+            {
+                series.u[i] = T(1) / (T(i + 1) * T(2 * i + 3));
+                series.v[i] = T(i + 1) / T(2 * i + 3);
+            }
+            series.u[SlerpSeries<T>::terms - 1] *= correction;
+            series.v[SlerpSeries<T>::terms - 1] *= correction;
+            return series;
+        }
+
+        template <typename T>
+        inline constexpr SlerpSeries<T> slerpSeries = makeSlerpSeries<T>();
+    }
+
+    /**
+     * @brief A quaternion x*i + y*j + z*k + w, used as a rotation when it has unit length
+     *
+     * Products compose rotations right to left like matrices: (a * b).rotate(v) equals a.rotate(b.rotate(v)).
+     * Interpolation always takes the shortest path, negating the end rotation when the two are more than half a turn
+     * apart, since q and -q describe the same rotation.
+     *
+     * @tparam T The type of the components, must be floating point
+     */
+    template <typename T, typename = std::enable_if_t<std::is_floating_point<T>::value>>
+    class Quaternion
+    {
+    public:
+        /**
+         * @brief Default constructor, initializes the quaternion to the identity rotation
+         */
+        constexpr Quaternion() : x(), y(), z(), w(T(1)) {}
+
+        constexpr Quaternion(T xVal, T yVal, T zVal, T wVal) : x{xVal}, y{yVal}, z{zVal}, w{wVal} {}
+
+        static constexpr auto Identity() -> Quaternion { return {}; }
+
+        /**
+         * @brief Create the rotation by angle radians around an axis, counter-clockwise when looking down the axis
+         *
+         * @param axis The rotation axis, must have unit length
+         * @param angle The rotation angle in radians
+         */
+        static auto FromAxisAngle(const Vector3<T> &axis, T angle) -> Quaternion
+        {
+            const T s = std::sin(angle / T(2));
+            return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle / T(2))};
+        }
+
+        [[nodiscard]] constexpr auto dot(const Quaternion &other) const -> T
+        {
+            return ((x * other.x + y * other.y) + z * other.z) + w * other.w;
+        }
+
+        [[nodiscard]] constexpr auto lengthSquared() const -> T { return dot(*this); }
+
+        [[nodiscard]] constexpr auto length() const -> T { return math::sqrt(lengthSquared()); }
+
+        /**
+         * @brief Normalize the quaternion in-place, zero quaternions are left unchanged
+         */
+        constexpr auto normalize() -> Quaternion &
+        {
+            const T len = length();
+            if (len != T(0))
+            {
+                x /= len;
+                y /= len;
+                z /= len;
+                w /= len;
+            }
+            return *this;
+        }
+
+        [[nodiscard]] constexpr auto normalized() const -> Quaternion { return Quaternion(*this).normalize(); }
+
+        /**
+         * @brief The conjugate, which is the inverse rotation for unit quaternions
+         */
+        [[nodiscard]] constexpr auto conjugate() const -> Quaternion { return {-x, -y, -z, w}; }
+
+        /**
+         * @brief The multiplicative inverse, conjugate() is cheaper and equal for unit quaternions
+         */
+        [[nodiscard]] constexpr auto inverse() const -> Quaternion
+        {
+            const T lenSq = lengthSquared();
+            return {-x / lenSq, -y / lenSq, -z / lenSq, w / lenSq};
+        }
+
+        /**
+         * @brief Rotate a vector, equal to the vector part of q * (v, 0) * q.conjugate() for unit quaternions
+         *
+         * Evaluated as v + w * t + u x t with u = (x, y, z) and t = 2 * (u x v), which takes 15 multiplications.
+         */
+        [[nodiscard]] constexpr auto rotate(const Vector3<T> &v) const -> Vector3<T>
+        {
+            const T tx = (y * v.z - z * v.y) * T(2);
+            const T ty = (z * v.x - x * v.z) * T(2);
+            const T tz = (x * v.y - y * v.x) * T(2);
+            return {(v.x + w * tx) + (y * tz - z * ty), (v.y + w * ty) + (z * tx - x * tz),
+                    (v.z + w * tz) + (x * ty - y * tx)};
+        }
+
+        /**
+         * @brief The rotation matrix of a unit quaternion
+         */
+        [[nodiscard]] constexpr auto toMatrix() const -> Matrix4<T>
+        {
+            const T xx = x * x, yy = y * y, zz = z * z;
+            const T xy = x * y, xz = x * z, yz = y * z;
+            const T wx = w * x, wy = w * y, wz = w * z;
+            return {{T(1) - T(2) * (yy + zz), T(2) * (xy + wz), T(2) * (xz - wy), T(0)},
+                    {T(2) * (xy - wz), T(1) - T(2) * (xx + zz), T(2) * (yz + wx), T(0)},
+                    {T(2) * (xz + wy), T(2) * (yz - wx), T(1) - T(2) * (xx + yy), T(0)},
+                    {T(0), T(0), T(0), T(1)}};
+        }
+
+        /**
+         * @brief Normalized linear interpolation, fast but with a non-constant angular velocity
+         *
+         * @param start The rotation at amount 0
+         * @param end The rotation at amount 1
+         * @param amount The interpolation factor, usually in [0, 1]
+         * @return Quaternion The normalized interpolated rotation
+         */
+        static constexpr auto Nlerp(const Quaternion &start, const Quaternion &end, T amount) -> Quaternion
+        {
+            const Quaternion target = start.dot(end) < T(0) ? -end : end;
+            return Quaternion{start.x + (target.x - start.x) * amount, start.y + (target.y - start.y) * amount,
+                              start.z + (target.z - start.z) * amount, start.w + (target.w - start.w) * amount}
+                .normalize();
+        }
+
+        /**
+         * @brief Spherical linear interpolation, constant angular velocity along the shortest arc
+         *
+         * The angle comes from atan2 of |start - end| and |start + end|, which stays accurate for nearly equal
+         * rotations where acos of the dot product loses half of its digits. Rotations closer than the square root of
+         * epsilon fall back to Nlerp, where both agree to the last bits.
+         *
+         * @param start The rotation at amount 0, must have unit length
+         * @param end The rotation at amount 1, must have unit length
+         * @param amount The interpolation factor, usually in [0, 1]
+         */
+        static auto Slerp(const Quaternion &start, const Quaternion &end, T amount) -> Quaternion
+        {
+            const Quaternion target = start.dot(end) < T(0) ? -end : end;
+            const T theta = T(2) * std::atan2((start - target).length(), (start + target).length());
+            if (theta < std::sqrt(std::numeric_limits<T>::epsilon()))
+            {
+                return Nlerp(start, target, amount);
+            }
+            const T sinTheta = std::sin(theta);
+            return start * (std::sin((T(1) - amount) * theta) / sinTheta) + target * (std::sin(amount * theta) / sinTheta);
+        }
+
+        /**
+         * @brief Spherical linear interpolation evaluated with polynomials only, the kernel behind batch::slerp
+         *
+         * Uses the series of detail::SlerpSeries, whose error against the exact slerp stays below 1e-6 for unit
+         * quaternions and amounts in [0, 1], plus the rounding of T. It needs no trigonometry or branches, so it
+         * vectorizes and is usable in constant expressions.
+         */
+        static constexpr auto SlerpFast(const Quaternion &start, const Quaternion &end, T amount) -> Quaternion
+        {
+            constexpr const detail::SlerpSeries<T> &series = detail::slerpSeries<T>;
+
+            const T cosine = start.dot(end);
+            const T sign = cosine < T(0) ? T(-1) : T(1);
+            const T xm1 = cosine * sign - T(1);
+            const T d = T(1) - amount;
+            const T sqrT = amount * amount;
+            const T sqrD = d * d;
+
+            T cT = T(1);
+            T cD = T(1);
+            for (int i = series.terms - 1; i >= 0; --i)
+            {
+                cT = T(1) + ((series.u[i] * sqrT - series.v[i]) * xm1) * cT;
+                cD = T(1) + ((series.u[i] * sqrD - series.v[i]) * xm1) * cD;
+            }
+            cT = (sign * amount) * cT;
+            cD = d * cD;
+            return start * cD + end * cT;
+        }
+
+        ///< Arithmetic operators, used by the interpolation functions
+
+        constexpr auto operator-() const -> Quaternion { return {-x, -y, -z, -w}; }
+
+        constexpr auto operator+(const Quaternion &other) const -> Quaternion
+        {
+            return {x + other.x, y + other.y, z + other.z, w + other.w};
+        }
+
+        constexpr auto operator-(const Quaternion &other) const -> Quaternion
+        {
+            return {x - other.x, y - other.y, z - other.z, w - other.w};
+        }
+
+        constexpr auto operator*(T scalar) const -> Quaternion { return {x * scalar, y * scalar, z * scalar, w * scalar}; }
+
+        /**
+         * @brief The Hamilton product, the rotation other followed by this one
+         */
+        constexpr auto operator*(const Quaternion &other) const -> Quaternion
+        {
+            return {((w * other.x + x * other.w) + y * other.z) - z * other.y,
+                    ((w * other.y - x * other.z) + y * other.w) + z * other.x,
+                    ((w * other.z + x * other.y) - y * other.x) + z * other.w,
+                    ((w * other.w - x * other.x) - y * other.y) - z * other.z};
+        }
+
+        constexpr auto operator*=(const Quaternion &other) -> Quaternion & { return *this = *this * other; }
+
+        constexpr auto operator==(const Quaternion &other) const -> bool
+        {
+            return x == other.x && y == other.y && z == other.z && w == other.w;
+        }
+
+        constexpr auto operator!=(const Quaternion &other) const -> bool { return !(*this == other); }
+
+        T x; ///< The i component
+        T y; ///< The j component
+        T z; ///< The k component
+        T w; ///< The real component
+    };
+
+    using Quaternionf = Quaternion<float>;
+    using Quaterniond = Quaternion<double>;
+
+    static_assert(std::is_trivially_copyable<Quaternionf>::value, "Quaternionf must be trivially copyable");
+    static_assert(sizeof(Quaternionf) == 4 * sizeof(float), "Quaternionf must load as one SIMD register");
+
+    namespace batch
+    {
+        namespace detail
+        {
+            namespace scalar
+            {
+                inline void rotate(const Quaternionf &q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = q.rotate(in[i]);
+                    }
+                }
+
+                inline void rotate(const Quaternionf *q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = q[i].rotate(in[i]);
+                    }
+                }
+
+                inline void nlerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Quaternionf::Nlerp(start[i], end[i], amount);
+                    }
+                }
+
+                inline void slerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = Quaternionf::SlerpFast(start[i], end[i], amount);
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                ///< Four Vector3f are 12 consecutive floats, split them into component lanes and back
+
+                inline void load4(const Vector3f *values, __m128 &xs, __m128 &ys, __m128 &zs)
+                {
+                    const float *data = &values[0].x;
+                    const __m128 a = _mm_loadu_ps(data);     ///< x0 y0 z0 x1
+                    const __m128 b = _mm_loadu_ps(data + 4); ///< y1 z1 x2 y2
+                    const __m128 c = _mm_loadu_ps(data + 8); ///< z2 x3 y3 z3
+                    const __m128 xy23 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+                    const __m128 yz01 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+                    xs = _mm_shuffle_ps(a, xy23, _MM_SHUFFLE(2, 0, 3, 0));
+                    ys = _mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(3, 1, 2, 0));
+                    zs = _mm_shuffle_ps(yz01, c, _MM_SHUFFLE(3, 0, 3, 1));
+                }
+
+                inline void store4(Vector3f *values, __m128 xs, __m128 ys, __m128 zs)
+                {
+                    float *data = &values[0].x;
+                    const __m128 xy01 = _mm_unpacklo_ps(xs, ys);
+                    const __m128 xy23 = _mm_unpackhi_ps(xs, ys);
+                    const __m128 zx01 = _mm_shuffle_ps(zs, xs, _MM_SHUFFLE(1, 1, 0, 0));
+                    const __m128 yz11 = _mm_shuffle_ps(ys, zs, _MM_SHUFFLE(1, 1, 1, 1));
+                    const __m128 zz23xy3 = _mm_shuffle_ps(zs, xy23, _MM_SHUFFLE(3, 2, 3, 2));
+                    _mm_storeu_ps(data, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(2, 0, 1, 0)));
+                    _mm_storeu_ps(data + 4, _mm_shuffle_ps(yz11, xy23, _MM_SHUFFLE(1, 0, 2, 0)));
+                    _mm_storeu_ps(data + 8, _mm_shuffle_ps(zz23xy3, zz23xy3, _MM_SHUFFLE(1, 3, 2, 0)));
+                }
+
+                ///< Four quaternions transposed into x, y, z and w lanes, the transpose is its own inverse
+                inline void load4(const Quaternionf *values, __m128 &xs, __m128 &ys, __m128 &zs, __m128 &ws)
+                {
+                    xs = _mm_loadu_ps(&values[0].x);
+                    ys = _mm_loadu_ps(&values[1].x);
+                    zs = _mm_loadu_ps(&values[2].x);
+                    ws = _mm_loadu_ps(&values[3].x);
+                    _MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+                }
+
+                inline void store4(Quaternionf *values, __m128 xs, __m128 ys, __m128 zs, __m128 ws)
+                {
+                    _MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+                    _mm_storeu_ps(&values[0].x, xs);
+                    _mm_storeu_ps(&values[1].x, ys);
+                    _mm_storeu_ps(&values[2].x, zs);
+                    _mm_storeu_ps(&values[3].x, ws);
+                }
+
+                ///< The expression of Quaternion::rotate on four lanes
+                inline void rotate4(__m128 qx, __m128 qy, __m128 qz, __m128 qw, __m128 &vx, __m128 &vy, __m128 &vz)
+                {
+                    const __m128 two = _mm_set1_ps(2.0F);
+                    const __m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qy, vz), _mm_mul_ps(qz, vy)), two);
+                    const __m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qz, vx), _mm_mul_ps(qx, vz)), two);
+                    const __m128 tz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qx, vy), _mm_mul_ps(qy, vx)), two);
+                    vx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(qw, tx)), _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(qz, ty)));
+                    vy = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(qw, ty)), _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz)));
+                    vz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(qw, tz)), _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx)));
+                }
+
+                ///< The dot product of Quaternion::dot on four lanes
+                inline auto dot4(__m128 ax, __m128 ay, __m128 az, __m128 aw, __m128 bx, __m128 by, __m128 bz, __m128 bw)
+                    -> __m128
+                {
+                    const __m128 xy = _mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by));
+                    return _mm_add_ps(_mm_add_ps(xy, _mm_mul_ps(az, bz)), _mm_mul_ps(aw, bw));
+                }
+
+                inline void rotate(const Quaternionf &q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    const __m128 qx = _mm_set1_ps(q.x);
+                    const __m128 qy = _mm_set1_ps(q.y);
+                    const __m128 qz = _mm_set1_ps(q.z);
+                    const __m128 qw = _mm_set1_ps(q.w);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 vx, vy, vz;
+                        load4(in + i, vx, vy, vz);
+                        rotate4(qx, qy, qz, qw, vx, vy, vz);
+                        store4(out + i, vx, vy, vz);
+                    }
+                    scalar::rotate(q, in + i, out + i, count - i);
+                }
+
+                inline void rotate(const Quaternionf *q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 qx, qy, qz, qw, vx, vy, vz;
+                        load4(q + i, qx, qy, qz, qw);
+                        load4(in + i, vx, vy, vz);
+                        rotate4(qx, qy, qz, qw, vx, vy, vz);
+                        store4(out + i, vx, vy, vz);
+                    }
+                    scalar::rotate(q + i, in + i, out + i, count - i);
+                }
+
+                inline void nlerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    const __m128 t = _mm_set1_ps(amount);
+                    const __m128 zero = _mm_setzero_ps();
+                    const __m128 signBit = _mm_set1_ps(-0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 ax, ay, az, aw, bx, by, bz, bw;
+                        load4(start + i, ax, ay, az, aw);
+                        load4(end + i, bx, by, bz, bw);
+
+                        ///< Negating is exact, flipping the sign bit matches -end
+                        const __m128 flip = _mm_and_ps(_mm_cmplt_ps(dot4(ax, ay, az, aw, bx, by, bz, bw), zero), signBit);
+                        bx = _mm_xor_ps(bx, flip);
+                        by = _mm_xor_ps(by, flip);
+                        bz = _mm_xor_ps(bz, flip);
+                        bw = _mm_xor_ps(bw, flip);
+
+                        __m128 x = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(bx, ax), t));
+                        __m128 y = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(by, ay), t));
+                        __m128 z = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(bz, az), t));
+                        __m128 w = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(bw, aw), t));
+
+                        ///< Zero lanes stay unchanged like Quaternion::normalize, dividing by one keeps them
+                        const __m128 len = _mm_sqrt_ps(dot4(x, y, z, w, x, y, z, w));
+                        const __m128 isZero = _mm_cmpeq_ps(len, zero);
+                        const __m128 divisor = _mm_or_ps(_mm_andnot_ps(isZero, len), _mm_and_ps(isZero, _mm_set1_ps(1.0F)));
+                        store4(out + i, _mm_div_ps(x, divisor), _mm_div_ps(y, divisor), _mm_div_ps(z, divisor),
+                               _mm_div_ps(w, divisor));
+                    }
+                    scalar::nlerp(start + i, end + i, amount, out + i, count - i);
+                }
+
+                inline void slerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    constexpr const Fzolv::detail::SlerpSeries<float> &series = Fzolv::detail::slerpSeries<float>;
+                    const __m128 one = _mm_set1_ps(1.0F);
+                    const float d = 1.0F - amount;
+
+                    ///< The factors that only depend on the amount are the same for every quaternion
+                    __m128 bT[series.terms];
+                    __m128 bD[series.terms];
+                    for (int k = 0; k < series.terms; ++k)
+                    {
+                        bT[k] = _mm_set1_ps(series.u[k] * (amount * amount) - series.v[k]);
+                        bD[k] = _mm_set1_ps(series.u[k] * (d * d) - series.v[k]);
+                    }
+
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        __m128 ax, ay, az, aw, bx, by, bz, bw;
+                        load4(start + i, ax, ay, az, aw);
+                        load4(end + i, bx, by, bz, bw);
+
+                        const __m128 cosine = dot4(ax, ay, az, aw, bx, by, bz, bw);
+                        const __m128 negative = _mm_cmplt_ps(cosine, _mm_setzero_ps());
+                        const __m128 sign = _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(-1.0F)), _mm_andnot_ps(negative, one));
+                        const __m128 xm1 = _mm_sub_ps(_mm_mul_ps(cosine, sign), one);
+
+                        __m128 cT = one;
+                        __m128 cD = one;
+                        for (int k = series.terms - 1; k >= 0; --k)
+                        {
+                            cT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(bT[k], xm1), cT));
+                            cD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(bD[k], xm1), cD));
+                        }
+                        cT = _mm_mul_ps(_mm_mul_ps(sign, _mm_set1_ps(amount)), cT);
+                        cD = _mm_mul_ps(_mm_set1_ps(d), cD);
+
+                        store4(out + i, _mm_add_ps(_mm_mul_ps(ax, cD), _mm_mul_ps(bx, cT)),
+                               _mm_add_ps(_mm_mul_ps(ay, cD), _mm_mul_ps(by, cT)),
+                               _mm_add_ps(_mm_mul_ps(az, cD), _mm_mul_ps(bz, cT)),
+                               _mm_add_ps(_mm_mul_ps(aw, cD), _mm_mul_ps(bw, cT)));
+                    }
+                    scalar::slerp(start + i, end + i, amount, out + i, count - i);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                ///< The quaternion kernels are shuffle-bound, the SSE2 versions are as fast on AVX2 targets
+                using sse2::nlerp;
+                using sse2::rotate;
+                using sse2::slerp;
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                ///< The expression of Quaternion::rotate on four lanes
+                inline void rotate4(float32x4_t qx, float32x4_t qy, float32x4_t qz, float32x4_t qw, float32x4x3_t &v)
+                {
+                    const float32x4_t tx = vmulq_n_f32(vsubq_f32(vmulq_f32(qy, v.val[2]), vmulq_f32(qz, v.val[1])), 2.0F);
+                    const float32x4_t ty = vmulq_n_f32(vsubq_f32(vmulq_f32(qz, v.val[0]), vmulq_f32(qx, v.val[2])), 2.0F);
+                    const float32x4_t tz = vmulq_n_f32(vsubq_f32(vmulq_f32(qx, v.val[1]), vmulq_f32(qy, v.val[0])), 2.0F);
+                    v.val[0] = vaddq_f32(vaddq_f32(v.val[0], vmulq_f32(qw, tx)), vsubq_f32(vmulq_f32(qy, tz), vmulq_f32(qz, ty)));
+                    v.val[1] = vaddq_f32(vaddq_f32(v.val[1], vmulq_f32(qw, ty)), vsubq_f32(vmulq_f32(qz, tx), vmulq_f32(qx, tz)));
+                    v.val[2] = vaddq_f32(vaddq_f32(v.val[2], vmulq_f32(qw, tz)), vsubq_f32(vmulq_f32(qx, ty), vmulq_f32(qy, tx)));
+                }
+
+                inline auto dot4(const float32x4x4_t &a, const float32x4x4_t &b) -> float32x4_t
+                {
+                    const float32x4_t xy = vaddq_f32(vmulq_f32(a.val[0], b.val[0]), vmulq_f32(a.val[1], b.val[1]));
+                    return vaddq_f32(vaddq_f32(xy, vmulq_f32(a.val[2], b.val[2])), vmulq_f32(a.val[3], b.val[3]));
+                }
+
+                inline void rotate(const Quaternionf &q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    const float32x4_t qx = vdupq_n_f32(q.x);
+                    const float32x4_t qy = vdupq_n_f32(q.y);
+                    const float32x4_t qz = vdupq_n_f32(q.z);
+                    const float32x4_t qw = vdupq_n_f32(q.w);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        float32x4x3_t v = vld3q_f32(&in[i].x);
+                        rotate4(qx, qy, qz, qw, v);
+                        vst3q_f32(&out[i].x, v);
+                    }
+                    scalar::rotate(q, in + i, out + i, count - i);
+                }
+
+                inline void rotate(const Quaternionf *q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x4_t lanes = vld4q_f32(&q[i].x);
+                        float32x4x3_t v = vld3q_f32(&in[i].x);
+                        rotate4(lanes.val[0], lanes.val[1], lanes.val[2], lanes.val[3], v);
+                        vst3q_f32(&out[i].x, v);
+                    }
+                    scalar::rotate(q + i, in + i, out + i, count - i);
+                }
+
+                inline void nlerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x4_t a = vld4q_f32(&start[i].x);
+                        float32x4x4_t b = vld4q_f32(&end[i].x);
+                        const uint32x4_t flip =
+                            vandq_u32(vcltq_f32(dot4(a, b), vdupq_n_f32(0.0F)), vdupq_n_u32(0x80000000U));
+                        float32x4x4_t r;
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            b.val[c] = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(b.val[c]), flip));
+                            r.val[c] = vaddq_f32(a.val[c], vmulq_n_f32(vsubq_f32(b.val[c], a.val[c]), amount));
+                        }
+                        const float32x4_t len = vsqrtq_f32(dot4(r, r));
+                        const float32x4_t divisor = vbslq_f32(vceqq_f32(len, vdupq_n_f32(0.0F)), vdupq_n_f32(1.0F), len);
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            r.val[c] = vdivq_f32(r.val[c], divisor);
+                        }
+                        vst4q_f32(&out[i].x, r);
+                    }
+                    scalar::nlerp(start + i, end + i, amount, out + i, count - i);
+                }
+
+                inline void slerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    constexpr const Fzolv::detail::SlerpSeries<float> &series = Fzolv::detail::slerpSeries<float>;
+                    const float32x4_t one = vdupq_n_f32(1.0F);
+                    const float d = 1.0F - amount;
+
+                    ///< The factors that only depend on the amount are the same for every quaternion
+                    float bT[series.terms];
+                    float bD[series.terms];
+                    for (int k = 0; k < series.terms; ++k)
+                    {
+                        bT[k] = series.u[k] * (amount * amount) - series.v[k];
+                        bD[k] = series.u[k] * (d * d) - series.v[k];
+                    }
+
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const float32x4x4_t a = vld4q_f32(&start[i].x);
+                        const float32x4x4_t b = vld4q_f32(&end[i].x);
+                        const float32x4_t cosine = dot4(a, b);
+                        const float32x4_t sign = vbslq_f32(vcltq_f32(cosine, vdupq_n_f32(0.0F)), vdupq_n_f32(-1.0F), one);
+                        const float32x4_t xm1 = vsubq_f32(vmulq_f32(cosine, sign), one);
+
+                        float32x4_t cT = one;
+                        float32x4_t cD = one;
+                        for (int k = series.terms - 1; k >= 0; --k)
+                        {
+                            cT = vaddq_f32(one, vmulq_f32(vmulq_n_f32(xm1, bT[k]), cT));
+                            cD = vaddq_f32(one, vmulq_f32(vmulq_n_f32(xm1, bD[k]), cD));
+                        }
+                        cT = vmulq_f32(vmulq_n_f32(sign, amount), cT);
+                        cD = vmulq_n_f32(cD, d);
+
+                        float32x4x4_t r;
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            r.val[c] = vaddq_f32(vmulq_f32(a.val[c], cD), vmulq_f32(b.val[c], cT));
+                        }
+                        vst4q_f32(&out[i].x, r);
+                    }
+                    scalar::slerp(start + i, end + i, amount, out + i, count - i);
+                }
+            }
+#endif
+
+            namespace best
+            {
+                inline void rotate(const Quaternionf &q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(rotate, (q, in, out, count))
+                }
+
+                inline void rotate(const Quaternionf *q, const Vector3f *in, Vector3f *out, std::size_t count)
+                {
+                    FZOLV_DISPATCH(rotate, (q, in, out, count))
+                }
+
+                inline void nlerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    FZOLV_DISPATCH(nlerp, (start, end, amount, out, count))
+                }
+
+                inline void slerp(const Quaternionf *start, const Quaternionf *end, float amount, Quaternionf *out,
+                                  std::size_t count)
+                {
+                    FZOLV_DISPATCH(slerp, (start, end, amount, out, count))
+                }
+            }
+        }
+
+        /**
+         * @brief Rotate every vector by the same rotation, out[i] = rotation.rotate(in[i])
+         *
+         * @param rotation The rotation, should have unit length
+         * @param in The vectors to rotate
+         * @param out The rotated vectors, must have the same size as in, may be in itself
+         */
+        template <typename T>
+        void rotate(const Quaternion<T> &rotation, span<const Vector3<T>> in, span<Vector3<T>> out)
+        {
+            assert(in.size() == out.size());
+            if constexpr (std::is_same<T, float>::value)
+            {
+                parallelFor(in.size(), detail::batchGrain, [&](std::size_t begin, std::size_t end)
+                            { detail::best::rotate(rotation, in.data() + begin, out.data() + begin, end - begin); });
+            }
+            else
+            {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    out[i] = rotation.rotate(in[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Rotate every vector by its own rotation, out[i] = rotations[i].rotate(in[i])
+         */
+        template <typename T>
+        void rotate(span<const Quaternion<T>> rotations, span<const Vector3<T>> in, span<Vector3<T>> out)
+        {
+            assert(rotations.size() == in.size() && in.size() == out.size());
+            if constexpr (std::is_same<T, float>::value)
+            {
+                parallelFor(in.size(), detail::batchGrain,
+                            [&](std::size_t begin, std::size_t end)
+                            {
+                                detail::best::rotate(rotations.data() + begin, in.data() + begin, out.data() + begin,
+                                                     end - begin);
+                            });
+            }
+            else
+            {
+                for (std::size_t i = 0; i < in.size(); ++i)
+                {
+                    out[i] = rotations[i].rotate(in[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief Blend every pair of rotations with the same amount, out[i] = Quaternion::Nlerp(start[i], end[i], amount)
+         */
+        template <typename T>
+        void nlerp(span<const Quaternion<T>> start, span<const Quaternion<T>> end, T amount, span<Quaternion<T>> out)
+        {
+            assert(start.size() == end.size() && start.size() == out.size());
+            if constexpr (std::is_same<T, float>::value)
+            {
+                parallelFor(start.size(), detail::batchGrain,
+                            [&](std::size_t begin, std::size_t stop)
+                            {
+                                detail::best::nlerp(start.data() + begin, end.data() + begin, amount, out.data() + begin,
+                                                    stop - begin);
+                            });
+            }
+            else
+            {
+                for (std::size_t i = 0; i < start.size(); ++i)
+                {
+                    out[i] = Quaternion<T>::Nlerp(start[i], end[i], amount);
+                }
+            }
+        }
+
+        /**
+         * @brief Blend every pair of rotations with the same amount, out[i] = Quaternion::SlerpFast(start[i], end[i], amount)
+         */
+        template <typename T>
+        void slerp(span<const Quaternion<T>> start, span<const Quaternion<T>> end, T amount, span<Quaternion<T>> out)
+        {
+            assert(start.size() == end.size() && start.size() == out.size());
+            if constexpr (std::is_same<T, float>::value)
+            {
+                parallelFor(start.size(), detail::batchGrain,
+                            [&](std::size_t begin, std::size_t stop)
+                            {
+                                detail::best::slerp(start.data() + begin, end.data() + begin, amount, out.data() + begin,
+                                                    stop - begin);
+                            });
+            }
+            else
+            {
+                for (std::size_t i = 0; i < start.size(); ++i)
+                {
+                    out[i] = Quaternion<T>::SlerpFast(start[i], end[i], amount);
+                }
+            }
+        }
+
+        ///< Non-template overloads so that containers of Quaternionf and Vector3f convert to spans implicitly
+
+        inline void rotate(const Quaternionf &rotation, span<const Vector3f> in, span<Vector3f> out)
+        {
+            rotate<float>(rotation, in, out);
+        }
+
+        inline void rotate(span<const Quaternionf> rotations, span<const Vector3f> in, span<Vector3f> out)
+        {
+            rotate<float>(rotations, in, out);
+        }
+
+        inline void nlerp(span<const Quaternionf> start, span<const Quaternionf> end, float amount, span<Quaternionf> out)
+        {
+            nlerp<float>(start, end, amount, out);
+        }
+
+        inline void slerp(span<const Quaternionf> start, span<const Quaternionf> end, float amount, span<Quaternionf> out)
+        {
+            slerp<float>(start, end, amount, out);
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_QUATERNION_2x80s5 */
@@ -0,0 +1,393 @@
+#ifndef FZOLV_RANGES_u87zqy
+#define FZOLV_RANGES_u87zqy
+
+/**
+ * The concepts and lazy pipelines below need C++20, the rest of the library keeps targeting C++17, so this header is
+ * empty under older standards and can be included unconditionally.
+ */
+#if __cplusplus >= 202002L && defined(__cpp_concepts) && defined(__cpp_lib_ranges)
+
+#include <algorithm>
+#include <batch.hpp>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <matrix.hpp>
+#include <parallel.hpp>
+#include <ranges>
+#include <span.hpp>
+#include <transform.hpp>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        template <typename V>
+        struct is_fzolv_vector : std::false_type
+        {
+        };
+
+        template <typename T, typename E>
+        struct is_fzolv_vector<Vector2<T, E>> : std::true_type
+        {
+            using component_type = T;
+        };
+
+        template <typename T, typename E>
+        struct is_fzolv_vector<Vector3<T, E>> : std::true_type
+        {
+            using component_type = T;
+        };
+
+        template <typename T, typename E>
+        struct is_fzolv_vector<Vector3A<T, E>> : std::true_type
+        {
+            using component_type = T;
+        };
+
+        template <typename T, typename E>
+        struct is_fzolv_vector<Vector4<T, E>> : std::true_type
+        {
+            using component_type = T;
+        };
+    }
+
+    /**
+     * @brief One of the library's vector types, Vector2, Vector3, Vector3A or Vector4 of any component type
+     */
+    template <typename V>
+    concept VectorLike = detail::is_fzolv_vector<std::remove_cv_t<V>>::value;
+
+    /**
+     * @brief A contiguous, sized range of vectors, such as std::vector, std::array, span or a pmr::vector on a FrameArena
+     *
+     * These are the containers the span-based batch functions take without copying.
+     */
+    template <typename R>
+    concept ContiguousVectorRange = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                                    VectorLike<std::ranges::range_value_t<R>>;
+
+    /**
+     * @brief A sized container of vectors with value_type and operator[] that is not contiguous, such as Vector2SoA
+     */
+    template <typename R>
+    concept IndexedVectorRange = !ContiguousVectorRange<R> && VectorLike<typename std::remove_cvref_t<R>::value_type> &&
+                                 requires(const std::remove_cvref_t<R> &range, std::size_t index) {
+                                     { range.size() } -> std::convertible_to<std::size_t>;
+                                     {
+                                         range[index]
+                                     } -> std::convertible_to<typename std::remove_cvref_t<R>::value_type>;
+                                 };
+
+    /**
+     * @brief A stage of a vector pipeline, applied to one vector lazily or to a block of vectors by a batch kernel
+     *
+     * apply must give the same results as calling the stage on every element and must allow in == out.
+     */
+    template <typename S, typename V>
+    concept PipelineStage = VectorLike<V> && std::copy_constructible<S> &&
+                            requires(const S &stage, const V &value, const V *in, V *out, std::size_t count) {
+                                { stage(value) } -> std::same_as<V>;
+                                stage.apply(in, out, count);
+                            };
+
+    namespace views
+    {
+        /**
+         * @brief Normalize every vector, like normalized() and batch::normalize
+         */
+        struct Normalized
+        {
+            template <VectorLike V>
+                requires std::is_floating_point_v<typename Fzolv::detail::is_fzolv_vector<V>::component_type>
+            auto operator()(const V &value) const -> V
+            {
+                return value.normalized();
+            }
+
+            template <VectorLike V>
+                requires std::is_floating_point_v<typename Fzolv::detail::is_fzolv_vector<V>::component_type>
+            void apply(const V *in, V *out, std::size_t count) const
+            {
+                if constexpr (std::is_same_v<V, Vector2f>)
+                {
+                    batch::detail::best::normalize(in, out, count);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = in[i].normalized();
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Transform every point or direction by a matrix, like transformPoints and transformDirections
+         */
+        template <typename T>
+        struct Transformed
+        {
+            Matrix4<T> matrix;
+            bool points = true; ///< Whether translation applies
+
+            template <VectorLike V>
+                requires std::is_same_v<V, Vector3<T>> || std::is_same_v<V, Vector2<T>>
+            auto operator()(const V &value) const -> V
+            {
+                if constexpr (std::is_same_v<V, Vector3<T>>)
+                {
+                    return points ? matrix.transformPoint(value) : matrix.transformDirection(value);
+                }
+                else
+                {
+                    const Vector3<T> flat{value, T(0)};
+                    const Vector3<T> result = points ? matrix.transformPoint(flat) : matrix.transformDirection(flat);
+                    return {result.x, result.y};
+                }
+            }
+
+            template <VectorLike V>
+                requires std::is_same_v<V, Vector3<T>> || std::is_same_v<V, Vector2<T>>
+            void apply(const V *in, V *out, std::size_t count) const
+            {
+                Fzolv::detail::transformKernel(matrix, in, out, count, points ? T(1) : T(0));
+            }
+        };
+
+        /**
+         * @brief Clamp every vector component-wise, like V::clamp and batch::clamp
+         */
+        template <VectorLike V>
+        struct Clamped
+        {
+            V low;
+            V high;
+
+            auto operator()(const V &value) const -> V { return V::clamp(value, low, high); }
+
+            void apply(const V *in, V *out, std::size_t count) const
+            {
+                if constexpr (std::is_same_v<V, Vector2f> || std::is_same_v<V, Vector3f>)
+                {
+                    constexpr std::size_t components = sizeof(V) / sizeof(float);
+                    const batch::detail::BoundLanes bounds = batch::detail::boundLanes(&low.x, &high.x, components);
+                    batch::detail::best::clamp(reinterpret_cast<const float *>(in), reinterpret_cast<float *>(out),
+                                               count * components, bounds);
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = V::clamp(in[i], low, high);
+                    }
+                }
+            }
+        };
+
+        [[nodiscard]] constexpr auto normalized() -> Normalized { return {}; }
+
+        ///< Points are treated as (x, y, z, 1), 2D points as (x, y, 0, 1)
+        template <typename T>
+        [[nodiscard]] auto transformed(const Matrix4<T> &matrix) -> Transformed<T>
+        {
+            return {matrix, true};
+        }
+
+        ///< Directions are treated as (x, y, z, 0), 2D directions as (x, y, 0, 0)
+        template <typename T>
+        [[nodiscard]] auto transformedDirections(const Matrix4<T> &matrix) -> Transformed<T>
+        {
+            return {matrix, false};
+        }
+
+        template <VectorLike V>
+        [[nodiscard]] auto clamped(const V &low, const V &high) -> Clamped<V>
+        {
+            return {low, high};
+        }
+
+        namespace detail
+        {
+            ///< The vectors one fused pass carries through every stage while they are in L1
+            constexpr std::size_t pipelineBlock = 256;
+
+            ///< A contiguous source, viewed without copying
+            template <VectorLike V>
+            struct ContiguousSource
+            {
+                using value_type = V;
+                static constexpr bool contiguous = true;
+
+                span<const V> values;
+
+                [[nodiscard]] auto size() const -> std::size_t { return values.size(); }
+
+                [[nodiscard]] auto operator[](std::size_t index) const -> V { return values[index]; }
+            };
+
+            ///< Any other indexed container, referenced, so it must outlive the pipeline
+            template <typename R>
+            struct IndexedSource
+            {
+                using value_type = typename R::value_type;
+                static constexpr bool contiguous = false;
+
+                const R *container = nullptr;
+
+                [[nodiscard]] auto size() const -> std::size_t { return container->size(); }
+
+                [[nodiscard]] auto operator[](std::size_t index) const -> value_type { return (*container)[index]; }
+            };
+
+            template <typename Source, typename... Stages>
+            struct Element
+            {
+                using value_type = typename Source::value_type;
+
+                Source source;
+                std::tuple<Stages...> stages;
+
+                auto operator()(std::size_t index) const -> value_type
+                {
+                    value_type value = source[index];
+                    std::apply([&](const Stages &...stage) { ((value = stage(value)), ...); }, stages);
+                    return value;
+                }
+            };
+
+            template <ContiguousVectorRange R>
+            auto sourceOf(R &range)
+            {
+                using V = std::ranges::range_value_t<R>;
+                return ContiguousSource<V>{span<const V>{std::ranges::data(range), std::ranges::size(range)}};
+            }
+
+            template <IndexedVectorRange R>
+            auto sourceOf(R &range)
+            {
+                return IndexedSource<std::remove_cv_t<R>>{&range};
+            }
+        }
+
+        /**
+         * @brief A lazy sequence of stages over a source range, built with operator|
+         *
+         * Iterating applies every stage to one vector at a time, batch::evaluate runs the whole pipeline in one
+         * fused pass with the batch kernels of every stage. Neither copies the source or materializes a stage.
+         */
+        template <typename Source, typename... Stages>
+        class Pipeline : public std::ranges::view_interface<Pipeline<Source, Stages...>>
+        {
+        public:
+            using value_type = typename Source::value_type;
+
+            Pipeline() = default;
+
+            Pipeline(const Source &source, const std::tuple<Stages...> &stages)
+                : element{source, stages}, lazy{std::views::iota(std::size_t{0}, source.size()), element}
+            {
+            }
+
+            [[nodiscard]] auto begin() const { return lazy.begin(); }
+
+            [[nodiscard]] auto end() const { return lazy.end(); }
+
+            [[nodiscard]] auto size() const -> std::size_t { return element.source.size(); }
+
+            [[nodiscard]] auto source() const -> const Source & { return element.source; }
+
+            [[nodiscard]] auto stages() const -> const std::tuple<Stages...> & { return element.stages; }
+
+        private:
+            detail::Element<Source, Stages...> element;
+            std::ranges::transform_view<std::ranges::iota_view<std::size_t, std::size_t>, detail::Element<Source, Stages...>>
+                lazy;
+        };
+
+        template <typename R, typename S>
+            requires(ContiguousVectorRange<R> || IndexedVectorRange<R>) &&
+                    PipelineStage<S, typename std::remove_cvref_t<R>::value_type>
+        auto operator|(R &range, const S &stage)
+        {
+            using Source = decltype(detail::sourceOf(range));
+            return Pipeline<Source, S>{detail::sourceOf(range), std::tuple<S>{stage}};
+        }
+
+        ///< Spans are views, so temporaries are fine as sources
+        template <VectorLike V, typename S>
+            requires PipelineStage<S, std::remove_cv_t<V>>
+        auto operator|(span<V> values, const S &stage)
+        {
+            using U = std::remove_cv_t<V>;
+            return Pipeline<detail::ContiguousSource<U>, S>{detail::ContiguousSource<U>{values}, std::tuple<S>{stage}};
+        }
+
+        template <typename Source, typename... Stages, typename S>
+            requires PipelineStage<S, typename Source::value_type>
+        auto operator|(const Pipeline<Source, Stages...> &pipeline, const S &stage)
+        {
+            return Pipeline<Source, Stages..., S>{pipeline.source(), std::tuple_cat(pipeline.stages(), std::tuple<S>{stage})};
+        }
+    }
+
+    namespace batch
+    {
+        /**
+         * @brief Run a pipeline over its whole source in one fused pass, out[i] = the i-th element of pipeline
+         *
+         * Blocks of views::detail::pipelineBlock vectors are loaded into out and pass through the batch kernel of
+         * every stage while they are still in L1, so memory is read and written once whatever the number of stages.
+         * Results match iterating the pipeline. Large sources are split across threads. out may be the contiguous
+         * source itself to run the pipeline in place.
+         *
+         * @param pipeline The pipeline to evaluate
+         * @param out The results, any contiguous range of the pipeline's vector type and size
+         */
+        template <typename Source, typename... Stages, ContiguousVectorRange Out>
+            requires std::same_as<std::ranges::range_value_t<Out>, typename Source::value_type>
+        void evaluate(const views::Pipeline<Source, Stages...> &pipeline, Out &&out)
+        {
+            using V = typename Source::value_type;
+            V *results = std::ranges::data(out);
+            const std::size_t count = pipeline.size();
+            assert(std::ranges::size(out) == count);
+            const Source &source = pipeline.source();
+            parallelFor(count, detail::batchGrain,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            for (std::size_t block = begin; block < end; block += views::detail::pipelineBlock)
+                            {
+                                const std::size_t size = std::min(views::detail::pipelineBlock, end - block);
+                                const V *in = results + block;
+                                if constexpr (Source::contiguous)
+                                {
+                                    in = source.values.data() + block;
+                                }
+                                else
+                                {
+                                    for (std::size_t i = 0; i < size; ++i)
+                                    {
+                                        results[block + i] = source[block + i];
+                                    }
+                                }
+                                std::apply(
+                                    [&](const Stages &...stage)
+                                    {
+                                        ((stage.apply(in, results + block, size), in = results + block), ...);
+                                    },
+                                    pipeline.stages());
+                            }
+                        });
+        }
+    }
+}
+
+#endif
+
+#endif /* end of include guard: FZOLV_RANGES_u87zqy */
@@ -0,0 +1,308 @@
+#ifndef FZOLV_SIMD_dun1pk
+#define FZOLV_SIMD_dun1pk
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief Detection of the SIMD instruction sets used by the batch kernels
+ *
+ * Each FZOLV_SIMD_* macro is defined to 1 when kernels for the matching instruction set are compiled in and to 0
+ * otherwise. SSE2 and NEON kernels need the compiler to target them. NEON kernels rely on AArch64 instructions and are
+ * not enabled on 32-bit ARM. Defining FZOLV_NO_SIMD before including any Fzolv header forces the scalar code paths
+ * everywhere.
+ *
+ * AVX2 kernels are also compiled into x86 builds that do not target AVX2, through function target attributes on GCC
+ * and Clang and unconditionally on MSVC, and only run when the processor supports them, see simd::activeLevel().
+ * Defining FZOLV_NO_RUNTIME_DISPATCH limits the kernels to the instruction sets the compiler targets.
+ *
+ * The AVX2 level includes the F16C half-precision conversions, which every processor with AVX2 implements.
+ *
+ * Kernels that promise the same results on every level compute the same expressions as the scalar code, with separate
+ * multiplies and adds. That only holds while the compiler does not contract the scalar code into fused multiply-adds,
+ * which GCC does by default for targets with FMA such as -march=haswell. The Fzolv CMake target adds
+ * -ffp-contract=off for GCC and Clang, builds that include the headers some other way must pass it themselves.
+ */
+#if !defined(FZOLV_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FZOLV_SIMD_SSE2 1
+#else
+#define FZOLV_SIMD_SSE2 0
+#endif
+
+#if !defined(FZOLV_NO_SIMD) && defined(__AVX2__)
+#define FZOLV_SIMD_AVX2 1
+#if defined(__F16C__) || !(defined(__GNUC__) || defined(__clang__))
+#define FZOLV_TARGET_AVX2
+#else
+#define FZOLV_TARGET_AVX2 __attribute__((target("f16c")))
+#endif
+#elif FZOLV_SIMD_SSE2 && !defined(FZOLV_NO_RUNTIME_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+#define FZOLV_SIMD_AVX2 1
+#define FZOLV_TARGET_AVX2 __attribute__((target("avx2,f16c")))
+#elif FZOLV_SIMD_SSE2 && !defined(FZOLV_NO_RUNTIME_DISPATCH) && defined(_MSC_VER)
+#define FZOLV_SIMD_AVX2 1
+#define FZOLV_TARGET_AVX2
+#else
+#define FZOLV_SIMD_AVX2 0
+#define FZOLV_TARGET_AVX2
+#endif
+
+#if !defined(FZOLV_NO_SIMD) && (defined(__aarch64__) || defined(_M_ARM64)) && (defined(__ARM_NEON) || defined(_M_ARM64))
+#define FZOLV_SIMD_NEON 1
+#else
+#define FZOLV_SIMD_NEON 0
+#endif
+
+#if FZOLV_SIMD_SSE2 || FZOLV_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+#if FZOLV_SIMD_AVX2 && !(defined(__AVX2__) && defined(__F16C__))
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if FZOLV_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Hint the processor to fetch the cache line holding an address, used by streaming kernels
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define FZOLV_PREFETCH(address) __builtin_prefetch(address)
+#elif FZOLV_SIMD_SSE2
+#define FZOLV_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0)
+#else
+#define FZOLV_PREFETCH(address) static_cast<void>(address)
+#endif
+
+namespace Fzolv
+{
+    namespace simd
+    {
+        /**
+         * @brief A set of batch kernels, each level only uses instructions of its own instruction set
+         */
+        enum class Level
+        {
+            Scalar,
+            SSE2,
+            AVX2,
+            NEON
+        };
+
+        /**
+         * @brief The lower-case name of a level, as accepted by the FZOLV_SIMD_LEVEL environment variable
+         */
+        constexpr auto levelName(Level level) -> const char *
+        {
+            switch (level)
+            {
+            case Level::SSE2:
+                return "sse2";
+            case Level::AVX2:
+                return "avx2";
+            case Level::NEON:
+                return "neon";
+            default:
+                return "scalar";
+            }
+        }
+
+        namespace detail
+        {
+            ///< Whether the processor runs AVX2 and F16C instructions and the operating system saves the YMM registers
+            inline auto cpuHasAvx2() -> bool
+            {
+#if FZOLV_SIMD_AVX2 && defined(__AVX2__) && defined(__F16C__)
+                return true;
+#elif FZOLV_SIMD_AVX2
+                unsigned int regs[4] = {};
+                unsigned int xcr0 = 0;
+#if defined(_MSC_VER) && !defined(__clang__)
+                int info[4] = {};
+                __cpuid(info, 0);
+                if (info[0] < 7)
+                {
+                    return false;
+                }
+                __cpuid(info, 1);
+                regs[2] = static_cast<unsigned int>(info[2]);
+                const bool f16c = (regs[2] & (1U << 29)) != 0;
+                const bool osxsave = (regs[2] & (1U << 27)) != 0 && (regs[2] & (1U << 28)) != 0;
+                if (!osxsave)
+                {
+                    return false;
+                }
+                xcr0 = static_cast<unsigned int>(_xgetbv(0));
+                __cpuidex(info, 7, 0);
+                regs[1] = static_cast<unsigned int>(info[1]);
+#else
+                if (__get_cpuid_max(0, nullptr) < 7)
+                {
+                    return false;
+                }
+                __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+                const bool f16c = (regs[2] & (1U << 29)) != 0;
+                const bool osxsave = (regs[2] & (1U << 27)) != 0 && (regs[2] & (1U << 28)) != 0;
+                if (!osxsave)
+                {
+                    return false;
+                }
+                ///< xgetbv through inline assembly, the intrinsic needs the XSAVE target enabled
+                unsigned int high = 0;
+                __asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(high) : "c"(0));
+                static_cast<void>(high);
+                __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+                ///< XMM and YMM state enabled by the OS, the AVX2 bit of leaf 7 and the F16C bit of leaf 1
+                return (xcr0 & 6U) == 6U && (regs[1] & (1U << 5)) != 0 && f16c;
+#else
+                return false;
+#endif
+            }
+
+            ///< The forced or detected level as an int, -1 until the first call to activeLevel()
+            inline std::atomic<int> currentLevel{-1};
+        }
+
+        /**
+         * @brief Whether the batch kernels of a level are compiled in and the processor can run them
+         */
+        inline auto isSupported(Level level) -> bool
+        {
+            switch (level)
+            {
+            case Level::Scalar:
+                return true;
+            case Level::SSE2:
+                return FZOLV_SIMD_SSE2 != 0;
+            case Level::AVX2:
+                return FZOLV_SIMD_AVX2 != 0 && detail::cpuHasAvx2();
+            case Level::NEON:
+                return FZOLV_SIMD_NEON != 0;
+            }
+            return false;
+        }
+
+        /**
+         * @brief The best level the processor supports, detected once
+         */
+        inline auto detectedLevel() -> Level
+        {
+            static const Level level = []()
+            {
+                for (Level candidate : {Level::AVX2, Level::SSE2, Level::NEON})
+                {
+                    if (isSupported(candidate))
+                    {
+                        return candidate;
+                    }
+                }
+                return Level::Scalar;
+            }();
+            return level;
+        }
+
+        /**
+         * @brief The level the batch operations run at
+         *
+         * On first use this is detectedLevel(), unless the FZOLV_SIMD_LEVEL environment variable names a supported
+         * level, which lets a bug report be reproduced with the kernels of another machine. The span transforms of
+         * transform.hpp follow it too, single-vector operations and matrices keep the instruction sets the compiler
+         * targets.
+         */
+        inline auto activeLevel() -> Level
+        {
+            const int current = detail::currentLevel.load(std::memory_order_relaxed);
+            if (current >= 0)
+            {
+                return static_cast<Level>(current);
+            }
+
+            Level level = detectedLevel();
+#if defined(_MSC_VER)
+#pragma warning(suppress : 4996)
+#endif
+            if (const char *name = std::getenv("FZOLV_SIMD_LEVEL"))
+            {
+                for (Level candidate : {Level::Scalar, Level::SSE2, Level::AVX2, Level::NEON})
+                {
+                    if (std::strcmp(name, levelName(candidate)) == 0 && isSupported(candidate))
+                    {
+                        level = candidate;
+                    }
+                }
+            }
+            detail::currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+            return level;
+        }
+
+        /**
+         * @brief Force the batch operations to a level, for tests and for reproducing results of other machines
+         *
+         * @param level The level to use from now on
+         * @return bool Whether the level is supported, an unsupported level leaves the active level unchanged
+         */
+        inline auto setLevel(Level level) -> bool
+        {
+            if (!isSupported(level))
+            {
+                return false;
+            }
+            detail::currentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * @brief Go back to detectedLevel(), ignoring FZOLV_SIMD_LEVEL
+         */
+        inline void resetLevel() { detail::currentLevel.store(static_cast<int>(detectedLevel()), std::memory_order_relaxed); }
+
+        /**
+         * @brief Whether rsqrt uses a hardware estimate instead of an exact square root and division
+         */
+        constexpr bool hasFastRsqrt = FZOLV_SIMD_SSE2 || FZOLV_SIMD_NEON;
+
+        /**
+         * @brief The maximum relative error of rsqrt against the exact 1 / sqrt(value), 2^-21
+         *
+         * The SSE estimate has a relative error of at most 1.5 * 2^-12 and one Newton-Raphson step brings it below
+         * 2^-21. The NEON estimate starts at about 2^-8 and needs two steps to get there.
+         */
+        constexpr float rsqrtMaxRelativeError = 1.0F / 2097152.0F;
+
+        /**
+         * @brief Compute an approximation of 1 / sqrt(value)
+         *
+         * The result is only meaningful for positive, normal, finite inputs. On platforms without a hardware estimate
+         * it is computed exactly.
+         *
+         * @param value The value to take the reciprocal square root of
+         * @return float 1 / sqrt(value) within rsqrtMaxRelativeError
+         */
+        inline auto rsqrt(float value) -> float
+        {
+#if FZOLV_SIMD_SSE2
+            const float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(value)));
+            return estimate * (1.5F - (0.5F * value * estimate * estimate));
+#elif FZOLV_SIMD_NEON
+            float32x2_t input = vdup_n_f32(value);
+            float32x2_t estimate = vrsqrte_f32(input);
+            estimate = vmul_f32(estimate, vrsqrts_f32(vmul_f32(input, estimate), estimate));
+            estimate = vmul_f32(estimate, vrsqrts_f32(vmul_f32(input, estimate), estimate));
+            return vget_lane_f32(estimate, 0);
+#else
+            return 1.0F / std::sqrt(value);
+#endif
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_SIMD_dun1pk */
@@ -0,0 +1,817 @@
+#ifndef FZOLV_SOA_hgax4f
+#define FZOLV_SOA_hgax4f
+
+#include <allocator.hpp>
+#include <batch.hpp>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector.hpp>
+#include <vector>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        ///< Element-wise loops over component lanes, shared by the structure-of-arrays containers
+
+        template <typename T>
+        void addLanes(T *dst, const T *src, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] += src[i];
+            }
+        }
+
+        template <typename T>
+        void subLanes(T *dst, const T *src, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] -= src[i];
+            }
+        }
+
+        template <typename T>
+        void addScalar(T *dst, T value, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] += value;
+            }
+        }
+
+        template <typename T>
+        void mulScalar(T *dst, T value, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] *= value;
+            }
+        }
+
+        template <typename T>
+        void divScalar(T *dst, T value, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] /= value;
+            }
+        }
+
+        template <typename T>
+        void clampLanes(T *dst, T low, T high, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = detail::clampComponent(dst[i], low, high);
+            }
+        }
+
+        template <typename T>
+        void lerpLanes(const T *start, const T *end, precision_type_t<T> amount, T *dst, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                dst[i] = detail::lerp(start[i], end[i], amount);
+            }
+        }
+    }
+
+    /**
+     * @brief A proxy that refers to one element of a structure-of-arrays container
+     *
+     * Vector2Ref behaves like a Vector2& whose components live in two separate arrays. Reading it yields a Vector2,
+     * assigning to it writes the components back to their lanes.
+     *
+     * @tparam T The type of the vector components, const-qualified for read-only proxies
+     */
+    template <typename T>
+    class Vector2Ref
+    {
+    public:
+        using value_type = Vector2<std::remove_const_t<T>>;
+
+        constexpr Vector2Ref(T &xRef, T &yRef) noexcept : x{xRef}, y{yRef} {}
+
+        constexpr Vector2Ref(const Vector2Ref &) noexcept = default;
+
+        /**
+         * @brief Assign the value of another element, not rebind the proxy
+         *
+         * @param other The element to copy the components from
+         * @return Vector2Ref& A reference to this proxy
+         */
+        constexpr auto operator=(const Vector2Ref &other) -> Vector2Ref &
+        {
+            x = other.x;
+            y = other.y;
+            return *this;
+        }
+
+        constexpr auto operator=(const value_type &value) -> Vector2Ref &
+        {
+            x = value.x;
+            y = value.y;
+            return *this;
+        }
+
+        constexpr operator value_type() const { return {x, y}; }
+
+        constexpr auto operator+=(const value_type &other) -> Vector2Ref &
+        {
+            x += other.x;
+            y += other.y;
+            return *this;
+        }
+
+        constexpr auto operator-=(const value_type &other) -> Vector2Ref &
+        {
+            x -= other.x;
+            y -= other.y;
+            return *this;
+        }
+
+        constexpr auto operator*=(std::remove_const_t<T> scalar) -> Vector2Ref &
+        {
+            x *= scalar;
+            y *= scalar;
+            return *this;
+        }
+
+        constexpr auto operator/=(std::remove_const_t<T> scalar) -> Vector2Ref &
+        {
+            x /= scalar;
+            y /= scalar;
+            return *this;
+        }
+
+        /**
+         * @brief The x component of the referenced element
+         */
+        T &x;
+
+        /**
+         * @brief The y component of the referenced element
+         */
+        T &y;
+    };
+
+    /**
+     * @brief A structure-of-arrays container for 2D vectors
+     *
+     * Vector2SoA keeps the x and y components of its elements in two separate, cache-line aligned arrays so that
+     * bulk passes run over contiguous lanes of a single component. Element access goes through Vector2Ref proxies,
+     * bulk operations work on whole lanes at once and are written so that the compiler can vectorize them.
+     *
+     * @tparam T The type of the vector components, must be arithmetic
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class Vector2SoA
+    {
+    public:
+        using value_type = Vector2<T>;
+        using reference = Vector2Ref<T>;
+        using const_reference = Vector2Ref<const T>;
+        using size_type = std::size_t;
+        using allocator_type = AlignedAllocator<T>;
+        using lane_type = std::vector<T, allocator_type>;
+
+        /**
+         * @brief Default constructor, creates an empty container
+         */
+        Vector2SoA() = default;
+
+        /**
+         * @brief Create an empty container whose lanes allocate through allocator, for example from a FrameArena
+         */
+        explicit Vector2SoA(const allocator_type &allocator) : xs(allocator), ys(allocator) {}
+
+        /**
+         * @brief Create a container of count elements, all equal to value
+         *
+         * @param count The number of elements
+         * @param value The value of every element
+         * @param allocator The allocator of the lanes
+         */
+        explicit Vector2SoA(size_type count, const Vector2<T> &value = {}, const allocator_type &allocator = {})
+            : xs(count, value.x, allocator), ys(count, value.y, allocator)
+        {
+        }
+
+        /**
+         * @brief Create a container from an array of vectors
+         *
+         * @param first A pointer to the first vector
+         * @param count The number of vectors to copy
+         * @param allocator The allocator of the lanes
+         */
+        Vector2SoA(const Vector2<T> *first, size_type count, const allocator_type &allocator = {})
+            : xs(count, allocator), ys(count, allocator)
+        {
+            for (size_type i = 0; i < count; ++i)
+            {
+                xs[i] = first[i].x;
+                ys[i] = first[i].y;
+            }
+        }
+
+        [[nodiscard]] auto get_allocator() const noexcept -> allocator_type { return xs.get_allocator(); }
+
+        [[nodiscard]] auto size() const noexcept -> size_type { return xs.size(); }
+
+        [[nodiscard]] auto empty() const noexcept -> bool { return xs.empty(); }
+
+        void reserve(size_type count)
+        {
+            xs.reserve(count);
+            ys.reserve(count);
+        }
+
+        void resize(size_type count, const Vector2<T> &value = {})
+        {
+            xs.resize(count, value.x);
+            ys.resize(count, value.y);
+        }
+
+        void clear() noexcept
+        {
+            xs.clear();
+            ys.clear();
+        }
+
+        void push_back(const Vector2<T> &value)
+        {
+            xs.push_back(value.x);
+            ys.push_back(value.y);
+        }
+
+        auto operator[](size_type index) -> reference { return {xs[index], ys[index]}; }
+
+        auto operator[](size_type index) const -> const_reference { return {xs[index], ys[index]}; }
+
+        /**
+         * @brief Read one element as a Vector2
+         *
+         * @param index The index of the element
+         * @return Vector2<T> A copy of the element
+         */
+        [[nodiscard]] auto get(size_type index) const -> Vector2<T> { return {xs[index], ys[index]}; }
+
+        /**
+         * @brief Raw access to the component lanes, aligned to cacheLineSize bytes
+         */
+        [[nodiscard]] auto xData() noexcept -> T * { return xs.data(); }
+        [[nodiscard]] auto yData() noexcept -> T * { return ys.data(); }
+        [[nodiscard]] auto xData() const noexcept -> const T * { return xs.data(); }
+        [[nodiscard]] auto yData() const noexcept -> const T * { return ys.data(); }
+
+        /**
+         * @brief Overload compound assignment operators for bulk element-wise arithmetic
+         *
+         * Adding or subtracting another container works element by element and requires both containers to have
+         * the same size. Adding or subtracting a single vector applies it to every element. Scalar multiplication and
+         * division scale every element.
+         */
+        auto operator+=(const Vector2SoA &other) -> Vector2SoA &
+        {
+            assert(other.size() == size());
+            detail::addLanes(xs.data(), other.xs.data(), size());
+            detail::addLanes(ys.data(), other.ys.data(), size());
+            return *this;
+        }
+
+        auto operator-=(const Vector2SoA &other) -> Vector2SoA &
+        {
+            assert(other.size() == size());
+            detail::subLanes(xs.data(), other.xs.data(), size());
+            detail::subLanes(ys.data(), other.ys.data(), size());
+            return *this;
+        }
+
+        auto operator+=(const Vector2<T> &other) -> Vector2SoA &
+        {
+            detail::addScalar(xs.data(), other.x, size());
+            detail::addScalar(ys.data(), other.y, size());
+            return *this;
+        }
+
+        auto operator-=(const Vector2<T> &other) -> Vector2SoA &
+        {
+            detail::addScalar(xs.data(), T(-other.x), size());
+            detail::addScalar(ys.data(), T(-other.y), size());
+            return *this;
+        }
+
+        auto operator*=(T scalar) -> Vector2SoA &
+        {
+            detail::mulScalar(xs.data(), scalar, size());
+            detail::mulScalar(ys.data(), scalar, size());
+            return *this;
+        }
+
+        auto operator/=(T scalar) -> Vector2SoA &
+        {
+            detail::divScalar(xs.data(), scalar, size());
+            detail::divScalar(ys.data(), scalar, size());
+            return *this;
+        }
+
+        /**
+         * @brief Normalize every element in-place, like Vector2::normalize
+         *
+         * Zero vectors are left unchanged. Float lanes go through the SIMD kernels of the active level, which give
+         * the same results as normalizing every element on its own.
+         *
+         * @return Vector2SoA& A reference to this container
+         */
+        auto normalize() -> Vector2SoA &
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                batch::detail::best::normalizeLanes(xs.data(), ys.data(), size());
+                return *this;
+            }
+            T *px = xs.data();
+            T *py = ys.data();
+            const size_type count = size();
+            for (size_type i = 0; i < count; ++i)
+            {
+                Vector2<T> value{px[i], py[i]};
+                value.normalize();
+                px[i] = value.x;
+                py[i] = value.y;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Clamp every element component-wise to the range [min, max], like Vector2::clamp
+         *
+         * @param min The vector representing the minimum values
+         * @param max The vector representing the maximum values
+         * @return Vector2SoA& A reference to this container
+         */
+        auto clamp(const Vector2<T> &min, const Vector2<T> &max) -> Vector2SoA &
+        {
+            detail::clampLanes(xs.data(), min.x, max.x, size());
+            detail::clampLanes(ys.data(), min.y, max.y, size());
+            return *this;
+        }
+
+        /**
+         * @brief Linearly interpolate two containers element by element, like Vector2::Lerp
+         *
+         * @param start The container of start vectors
+         * @param end The container of end vectors, must have the same size as start
+         * @param amount The interpolation factor
+         * @param out The container receiving the result, resized to the size of start
+         */
+        static void Lerp(const Vector2SoA &start, const Vector2SoA &end, precision_type_t<T> amount, Vector2SoA &out)
+        {
+            assert(start.size() == end.size());
+            out.resize(start.size());
+            detail::lerpLanes(start.xs.data(), end.xs.data(), amount, out.xs.data(), start.size());
+            detail::lerpLanes(start.ys.data(), end.ys.data(), amount, out.ys.data(), start.size());
+        }
+
+    private:
+        lane_type xs;
+        lane_type ys;
+    };
+
+    /**
+     * @brief A proxy that refers to one element of a structure-of-arrays container
+     *
+     * Vector3Ref behaves like a Vector3& whose components live in three separate arrays. Reading it yields a Vector3,
+     * assigning to it writes the components back to their lanes.
+     *
+     * @tparam T The type of the vector components, const-qualified for read-only proxies
+     */
+    template <typename T>
+    class Vector3Ref
+    {
+    public:
+        using value_type = Vector3<std::remove_const_t<T>>;
+
+        constexpr Vector3Ref(T &xRef, T &yRef, T &zRef) noexcept : x{xRef}, y{yRef}, z{zRef} {}
+
+        constexpr Vector3Ref(const Vector3Ref &) noexcept = default;
+
+        /**
+         * @brief Assign the value of another element, not rebind the proxy
+         *
+         * @param other The element to copy the components from
+         * @return Vector3Ref& A reference to this proxy
+         */
+        constexpr auto operator=(const Vector3Ref &other) -> Vector3Ref &
+        {
+            x = other.x;
+            y = other.y;
+            z = other.z;
+            return *this;
+        }
+
+        constexpr auto operator=(const value_type &value) -> Vector3Ref &
+        {
+            x = value.x;
+            y = value.y;
+            z = value.z;
+            return *this;
+        }
+
+        constexpr operator value_type() const { return {x, y, z}; }
+
+        constexpr auto operator+=(const value_type &other) -> Vector3Ref &
+        {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            return *this;
+        }
+
+        constexpr auto operator-=(const value_type &other) -> Vector3Ref &
+        {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            return *this;
+        }
+
+        constexpr auto operator*=(std::remove_const_t<T> scalar) -> Vector3Ref &
+        {
+            x *= scalar;
+            y *= scalar;
+            z *= scalar;
+            return *this;
+        }
+
+        constexpr auto operator/=(std::remove_const_t<T> scalar) -> Vector3Ref &
+        {
+            x /= scalar;
+            y /= scalar;
+            z /= scalar;
+            return *this;
+        }
+
+        /**
+         * @brief The x component of the referenced element
+         */
+        T &x;
+
+        /**
+         * @brief The y component of the referenced element
+         */
+        T &y;
+
+        /**
+         * @brief The z component of the referenced element
+         */
+        T &z;
+    };
+
+    /**
+     * @brief A structure-of-arrays container for 3D vectors
+     *
+     * Vector3SoA keeps the x, y and z components of its elements in three separate, cache-line aligned arrays so that
+     * bulk passes run over contiguous lanes of a single component. Element access goes through Vector3Ref proxies,
+     * bulk operations work on whole lanes at once and are written so that the compiler can vectorize them.
+     *
+     * @tparam T The type of the vector components, must be arithmetic
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class Vector3SoA
+    {
+    public:
+        using value_type = Vector3<T>;
+        using reference = Vector3Ref<T>;
+        using const_reference = Vector3Ref<const T>;
+        using size_type = std::size_t;
+        using allocator_type = AlignedAllocator<T>;
+        using lane_type = std::vector<T, allocator_type>;
+
+        /**
+         * @brief Default constructor, creates an empty container
+         */
+        Vector3SoA() = default;
+
+        /**
+         * @brief Create an empty container whose lanes allocate through allocator, for example from a FrameArena
+         */
+        explicit Vector3SoA(const allocator_type &allocator) : xs(allocator), ys(allocator), zs(allocator) {}
+
+        /**
+         * @brief Create a container of count elements, all equal to value
+         *
+         * @param count The number of elements
+         * @param value The value of every element
+         * @param allocator The allocator of the lanes
+         */
+        explicit Vector3SoA(size_type count, const Vector3<T> &value = {}, const allocator_type &allocator = {})
+            : xs(count, value.x, allocator), ys(count, value.y, allocator), zs(count, value.z, allocator)
+        {
+        }
+
+        /**
+         * @brief Create a container from an array of vectors
+         *
+         * @param first A pointer to the first vector
+         * @param count The number of vectors to copy
+         * @param allocator The allocator of the lanes
+         */
+        Vector3SoA(const Vector3<T> *first, size_type count, const allocator_type &allocator = {})
+            : xs(count, allocator), ys(count, allocator), zs(count, allocator)
+        {
+            for (size_type i = 0; i < count; ++i)
+            {
+                xs[i] = first[i].x;
+                ys[i] = first[i].y;
+                zs[i] = first[i].z;
+            }
+        }
+
+        [[nodiscard]] auto get_allocator() const noexcept -> allocator_type { return xs.get_allocator(); }
+
+        [[nodiscard]] auto size() const noexcept -> size_type { return xs.size(); }
+
+        [[nodiscard]] auto empty() const noexcept -> bool { return xs.empty(); }
+
+        void reserve(size_type count)
+        {
+            xs.reserve(count);
+            ys.reserve(count);
+            zs.reserve(count);
+        }
+
+        void resize(size_type count, const Vector3<T> &value = {})
+        {
+            xs.resize(count, value.x);
+            ys.resize(count, value.y);
+            zs.resize(count, value.z);
+        }
+
+        void clear() noexcept
+        {
+            xs.clear();
+            ys.clear();
+            zs.clear();
+        }
+
+        void push_back(const Vector3<T> &value)
+        {
+            xs.push_back(value.x);
+            ys.push_back(value.y);
+            zs.push_back(value.z);
+        }
+
+        auto operator[](size_type index) -> reference { return {xs[index], ys[index], zs[index]}; }
+
+        auto operator[](size_type index) const -> const_reference { return {xs[index], ys[index], zs[index]}; }
+
+        /**
+         * @brief Read one element as a Vector3
+         *
+         * @param index The index of the element
+         * @return Vector3<T> A copy of the element
+         */
+        [[nodiscard]] auto get(size_type index) const -> Vector3<T> { return {xs[index], ys[index], zs[index]}; }
+
+        /**
+         * @brief Raw access to the component lanes, aligned to cacheLineSize bytes
+         */
+        [[nodiscard]] auto xData() noexcept -> T * { return xs.data(); }
+        [[nodiscard]] auto yData() noexcept -> T * { return ys.data(); }
+        [[nodiscard]] auto zData() noexcept -> T * { return zs.data(); }
+        [[nodiscard]] auto xData() const noexcept -> const T * { return xs.data(); }
+        [[nodiscard]] auto yData() const noexcept -> const T * { return ys.data(); }
+        [[nodiscard]] auto zData() const noexcept -> const T * { return zs.data(); }
+
+        /**
+         * @brief Overload compound assignment operators for bulk element-wise arithmetic
+         *
+         * Adding or subtracting another container works element by element and requires both containers to have
+         * the same size. Adding or subtracting a single vector applies it to every element. Scalar multiplication and
+         * division scale every element.
+         */
+        auto operator+=(const Vector3SoA &other) -> Vector3SoA &
+        {
+            assert(other.size() == size());
+            detail::addLanes(xs.data(), other.xs.data(), size());
+            detail::addLanes(ys.data(), other.ys.data(), size());
+            detail::addLanes(zs.data(), other.zs.data(), size());
+            return *this;
+        }
+
+        auto operator-=(const Vector3SoA &other) -> Vector3SoA &
+        {
+            assert(other.size() == size());
+            detail::subLanes(xs.data(), other.xs.data(), size());
+            detail::subLanes(ys.data(), other.ys.data(), size());
+            detail::subLanes(zs.data(), other.zs.data(), size());
+            return *this;
+        }
+
+        auto operator+=(const Vector3<T> &other) -> Vector3SoA &
+        {
+            detail::addScalar(xs.data(), other.x, size());
+            detail::addScalar(ys.data(), other.y, size());
+            detail::addScalar(zs.data(), other.z, size());
+            return *this;
+        }
+
+        auto operator-=(const Vector3<T> &other) -> Vector3SoA &
+        {
+            detail::addScalar(xs.data(), T(-other.x), size());
+            detail::addScalar(ys.data(), T(-other.y), size());
+            detail::addScalar(zs.data(), T(-other.z), size());
+            return *this;
+        }
+
+        auto operator*=(T scalar) -> Vector3SoA &
+        {
+            detail::mulScalar(xs.data(), scalar, size());
+            detail::mulScalar(ys.data(), scalar, size());
+            detail::mulScalar(zs.data(), scalar, size());
+            return *this;
+        }
+
+        auto operator/=(T scalar) -> Vector3SoA &
+        {
+            detail::divScalar(xs.data(), scalar, size());
+            detail::divScalar(ys.data(), scalar, size());
+            detail::divScalar(zs.data(), scalar, size());
+            return *this;
+        }
+
+        /**
+         * @brief Normalize every element in-place, like Vector3::normalize
+         *
+         * Zero vectors are left unchanged. Float lanes go through the SIMD kernels of the active level, which give
+         * the same results as normalizing every element on its own.
+         *
+         * @return Vector3SoA& A reference to this container
+         */
+        auto normalize() -> Vector3SoA &
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                batch::detail::best::normalizeLanes(xs.data(), ys.data(), zs.data(), size());
+                return *this;
+            }
+            T *px = xs.data();
+            T *py = ys.data();
+            T *pz = zs.data();
+            const size_type count = size();
+            for (size_type i = 0; i < count; ++i)
+            {
+                Vector3<T> value{px[i], py[i], pz[i]};
+                value.normalize();
+                px[i] = value.x;
+                py[i] = value.y;
+                pz[i] = value.z;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Clamp every element component-wise to the range [min, max], like Vector3::clamp
+         *
+         * @param min The vector representing the minimum values
+         * @param max The vector representing the maximum values
+         * @return Vector3SoA& A reference to this container
+         */
+        auto clamp(const Vector3<T> &min, const Vector3<T> &max) -> Vector3SoA &
+        {
+            detail::clampLanes(xs.data(), min.x, max.x, size());
+            detail::clampLanes(ys.data(), min.y, max.y, size());
+            detail::clampLanes(zs.data(), min.z, max.z, size());
+            return *this;
+        }
+
+        /**
+         * @brief Linearly interpolate two containers element by element, like Vector3::Lerp
+         *
+         * @param start The container of start vectors
+         * @param end The container of end vectors, must have the same size as start
+         * @param amount The interpolation factor
+         * @param out The container receiving the result, resized to the size of start
+         */
+        static void Lerp(const Vector3SoA &start, const Vector3SoA &end, precision_type_t<T> amount, Vector3SoA &out)
+        {
+            assert(start.size() == end.size());
+            out.resize(start.size());
+            detail::lerpLanes(start.xs.data(), end.xs.data(), amount, out.xs.data(), start.size());
+            detail::lerpLanes(start.ys.data(), end.ys.data(), amount, out.ys.data(), start.size());
+            detail::lerpLanes(start.zs.data(), end.zs.data(), amount, out.zs.data(), start.size());
+        }
+
+    private:
+        lane_type xs;
+        lane_type ys;
+        lane_type zs;
+    };
+
+    using Vector2fSoA = Vector2SoA<float>;
+    using Vector2iSoA = Vector2SoA<int>;
+    using Vector3fSoA = Vector3SoA<float>;
+    using Vector3iSoA = Vector3SoA<int>;
+
+    namespace batch
+    {
+        namespace detail
+        {
+            ///< Every lane of a SoA container holds a single component, so the bounds do not repeat
+            inline void clampLane(float *values, std::size_t count, float low, float high)
+            {
+                clampVectors(values, values, count, 1, &low, &high);
+            }
+        }
+
+        /**
+         * @brief Clamp every element component-wise to [min, max] using SIMD min and max, like Vector2SoA::clamp
+         *
+         * @param values The container to clamp in place
+         * @param min The lower bounds, each component at most the matching one of max
+         * @param max The upper bounds
+         */
+        inline void clamp(Vector2fSoA &values, const Vector2f &min, const Vector2f &max)
+        {
+            detail::clampLane(values.xData(), values.size(), min.x, max.x);
+            detail::clampLane(values.yData(), values.size(), min.y, max.y);
+        }
+
+        inline void clamp(Vector3fSoA &values, const Vector3f &min, const Vector3f &max)
+        {
+            detail::clampLane(values.xData(), values.size(), min.x, max.x);
+            detail::clampLane(values.yData(), values.size(), min.y, max.y);
+            detail::clampLane(values.zData(), values.size(), min.z, max.z);
+        }
+
+        /**
+         * @brief The component-wise minimum of two containers, std::min per component
+         *
+         * @param lhs The first container
+         * @param rhs The second container, must have the same size as lhs
+         * @param out The container receiving the result, resized to the size of lhs
+         */
+        inline void min(const Vector2fSoA &lhs, const Vector2fSoA &rhs, Vector2fSoA &out)
+        {
+            assert(lhs.size() == rhs.size());
+            out.resize(lhs.size());
+            detail::minimumFloats(lhs.xData(), rhs.xData(), out.xData(), lhs.size());
+            detail::minimumFloats(lhs.yData(), rhs.yData(), out.yData(), lhs.size());
+        }
+
+        inline void min(const Vector3fSoA &lhs, const Vector3fSoA &rhs, Vector3fSoA &out)
+        {
+            assert(lhs.size() == rhs.size());
+            out.resize(lhs.size());
+            detail::minimumFloats(lhs.xData(), rhs.xData(), out.xData(), lhs.size());
+            detail::minimumFloats(lhs.yData(), rhs.yData(), out.yData(), lhs.size());
+            detail::minimumFloats(lhs.zData(), rhs.zData(), out.zData(), lhs.size());
+        }
+
+        /**
+         * @brief The component-wise maximum of two containers, std::max per component
+         *
+         * @param lhs The first container
+         * @param rhs The second container, must have the same size as lhs
+         * @param out The container receiving the result, resized to the size of lhs
+         */
+        inline void max(const Vector2fSoA &lhs, const Vector2fSoA &rhs, Vector2fSoA &out)
+        {
+            assert(lhs.size() == rhs.size());
+            out.resize(lhs.size());
+            detail::maximumFloats(lhs.xData(), rhs.xData(), out.xData(), lhs.size());
+            detail::maximumFloats(lhs.yData(), rhs.yData(), out.yData(), lhs.size());
+        }
+
+        inline void max(const Vector3fSoA &lhs, const Vector3fSoA &rhs, Vector3fSoA &out)
+        {
+            assert(lhs.size() == rhs.size());
+            out.resize(lhs.size());
+            detail::maximumFloats(lhs.xData(), rhs.xData(), out.xData(), lhs.size());
+            detail::maximumFloats(lhs.yData(), rhs.yData(), out.yData(), lhs.size());
+            detail::maximumFloats(lhs.zData(), rhs.zData(), out.zData(), lhs.size());
+        }
+
+        /**
+         * @brief Replace every component by its absolute value
+         */
+        inline void abs(Vector2fSoA &values)
+        {
+            detail::absFloats(values.xData(), values.xData(), values.size());
+            detail::absFloats(values.yData(), values.yData(), values.size());
+        }
+
+        inline void abs(Vector3fSoA &values)
+        {
+            detail::absFloats(values.xData(), values.xData(), values.size());
+            detail::absFloats(values.yData(), values.yData(), values.size());
+            detail::absFloats(values.zData(), values.zData(), values.size());
+        }
+    }
+}
+
+#endif /* end of include guard: FZOLV_SOA_hgax4f */
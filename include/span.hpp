@@ -0,0 +1,122 @@
+#ifndef FZOLV_SPAN_tatenk
+#define FZOLV_SPAN_tatenk
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace Fzolv
+{
+    /**
+     * @brief A non-owning view over a contiguous sequence of objects
+     *
+     * span is a minimal stand-in for C++20 std::span with a dynamic extent, so that batch kernels can take arrays,
+     * std::vector, std::array and raw pointer ranges without copying while the library still targets C++17.
+     * A span<T> converts implicitly to span<const T>.
+     *
+     * @tparam T The type of the viewed elements, const-qualified for read-only views
+     */
+    template <typename T>
+    class span
+    {
+        template <typename Container>
+        using container_element_t = std::remove_pointer_t<decltype(std::data(std::declval<Container &>()))>;
+
+        template <typename U>
+        using is_compatible_element = std::is_convertible<U (*)[], T (*)[]>;
+
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using pointer = T *;
+        using reference = T &;
+        using iterator = T *;
+
+        /**
+         * @brief Default constructor, creates an empty view
+         */
+        constexpr span() noexcept = default;
+
+        /**
+         * @brief Create a view over count elements starting at first
+         *
+         * @param first A pointer to the first element
+         * @param count The number of elements
+         */
+        constexpr span(T *first, size_type count) noexcept : ptr{first}, len{count} {}
+
+        template <std::size_t N>
+        constexpr span(T (&array)[N]) noexcept : ptr{array}, len{N}
+        {
+        }
+
+        /**
+         * @brief Create a view over any contiguous container that provides data() and size()
+         *
+         * @param container The container to view, must outlive the span
+         */
+        template <typename Container,
+                  typename = std::enable_if_t<!std::is_same<std::remove_cv_t<Container>, span>::value &&
+                                              !std::is_array<Container>::value &&
+                                              is_compatible_element<container_element_t<Container>>::value>>
+        constexpr span(Container &container) noexcept(noexcept(std::data(container)))
+            : ptr{std::data(container)}, len{std::size(container)}
+        {
+        }
+
+        template <typename U, typename = std::enable_if_t<!std::is_same<U, T>::value && is_compatible_element<U>::value>>
+        constexpr span(const span<U> &other) noexcept : ptr{other.data()}, len{other.size()}
+        {
+        }
+
+        [[nodiscard]] constexpr auto data() const noexcept -> T * { return ptr; }
+
+        [[nodiscard]] constexpr auto size() const noexcept -> size_type { return len; }
+
+        [[nodiscard]] constexpr auto size_bytes() const noexcept -> size_type { return len * sizeof(T); }
+
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool { return len == 0; }
+
+        [[nodiscard]] constexpr auto begin() const noexcept -> iterator { return ptr; }
+
+        [[nodiscard]] constexpr auto end() const noexcept -> iterator { return ptr + len; }
+
+        constexpr auto operator[](size_type index) const -> T &
+        {
+            assert(index < len);
+            return ptr[index];
+        }
+
+        /**
+         * @brief Get a view over count elements starting at offset
+         *
+         * @param offset The index of the first element of the subview
+         * @param count The number of elements of the subview
+         * @return span A view over the requested elements
+         */
+        [[nodiscard]] constexpr auto subspan(size_type offset, size_type count) const -> span
+        {
+            assert(offset <= len && count <= len - offset);
+            return {ptr + offset, count};
+        }
+
+        [[nodiscard]] constexpr auto first(size_type count) const -> span { return subspan(0, count); }
+
+        [[nodiscard]] constexpr auto last(size_type count) const -> span { return subspan(len - count, count); }
+
+    private:
+        T *ptr = nullptr;
+        size_type len = 0;
+    };
+
+    template <typename T, std::size_t N>
+    span(T (&)[N]) -> span<T>;
+
+    template <typename Container>
+    span(Container &) -> span<std::remove_pointer_t<decltype(std::data(std::declval<Container &>()))>>;
+}
+
+#endif /* end of include guard: FZOLV_SPAN_tatenk */
@@ -0,0 +1,410 @@
+#ifndef FZOLV_SPATIAL_HASH_jy10nn
+#define FZOLV_SPATIAL_HASH_jy10nn
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <profile.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+#include <vector>
+
+namespace Fzolv
+{
+    /**
+     * @brief A uniform grid over 2D positions, hashed into a fixed number of buckets, for radius and box queries
+     *
+     * Positions are sorted by bucket with a counting sort into one contiguous array, so a query reads a few short,
+     * contiguous runs instead of chasing nodes. Each entry keeps a copy of its position and its cell next to the
+     * original index, which lets queries filter hash collisions and test distances without touching the caller's
+     * data. Rebuilding reuses every buffer, and update() only moves the entries that left their cells into their new
+     * buckets instead of sorting again. The per-position work of large builds and updates is split across threads with
+     * parallelFor.
+     *
+     * Any position is accepted. Cell coordinates are clamped to +-2^30, so positions further out share the border
+     * cells and NaN positions land in the lowest one, where the exact tests of the queries never report them.
+     *
+     * Queries never allocate: they either call a visitor or write indices into a caller-provided span. A query box
+     * covering more cells than there are buckets scans the entries once instead of visiting every cell.
+     *
+     * @tparam T The type of the vector components, must be numeric
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class SpatialHash2D
+    {
+    public:
+        using index_type = std::uint32_t;
+        using size_type = std::size_t;
+
+        /**
+         * @brief One position stored in the grid, in bucket order
+         */
+        struct Entry
+        {
+            Vector2<T> position;
+            std::int32_t cellX;
+            std::int32_t cellY;
+            index_type index; ///< The index of the position in the span given to build()
+        };
+
+        /**
+         * @brief Create an empty grid
+         *
+         * @param cellSize The side length of a grid cell, ideally close to the typical query radius
+         */
+        explicit SpatialHash2D(T cellSize) : side{cellSize}, inverse{precision_type_t<T>(1) / static_cast<precision_type_t<T>>(cellSize)}
+        {
+            assert(cellSize > T(0) && "the cell size must be positive");
+        }
+
+        [[nodiscard]] auto cellSize() const noexcept -> T { return side; }
+
+        [[nodiscard]] auto size() const noexcept -> size_type { return entries.size(); }
+
+        [[nodiscard]] auto empty() const noexcept -> bool { return entries.empty(); }
+
+        [[nodiscard]] auto bucketCount() const noexcept -> size_type { return mask + 1; }
+
+        /**
+         * @brief The stored positions in bucket order
+         */
+        [[nodiscard]] auto data() const noexcept -> span<const Entry> { return {entries.data(), entries.size()}; }
+
+        /**
+         * @brief Insert every position, replacing the previous contents
+         *
+         * @param positions The positions, their indices in this span are what queries report
+         */
+        void build(span<const Vector2<T>> positions)
+        {
+            FZOLV_PROFILE_ZONE("SpatialHash2D::build", positions.size());
+            assert(positions.size() <= std::numeric_limits<index_type>::max() && "too many positions for index_type");
+            const size_type count = positions.size();
+
+            ///< A power of two at least as large as the count keeps buckets short and turns the modulo into a mask
+            size_type buckets = mask + 1;
+            while (buckets < count)
+            {
+                buckets *= 2;
+            }
+            mask = buckets - 1;
+
+            cells.resize(count);
+            slots.resize(count);
+            entries.resize(count);
+            starts.assign(buckets + 1, 0);
+
+            ///< Finding the cells is the only part that splits across threads, the counting sort stays sequential
+            parallelFor(count, buildGrain,
+                        [&](size_type begin, size_type end)
+                        {
+                            for (size_type i = begin; i < end; ++i)
+                            {
+                                cells[i] = cellOf(positions[i]);
+                            }
+                        });
+            for (size_type i = 0; i < count; ++i)
+            {
+                ++starts[bucketOf(cells[i])];
+            }
+            for (size_type b = 1; b <= buckets; ++b)
+            {
+                starts[b] += starts[b - 1];
+            }
+
+            ///< starts[b] holds the end of bucket b, filling backwards leaves it at the beginning and keeps the order
+            for (size_type i = count; i-- > 0;)
+            {
+                const index_type slot = --starts[bucketOf(cells[i])];
+                slots[i] = slot;
+                entries[slot] = Entry{positions[i], cells[i].x, cells[i].y, static_cast<index_type>(i)};
+            }
+        }
+
+        /**
+         * @brief Refresh the grid for moved positions
+         *
+         * The stored copies are rewritten in place. Entries that changed cells within their bucket keep their slot,
+         * the ones that changed buckets are sorted by their new bucket and merged into the others in one sequential
+         * pass, which also shifts the bucket starts by the per-bucket change in count. Only when more than a quarter of
+         * the positions changed buckets, or the count differs from the last build, the whole grid is rebuilt at the
+         * cost of build().
+         *
+         * @param positions The new positions, in the same order as in the last build
+         */
+        void update(span<const Vector2<T>> positions)
+        {
+            FZOLV_PROFILE_ZONE("SpatialHash2D::update", positions.size());
+            if (positions.size() != entries.size())
+            {
+                build(positions);
+                return;
+            }
+            std::atomic<size_type> changed{0};
+            parallelFor(positions.size(), buildGrain,
+                        [&](size_type begin, size_type end)
+                        {
+                            size_type local = 0;
+                            for (size_type i = begin; i < end; ++i)
+                            {
+                                const Cell cell = cellOf(positions[i]);
+                                local += cell.x != cells[i].x || cell.y != cells[i].y;
+                                cells[i] = cell;
+                                entries[slots[i]].position = positions[i];
+                            }
+                            changed.fetch_add(local, std::memory_order_relaxed);
+                        });
+            if (changed.load(std::memory_order_relaxed) != 0)
+            {
+                rebucket(positions);
+            }
+        }
+
+        /**
+         * @brief Call fn(index, position) for every position within radius of center, boundary included
+         */
+        template <typename Fn>
+        void forEachInRadius(const Vector2<T> &center, T radius, Fn &&fn) const
+        {
+            const T radiusSquared = radius * radius;
+            forEachCandidate(cellOf({center.x - radius, center.y - radius}), cellOf({center.x + radius, center.y + radius}),
+                             [&](const Entry &entry)
+                             {
+                                 if (center.distanceToSquared(entry.position) <= radiusSquared)
+                                 {
+                                     fn(entry.index, entry.position);
+                                 }
+                             });
+        }
+
+        /**
+         * @brief Call fn(index, position) for every position inside the box [min, max], boundary included
+         */
+        template <typename Fn>
+        void forEachInBox(const Vector2<T> &min, const Vector2<T> &max, Fn &&fn) const
+        {
+            forEachCandidate(cellOf(min), cellOf(max),
+                             [&](const Entry &entry)
+                             {
+                                 const Vector2<T> &p = entry.position;
+                                 if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y)
+                                 {
+                                     fn(entry.index, p);
+                                 }
+                             });
+        }
+
+        /**
+         * @brief Collect the indices of the positions within radius of center
+         *
+         * @param center The center of the query
+         * @param radius The query radius, boundary included
+         * @param out Receives the first out.size() indices found, in no particular order
+         * @return size_type The number of positions found, larger than out.size() when out was too small
+         */
+        auto queryRadius(const Vector2<T> &center, T radius, span<index_type> out) const -> size_type
+        {
+            size_type found = 0;
+            forEachInRadius(center, radius, [&](index_type index, const Vector2<T> &) { collect(out, found, index); });
+            return found;
+        }
+
+        /**
+         * @brief Collect the indices of the positions inside the box [min, max], see queryRadius
+         */
+        auto queryBox(const Vector2<T> &min, const Vector2<T> &max, span<index_type> out) const -> size_type
+        {
+            size_type found = 0;
+            forEachInBox(min, max, [&](index_type index, const Vector2<T> &) { collect(out, found, index); });
+            return found;
+        }
+
+    private:
+        struct Cell
+        {
+            std::int32_t x;
+            std::int32_t y;
+        };
+
+        ///< The minimum number of positions per thread for the parallel passes of build and update
+        static constexpr size_type buildGrain = size_type{1} << 14;
+
+        ///< The largest cell coordinate, far enough from the int32 limits that cell loops and ranges cannot overflow
+        static constexpr std::int32_t cellLimit = std::int32_t{1} << 30;
+
+        auto cellOf(const Vector2<T> &position) const -> Cell
+        {
+            return {cellCoordinate(position.x), cellCoordinate(position.y)};
+        }
+
+        auto cellCoordinate(T value) const -> std::int32_t
+        {
+            using P = precision_type_t<T>;
+            const P cell = math::floor(static_cast<P>(value) * inverse);
+            if constexpr (std::is_floating_point<P>::value)
+            {
+                ///< Clamp before the cast, which is undefined for NaN and out of range values, NaN fails the first test
+                const P limit = static_cast<P>(cellLimit);
+                if (!(cell > -limit))
+                {
+                    return -cellLimit;
+                }
+                return cell < limit ? static_cast<std::int32_t>(cell) : cellLimit;
+            }
+            else
+            {
+                return static_cast<std::int32_t>(cell);
+            }
+        }
+
+        auto bucketOf(std::int32_t x, std::int32_t y) const -> size_type
+        {
+            ///< The large primes of Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+            const std::uint32_t hash = (static_cast<std::uint32_t>(x) * 73856093u) ^ (static_cast<std::uint32_t>(y) * 19349663u);
+            return hash & mask;
+        }
+
+        auto bucketOf(const Cell &cell) const -> size_type { return bucketOf(cell.x, cell.y); }
+
+        ///< Visit the entries of every cell in [low, high], skipping other cells that share their buckets
+        template <typename Fn>
+        void forEachCandidate(const Cell &low, const Cell &high, Fn &&fn) const
+        {
+            if (entries.empty() || low.x > high.x || low.y > high.y)
+            {
+                return;
+            }
+            const std::uint64_t width = static_cast<std::uint64_t>(std::int64_t{high.x} - low.x + 1);
+            const std::uint64_t height = static_cast<std::uint64_t>(std::int64_t{high.y} - low.y + 1);
+            if (width * height > bucketCount())
+            {
+                ///< Every bucket would be read at least once anyway, so one pass over all entries is cheaper
+                for (const Entry &entry : entries)
+                {
+                    if (entry.cellX >= low.x && entry.cellX <= high.x && entry.cellY >= low.y && entry.cellY <= high.y)
+                    {
+                        fn(entry);
+                    }
+                }
+                return;
+            }
+            for (std::int32_t y = low.y; y <= high.y; ++y)
+            {
+                for (std::int32_t x = low.x; x <= high.x; ++x)
+                {
+                    const size_type bucket = bucketOf(x, y);
+                    for (index_type slot = starts[bucket]; slot < starts[bucket + 1]; ++slot)
+                    {
+                        const Entry &entry = entries[slot];
+                        if (entry.cellX == x && entry.cellY == y)
+                        {
+                            fn(entry);
+                        }
+                    }
+                }
+            }
+        }
+
+        ///< Move the entries whose cells differ from cells into the buckets of their new cells
+        void rebucket(span<const Vector2<T>> positions)
+        {
+            moved.clear();
+            for (Entry &entry : entries)
+            {
+                const Cell &cell = cells[entry.index];
+                if (entry.cellX == cell.x && entry.cellY == cell.y)
+                {
+                    continue;
+                }
+                if (bucketOf(cell) == bucketOf(entry.cellX, entry.cellY))
+                {
+                    entry.cellX = cell.x;
+                    entry.cellY = cell.y;
+                    continue;
+                }
+                moved.push_back(entry.index);
+            }
+            if (moved.size() > entries.size() / 4)
+            {
+                build(positions);
+                return;
+            }
+            std::sort(moved.begin(), moved.end(),
+                      [&](index_type lhs, index_type rhs) { return bucketOf(cells[lhs]) < bucketOf(cells[rhs]); });
+
+            ///< starts[b] ends up as the first slot of a bucket at or after b, which every emitted bucket fills in
+            spare.resize(entries.size());
+            size_type filled = 0;
+            size_type next = 0;
+            size_type bucket = 0;
+            auto emit = [&](const Entry &entry, size_type entryBucket)
+            {
+                for (; bucket <= entryBucket; ++bucket)
+                {
+                    starts[bucket] = static_cast<index_type>(filled);
+                }
+                slots[entry.index] = static_cast<index_type>(filled);
+                spare[filled++] = entry;
+            };
+            auto emitMoved = [&](size_type upTo)
+            {
+                for (; next < moved.size(); ++next)
+                {
+                    const index_type index = moved[next];
+                    const size_type movedBucket = bucketOf(cells[index]);
+                    if (movedBucket > upTo)
+                    {
+                        return;
+                    }
+                    emit(Entry{entries[slots[index]].position, cells[index].x, cells[index].y, index}, movedBucket);
+                }
+            };
+            for (const Entry &entry : entries)
+            {
+                const Cell &cell = cells[entry.index];
+                if (entry.cellX != cell.x || entry.cellY != cell.y)
+                {
+                    continue;
+                }
+                const size_type entryBucket = bucketOf(cell);
+                emitMoved(entryBucket);
+                emit(entry, entryBucket);
+            }
+            emitMoved(mask);
+            for (; bucket < starts.size(); ++bucket)
+            {
+                starts[bucket] = static_cast<index_type>(filled);
+            }
+            entries.swap(spare);
+        }
+
+        static void collect(span<index_type> out, size_type &found, index_type index)
+        {
+            if (found < out.size())
+            {
+                out[found] = index;
+            }
+            ++found;
+        }
+
+        T side;
+        precision_type_t<T> inverse;
+        size_type mask = 0;
+        std::vector<index_type> starts;
+        std::vector<Entry> entries;
+        std::vector<Cell> cells;
+        std::vector<index_type> slots;
+        std::vector<index_type> moved; ///< The positions that changed buckets in the last update
+        std::vector<Entry> spare;      ///< The entries being merged by update, swapped with entries when done
+    };
+
+    using SpatialHash2Df = SpatialHash2D<float>;
+}
+
+#endif /* end of include guard: FZOLV_SPATIAL_HASH_jy10nn */
@@ -0,0 +1,518 @@
+#ifndef FZOLV_TRANSFORM_2bhts8
+#define FZOLV_TRANSFORM_2bhts8
+
+#include <batch.hpp>
+#include <cassert>
+#include <cstddef>
+#include <matrix.hpp>
+#include <parallel.hpp>
+#include <profile.hpp>
+#include <simd.hpp>
+#include <soa.hpp>
+#include <span.hpp>
+#include <type_traits>
+#include <vector.hpp>
+
+namespace Fzolv
+{
+    namespace detail
+    {
+        ///< How far ahead of the current element the streaming kernels prefetch, in bytes
+        constexpr std::size_t prefetchDistance = 512;
+
+        ///< The smallest chunk of elements handed to one thread by the transform kernels
+        constexpr std::size_t transformGrain = std::size_t{1} << 14;
+    }
+
+    namespace batch
+    {
+        namespace detail
+        {
+            /**
+             * @brief The float transform kernels, vectors as (x, y, z, w) and 2D vectors as (x, y, 0, w)
+             *
+             * Every level computes the columns of the matrix scaled by the components and sums them from the first
+             * column to the last, like (m * Vector4f{v, w}).xyz(). zs and outZ of transformLanes are null for 2D
+             * vectors.
+             */
+            namespace scalar
+            {
+                inline void transformVector3(const Matrix4f &m, const Vector3f *in, Vector3f *out, std::size_t count,
+                                             float w)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        out[i] = (m * Vector4f{in[i], w}).xyz();
+                    }
+                }
+
+                inline void transformVector2(const Matrix4f &m, const Vector2f *in, Vector2f *out, std::size_t count,
+                                             float w)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const Vector4f r = m * Vector4f{in[i].x, in[i].y, 0.0F, w};
+                        out[i] = {r.x, r.y};
+                    }
+                }
+
+                inline void transformLanes(const Matrix4f &m, const float *xs, const float *ys, const float *zs,
+                                           float *outX, float *outY, float *outZ, std::size_t count, float w)
+                {
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const Vector4f r = m * Vector4f{xs[i], ys[i], zs != nullptr ? zs[i] : 0.0F, w};
+                        outX[i] = r.x;
+                        outY[i] = r.y;
+                        if (outZ != nullptr)
+                        {
+                            outZ[i] = r.z;
+                        }
+                    }
+                }
+            }
+
+#if FZOLV_SIMD_SSE2
+            namespace sse2
+            {
+                inline void transformVector3(const Matrix4f &m, const Vector3f *in, Vector3f *out, std::size_t count,
+                                             float w)
+                {
+                    const __m128 c0 = _mm_load_ps(&m.columns[0].x);
+                    const __m128 c1 = _mm_load_ps(&m.columns[1].x);
+                    const __m128 c2 = _mm_load_ps(&m.columns[2].x);
+                    const __m128 c3w = _mm_mul_ps(_mm_load_ps(&m.columns[3].x), _mm_set1_ps(w));
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        FZOLV_PREFETCH(reinterpret_cast<const char *>(in + i) + Fzolv::detail::prefetchDistance);
+                        __m128 r = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+                        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[i].y)));
+                        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(in[i].z)));
+                        r = _mm_add_ps(r, c3w);
+                        _mm_storel_pi(reinterpret_cast<__m64 *>(&out[i].x), r);
+                        _mm_store_ss(&out[i].z, _mm_movehl_ps(r, r));
+                    }
+                }
+
+                inline void transformVector2(const Matrix4f &m, const Vector2f *in, Vector2f *out, std::size_t count,
+                                             float w)
+                {
+                    const __m128 c0 = _mm_load_ps(&m.columns[0].x);
+                    const __m128 c1 = _mm_load_ps(&m.columns[1].x);
+                    const __m128 c2z = _mm_mul_ps(_mm_load_ps(&m.columns[2].x), _mm_setzero_ps());
+                    const __m128 c3w = _mm_mul_ps(_mm_load_ps(&m.columns[3].x), _mm_set1_ps(w));
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        FZOLV_PREFETCH(reinterpret_cast<const char *>(in + i) + Fzolv::detail::prefetchDistance);
+                        __m128 r = _mm_mul_ps(c0, _mm_set1_ps(in[i].x));
+                        r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(in[i].y)));
+                        r = _mm_add_ps(_mm_add_ps(r, c2z), c3w);
+                        _mm_storel_pi(reinterpret_cast<__m64 *>(&out[i].x), r);
+                    }
+                }
+
+                inline void transformLanes(const Matrix4f &m, const float *xs, const float *ys, const float *zs,
+                                           float *outX, float *outY, float *outZ, std::size_t count, float w)
+                {
+                    __m128 e[3][4];
+                    for (std::size_t r = 0; r < 3; ++r)
+                    {
+                        for (std::size_t c = 0; c < 3; ++c)
+                        {
+                            e[r][c] = _mm_set1_ps(m(r, c));
+                        }
+                        e[r][3] = _mm_set1_ps(m(r, 3) * w);
+                    }
+
+                    constexpr std::size_t ahead = Fzolv::detail::prefetchDistance / sizeof(float);
+                    const __m128 zero = _mm_setzero_ps();
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        FZOLV_PREFETCH(xs + i + ahead);
+                        FZOLV_PREFETCH(ys + i + ahead);
+                        const __m128 x = _mm_loadu_ps(xs + i);
+                        const __m128 y = _mm_loadu_ps(ys + i);
+                        const __m128 z = zs != nullptr ? _mm_loadu_ps(zs + i) : zero;
+                        __m128 r[3];
+                        for (std::size_t row = 0; row < 3; ++row)
+                        {
+                            r[row] = _mm_add_ps(_mm_mul_ps(e[row][0], x), _mm_mul_ps(e[row][1], y));
+                            r[row] = _mm_add_ps(_mm_add_ps(r[row], _mm_mul_ps(e[row][2], z)), e[row][3]);
+                        }
+                        _mm_storeu_ps(outX + i, r[0]);
+                        _mm_storeu_ps(outY + i, r[1]);
+                        if (outZ != nullptr)
+                        {
+                            _mm_storeu_ps(outZ + i, r[2]);
+                        }
+                    }
+                    scalar::transformLanes(m, xs + i, ys + i, zs != nullptr ? zs + i : nullptr, outX + i, outY + i,
+                                           outZ != nullptr ? outZ + i : nullptr, count - i, w);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_AVX2
+            namespace avx2
+            {
+                ///< One vector per register already keeps the AoS kernels bound by memory, only the lanes get wider
+                using sse2::transformVector2;
+                using sse2::transformVector3;
+
+                FZOLV_TARGET_AVX2 inline void transformLanes(const Matrix4f &m, const float *xs, const float *ys,
+                                                             const float *zs, float *outX, float *outY, float *outZ,
+                                                             std::size_t count, float w)
+                {
+                    __m256 e[3][4];
+                    for (std::size_t r = 0; r < 3; ++r)
+                    {
+                        for (std::size_t c = 0; c < 3; ++c)
+                        {
+                            e[r][c] = _mm256_set1_ps(m(r, c));
+                        }
+                        e[r][3] = _mm256_set1_ps(m(r, 3) * w);
+                    }
+
+                    constexpr std::size_t ahead = Fzolv::detail::prefetchDistance / sizeof(float);
+                    const __m256 zero = _mm256_setzero_ps();
+                    std::size_t i = 0;
+                    for (; i + 8 <= count; i += 8)
+                    {
+                        FZOLV_PREFETCH(xs + i + ahead);
+                        FZOLV_PREFETCH(ys + i + ahead);
+                        const __m256 x = _mm256_loadu_ps(xs + i);
+                        const __m256 y = _mm256_loadu_ps(ys + i);
+                        const __m256 z = zs != nullptr ? _mm256_loadu_ps(zs + i) : zero;
+                        __m256 r[3];
+                        for (std::size_t row = 0; row < 3; ++row)
+                        {
+                            r[row] = _mm256_add_ps(_mm256_mul_ps(e[row][0], x), _mm256_mul_ps(e[row][1], y));
+                            r[row] = _mm256_add_ps(_mm256_add_ps(r[row], _mm256_mul_ps(e[row][2], z)), e[row][3]);
+                        }
+                        _mm256_storeu_ps(outX + i, r[0]);
+                        _mm256_storeu_ps(outY + i, r[1]);
+                        if (outZ != nullptr)
+                        {
+                            _mm256_storeu_ps(outZ + i, r[2]);
+                        }
+                    }
+                    sse2::transformLanes(m, xs + i, ys + i, zs != nullptr ? zs + i : nullptr, outX + i, outY + i,
+                                         outZ != nullptr ? outZ + i : nullptr, count - i, w);
+                }
+            }
+#endif
+
+#if FZOLV_SIMD_NEON
+            namespace neon
+            {
+                inline void transformVector3(const Matrix4f &m, const Vector3f *in, Vector3f *out, std::size_t count,
+                                             float w)
+                {
+                    const float32x4_t c0 = vld1q_f32(&m.columns[0].x);
+                    const float32x4_t c1 = vld1q_f32(&m.columns[1].x);
+                    const float32x4_t c2 = vld1q_f32(&m.columns[2].x);
+                    const float32x4_t c3w = vmulq_n_f32(vld1q_f32(&m.columns[3].x), w);
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        FZOLV_PREFETCH(reinterpret_cast<const char *>(in + i) + Fzolv::detail::prefetchDistance);
+                        float32x4_t r = vmulq_n_f32(c0, in[i].x);
+                        r = vaddq_f32(r, vmulq_n_f32(c1, in[i].y));
+                        r = vaddq_f32(r, vmulq_n_f32(c2, in[i].z));
+                        r = vaddq_f32(r, c3w);
+                        vst1_f32(&out[i].x, vget_low_f32(r));
+                        out[i].z = vgetq_lane_f32(r, 2);
+                    }
+                }
+
+                inline void transformVector2(const Matrix4f &m, const Vector2f *in, Vector2f *out, std::size_t count,
+                                             float w)
+                {
+                    const float32x4_t c0 = vld1q_f32(&m.columns[0].x);
+                    const float32x4_t c1 = vld1q_f32(&m.columns[1].x);
+                    const float32x4_t c2z = vmulq_n_f32(vld1q_f32(&m.columns[2].x), 0.0F);
+                    const float32x4_t c3w = vmulq_n_f32(vld1q_f32(&m.columns[3].x), w);
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        FZOLV_PREFETCH(reinterpret_cast<const char *>(in + i) + Fzolv::detail::prefetchDistance);
+                        float32x4_t r = vmulq_n_f32(c0, in[i].x);
+                        r = vaddq_f32(r, vmulq_n_f32(c1, in[i].y));
+                        r = vaddq_f32(vaddq_f32(r, c2z), c3w);
+                        vst1_f32(&out[i].x, vget_low_f32(r));
+                    }
+                }
+
+                inline void transformLanes(const Matrix4f &m, const float *xs, const float *ys, const float *zs,
+                                           float *outX, float *outY, float *outZ, std::size_t count, float w)
+                {
+                    float32x4_t e[3][4];
+                    for (std::size_t r = 0; r < 3; ++r)
+                    {
+                        for (std::size_t c = 0; c < 3; ++c)
+                        {
+                            e[r][c] = vdupq_n_f32(m(r, c));
+                        }
+                        e[r][3] = vdupq_n_f32(m(r, 3) * w);
+                    }
+
+                    constexpr std::size_t ahead = Fzolv::detail::prefetchDistance / sizeof(float);
+                    const float32x4_t zero = vdupq_n_f32(0.0F);
+                    std::size_t i = 0;
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        FZOLV_PREFETCH(xs + i + ahead);
+                        FZOLV_PREFETCH(ys + i + ahead);
+                        const float32x4_t x = vld1q_f32(xs + i);
+                        const float32x4_t y = vld1q_f32(ys + i);
+                        const float32x4_t z = zs != nullptr ? vld1q_f32(zs + i) : zero;
+                        float32x4_t r[3];
+                        for (std::size_t row = 0; row < 3; ++row)
+                        {
+                            r[row] = vaddq_f32(vmulq_f32(e[row][0], x), vmulq_f32(e[row][1], y));
+                            r[row] = vaddq_f32(vaddq_f32(r[row], vmulq_f32(e[row][2], z)), e[row][3]);
+                        }
+                        vst1q_f32(outX + i, r[0]);
+                        vst1q_f32(outY + i, r[1]);
+                        if (outZ != nullptr)
+                        {
+                            vst1q_f32(outZ + i, r[2]);
+                        }
+                    }
+                    scalar::transformLanes(m, xs + i, ys + i, zs != nullptr ? zs + i : nullptr, outX + i, outY + i,
+                                           outZ != nullptr ? outZ + i : nullptr, count - i, w);
+                }
+            }
+#endif
+
+            namespace best
+            {
+                inline void transformVector3(const Matrix4f &m, const Vector3f *in, Vector3f *out, std::size_t count,
+                                             float w)
+                {
+                    FZOLV_DISPATCH(transformVector3, (m, in, out, count, w))
+                }
+
+                inline void transformVector2(const Matrix4f &m, const Vector2f *in, Vector2f *out, std::size_t count,
+                                             float w)
+                {
+                    FZOLV_DISPATCH(transformVector2, (m, in, out, count, w))
+                }
+
+                inline void transformLanes(const Matrix4f &m, const float *xs, const float *ys, const float *zs,
+                                           float *outX, float *outY, float *outZ, std::size_t count, float w)
+                {
+                    FZOLV_DISPATCH(transformLanes, (m, xs, ys, zs, outX, outY, outZ, count, w))
+                }
+            }
+        }
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Transform count 3D vectors as (x, y, z, w), matching (m * Vector4{v, w}).xyz() for every element
+         *
+         * Floats run on the kernels of simd::activeLevel(), other types on a scalar loop.
+         */
+        template <typename T>
+        void transformKernel(const Matrix4<T> &m, const Vector3<T> *in, Vector3<T> *out, std::size_t count, T w)
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                batch::detail::best::transformVector3(m, in, out, count, w);
+            }
+            else
+            {
+                FZOLV_PROFILE_ZONE("transform::vector3", count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    out[i] = (m * Vector4<T>{in[i], w}).xyz();
+                }
+            }
+        }
+
+        /**
+         * @brief Transform count 2D vectors as (x, y, 0, w), matching m * Vector4{x, y, 0, w} for every element
+         */
+        template <typename T>
+        void transformKernel(const Matrix4<T> &m, const Vector2<T> *in, Vector2<T> *out, std::size_t count, T w)
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                batch::detail::best::transformVector2(m, in, out, count, w);
+            }
+            else
+            {
+                FZOLV_PROFILE_ZONE("transform::vector2", count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const Vector4<T> r = m * Vector4<T>{in[i].x, in[i].y, T(0), w};
+                    out[i] = {r.x, r.y};
+                }
+            }
+        }
+
+        /**
+         * @brief Transform count vectors stored as component lanes, zs and outZ are null for 2D vectors
+         *
+         * Every lane computes the same expression as transformKernel, so AoS and SoA inputs give the same results.
+         */
+        template <typename T>
+        void transformLanes(const Matrix4<T> &m, const T *xs, const T *ys, const T *zs, T *outX, T *outY, T *outZ,
+                            std::size_t count, T w)
+        {
+            if constexpr (std::is_same<T, float>::value)
+            {
+                batch::detail::best::transformLanes(m, xs, ys, zs, outX, outY, outZ, count, w);
+            }
+            else
+            {
+                FZOLV_PROFILE_ZONE("transform::lanes", count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const Vector4<T> r = m * Vector4<T>{xs[i], ys[i], zs != nullptr ? zs[i] : T(0), w};
+                    outX[i] = r.x;
+                    outY[i] = r.y;
+                    if (outZ != nullptr)
+                    {
+                        outZ[i] = r.z;
+                    }
+                }
+            }
+        }
+
+        template <typename T, typename V>
+        void transformSpan(const Matrix4<T> &m, span<const V> in, span<V> out, T w)
+        {
+            assert(in.size() == out.size());
+            parallelFor(in.size(), transformGrain, [&](std::size_t begin, std::size_t end)
+                        { transformKernel(m, in.data() + begin, out.data() + begin, end - begin, w); });
+        }
+    }
+
+    /**
+     * @brief Transform every point of a span by a matrix, out[i] = m.transformPoint(in[i])
+     *
+     * Points are treated as (x, y, z, 1), so translation applies. For floats the kernels of simd::activeLevel() stream
+     * through memory with software prefetching, and arrays of at least parallelThreshold() elements are split across
+     * threads. in and out may be the same
+     * span to transform in place.
+     *
+     * @param m The transformation matrix
+     * @param in The points to transform
+     * @param out The transformed points, must have the same size as in
+     */
+    template <typename T>
+    void transformPoints(const Matrix4<T> &m, span<const Vector3<T>> in, span<Vector3<T>> out)
+    {
+        detail::transformSpan(m, in, out, T(1));
+    }
+
+    /**
+     * @brief Transform every direction of a span by a matrix, out[i] = m.transformDirection(in[i])
+     *
+     * Directions are treated as (x, y, z, 0), so translation does not apply. Otherwise this works like transformPoints.
+     *
+     * @param m The transformation matrix
+     * @param in The directions to transform
+     * @param out The transformed directions, must have the same size as in
+     */
+    template <typename T>
+    void transformDirections(const Matrix4<T> &m, span<const Vector3<T>> in, span<Vector3<T>> out)
+    {
+        detail::transformSpan(m, in, out, T(0));
+    }
+
+    /**
+     * @brief Transform every 2D point of a span, treated as (x, y, 0, 1), and keep x and y of the result
+     *
+     * @param m The transformation matrix
+     * @param in The points to transform
+     * @param out The transformed points, must have the same size as in
+     */
+    template <typename T>
+    void transformPoints(const Matrix4<T> &m, span<const Vector2<T>> in, span<Vector2<T>> out)
+    {
+        detail::transformSpan(m, in, out, T(1));
+    }
+
+    /**
+     * @brief Transform every 2D direction of a span, treated as (x, y, 0, 0), and keep x and y of the result
+     *
+     * @param m The transformation matrix
+     * @param in The directions to transform
+     * @param out The transformed directions, must have the same size as in
+     */
+    template <typename T>
+    void transformDirections(const Matrix4<T> &m, span<const Vector2<T>> in, span<Vector2<T>> out)
+    {
+        detail::transformSpan(m, in, out, T(0));
+    }
+
+    /**
+     * @brief Transform every point of a structure-of-arrays container, like the span overload
+     *
+     * @param m The transformation matrix
+     * @param in The points to transform
+     * @param out The transformed points, resized to the size of in, may be the same container as in
+     */
+    template <typename T>
+    void transformPoints(const Matrix4<T> &m, const Vector3SoA<T> &in, Vector3SoA<T> &out)
+    {
+        out.resize(in.size());
+        parallelFor(in.size(), detail::transformGrain, [&](std::size_t b, std::size_t e)
+                    { detail::transformLanes(m, in.xData() + b, in.yData() + b, in.zData() + b, out.xData() + b,
+                                             out.yData() + b, out.zData() + b, e - b, T(1)); });
+    }
+
+    template <typename T>
+    void transformDirections(const Matrix4<T> &m, const Vector3SoA<T> &in, Vector3SoA<T> &out)
+    {
+        out.resize(in.size());
+        parallelFor(in.size(), detail::transformGrain, [&](std::size_t b, std::size_t e)
+                    { detail::transformLanes(m, in.xData() + b, in.yData() + b, in.zData() + b, out.xData() + b,
+                                             out.yData() + b, out.zData() + b, e - b, T(0)); });
+    }
+
+    template <typename T>
+    void transformPoints(const Matrix4<T> &m, const Vector2SoA<T> &in, Vector2SoA<T> &out)
+    {
+        out.resize(in.size());
+        parallelFor(in.size(), detail::transformGrain, [&](std::size_t b, std::size_t e)
+                    { detail::transformLanes<T>(m, in.xData() + b, in.yData() + b, nullptr, out.xData() + b,
+                                                out.yData() + b, nullptr, e - b, T(1)); });
+    }
+
+    template <typename T>
+    void transformDirections(const Matrix4<T> &m, const Vector2SoA<T> &in, Vector2SoA<T> &out)
+    {
+        out.resize(in.size());
+        parallelFor(in.size(), detail::transformGrain, [&](std::size_t b, std::size_t e)
+                    { detail::transformLanes<T>(m, in.xData() + b, in.yData() + b, nullptr, out.xData() + b,
+                                                out.yData() + b, nullptr, e - b, T(0)); });
+    }
+
+    ///< Float overloads, so that containers of vectors convert to spans without naming the span type
+
+    inline void transformPoints(const Matrix4f &m, span<const Vector3f> in, span<Vector3f> out)
+    {
+        transformPoints<float>(m, in, out);
+    }
+
+    inline void transformDirections(const Matrix4f &m, span<const Vector3f> in, span<Vector3f> out)
+    {
+        transformDirections<float>(m, in, out);
+    }
+
+    inline void transformPoints(const Matrix4f &m, span<const Vector2f> in, span<Vector2f> out)
+    {
+        transformPoints<float>(m, in, out);
+    }
+
+    inline void transformDirections(const Matrix4f &m, span<const Vector2f> in, span<Vector2f> out)
+    {
+        transformDirections<float>(m, in, out);
+    }
+}
+
+#endif /* end of include guard: FZOLV_TRANSFORM_2bhts8 */
@@ -15,6 +15,36 @@ namespace Fzolv
     struct is_numeric : std::integral_constant<bool, std::is_integral<T>::value || std::is_floating_point<T>::value>
     {
     };
+
+    /**
+     * @brief A template struct that selects the type used for lengths, distances and normalization of vectors of T.
+     * @tparam T The component type of the vector.
+     * @details Floating point components keep their own precision, so a Vector2<float> stays in single precision on the
+     * hot path. Integral components use double, since their square roots are generally not integral. Specialize this
+     * struct to change the precision used for a component type.
+     */
+    template <typename T>
+    struct precision_type
+    {
+        using type = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+    };
+
+    template <typename T>
+    using precision_type_t = typename precision_type<T>::type;
+
+    /**
+     * @brief A template struct that selects the type used by the explicit high-precision vector functions.
+     * @tparam T The component type of the vector.
+     * @details This is at least double, and wider when precision_type<T> already is.
+     */
+    template <typename T>
+    struct high_precision_type
+    {
+        using type = std::common_type_t<precision_type_t<T>, double>;
+    };
+
+    template <typename T>
+    using high_precision_type_t = typename high_precision_type<T>::type;
 }
 
 #endif /* end of include guard : FZOLV_UTIL_mzn8c4 */
\ No newline at end of file
@@ -2,11 +2,158 @@
 #define FZOLV_VECTOR_hy78kj
 
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <math.hpp>
+#include <simd.hpp>
 #include <util.hpp>
 
 namespace Fzolv
 {
+    /**
+     * @brief The maximum relative error of a component produced by normalizeFast, 2^-20
+     *
+     * This covers the error of simd::rsqrt plus the rounding of the squared length and the final multiplication.
+     * Vectors whose squared length is zero, denormal or not finite take the exact normalize path instead.
+     */
+    constexpr float normalizeFastMaxRelativeError = 1.0F / 1048576.0F;
+
+    namespace detail
+    {
+        /**
+         * @brief Convert an interpolated value back to a component, rounding to the nearest value for integral T
+         */
+        template <typename T>
+        constexpr auto fromPrecision(precision_type_t<T> value) -> T
+        {
+            if constexpr (std::is_integral<T>::value)
+            {
+                return static_cast<T>(math::round(value));
+            }
+            else
+            {
+                return value;
+            }
+        }
+
+        /**
+         * @brief Linearly interpolate one component in precision_type_t<T>, start + (end - start) * amount
+         */
+        template <typename T>
+        constexpr auto lerp(T start, T end, precision_type_t<T> amount) -> T
+        {
+            using P = precision_type_t<T>;
+            return fromPrecision<T>(static_cast<P>(start) + ((static_cast<P>(end) - static_cast<P>(start)) * amount));
+        }
+
+        /**
+         * @brief Clamp an interpolation factor to [0, 1] and ease it with 3t^2 - 2t^3, NaN factors become 0
+         */
+        template <typename P>
+        constexpr auto smoothstep(P amount) -> P
+        {
+            const P t = amount > P(0) ? (amount < P(1) ? amount : P(1)) : P(0);
+            return (t * t) * (P(3) - (P(2) * t));
+        }
+
+        /**
+         * @brief The vector type a swizzle of N components returns, Vector2, Vector3 or Vector4 of T
+         *
+         * Specialised after the vector classes, so that each of them can name the others in its swizzle().
+         */
+        template <typename T, std::size_t N>
+        struct SwizzleVector;
+
+        /**
+         * @brief The _mm_shuffle_ps immediate that moves lane I[k] to lane k, lanes past the indices stay in place
+         */
+        template <std::size_t... I>
+        constexpr auto shuffleMask() -> int
+        {
+            constexpr std::size_t indices[] = {I...};
+            int mask = 0;
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                mask |= static_cast<int>(k < sizeof...(I) ? indices[k] : k) << (2 * k);
+            }
+            return mask;
+        }
+
+#if FZOLV_SIMD_NEON
+        /**
+         * @brief Move lane I[k] to lane k with one vqtbl1q_u8 table lookup, lanes past the indices stay in place
+         */
+        template <std::size_t... I>
+        inline auto shuffleLanes(float32x4_t value) -> float32x4_t
+        {
+            constexpr std::size_t indices[] = {I...};
+            std::uint8_t table[16] = {};
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                const std::size_t lane = k < sizeof...(I) ? indices[k] : k;
+                for (std::size_t b = 0; b < 4; ++b)
+                {
+                    table[4 * k + b] = static_cast<std::uint8_t>(4 * lane + b);
+                }
+            }
+            return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(value), vld1q_u8(table)));
+        }
+#endif
+
+        /**
+         * @brief Clamp one component to [low, high], for low <= high
+         *
+         * Floating-point components are raised to low first and then lowered to high, the order in which the max and
+         * min instructions compare, so compilers emit maxss and minss instead of branches. NaNs pass through.
+         */
+        template <typename T>
+        constexpr auto clampComponent(T value, T low, T high) -> T
+        {
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                const T raised = value < low ? low : value;
+                return raised > high ? high : raised;
+            }
+            else
+            {
+                return value > high ? high : (value < low ? low : value);
+            }
+        }
+
+        /**
+         * @brief The four cubic Hermite basis functions at an interpolation factor
+         */
+        template <typename P>
+        struct HermiteWeights
+        {
+            P h00; ///< Weight of the start point
+            P h10; ///< Weight of the start tangent
+            P h01; ///< Weight of the end point
+            P h11; ///< Weight of the end tangent
+
+            constexpr explicit HermiteWeights(P t) : HermiteWeights{t, t * t, (t * t) * t} {}
+
+            constexpr HermiteWeights(P t, P t2, P t3)
+                : h00{((P(2) * t3) - (P(3) * t2)) + P(1)}, h10{(t3 - (P(2) * t2)) + t}, h01{(P(3) * t2) - (P(2) * t3)},
+                  h11{t3 - t2}
+            {
+            }
+        };
+
+        /**
+         * @brief Evaluate the cubic Hermite spline of one component
+         */
+        template <typename T>
+        constexpr auto hermite(T p0, T m0, T p1, T m1, const HermiteWeights<precision_type_t<T>> &h) -> T
+        {
+            using P = precision_type_t<T>;
+            return fromPrecision<T>(((h.h00 * static_cast<P>(p0)) + (h.h10 * static_cast<P>(m0))) +
+                                    ((h.h01 * static_cast<P>(p1)) + (h.h11 * static_cast<P>(m1))));
+        }
+    }
+
     /**
      * @brief A generic class for 2D vectors with numeric types
      *
@@ -20,29 +167,23 @@ namespace Fzolv
          * @brief Default constructor, initializes the vector to zero
          *
          */
-        Vector2() : x(), y(){};
+        constexpr Vector2() : x(), y() {}
 
         /**
          * @brief Copy constructor, copies the components from another vector
          *
          * @param other The other vector to copy from
          */
-        Vector2(const Vector2 &) = default;
+        constexpr Vector2(const Vector2 &) = default;
 
         /**
-         * @brief Move constructor, moves the components from another vector
+         * @brief Move constructor, copies the components from another vector
+         *
+         * Defaulted so that Vector2 stays trivially copyable; the source vector is left unchanged.
          *
          * @param other The other vector to move from
          */
-        Vector2(Vector2 &&other) noexcept
-        {
-            x = std::move(other.x);
-            y = std::move(other.y);
-
-            ///< Empty other
-            other.x = 0;
-            other.y = 0;
-        }
+        constexpr Vector2(Vector2 &&) noexcept = default;
 
         /**
          * @brief Copy assignment operator, copies the components from another vector
@@ -50,28 +191,17 @@ namespace Fzolv
          * @param other The other vector to copy from
          * @return Vector2& A reference to this vector
          */
-        auto operator=(const Vector2 &) -> Vector2 & = default;
+        constexpr auto operator=(const Vector2 &) -> Vector2 & = default;
 
         /**
-         * @brief Move assignment operator, moves the components from another vector
+         * @brief Move assignment operator, copies the components from another vector
+         *
+         * Defaulted so that Vector2 stays trivially copyable; the source vector is left unchanged.
          *
          * @param other The other vector to move from
          * @return Vector2& A reference to this vector
          */
-        auto operator=(Vector2 &&other) noexcept -> Vector2 &
-        {
-            if (this != &other)
-            {
-                x = std::move(other.x);
-                y = std::move(other.y);
-
-                ///< Empty other
-                other.x = 0;
-                other.y = 0;
-            }
-
-            return *this;
-        }
+        constexpr auto operator=(Vector2 &&) noexcept -> Vector2 & = default;
 
         /**
          * @brief Constructor from x and y components
@@ -88,28 +218,69 @@ namespace Fzolv
          *
          * @return constexpr Vector2 The zero vector
          */
-        static constexpr auto Zero() -> Vector2 { return {.0F, .0F}; }
+        static constexpr auto Zero() -> Vector2 { return {T(0), T(0)}; }
 
         /**
          * @brief Static factory method for the one vector
          *
          * @return constexpr Vector2 The one vector
          */
-        static constexpr auto One() -> Vector2 { return {1.0F, 1.0F}; }
+        static constexpr auto One() -> Vector2 { return {T(1), T(1)}; }
 
         /**
          * @brief Static factory method for the unit x vector
          *
          * @return constexpr Vector2 The unit x vector
          */
-        static constexpr auto UnitX() -> Vector2 { return {1.0F, .0F}; }
+        static constexpr auto UnitX() -> Vector2 { return {T(1), T(0)}; }
 
         /**
          * @brief Static factory method for the unit y vector
          *
          * @return constexpr Vector2 The unit y vector
          */
-        static constexpr auto UnitY() -> Vector2 { return {.0F, 1.0F}; }
+        static constexpr auto UnitY() -> Vector2 { return {T(0), T(1)}; }
+
+        /**
+         * @brief Get a component by an index known at compile time, 0 for x and 1 for y
+         *
+         * @tparam I The index of the component
+         * @return T The component
+         */
+        template <std::size_t I>
+        [[nodiscard]] constexpr auto component() const -> T
+        {
+            static_assert(I < 2, "Vector2 has the components 0 and 1");
+            if constexpr (I == 0)
+            {
+                return x;
+            }
+            else
+            {
+                return y;
+            }
+        }
+
+        /**
+         * @brief Build a vector from the components at the given indices, e.g. swizzle<1, 0>() for (y, x)
+         *
+         * The indices are resolved at compile time and the result is constructed directly from the selected
+         * components, so rearranging never goes through intermediate vectors.
+         *
+         * @tparam I Two, three or four component indices
+         * @return A Vector2, Vector3 or Vector4 of the selected components
+         */
+        template <std::size_t... I>
+        [[nodiscard]] constexpr auto swizzle() const -> typename detail::SwizzleVector<T, sizeof...(I)>::type
+        {
+            return {component<I>()...};
+        }
+
+        [[nodiscard]] constexpr auto xx() const -> Vector2 { return swizzle<0, 0>(); }
+
+        [[nodiscard]] constexpr auto yx() const -> Vector2 { return swizzle<1, 0>(); }
+
+        [[nodiscard]] constexpr auto yy() const -> Vector2 { return swizzle<1, 1>(); }
 
         /**
          * @brief Set the x and y components of the vector
@@ -136,11 +307,25 @@ namespace Fzolv
         /**
          * @brief Get the length of the vector
          *
-         * @return double The length of the vector
+         * The length is computed in precision_type_t<T>, which is T itself for floating point components, so that
+         * single precision vectors never round-trip through double.
+         *
+         * @return precision_type_t<T> The length of the vector
+         */
+        [[nodiscard]] constexpr auto length() const -> precision_type_t<T>
+        {
+            return math::sqrt(static_cast<precision_type_t<T>>(lengthSquared()));
+        }
+
+        /**
+         * @brief Get the length of the vector in high precision
+         *
+         * @return high_precision_type_t<T> The length of the vector, computed in at least double precision
          */
-        [[nodiscard]] auto length() const -> double
+        [[nodiscard]] constexpr auto lengthPrecise() const -> high_precision_type_t<T>
         {
-            return std::sqrt(lengthSquared());
+            using P = high_precision_type_t<T>;
+            return math::sqrt((static_cast<P>(x) * static_cast<P>(x)) + (static_cast<P>(y) * static_cast<P>(y)));
         }
 
         /**
@@ -148,7 +333,7 @@ namespace Fzolv
          *
          * @return Vector2& A reference to this normalized vector
          */
-        auto normalize() -> Vector2 &
+        constexpr auto normalize() -> Vector2 &
         {
             auto len = length();
             if (len != 0)
@@ -159,6 +344,70 @@ namespace Fzolv
             return *this;
         }
 
+        /**
+         * @brief Get a normalized copy of the vector
+         *
+         * @return Vector2 The normalized vector
+         */
+        [[nodiscard]] constexpr auto normalized() const -> Vector2
+        {
+            Vector2 result{*this};
+            return result.normalize();
+        }
+
+        /**
+         * @brief Normalize the vector in-place with a reciprocal square root estimate and return a reference to itself
+         *
+         * For float components this uses simd::rsqrt, a hardware estimate refined with Newton-Raphson, and every
+         * component is within normalizeFastMaxRelativeError of the exact result. Zero vectors are left unchanged.
+         * Squared lengths that are denormal or not finite, other component types, platforms without an estimate
+         * instruction and constant evaluation use normalize() instead.
+         *
+         * @return Vector2& A reference to this normalized vector
+         */
+        constexpr auto normalizeFast() -> Vector2 &
+        {
+            if constexpr (std::is_same<T, float>::value && simd::hasFastRsqrt)
+            {
+                const float lenSq = lengthSquared();
+                if (!FZOLV_IS_CONSTANT_EVALUATED() && lenSq >= FLT_MIN && lenSq <= FLT_MAX)
+                {
+                    const float inv = simd::rsqrt(lenSq);
+                    x *= inv;
+                    y *= inv;
+                    return *this;
+                }
+            }
+            return normalize();
+        }
+
+        /**
+         * @brief Get a copy of the vector normalized with normalizeFast
+         *
+         * @return Vector2 The normalized vector
+         */
+        [[nodiscard]] constexpr auto normalizedFast() const -> Vector2
+        {
+            Vector2 result{*this};
+            return result.normalizeFast();
+        }
+
+        /**
+         * @brief Normalize the vector in-place using a high precision length and return a reference to itself
+         *
+         * @return Vector2& A reference to this normalized vector
+         */
+        constexpr auto normalizePrecise() -> Vector2 &
+        {
+            auto len = lengthPrecise();
+            if (len != 0)
+            {
+                x = static_cast<T>(x / len);
+                y = static_cast<T>(y / len);
+            }
+            return *this;
+        }
+
         /**
          * @brief Get the dot product of this vector and another vector
          *
@@ -223,20 +472,34 @@ namespace Fzolv
          * @brief Get the distance between this vector and another vector
          *
          * @param other The other vector to measure the distance to
-         * @return double The distance between the two vectors
+         * @return precision_type_t<T> The distance between the two vectors
+         */
+        [[nodiscard]] constexpr auto distanceTo(const Vector2 &other) const -> precision_type_t<T>
+        {
+            return math::sqrt(static_cast<precision_type_t<T>>(distanceToSquared(other)));
+        }
+
+        /**
+         * @brief Get the distance between this vector and another vector in high precision
+         *
+         * @param other The other vector to measure the distance to
+         * @return high_precision_type_t<T> The distance between the two vectors, computed in at least double precision
          */
-        [[nodiscard]] auto distanceTo(const Vector2 &other) const -> double
+        [[nodiscard]] constexpr auto distanceToPrecise(const Vector2 &other) const -> high_precision_type_t<T>
         {
-            return std::sqrt(distanceToSquared(other));
+            using P = high_precision_type_t<T>;
+            auto dxVal = static_cast<P>(x) - static_cast<P>(other.x);
+            auto dyVal = static_cast<P>(y) - static_cast<P>(other.y);
+            return math::sqrt((dxVal * dxVal) + (dyVal * dyVal));
         }
 
         /**
          * @brief Clamps a vector to a given range.
          * 
          * This function template takes a vector of type U and two vectors of the same type representing the minimum and maximum values, 
-         * and returns a new vector of type U that is clamped to the range [min, max]. The clamping is done component-wise, using a lambda 
-         * expression that clamps a scalar value to a scalar range. The function template uses std::enable_if and std::is_convertible to enable 
-         * the function only if U is convertible to Vector2<T>.
+         * and returns a new vector of type U that is clamped to the range [min, max]. The clamping is done component-wise and compiles
+         * to min and max instructions without branches for floating-point components, see detail::clampComponent. The function template uses
+         * std::enable_if and std::is_convertible to enable the function only if U is convertible to Vector2<T>.
          * 
          * @tparam U The type of the vector to be clamped. Must be convertible to Vector2<T>.
          * @param value The vector to be clamped.
@@ -247,12 +510,7 @@ namespace Fzolv
         template <typename U> static constexpr auto clamp(const U &value, const U &min, const U &max) 
             -> typename std::enable_if<std::is_convertible<U, Vector2<T>>::value, U>::type
         {
-            constexpr auto clamp = [](auto x, auto low, auto high)
-            {
-                return x > high ? high : (x < low ? low : x);
-            };
-
-            return U{clamp(value.x, min.x, max.x), clamp(value.y, min.y, max.y)};
+            return U{detail::clampComponent(value.x, min.x, max.x), detail::clampComponent(value.y, min.y, max.y)};
         }
 
         /**
@@ -271,10 +529,10 @@ namespace Fzolv
          *
          * @return Vector2& A reference to this floored vector
          */
-        auto floor() -> Vector2 &
+        constexpr auto floor() -> Vector2 &
         {
-            x = std::floor(x);
-            y = std::floor(y);
+            x = math::floor(x);
+            y = math::floor(y);
             return *this;
         }
 
@@ -294,10 +552,10 @@ namespace Fzolv
          *
          * @return Vector2& A reference to this ceiled vector
          */
-        auto ceil() -> Vector2 &
+        constexpr auto ceil() -> Vector2 &
         {
-            x = std::ceil(x);
-            y = std::ceil(y);
+            x = math::ceil(x);
+            y = math::ceil(y);
             return *this;
         }
 
@@ -318,13 +576,62 @@ namespace Fzolv
          *
          * @return Vector2& A reference to this rounded vector
          */
-        auto round() -> Vector2 &
+        constexpr auto round() -> Vector2 &
         {
-            x = std::round(x);
-            y = std::round(y);
+            x = math::round(x);
+            y = math::round(y);
             return *this;
         }
 
+        /**
+         * @brief Linearly interpolate between two vectors, start + (end - start) * amount
+         *
+         * The interpolation runs in precision_type_t<T>, so float vectors stay in float, double vectors keep their
+         * precision and integral vectors are interpolated in double and rounded to the nearest value.
+         *
+         * @param start The vector at amount 0
+         * @param end The vector at amount 1
+         * @param amount The interpolation factor, not clamped
+         * @return constexpr Vector2 The interpolated vector
+         */
+        static constexpr auto Lerp(const Vector2 &start, const Vector2 &end, precision_type_t<T> amount) -> Vector2
+        {
+            return {detail::lerp(start.x, end.x, amount), detail::lerp(start.y, end.y, amount)};
+        }
+
+        /**
+         * @brief Interpolate between two vectors with an ease-in ease-out curve
+         *
+         * The factor is clamped to [0, 1] and eased with 3t^2 - 2t^3 before interpolating like Lerp.
+         *
+         * @param start The vector at amount 0
+         * @param end The vector at amount 1
+         * @param amount The interpolation factor
+         * @return constexpr Vector2 The interpolated vector
+         */
+        static constexpr auto SmoothStep(const Vector2 &start, const Vector2 &end, precision_type_t<T> amount)
+            -> Vector2
+        {
+            return Lerp(start, end, detail::smoothstep(amount));
+        }
+
+        /**
+         * @brief Evaluate a cubic Hermite spline between two points with the given tangents
+         *
+         * @param p0 The point at amount 0
+         * @param m0 The tangent at p0
+         * @param p1 The point at amount 1
+         * @param m1 The tangent at p1
+         * @param amount The interpolation factor, not clamped
+         * @return constexpr Vector2 The point on the spline
+         */
+        static constexpr auto Hermite(const Vector2 &p0, const Vector2 &m0, const Vector2 &p1, const Vector2 &m1,
+                                      precision_type_t<T> amount) -> Vector2
+        {
+            const detail::HermiteWeights<precision_type_t<T>> h{amount};
+            return {detail::hermite(p0.x, m0.x, p1.x, m1.x, h), detail::hermite(p0.y, m0.y, p1.y, m1.y, h)};
+        }
+
         /**
          * @brief Overload arithmetic operators for vector addition, subtraction, scalar multiplication and division
          *
@@ -344,13 +651,6 @@ namespace Fzolv
          * @param rhs The right-hand side operand of the operator
          * @return friend constexpr Vector2 The result of the operation
          */
-        static constexpr auto Lerp(const Vector2 &start, const Vector2 &end, float amount) -> Vector2
-        {
-            float x = start.x + ((end.x - start.x) * amount);
-            float y = start.y + ((end.y - start.y) * amount);
-            return {x, y};
-        }
-
         friend constexpr auto operator+(const Vector2 &lhs, const Vector2 &rhs) -> Vector2
         {
             return {lhs.x + rhs.x, lhs.y + rhs.y};
@@ -384,28 +684,28 @@ namespace Fzolv
          * the result to the first vector results in (a1 + a2, b1 + b2) stored in (a1, b1). Vector addition and subtraction are commutative
          * and associative, meaning that (a += b) = (b += a) and (a += (b += c)) = ((a += b) += c).
          */
-        auto operator+=(const Vector2 &other) -> Vector2 &
+        constexpr auto operator+=(const Vector2 &other) -> Vector2 &
         {
             x += other.x;
             y += other.y;
             return *this;
         }
 
-        auto operator-=(const Vector2 &other) -> Vector2 &
+        constexpr auto operator-=(const Vector2 &other) -> Vector2 &
         {
             x -= other.x;
             y -= other.y;
             return *this;
         }
 
-        auto operator*=(T scalar) -> Vector2 &
+        constexpr auto operator*=(T scalar) -> Vector2 &
         {
             x *= scalar;
             y *= scalar;
             return *this;
         }
 
-        auto operator/=(T scalar) -> Vector2 &
+        constexpr auto operator/=(T scalar) -> Vector2 &
         {
             x /= scalar;
             y /= scalar;
@@ -449,24 +749,1308 @@ namespace Fzolv
         T y;
     };
 
+    /**
+     * @brief A generic class for 3D vectors with numeric types
+     *
+     * Vector3 offers the same operations as Vector2, with cross returning the perpendicular vector instead of a scalar.
+     *
+     * @tparam T The type of the vector components, must be arithmetic
+     */
     template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
     class Vector3
     {
     public:
-        Vector3() = default;
-        Vector3(const Vector3 &) = default;
-        Vector3(const Vector3 &&)  noexcept = default;
-        auto operator=(const Vector3 &) -> Vector3 & = default;
-        auto operator=(Vector3 &&)  noexcept -> Vector3 & = default;
+        /**
+         * @brief Default constructor, initializes the vector to zero
+         */
+        constexpr Vector3() : x(), y(), z() {}
 
-    private:
-        T x, y, z;
-    };
+        constexpr Vector3(const Vector3 &) = default;
+        constexpr Vector3(Vector3 &&) noexcept = default;
+        constexpr auto operator=(const Vector3 &) -> Vector3 & = default;
+        constexpr auto operator=(Vector3 &&) noexcept -> Vector3 & = default;
 
-    using Vector2f = Vector2<float>;
-    using Vector2i = Vector2<int>;
-    using Vector3f = Vector3<float>;
-    using Vector3i = Vector3<int>;
+        /**
+         * @brief Constructor from x, y and z components
+         *
+         * @param xVal The x component of the vector
+         * @param yVal The y component of the vector
+         * @param zVal The z component of the vector
+         */
+        constexpr Vector3(T xVal, T yVal, T zVal) : x{xVal}, y{yVal}, z{zVal} {}
+
+        /**
+         * @brief Constructor from a 2D vector and a z component
+         *
+         * @param xy The x and y components of the vector
+         * @param zVal The z component of the vector
+         */
+        constexpr Vector3(const Vector2<T> &xy, T zVal) : x{xy.x}, y{xy.y}, z{zVal} {}
+
+        ///< Static factory methods for common vectors
+
+        static constexpr auto Zero() -> Vector3 { return {T(0), T(0), T(0)}; }
+
+        static constexpr auto One() -> Vector3 { return {T(1), T(1), T(1)}; }
+
+        static constexpr auto UnitX() -> Vector3 { return {T(1), T(0), T(0)}; }
+
+        static constexpr auto UnitY() -> Vector3 { return {T(0), T(1), T(0)}; }
+
+        static constexpr auto UnitZ() -> Vector3 { return {T(0), T(0), T(1)}; }
+
+        /**
+         * @brief Get a component by an index known at compile time, 0 to 2 for x to z
+         */
+        template <std::size_t I>
+        [[nodiscard]] constexpr auto component() const -> T
+        {
+            static_assert(I < 3, "Vector3 has the components 0 to 2");
+            if constexpr (I == 0)
+            {
+                return x;
+            }
+            else if constexpr (I == 1)
+            {
+                return y;
+            }
+            else
+            {
+                return z;
+            }
+        }
+
+        /**
+         * @brief Build a vector from the components at the given indices, like Vector2::swizzle
+         */
+        template <std::size_t... I>
+        [[nodiscard]] constexpr auto swizzle() const -> typename detail::SwizzleVector<T, sizeof...(I)>::type
+        {
+            return {component<I>()...};
+        }
+
+        [[nodiscard]] constexpr auto xy() const -> Vector2<T> { return swizzle<0, 1>(); }
+
+        [[nodiscard]] constexpr auto xz() const -> Vector2<T> { return swizzle<0, 2>(); }
+
+        [[nodiscard]] constexpr auto yz() const -> Vector2<T> { return swizzle<1, 2>(); }
+
+        [[nodiscard]] constexpr auto yzx() const -> Vector3 { return swizzle<1, 2, 0>(); }
+
+        [[nodiscard]] constexpr auto zxy() const -> Vector3 { return swizzle<2, 0, 1>(); }
+
+        [[nodiscard]] constexpr auto zyx() const -> Vector3 { return swizzle<2, 1, 0>(); }
+
+        /**
+         * @brief Set the x, y and z components of the vector
+         *
+         * @param xVal The new x component of the vector
+         * @param yVal The new y component of the vector
+         * @param zVal The new z component of the vector
+         */
+        constexpr void set(T xVal, T yVal, T zVal)
+        {
+            x = xVal;
+            y = yVal;
+            z = zVal;
+        }
+
+        /**
+         * @brief Get the squared length of the vector
+         *
+         * @return constexpr T The squared length of the vector
+         */
+        [[nodiscard]] constexpr auto lengthSquared() const -> T
+        {
+            return (x * x) + (y * y) + (z * z);
+        }
+
+        /**
+         * @brief Get the length of the vector, computed in precision_type_t<T>
+         *
+         * @return precision_type_t<T> The length of the vector
+         */
+        [[nodiscard]] constexpr auto length() const -> precision_type_t<T>
+        {
+            return math::sqrt(static_cast<precision_type_t<T>>(lengthSquared()));
+        }
+
+        /**
+         * @brief Get the length of the vector in high precision
+         *
+         * @return high_precision_type_t<T> The length of the vector, computed in at least double precision
+         */
+        [[nodiscard]] constexpr auto lengthPrecise() const -> high_precision_type_t<T>
+        {
+            using P = high_precision_type_t<T>;
+            return math::sqrt((static_cast<P>(x) * static_cast<P>(x)) + (static_cast<P>(y) * static_cast<P>(y)) +
+                             (static_cast<P>(z) * static_cast<P>(z)));
+        }
+
+        /**
+         * @brief Normalize the vector in-place and return a reference to itself
+         *
+         * @return Vector3& A reference to this normalized vector
+         */
+        constexpr auto normalize() -> Vector3 &
+        {
+            auto len = length();
+            if (len != 0)
+            {
+                x /= len;
+                y /= len;
+                z /= len;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Get a normalized copy of the vector
+         *
+         * @return Vector3 The normalized vector
+         */
+        [[nodiscard]] constexpr auto normalized() const -> Vector3
+        {
+            Vector3 result{*this};
+            return result.normalize();
+        }
+
+        /**
+         * @brief Normalize the vector in-place with a reciprocal square root estimate, like Vector2::normalizeFast
+         *
+         * @return Vector3& A reference to this normalized vector
+         */
+        constexpr auto normalizeFast() -> Vector3 &
+        {
+            if constexpr (std::is_same<T, float>::value && simd::hasFastRsqrt)
+            {
+                const float lenSq = lengthSquared();
+                if (!FZOLV_IS_CONSTANT_EVALUATED() && lenSq >= FLT_MIN && lenSq <= FLT_MAX)
+                {
+                    const float inv = simd::rsqrt(lenSq);
+                    x *= inv;
+                    y *= inv;
+                    z *= inv;
+                    return *this;
+                }
+            }
+            return normalize();
+        }
+
+        /**
+         * @brief Get a copy of the vector normalized with normalizeFast
+         *
+         * @return Vector3 The normalized vector
+         */
+        [[nodiscard]] constexpr auto normalizedFast() const -> Vector3
+        {
+            Vector3 result{*this};
+            return result.normalizeFast();
+        }
+
+        /**
+         * @brief Normalize the vector in-place using a high precision length and return a reference to itself
+         *
+         * @return Vector3& A reference to this normalized vector
+         */
+        constexpr auto normalizePrecise() -> Vector3 &
+        {
+            auto len = lengthPrecise();
+            if (len != 0)
+            {
+                x = static_cast<T>(x / len);
+                y = static_cast<T>(y / len);
+                z = static_cast<T>(z / len);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Get the dot product of this vector and another vector
+         *
+         * @param other The other vector to dot with
+         * @return constexpr T The dot product of the two vectors
+         */
+        [[nodiscard]] constexpr auto dot(const Vector3 &other) const -> T
+        {
+            return x * other.x + y * other.y + z * other.z;
+        }
+
+        /**
+         * @brief Get the cross product of this vector and another vector
+         *
+         * The cross product is perpendicular to both vectors, its length is |a|*|b|*sin(theta) and its direction
+         * follows the right-hand rule. It is anti-commutative, meaning that a.cross(b) = -b.cross(a).
+         *
+         * @param other The other vector to cross with
+         * @return constexpr Vector3 The cross product of the two vectors
+         */
+        [[nodiscard]] constexpr auto cross(const Vector3 &other) const -> Vector3
+        {
+            return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+        }
+
+        /**
+         * @brief Get the squared distance between this vector and another vector
+         *
+         * @param other The other vector to measure the distance to
+         * @return constexpr T The squared distance between the two vectors
+         */
+        [[nodiscard]] constexpr auto distanceToSquared(const Vector3 &other) const -> T
+        {
+            auto dxVal = x - other.x;
+            auto dyVal = y - other.y;
+            auto dzVal = z - other.z;
+            return (dxVal * dxVal) + (dyVal * dyVal) + (dzVal * dzVal);
+        }
+
+        /**
+         * @brief Get the distance between this vector and another vector
+         *
+         * @param other The other vector to measure the distance to
+         * @return precision_type_t<T> The distance between the two vectors
+         */
+        [[nodiscard]] constexpr auto distanceTo(const Vector3 &other) const -> precision_type_t<T>
+        {
+            return math::sqrt(static_cast<precision_type_t<T>>(distanceToSquared(other)));
+        }
+
+        /**
+         * @brief Get the distance between this vector and another vector in high precision
+         *
+         * @param other The other vector to measure the distance to
+         * @return high_precision_type_t<T> The distance between the two vectors, computed in at least double precision
+         */
+        [[nodiscard]] constexpr auto distanceToPrecise(const Vector3 &other) const -> high_precision_type_t<T>
+        {
+            using P = high_precision_type_t<T>;
+            auto dxVal = static_cast<P>(x) - static_cast<P>(other.x);
+            auto dyVal = static_cast<P>(y) - static_cast<P>(other.y);
+            auto dzVal = static_cast<P>(z) - static_cast<P>(other.z);
+            return math::sqrt((dxVal * dxVal) + (dyVal * dyVal) + (dzVal * dzVal));
+        }
+
+        /**
+         * @brief Clamps a vector component-wise to a given range, like Vector2::clamp
+         *
+         * @tparam U The type of the vector to be clamped. Must be convertible to Vector3<T>.
+         * @param value The vector to be clamped.
+         * @param min The vector representing the minimum values.
+         * @param max The vector representing the maximum values.
+         * @return U A new vector of type U that is clamped to the range [min, max].
+         */
+        template <typename U> static constexpr auto clamp(const U &value, const U &min, const U &max)
+            -> typename std::enable_if<std::is_convertible<U, Vector3<T>>::value, U>::type
+        {
+            return U{detail::clampComponent(value.x, min.x, max.x), detail::clampComponent(value.y, min.y, max.y),
+                     detail::clampComponent(value.z, min.z, max.z)};
+        }
+
+        /**
+         * @brief Floor, ceil or round the components of this vector in-place, like the Vector2 counterparts
+         *
+         * @return Vector3& A reference to this vector
+         */
+        constexpr auto floor() -> Vector3 &
+        {
+            x = math::floor(x);
+            y = math::floor(y);
+            z = math::floor(z);
+            return *this;
+        }
+
+        constexpr auto ceil() -> Vector3 &
+        {
+            x = math::ceil(x);
+            y = math::ceil(y);
+            z = math::ceil(z);
+            return *this;
+        }
+
+        constexpr auto round() -> Vector3 &
+        {
+            x = math::round(x);
+            y = math::round(y);
+            z = math::round(z);
+            return *this;
+        }
+
+        /**
+         * @brief Linearly interpolate between two vectors, like Vector2::Lerp
+         *
+         * @param start The vector at amount 0
+         * @param end The vector at amount 1
+         * @param amount The interpolation factor, not clamped
+         * @return constexpr Vector3 The interpolated vector
+         */
+        static constexpr auto Lerp(const Vector3 &start, const Vector3 &end, precision_type_t<T> amount) -> Vector3
+        {
+            return {detail::lerp(start.x, end.x, amount), detail::lerp(start.y, end.y, amount),
+                    detail::lerp(start.z, end.z, amount)};
+        }
+
+        /**
+         * @brief Interpolate between two vectors with an ease-in ease-out curve, like Vector2::SmoothStep
+         */
+        static constexpr auto SmoothStep(const Vector3 &start, const Vector3 &end, precision_type_t<T> amount)
+            -> Vector3
+        {
+            return Lerp(start, end, detail::smoothstep(amount));
+        }
+
+        /**
+         * @brief Evaluate a cubic Hermite spline between two points, like Vector2::Hermite
+         */
+        static constexpr auto Hermite(const Vector3 &p0, const Vector3 &m0, const Vector3 &p1, const Vector3 &m1,
+                                      precision_type_t<T> amount) -> Vector3
+        {
+            const detail::HermiteWeights<precision_type_t<T>> h{amount};
+            return {detail::hermite(p0.x, m0.x, p1.x, m1.x, h), detail::hermite(p0.y, m0.y, p1.y, m1.y, h),
+                    detail::hermite(p0.z, m0.z, p1.z, m1.z, h)};
+        }
+
+        /**
+         * @brief Overload arithmetic operators for vector addition, subtraction, scalar multiplication and division
+         *
+         * @param lhs The left-hand side operand of the operator
+         * @param rhs The right-hand side operand of the operator
+         * @return friend constexpr Vector3 The result of the operation
+         */
+        friend constexpr auto operator+(const Vector3 &lhs, const Vector3 &rhs) -> Vector3
+        {
+            return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+        }
+
+        friend constexpr auto operator-(const Vector3 &lhs, const Vector3 &rhs) -> Vector3
+        {
+            return {lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+        }
+
+        friend constexpr auto operator*(const Vector3 &lhs, T scalar) -> Vector3
+        {
+            return {lhs.x * scalar, lhs.y * scalar, lhs.z * scalar};
+        }
+
+        friend constexpr auto operator/(const Vector3 &lhs, T scalar) -> Vector3
+        {
+            return {lhs.x / scalar, lhs.y / scalar, lhs.z / scalar};
+        }
+
+        /**
+         * @brief Overload compound assignment operators for vector addition, subtraction, scalar multiplication and division
+         */
+        constexpr auto operator+=(const Vector3 &other) -> Vector3 &
+        {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            return *this;
+        }
+
+        constexpr auto operator-=(const Vector3 &other) -> Vector3 &
+        {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            return *this;
+        }
+
+        constexpr auto operator*=(T scalar) -> Vector3 &
+        {
+            x *= scalar;
+            y *= scalar;
+            z *= scalar;
+            return *this;
+        }
+
+        constexpr auto operator/=(T scalar) -> Vector3 &
+        {
+            x /= scalar;
+            y /= scalar;
+            z /= scalar;
+            return *this;
+        }
+
+        /**
+         * @brief Overload comparison operators for vector equality and inequality
+         *
+         * @param lhs The left-hand side operand of the operator
+         * @param rhs The right-hand side operand of the operator
+         * @return friend constexpr bool The result of the comparison
+         */
+        friend constexpr auto operator==(const Vector3 &lhs, const Vector3 &rhs) -> bool
+        {
+            return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+        }
+
+        friend constexpr auto operator!=(const Vector3 &lhs, const Vector3 &rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+        /**
+         * @brief The x component of the vector
+         */
+        T x;
+
+        /**
+         * @brief The y component of the vector
+         */
+        T y;
+
+        /**
+         * @brief The z component of the vector
+         */
+        T z;
+    };
+
+    /**
+     * @brief A 3D vector padded to four components and aligned so that it loads in a single SIMD register
+     *
+     * Vector3A stores x, y and z followed by an unused padding component w that is kept at zero. For float components
+     * the operations run on one SSE or NEON register and evaluate in the same order as Vector3, so both types produce
+     * the same results. It converts to and from Vector3 for use with the rest of the library.
+     *
+     * @tparam T The type of the vector components, must be arithmetic
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class alignas(4 * sizeof(T)) Vector3A
+    {
+        static constexpr bool simdFloat = std::is_same<T, float>::value && (FZOLV_SIMD_SSE2 || FZOLV_SIMD_NEON);
+
+    public:
+        /**
+         * @brief Default constructor, initializes the vector to zero
+         */
+        constexpr Vector3A() : x(), y(), z(), w() {}
+
+        Vector3A(const Vector3A &) = default;
+        Vector3A(Vector3A &&) noexcept = default;
+        auto operator=(const Vector3A &) -> Vector3A & = default;
+        auto operator=(Vector3A &&) noexcept -> Vector3A & = default;
+
+        /**
+         * @brief Constructor from x, y and z components
+         *
+         * @param xVal The x component of the vector
+         * @param yVal The y component of the vector
+         * @param zVal The z component of the vector
+         */
+        constexpr Vector3A(T xVal, T yVal, T zVal) : x{xVal}, y{yVal}, z{zVal}, w() {}
+
+        /**
+         * @brief Converting constructor from an unpadded vector
+         *
+         * @param other The vector to copy the components from
+         */
+        constexpr Vector3A(const Vector3<T> &other) : x{other.x}, y{other.y}, z{other.z}, w() {}
+
+        /**
+         * @brief Convert to an unpadded vector
+         *
+         * @return Vector3<T> The vector without its padding
+         */
+        constexpr operator Vector3<T>() const { return {x, y, z}; }
+
+        static constexpr auto Zero() -> Vector3A { return {T(0), T(0), T(0)}; }
+
+        static constexpr auto One() -> Vector3A { return {T(1), T(1), T(1)}; }
+
+        static constexpr auto UnitX() -> Vector3A { return {T(1), T(0), T(0)}; }
+
+        static constexpr auto UnitY() -> Vector3A { return {T(0), T(1), T(0)}; }
+
+        static constexpr auto UnitZ() -> Vector3A { return {T(0), T(0), T(1)}; }
+
+        /**
+         * @brief Get a component by an index known at compile time, 0 to 2 for x to z
+         */
+        template <std::size_t I>
+        [[nodiscard]] constexpr auto component() const -> T
+        {
+            static_assert(I < 3, "Vector3A has the components 0 to 2, the padding is not a component");
+            if constexpr (I == 0)
+            {
+                return x;
+            }
+            else if constexpr (I == 1)
+            {
+                return y;
+            }
+            else
+            {
+                return z;
+            }
+        }
+
+        /**
+         * @brief Build a vector from the components at the given indices, like Vector3::swizzle
+         *
+         * Three indices give a Vector3A and four a Vector4, for float components both are a single shuffle of the
+         * register on SSE2 and a single table lookup on NEON. The padding of a Vector3A result stays zero.
+         */
+        template <std::size_t... I>
+        [[nodiscard]] auto swizzle() const
+        {
+            constexpr std::size_t count = sizeof...(I);
+            if constexpr (count == 3 || count == 4)
+            {
+                using Result = std::conditional_t<count == 3, Vector3A, typename detail::SwizzleVector<T, count>::type>;
+                static_assert(((I < 3) && ...), "Vector3A has the components 0 to 2, the padding is not a component");
+#if FZOLV_SIMD_SSE2
+                if constexpr (simdFloat)
+                {
+                    constexpr int mask = detail::shuffleMask<I...>();
+                    const __m128 value = load();
+                    Result result;
+                    _mm_store_ps(&result.x, _mm_shuffle_ps(value, value, mask));
+                    return result;
+                }
+#elif FZOLV_SIMD_NEON
+                if constexpr (simdFloat)
+                {
+                    Result result;
+                    vst1q_f32(&result.x, detail::shuffleLanes<I...>(load()));
+                    return result;
+                }
+#endif
+                return Result{component<I>()...};
+            }
+            else
+            {
+                return typename detail::SwizzleVector<T, count>::type{component<I>()...};
+            }
+        }
+
+        [[nodiscard]] auto xy() const -> Vector2<T> { return swizzle<0, 1>(); }
+
+        [[nodiscard]] auto yzx() const -> Vector3A { return swizzle<1, 2, 0>(); }
+
+        [[nodiscard]] auto zxy() const -> Vector3A { return swizzle<2, 0, 1>(); }
+
+        [[nodiscard]] auto lengthSquared() const -> T { return dot(*this); }
+
+        [[nodiscard]] auto length() const -> precision_type_t<T>
+        {
+            return std::sqrt(static_cast<precision_type_t<T>>(lengthSquared()));
+        }
+
+        /**
+         * @brief Normalize the vector in-place and return a reference to itself
+         *
+         * @return Vector3A& A reference to this normalized vector
+         */
+        auto normalize() -> Vector3A &
+        {
+            auto len = length();
+            if (len != 0)
+            {
+                if constexpr (std::is_floating_point<T>::value)
+                {
+                    *this /= len;
+                }
+                else
+                {
+                    x /= len;
+                    y /= len;
+                    z /= len;
+                }
+            }
+            return *this;
+        }
+
+        [[nodiscard]] auto normalized() const -> Vector3A
+        {
+            Vector3A result{*this};
+            return result.normalize();
+        }
+
+        /**
+         * @brief Normalize the vector in-place with a reciprocal square root estimate, like Vector3::normalizeFast
+         *
+         * @return Vector3A& A reference to this normalized vector
+         */
+        auto normalizeFast() -> Vector3A &
+        {
+            if constexpr (std::is_same<T, float>::value && simd::hasFastRsqrt)
+            {
+                const float lenSq = lengthSquared();
+                if (lenSq >= FLT_MIN && lenSq <= FLT_MAX)
+                {
+                    return *this *= simd::rsqrt(lenSq);
+                }
+            }
+            return normalize();
+        }
+
+        [[nodiscard]] auto normalizedFast() const -> Vector3A
+        {
+            Vector3A result{*this};
+            return result.normalizeFast();
+        }
+
+        /**
+         * @brief Get the dot product of this vector and another vector, summed in the same order as Vector3::dot
+         *
+         * @param other The other vector to dot with
+         * @return T The dot product of the two vectors
+         */
+        [[nodiscard]] auto dot(const Vector3A &other) const -> T
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                const __m128 product = _mm_mul_ps(load(), other.load());
+                const __m128 xy = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+                return _mm_cvtss_f32(_mm_add_ss(xy, _mm_movehl_ps(product, product)));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                const float32x4_t product = vmulq_f32(load(), other.load());
+                return (vgetq_lane_f32(product, 0) + vgetq_lane_f32(product, 1)) + vgetq_lane_f32(product, 2);
+            }
+#endif
+            return x * other.x + y * other.y + z * other.z;
+        }
+
+        /**
+         * @brief Get the cross product of this vector and another vector, like Vector3::cross
+         *
+         * @param other The other vector to cross with
+         * @return Vector3A The cross product of the two vectors
+         */
+        [[nodiscard]] auto cross(const Vector3A &other) const -> Vector3A
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                const __m128 a = load();
+                const __m128 b = other.load();
+                const __m128 aYzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+                const __m128 bYzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+                const __m128 aZxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+                const __m128 bZxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+                return fromRegister(_mm_sub_ps(_mm_mul_ps(aYzx, bZxy), _mm_mul_ps(aZxy, bYzx)));
+            }
+#endif
+            return {y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x};
+        }
+
+        [[nodiscard]] auto distanceToSquared(const Vector3A &other) const -> T
+        {
+            const Vector3A delta = *this - other;
+            return delta.dot(delta);
+        }
+
+        [[nodiscard]] auto distanceTo(const Vector3A &other) const -> precision_type_t<T>
+        {
+            return std::sqrt(static_cast<precision_type_t<T>>(distanceToSquared(other)));
+        }
+
+        /**
+         * @brief Clamp a vector component-wise to the range [min, max], like Vector3::clamp
+         *
+         * @param value The vector to be clamped
+         * @param min The vector representing the minimum values
+         * @param max The vector representing the maximum values
+         * @return Vector3A The clamped vector
+         */
+        static auto clamp(const Vector3A &value, const Vector3A &min, const Vector3A &max) -> Vector3A
+        {
+            return Vector3<T>::clamp(Vector3<T>(value), Vector3<T>(min), Vector3<T>(max));
+        }
+
+        /**
+         * @brief Linearly interpolate between two vectors, like Vector3::Lerp
+         *
+         * @param start The vector at amount 0
+         * @param end The vector at amount 1
+         * @param amount The interpolation factor
+         * @return Vector3A The interpolated vector
+         */
+        static auto Lerp(const Vector3A &start, const Vector3A &end, precision_type_t<T> amount) -> Vector3A
+        {
+            if constexpr (simdFloat)
+            {
+                return start + ((end - start) * amount);
+            }
+            return Vector3<T>::Lerp(Vector3<T>(start), Vector3<T>(end), amount);
+        }
+
+        /**
+         * @brief Overload arithmetic operators for vector addition, subtraction, scalar multiplication and division
+         *
+         * @param lhs The left-hand side operand of the operator
+         * @param rhs The right-hand side operand of the operator
+         * @return friend Vector3A The result of the operation
+         */
+        friend auto operator+(const Vector3A &lhs, const Vector3A &rhs) -> Vector3A
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_add_ps(lhs.load(), rhs.load()));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vaddq_f32(lhs.load(), rhs.load()));
+            }
+#endif
+            return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+        }
+
+        friend auto operator-(const Vector3A &lhs, const Vector3A &rhs) -> Vector3A
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_sub_ps(lhs.load(), rhs.load()));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vsubq_f32(lhs.load(), rhs.load()));
+            }
+#endif
+            return {lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+        }
+
+        friend auto operator*(const Vector3A &lhs, T scalar) -> Vector3A
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                ///< Zero in the padding lane, multiplying the padding by an infinite or NaN scalar would give NaN
+                return fromRegister(_mm_mul_ps(lhs.load(), _mm_setr_ps(scalar, scalar, scalar, 0.0F)));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vmulq_f32(lhs.load(), float32x4_t{scalar, scalar, scalar, 0.0F}));
+            }
+#endif
+            return {lhs.x * scalar, lhs.y * scalar, lhs.z * scalar};
+        }
+
+        friend auto operator/(const Vector3A &lhs, T scalar) -> Vector3A
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                ///< Division by a padded register would turn the zero padding into NaN when scalar is zero
+                return fromRegister(_mm_div_ps(lhs.load(), _mm_setr_ps(scalar, scalar, scalar, 1.0F)));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vdivq_f32(lhs.load(), float32x4_t{scalar, scalar, scalar, 1.0F}));
+            }
+#endif
+            return {lhs.x / scalar, lhs.y / scalar, lhs.z / scalar};
+        }
+
+        auto operator+=(const Vector3A &other) -> Vector3A & { return *this = *this + other; }
+
+        auto operator-=(const Vector3A &other) -> Vector3A & { return *this = *this - other; }
+
+        auto operator*=(T scalar) -> Vector3A & { return *this = *this * scalar; }
+
+        auto operator/=(T scalar) -> Vector3A & { return *this = *this / scalar; }
+
+        friend constexpr auto operator==(const Vector3A &lhs, const Vector3A &rhs) -> bool
+        {
+            return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z;
+        }
+
+        friend constexpr auto operator!=(const Vector3A &lhs, const Vector3A &rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+        /**
+         * @brief The x component of the vector
+         */
+        T x;
+
+        /**
+         * @brief The y component of the vector
+         */
+        T y;
+
+        /**
+         * @brief The z component of the vector
+         */
+        T z;
+
+        /**
+         * @brief Padding that completes the SIMD register, always zero
+         */
+        T w;
+
+    private:
+#if FZOLV_SIMD_SSE2
+        [[nodiscard]] auto load() const -> __m128 { return _mm_load_ps(&x); }
+
+        static auto fromRegister(__m128 value) -> Vector3A
+        {
+            Vector3A result;
+            _mm_store_ps(&result.x, value);
+            return result;
+        }
+#elif FZOLV_SIMD_NEON
+        [[nodiscard]] auto load() const -> float32x4_t { return vld1q_f32(&x); }
+
+        static auto fromRegister(float32x4_t value) -> Vector3A
+        {
+            Vector3A result;
+            vst1q_f32(&result.x, value);
+            return result;
+        }
+#endif
+    };
+
+    /**
+     * @brief A generic class for 4D vectors with numeric types
+     *
+     * Vector4 is aligned so that a float vector loads in a single SIMD register. For float components the operations
+     * run on one SSE or NEON register and evaluate in the same order as the scalar code used for other types, so both
+     * produce the same results. It is mostly used for homogeneous coordinates together with Matrix4.
+     *
+     * @tparam T The type of the vector components, must be arithmetic
+     */
+    template <typename T, typename = std::enable_if_t<is_numeric<T>::value>>
+    class alignas(4 * sizeof(T)) Vector4
+    {
+        static constexpr bool simdFloat = std::is_same<T, float>::value && (FZOLV_SIMD_SSE2 || FZOLV_SIMD_NEON);
+
+    public:
+        /**
+         * @brief Default constructor, initializes the vector to zero
+         */
+        constexpr Vector4() : x(), y(), z(), w() {}
+
+        Vector4(const Vector4 &) = default;
+        Vector4(Vector4 &&) noexcept = default;
+        auto operator=(const Vector4 &) -> Vector4 & = default;
+        auto operator=(Vector4 &&) noexcept -> Vector4 & = default;
+
+        /**
+         * @brief Constructor from x, y, z and w components
+         *
+         * @param xVal The x component of the vector
+         * @param yVal The y component of the vector
+         * @param zVal The z component of the vector
+         * @param wVal The w component of the vector
+         */
+        constexpr Vector4(T xVal, T yVal, T zVal, T wVal) : x{xVal}, y{yVal}, z{zVal}, w{wVal} {}
+
+        /**
+         * @brief Constructor from a 3D vector and a w component, e.g. w = 1 for points and w = 0 for directions
+         *
+         * @param xyz The x, y and z components of the vector
+         * @param wVal The w component of the vector
+         */
+        constexpr Vector4(const Vector3<T> &xyz, T wVal) : x{xyz.x}, y{xyz.y}, z{xyz.z}, w{wVal} {}
+
+        /**
+         * @brief Get the x, y and z components as a 3D vector
+         *
+         * @return constexpr Vector3<T> The vector without its w component
+         */
+        [[nodiscard]] constexpr auto xyz() const -> Vector3<T> { return {x, y, z}; }
+
+        /**
+         * @brief Get a component by an index known at compile time, 0 to 3 for x to w
+         */
+        template <std::size_t I>
+        [[nodiscard]] constexpr auto component() const -> T
+        {
+            static_assert(I < 4, "Vector4 has the components 0 to 3");
+            if constexpr (I == 0)
+            {
+                return x;
+            }
+            else if constexpr (I == 1)
+            {
+                return y;
+            }
+            else if constexpr (I == 2)
+            {
+                return z;
+            }
+            else
+            {
+                return w;
+            }
+        }
+
+        /**
+         * @brief Build a vector from the components at the given indices, like Vector2::swizzle
+         *
+         * Four indices of a float vector are a single shuffle of the register on SSE2 and a single table lookup on NEON.
+         */
+        template <std::size_t... I>
+        [[nodiscard]] auto swizzle() const -> typename detail::SwizzleVector<T, sizeof...(I)>::type
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat && sizeof...(I) == 4)
+            {
+                static_assert(((I < 4) && ...), "Vector4 has the components 0 to 3");
+                constexpr int mask = detail::shuffleMask<I...>();
+                const __m128 value = load();
+                return fromRegister(_mm_shuffle_ps(value, value, mask));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat && sizeof...(I) == 4)
+            {
+                static_assert(((I < 4) && ...), "Vector4 has the components 0 to 3");
+                return fromRegister(detail::shuffleLanes<I...>(load()));
+            }
+#endif
+            return {component<I>()...};
+        }
+
+        [[nodiscard]] auto xy() const -> Vector2<T> { return swizzle<0, 1>(); }
+
+        [[nodiscard]] auto wzyx() const -> Vector4 { return swizzle<3, 2, 1, 0>(); }
+
+        static constexpr auto Zero() -> Vector4 { return {T(0), T(0), T(0), T(0)}; }
+
+        static constexpr auto One() -> Vector4 { return {T(1), T(1), T(1), T(1)}; }
+
+        static constexpr auto UnitX() -> Vector4 { return {T(1), T(0), T(0), T(0)}; }
+
+        static constexpr auto UnitY() -> Vector4 { return {T(0), T(1), T(0), T(0)}; }
+
+        static constexpr auto UnitZ() -> Vector4 { return {T(0), T(0), T(1), T(0)}; }
+
+        static constexpr auto UnitW() -> Vector4 { return {T(0), T(0), T(0), T(1)}; }
+
+        [[nodiscard]] auto lengthSquared() const -> T { return dot(*this); }
+
+        [[nodiscard]] auto length() const -> precision_type_t<T>
+        {
+            return std::sqrt(static_cast<precision_type_t<T>>(lengthSquared()));
+        }
+
+        /**
+         * @brief Normalize the vector in-place and return a reference to itself
+         *
+         * @return Vector4& A reference to this normalized vector
+         */
+        auto normalize() -> Vector4 &
+        {
+            auto len = length();
+            if (len != 0)
+            {
+                if constexpr (std::is_floating_point<T>::value)
+                {
+                    *this /= len;
+                }
+                else
+                {
+                    x /= len;
+                    y /= len;
+                    z /= len;
+                    w /= len;
+                }
+            }
+            return *this;
+        }
+
+        [[nodiscard]] auto normalized() const -> Vector4
+        {
+            Vector4 result{*this};
+            return result.normalize();
+        }
+
+        /**
+         * @brief Normalize the vector in-place with a reciprocal square root estimate, like Vector2::normalizeFast
+         *
+         * @return Vector4& A reference to this normalized vector
+         */
+        auto normalizeFast() -> Vector4 &
+        {
+            if constexpr (std::is_same<T, float>::value && simd::hasFastRsqrt)
+            {
+                const float lenSq = lengthSquared();
+                if (lenSq >= FLT_MIN && lenSq <= FLT_MAX)
+                {
+                    return *this *= simd::rsqrt(lenSq);
+                }
+            }
+            return normalize();
+        }
+
+        [[nodiscard]] auto normalizedFast() const -> Vector4
+        {
+            Vector4 result{*this};
+            return result.normalizeFast();
+        }
+
+        /**
+         * @brief Get the dot product of this vector and another vector, summed from x to w
+         *
+         * @param other The other vector to dot with
+         * @return T The dot product of the two vectors
+         */
+        [[nodiscard]] auto dot(const Vector4 &other) const -> T
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                const __m128 product = _mm_mul_ps(load(), other.load());
+                const __m128 xy = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+                const __m128 xyz = _mm_add_ss(xy, _mm_movehl_ps(product, product));
+                return _mm_cvtss_f32(_mm_add_ss(xyz, _mm_shuffle_ps(product, product, _MM_SHUFFLE(3, 3, 3, 3))));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                const float32x4_t product = vmulq_f32(load(), other.load());
+                return ((vgetq_lane_f32(product, 0) + vgetq_lane_f32(product, 1)) + vgetq_lane_f32(product, 2)) +
+                       vgetq_lane_f32(product, 3);
+            }
+#endif
+            return x * other.x + y * other.y + z * other.z + w * other.w;
+        }
+
+        [[nodiscard]] auto distanceToSquared(const Vector4 &other) const -> T
+        {
+            const Vector4 delta = *this - other;
+            return delta.dot(delta);
+        }
+
+        [[nodiscard]] auto distanceTo(const Vector4 &other) const -> precision_type_t<T>
+        {
+            return std::sqrt(static_cast<precision_type_t<T>>(distanceToSquared(other)));
+        }
+
+        /**
+         * @brief Clamp a vector component-wise to the range [min, max], like Vector2::clamp
+         *
+         * @param value The vector to be clamped
+         * @param min The vector representing the minimum values
+         * @param max The vector representing the maximum values
+         * @return Vector4 The clamped vector
+         */
+        static auto clamp(const Vector4 &value, const Vector4 &min, const Vector4 &max) -> Vector4
+        {
+            return {detail::clampComponent(value.x, min.x, max.x), detail::clampComponent(value.y, min.y, max.y),
+                    detail::clampComponent(value.z, min.z, max.z), detail::clampComponent(value.w, min.w, max.w)};
+        }
+
+        /**
+         * @brief Linearly interpolate between two vectors, like Vector2::Lerp
+         *
+         * @param start The vector at amount 0
+         * @param end The vector at amount 1
+         * @param amount The interpolation factor
+         * @return Vector4 The interpolated vector
+         */
+        static auto Lerp(const Vector4 &start, const Vector4 &end, precision_type_t<T> amount) -> Vector4
+        {
+            if constexpr (simdFloat)
+            {
+                return start + ((end - start) * amount);
+            }
+            return {detail::lerp(start.x, end.x, amount), detail::lerp(start.y, end.y, amount),
+                    detail::lerp(start.z, end.z, amount), detail::lerp(start.w, end.w, amount)};
+        }
+
+        /**
+         * @brief Overload arithmetic operators for vector addition, subtraction, scalar multiplication and division
+         *
+         * @param lhs The left-hand side operand of the operator
+         * @param rhs The right-hand side operand of the operator
+         * @return friend Vector4 The result of the operation
+         */
+        friend auto operator+(const Vector4 &lhs, const Vector4 &rhs) -> Vector4
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_add_ps(lhs.load(), rhs.load()));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vaddq_f32(lhs.load(), rhs.load()));
+            }
+#endif
+            return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w};
+        }
+
+        friend auto operator-(const Vector4 &lhs, const Vector4 &rhs) -> Vector4
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_sub_ps(lhs.load(), rhs.load()));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vsubq_f32(lhs.load(), rhs.load()));
+            }
+#endif
+            return {lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z, lhs.w - rhs.w};
+        }
+
+        friend auto operator*(const Vector4 &lhs, T scalar) -> Vector4
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_mul_ps(lhs.load(), _mm_set1_ps(scalar)));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vmulq_n_f32(lhs.load(), scalar));
+            }
+#endif
+            return {lhs.x * scalar, lhs.y * scalar, lhs.z * scalar, lhs.w * scalar};
+        }
+
+        friend auto operator/(const Vector4 &lhs, T scalar) -> Vector4
+        {
+#if FZOLV_SIMD_SSE2
+            if constexpr (simdFloat)
+            {
+                return fromRegister(_mm_div_ps(lhs.load(), _mm_set1_ps(scalar)));
+            }
+#elif FZOLV_SIMD_NEON
+            if constexpr (simdFloat)
+            {
+                return fromRegister(vdivq_f32(lhs.load(), vdupq_n_f32(scalar)));
+            }
+#endif
+            return {lhs.x / scalar, lhs.y / scalar, lhs.z / scalar, lhs.w / scalar};
+        }
+
+        auto operator+=(const Vector4 &other) -> Vector4 & { return *this = *this + other; }
+
+        auto operator-=(const Vector4 &other) -> Vector4 & { return *this = *this - other; }
+
+        auto operator*=(T scalar) -> Vector4 & { return *this = *this * scalar; }
+
+        auto operator/=(T scalar) -> Vector4 & { return *this = *this / scalar; }
+
+        friend constexpr auto operator==(const Vector4 &lhs, const Vector4 &rhs) -> bool
+        {
+            return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.w == rhs.w;
+        }
+
+        friend constexpr auto operator!=(const Vector4 &lhs, const Vector4 &rhs) -> bool
+        {
+            return !(lhs == rhs);
+        }
+
+        /**
+         * @brief The x component of the vector
+         */
+        T x;
+
+        /**
+         * @brief The y component of the vector
+         */
+        T y;
+
+        /**
+         * @brief The z component of the vector
+         */
+        T z;
+
+        /**
+         * @brief The w component of the vector
+         */
+        T w;
+
+    private:
+        // Matrix4 multiplies its columns in registers with the same helpers
+        template <typename, typename>
+        friend class Matrix4;
+
+#if FZOLV_SIMD_SSE2
+        /**
+         * @brief Load the vector into a SIMD register, only available for float components
+         *
+         * @return __m128 The components x to w in lanes 0 to 3
+         */
+        [[nodiscard]] auto load() const -> __m128 { return _mm_load_ps(&x); }
+
+        static auto fromRegister(__m128 value) -> Vector4
+        {
+            Vector4 result;
+            _mm_store_ps(&result.x, value);
+            return result;
+        }
+#elif FZOLV_SIMD_NEON
+        /**
+         * @brief Load the vector into a SIMD register, only available for float components
+         *
+         * @return float32x4_t The components x to w in lanes 0 to 3
+         */
+        [[nodiscard]] auto load() const -> float32x4_t { return vld1q_f32(&x); }
+
+        static auto fromRegister(float32x4_t value) -> Vector4
+        {
+            Vector4 result;
+            vst1q_f32(&result.x, value);
+            return result;
+        }
+#endif
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        struct SwizzleVector<T, 2>
+        {
+            using type = Vector2<T>;
+        };
+
+        template <typename T>
+        struct SwizzleVector<T, 3>
+        {
+            using type = Vector3<T>;
+        };
+
+        template <typename T>
+        struct SwizzleVector<T, 4>
+        {
+            using type = Vector4<T>;
+        };
+    }
+
+    using Vector2f = Vector2<float>;
+    using Vector2i = Vector2<int>;
+    using Vector3f = Vector3<float>;
+    using Vector3i = Vector3<int>;
+    using Vector3Af = Vector3A<float>;
+    using Vector4f = Vector4<float>;
+    using Vector4i = Vector4<int>;
+
+    ///< Vectors are plain aggregates of their components, so arrays of them can be copied as raw bytes
+    static_assert(std::is_trivially_copyable<Vector2f>::value, "Vector2f must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Vector2i>::value, "Vector2i must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Vector3f>::value, "Vector3f must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Vector3i>::value, "Vector3i must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Vector3Af>::value, "Vector3Af must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Vector4f>::value, "Vector4f must be trivially copyable");
+    static_assert(std::is_standard_layout<Vector2f>::value, "Vector2f must be standard layout");
+    static_assert(std::is_standard_layout<Vector2i>::value, "Vector2i must be standard layout");
+    static_assert(std::is_standard_layout<Vector3f>::value, "Vector3f must be standard layout");
+    static_assert(std::is_standard_layout<Vector3i>::value, "Vector3i must be standard layout");
+    static_assert(std::is_standard_layout<Vector3Af>::value, "Vector3Af must be standard layout");
+    static_assert(std::is_standard_layout<Vector4f>::value, "Vector4f must be standard layout");
+    static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Vector2f must not contain padding");
+    static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f must not contain padding");
+    static_assert(sizeof(Vector3Af) == 16 && alignof(Vector3Af) == 16, "Vector3Af must fill exactly one SIMD register");
+    static_assert(sizeof(Vector4f) == 16 && alignof(Vector4f) == 16, "Vector4f must fill exactly one SIMD register");
 }
 
 #endif /* end of include guard: FZOLV_VECTOR_hy78kj */
\ No newline at end of file
@@ -0,0 +1,261 @@
+#ifndef FZOLV_ACCURACY_n5ph3i
+#define FZOLV_ACCURACY_n5ph3i
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <quaternion.hpp>
+#include <random>
+#include <vector>
+#include <vector.hpp>
+
+/**
+ * @brief Measure the error of the fast and batch kernels against long double references
+ *
+ * Shared by the accuracy tests, which fail when a kernel leaves its documented bound, and by the Accuracy/ benchmarks,
+ * which report the same errors next to the throughput.
+ */
+namespace accuracy
+{
+    /**
+     * @brief The spacing of floats around reference, 2^-149 in the denormal range
+     */
+    inline auto ulpOf(long double reference) -> long double
+    {
+        const long double magnitude = std::fabs(reference);
+        if (magnitude < FLT_MIN)
+        {
+            return std::ldexp(1.0L, -149);
+        }
+        int exponent = 0;
+        std::frexp(std::fmin(magnitude, static_cast<long double>(FLT_MAX)), &exponent);
+        return std::ldexp(1.0L, exponent - 24);
+    }
+
+    /**
+     * @brief The largest errors of a kernel over all samples, in float ulps and relative to the reference
+     *
+     * Relative errors of results below FLT_MIN are taken against FLT_MIN, where the spacing of floats stops shrinking,
+     * so that a denormal off by one step does not count as a large relative error. A result that is NaN or infinite
+     * where the reference is not, or the other way round, counts as an infinite error.
+     *
+     * Kernels with an absolute bound, like the quantizers and slerp, are measured with absolute(). Their results are
+     * near zero whenever a component is, so the relative error says nothing about them and is not reported.
+     */
+    struct Errors
+    {
+        double maxUlp = 0.0;
+        double maxRelative = 0.0;
+        double maxAbsolute = 0.0;
+        std::size_t samples = 0;
+        bool relative = true; ///< Whether maxRelative is meaningful and reported
+
+        static auto absolute() -> Errors
+        {
+            Errors errors;
+            errors.relative = false;
+            return errors;
+        }
+
+        void add(float actual, long double reference) { add(actual, reference, ulpOf(reference)); }
+
+        ///< Count ulps in another spacing, halfUlpOf for results stored at half precision
+        void add(float actual, long double reference, long double ulp)
+        {
+            ++samples;
+            if (std::isnan(reference) || std::isnan(actual) || std::isinf(reference) || std::isinf(actual))
+            {
+                if (!(std::isnan(reference) && std::isnan(actual)) && static_cast<long double>(actual) != reference)
+                {
+                    maxUlp = maxRelative = maxAbsolute = std::numeric_limits<double>::infinity();
+                }
+                return;
+            }
+            const long double error = std::fabs(static_cast<long double>(actual) - reference);
+            const long double scale = std::fmax(std::fabs(reference), static_cast<long double>(FLT_MIN));
+            maxUlp = std::fmax(maxUlp, static_cast<double>(error / ulp));
+            maxRelative = std::fmax(maxRelative, static_cast<double>(error / scale));
+            maxAbsolute = std::fmax(maxAbsolute, static_cast<double>(error));
+        }
+    };
+
+    ///< The bound to report for kernels that document none
+    constexpr double noBound = -1.0;
+
+    ///< One line per kernel, e.g. "[ accuracy ] batch::normalizeFast/avx2   3.83 ulp  rel 2.7e-07 ... bound 9.54e-07"
+    inline void print(const char *kernel, const Errors &errors, double bound)
+    {
+        char limit[32] = "none";
+        if (bound >= 0.0)
+        {
+            std::snprintf(limit, sizeof(limit), "%.3g", bound);
+        }
+        char relative[32] = "n/a";
+        if (errors.relative)
+        {
+            std::snprintf(relative, sizeof(relative), "%.3g", errors.maxRelative);
+        }
+        std::printf("[ accuracy ] %-32s %8.2f ulp  rel %9s  abs %9.3g  bound %9s  %zu samples\n", kernel,
+                    errors.maxUlp, relative, errors.maxAbsolute, limit, errors.samples);
+    }
+
+    /**
+     * @brief Floats whose exponents are spread evenly over the whole normal and denormal range, both signs
+     */
+    inline auto randomFloats(std::size_t count, unsigned seed, int minExponent = -149, int maxExponent = 127)
+        -> std::vector<float>
+    {
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<int> exponent{minExponent, maxExponent};
+        std::uniform_real_distribution<float> mantissa{1.0f, 2.0f};
+        std::bernoulli_distribution negative{0.5};
+        std::vector<float> values(count);
+        for (float &value : values)
+        {
+            value = std::ldexp(mantissa(rng), exponent(rng));
+            value = negative(rng) ? -value : value;
+        }
+        return values;
+    }
+
+    /**
+     * @brief Zeros, denormals, the limits of float and half and the neighbours of powers of two
+     */
+    inline auto adversarialFloats() -> std::vector<float>
+    {
+        std::vector<float> values{0.0f,
+                                  std::numeric_limits<float>::denorm_min(),
+                                  1e-40f,
+                                  FLT_MIN,
+                                  std::nextafter(FLT_MIN, 0.0f),
+                                  FLT_MAX,
+                                  std::nextafter(FLT_MAX, 0.0f),
+                                  FLT_EPSILON,
+                                  1.0f,
+                                  std::nextafter(1.0f, 0.0f),
+                                  std::nextafter(1.0f, 2.0f),
+                                  65504.0f,
+                                  65519.996f,
+                                  65520.0f,
+                                  std::ldexp(1.0f, -14),
+                                  std::ldexp(1.0f, -24),
+                                  std::ldexp(1.0f, -25),
+                                  std::ldexp(1.5f, -25),
+                                  std::ldexp(1.0f, -26),
+                                  1.0f + std::ldexp(1.0f, -11),
+                                  1.0f + std::ldexp(3.0f, -11),
+                                  std::numeric_limits<float>::infinity()};
+        const std::size_t positives = values.size();
+        for (std::size_t i = 0; i < positives; ++i)
+        {
+            values.push_back(-values[i]);
+        }
+        return values;
+    }
+
+    /**
+     * @brief 2D vectors mixing every adversarial float with random directions at every scale
+     */
+    inline auto adversarialVectors(std::size_t randomCount, unsigned seed) -> std::vector<Fzolv::Vector2f>
+    {
+        const std::vector<float> special = adversarialFloats();
+        std::vector<Fzolv::Vector2f> vectors;
+        for (float x : special)
+        {
+            for (float y : special)
+            {
+                if (std::isfinite(x) && std::isfinite(y))
+                {
+                    vectors.push_back({x, y});
+                }
+            }
+        }
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<int> exponent{-140, 125};
+        std::uniform_real_distribution<float> component{-1.0f, 1.0f};
+        for (std::size_t i = 0; i < randomCount; ++i)
+        {
+            const int scale = exponent(rng);
+            vectors.push_back({std::ldexp(component(rng), scale), std::ldexp(component(rng), scale)});
+        }
+        return vectors;
+    }
+
+    ///< The exact normalized vector, zero for the zero vector like normalize()
+    inline void referenceNormalize(const Fzolv::Vector2f &value, long double &x, long double &y)
+    {
+        const long double length = std::sqrt(static_cast<long double>(value.x) * value.x +
+                                             static_cast<long double>(value.y) * value.y);
+        x = length != 0.0L ? value.x / length : 0.0L;
+        y = length != 0.0L ? value.y / length : 0.0L;
+    }
+
+    /**
+     * @brief The binary16 value nearest to value with ties to even, as the float it widens to
+     */
+    inline auto referenceHalf(float value) -> long double
+    {
+        if (std::isnan(value))
+        {
+            return value;
+        }
+        const long double magnitude = std::fabs(static_cast<long double>(value));
+        ///< Halfway between 65504 and the first value past it rounds to infinity
+        if (magnitude >= 65520.0L)
+        {
+            return std::copysign(std::numeric_limits<long double>::infinity(), static_cast<long double>(value));
+        }
+        int exponent = 0;
+        std::frexp(magnitude, &exponent);
+        const long double quantum = std::ldexp(1.0L, std::max(exponent, -13) - 11);
+        return std::copysign(std::nearbyint(magnitude / quantum) * quantum, static_cast<long double>(value));
+    }
+
+    /**
+     * @brief Smallest-three words no encoder writes, index 3 for three components, all ones and stray sign bits
+     */
+    inline auto malformedWords() -> std::vector<std::uint32_t>
+    {
+        return {0xFFFFFFFFu, 0xC0000000u, 0xC0001234u, 0xDFFFFFFFu, 0xE0000000u,
+                0xFFFFC000u, 0x3FFFFFFFu, 0x7FFFFFFFu, 0xBFFFFFFFu};
+    }
+
+    /**
+     * @brief The slerp of two unit quaternions in long double, without the series of Quaternion::SlerpFast
+     */
+    inline void referenceSlerp(const Fzolv::Quaternionf &start, const Fzolv::Quaternionf &end, float amount,
+                               long double (&out)[4])
+    {
+        const long double s[4] = {start.x, start.y, start.z, start.w};
+        long double e[4] = {end.x, end.y, end.z, end.w};
+        const long double cosine = s[0] * e[0] + s[1] * e[1] + s[2] * e[2] + s[3] * e[3];
+        long double difference = 0.0L, sum = 0.0L;
+        for (int k = 0; k < 4; ++k)
+        {
+            e[k] = cosine < 0.0L ? -e[k] : e[k];
+            difference += (s[k] - e[k]) * (s[k] - e[k]);
+            sum += (s[k] + e[k]) * (s[k] + e[k]);
+        }
+        const long double theta = 2.0L * std::atan2(std::sqrt(difference), std::sqrt(sum));
+        const long double sine = std::sin(theta);
+        for (int k = 0; k < 4; ++k)
+        {
+            out[k] = sine > 0.0L ? (s[k] * std::sin((1.0L - amount) * theta) + e[k] * std::sin(amount * theta)) / sine
+                                 : s[k] + (e[k] - s[k]) * amount;
+        }
+    }
+
+    ///< The spacing of halves around reference, 2^-24 in the subnormal range
+    inline auto halfUlpOf(long double reference) -> long double
+    {
+        int exponent = 0;
+        std::frexp(std::fmin(std::fabs(reference), 65504.0L), &exponent);
+        return std::ldexp(1.0L, std::max(exponent, -13) - 11);
+    }
+}
+
+#endif /* end of include guard: FZOLV_ACCURACY_n5ph3i */
@@ -0,0 +1,1014 @@
+#include "accuracy.hpp"
+#include <aabb.hpp>
+#include <arena.hpp>
+#include <batch.hpp>
+#include <benchmark/benchmark.h>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expr.hpp>
+#include <fixed.hpp>
+#include <geometry.hpp>
+#include <half.hpp>
+#include <limits>
+#include <mapped.hpp>
+#include <memory_resource>
+#include <parallel.hpp>
+#include <quantize.hpp>
+#include <quaternion.hpp>
+#include <random>
+#include <soa.hpp>
+#include <spatial_hash.hpp>
+#include <string>
+#include <type_traits>
+#include <vector.hpp>
+#include <vector>
+
+namespace
+{
+    ///< Element counts whose working sets stay in L1, stay in L2 and spill to DRAM
+    constexpr std::size_t benchSizes[] = {std::size_t{1} << 10, std::size_t{1} << 15, std::size_t{1} << 22};
+
+    template <typename T>
+    auto typeName() -> std::string
+    {
+        if constexpr (std::is_same<T, float>::value)
+        {
+            return "float";
+        }
+        else if constexpr (std::is_same<T, double>::value)
+        {
+            return "double";
+        }
+        else if constexpr (std::is_same<T, Fzolv::Fixed16>::value)
+        {
+            return "Fixed16";
+        }
+        else
+        {
+            return "int";
+        }
+    }
+
+    template <typename T>
+    auto makeVectors(std::size_t count, unsigned seed) -> std::vector<Fzolv::Vector2<T>>
+    {
+        std::mt19937 rng{seed};
+        std::vector<Fzolv::Vector2<T>> vectors;
+        vectors.reserve(count);
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            std::uniform_real_distribution<T> dist{T(-100), T(100)};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                vectors.emplace_back(dist(rng), dist(rng));
+            }
+        }
+        else
+        {
+            ///< Non-zero components keep the integer divisions and normalizations well defined
+            std::uniform_int_distribution<int> dist{1, 100};
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                vectors.emplace_back(T(dist(rng)), T(dist(rng)));
+            }
+        }
+        return vectors;
+    }
+
+    ///< Hide a constant from the optimizer so that multiplying by one is not folded away
+    template <typename T>
+    auto opaque(T value) -> T
+    {
+        benchmark::DoNotOptimize(value);
+        return value;
+    }
+
+    template <typename T>
+    void setThroughput(benchmark::State &state, std::size_t count)
+    {
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * count * sizeof(Fzolv::Vector2<T>)));
+    }
+
+    /**
+     * @brief Register a benchmark of out[i] = op(lhs[i], rhs[i]) for every array size
+     */
+    template <typename T, typename Op>
+    void registerElementwise(const std::string &name, Op op)
+    {
+        using Result = decltype(op(std::declval<Fzolv::Vector2<T> &>(), std::declval<const Fzolv::Vector2<T> &>()));
+        using Stored = std::conditional_t<std::is_same<Result, bool>::value, char, std::decay_t<Result>>;
+
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark(("Vector2<" + typeName<T>() + ">/" + name).c_str(),
+                                         [op, count](benchmark::State &state)
+                                         {
+                                             auto lhs = makeVectors<T>(count, 1);
+                                             const auto rhs = makeVectors<T>(count, 2);
+                                             std::vector<Stored> out(count);
+                                             for (auto _ : state)
+                                             {
+                                                 for (std::size_t i = 0; i < count; ++i)
+                                                 {
+                                                     Fzolv::Vector2<T> value = lhs[i];
+                                                     out[i] = static_cast<Stored>(op(value, rhs[i]));
+                                                 }
+                                                 benchmark::DoNotOptimize(out.data());
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             setThroughput<T>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    template <typename Container, typename T>
+    auto makeContainer(const std::vector<Fzolv::Vector2<T>> &vectors) -> Container
+    {
+        if constexpr (std::is_same<Container, std::vector<Fzolv::Vector2<T>>>::value)
+        {
+            return vectors;
+        }
+        else
+        {
+            return Container{vectors.data(), vectors.size()};
+        }
+    }
+
+    /**
+     * @brief Register a benchmark of a whole-array operation fn(lhs, rhs, scalars) for every array size
+     *
+     * @tparam Container Either std::vector<Vector2<T>> or Vector2SoA<T>
+     */
+    template <typename T, typename Container, typename Fn>
+    void registerBatch(const std::string &name, Fn fn)
+    {
+        const std::string layout = std::is_same<Container, Fzolv::Vector2SoA<T>>::value ? "SoA<" : "Batch<";
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark((layout + typeName<T>() + ">/" + name).c_str(),
+                                         [fn, count](benchmark::State &state)
+                                         {
+                                             const auto lhsVectors = makeVectors<T>(count, 1);
+                                             const auto rhsVectors = makeVectors<T>(count, 2);
+                                             auto lhs = makeContainer<Container>(lhsVectors);
+                                             const auto rhs = makeContainer<Container>(rhsVectors);
+                                             std::vector<T> scalars(count);
+                                             for (auto _ : state)
+                                             {
+                                                 fn(lhs, rhs, scalars);
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             setThroughput<T>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    template <typename T>
+    void registerVector2()
+    {
+        using V = Fzolv::Vector2<T>;
+
+        registerElementwise<T>("Zero", [](V &, const V &) { return V::Zero(); });
+        registerElementwise<T>("One", [](V &, const V &) { return V::One(); });
+        registerElementwise<T>("UnitX", [](V &, const V &) { return V::UnitX(); });
+        registerElementwise<T>("UnitY", [](V &, const V &) { return V::UnitY(); });
+        registerElementwise<T>("set", [](V &a, const V &b) { a.set(b.y, b.x); return a; });
+        registerElementwise<T>("lengthSquared", [](V &a, const V &) { return a.lengthSquared(); });
+        registerElementwise<T>("length", [](V &a, const V &) { return a.length(); });
+        registerElementwise<T>("lengthPrecise", [](V &a, const V &) { return a.lengthPrecise(); });
+        registerElementwise<T>("normalize", [](V &a, const V &) { return a.normalize(); });
+        registerElementwise<T>("normalized", [](V &a, const V &) { return a.normalized(); });
+        registerElementwise<T>("normalizeFast", [](V &a, const V &) { return a.normalizeFast(); });
+        registerElementwise<T>("normalizedFast", [](V &a, const V &) { return a.normalizedFast(); });
+        registerElementwise<T>("normalizePrecise", [](V &a, const V &) { return a.normalizePrecise(); });
+        registerElementwise<T>("dot", [](V &a, const V &b) { return a.dot(b); });
+        registerElementwise<T>("cross", [](V &a, const V &b) { return a.cross(b); });
+        registerElementwise<T>("distanceToSquared", [](V &a, const V &b) { return a.distanceToSquared(b); });
+        registerElementwise<T>("distanceTo", [](V &a, const V &b) { return a.distanceTo(b); });
+        registerElementwise<T>("distanceToPrecise", [](V &a, const V &b) { return a.distanceToPrecise(b); });
+        registerElementwise<T>("clamp", [](V &a, const V &b) { return V::clamp(a, V::Zero(), b); });
+        registerElementwise<T>("floor", [](V &a, const V &) { return a.floor(); });
+        registerElementwise<T>("ceil", [](V &a, const V &) { return a.ceil(); });
+        registerElementwise<T>("round", [](V &a, const V &) { return a.round(); });
+        registerElementwise<T>("Lerp", [](V &a, const V &b) { return V::Lerp(a, b, Fzolv::precision_type_t<T>(0.25)); });
+        registerElementwise<T>("SmoothStep",
+                               [](V &a, const V &b) { return V::SmoothStep(a, b, Fzolv::precision_type_t<T>(0.25)); });
+        registerElementwise<T>("Hermite", [](V &a, const V &b)
+                               { return V::Hermite(a, b - a, b, a - b, Fzolv::precision_type_t<T>(0.25)); });
+        registerElementwise<T>("yx", [](V &a, const V &) { return a.yx(); });
+        registerElementwise<T>("swizzle<1,0,1,0>", [](V &a, const V &) { return a.template swizzle<1, 0, 1, 0>(); });
+        registerElementwise<T>("operator+", [](V &a, const V &b) { return a + b; });
+        registerElementwise<T>("operator-", [](V &a, const V &b) { return a - b; });
+        registerElementwise<T>("operator*", [](V &a, const V &b) { return a * b.x; });
+        registerElementwise<T>("operator/", [](V &a, const V &b) { return a / b.x; });
+        registerElementwise<T>("operator+=", [](V &a, const V &b) { return a += b; });
+        registerElementwise<T>("operator-=", [](V &a, const V &b) { return a -= b; });
+        registerElementwise<T>("operator*=", [](V &a, const V &b) { return a *= b.x; });
+        registerElementwise<T>("operator/=", [](V &a, const V &b) { return a /= b.x; });
+        registerElementwise<T>("operator==", [](V &a, const V &b) { return a == b; });
+        registerElementwise<T>("operator!=", [](V &a, const V &b) { return a != b; });
+        registerElementwise<T>("fusedExpression",
+                               [](V &a, const V &b) { return V(Fzolv::expr::lazy(a) + Fzolv::expr::lazy(b) * T(2) - b); });
+        registerElementwise<T>("eagerExpression", [](V &a, const V &b) { return a + b * T(2) - b; });
+    }
+
+    template <typename T>
+    void registerBatchKernels()
+    {
+        using V = Fzolv::Vector2<T>;
+        using Vectors = std::vector<V>;
+        using SoA = Fzolv::Vector2SoA<T>;
+        using Scalars = std::vector<T>;
+
+        registerBatch<T, Vectors>("dot", [](Vectors &a, const Vectors &b, Scalars &out)
+                                  { Fzolv::batch::dot<T>(a, b, out); });
+        registerBatch<T, Vectors>("cross", [](Vectors &a, const Vectors &b, Scalars &out)
+                                  { Fzolv::batch::cross<T>(a, b, out); });
+        registerBatch<T, Vectors>("lengthSquared", [](Vectors &a, const Vectors &, Scalars &out)
+                                  { Fzolv::batch::lengthSquared<T>(a, out); });
+        registerBatch<T, Vectors>("distanceToSquared", [](Vectors &a, const Vectors &b, Scalars &out)
+                                  { Fzolv::batch::distanceToSquared<T>(a, b, out); });
+        registerBatch<T, Vectors>("normalize", [](Vectors &a, const Vectors &b, Scalars &)
+                                  { Fzolv::batch::normalize<T>(b, a); });
+        registerBatch<T, Vectors>("normalizeFast", [](Vectors &a, const Vectors &b, Scalars &)
+                                  { Fzolv::batch::normalizeFast<T>(b, a); });
+        registerBatch<T, Vectors>("lerp", [](Vectors &a, const Vectors &b, Scalars &t)
+                                  { Fzolv::batch::lerp<T>(b, b, t, a); });
+        registerBatch<T, Vectors>("smoothstep", [](Vectors &a, const Vectors &b, Scalars &t)
+                                  { Fzolv::batch::smoothstep<T>(b, b, t, a); });
+        registerBatch<T, Vectors>("hermite", [](Vectors &a, const Vectors &b, Scalars &t)
+                                  { Fzolv::batch::hermite<T>(b, b, b, b, t, a); });
+        registerBatch<T, Vectors>("fusedAddScaled", [](Vectors &a, const Vectors &b, Scalars &)
+                                  { a += Fzolv::expr::lazy(b) * T(0.5); });
+
+        registerBatch<T, SoA>("operator+=", [](SoA &a, const SoA &b, Scalars &) { a += b; });
+        registerBatch<T, SoA>("operator-=", [](SoA &a, const SoA &b, Scalars &) { a -= b; });
+        registerBatch<T, SoA>("operator*=", [](SoA &a, const SoA &, Scalars &) { a *= opaque(T(1)); });
+        registerBatch<T, SoA>("operator/=", [](SoA &a, const SoA &, Scalars &) { a /= opaque(T(1)); });
+        registerBatch<T, SoA>("normalize", [](SoA &a, const SoA &, Scalars &) { a.normalize(); });
+        registerBatch<T, SoA>("clamp", [](SoA &a, const SoA &b, Scalars &) { a.clamp(b[0], b[1]); });
+        registerBatch<T, SoA>("Lerp", [](SoA &a, const SoA &b, Scalars &) { SoA::Lerp(a, b, 0.25F, a); });
+        registerBatch<T, SoA>("fusedAddScaled", [](SoA &a, const SoA &b, Scalars &)
+                              { a += Fzolv::expr::lazy(b) * T(0.5); });
+    }
+
+    /**
+     * @brief Register a rebuild of the grid and a pass of radius queries around every position
+     */
+    void registerSpatialHash()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("SpatialHash2D<float>/build",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto positions = makeVectors<float>(count, 1);
+                                             Fzolv::SpatialHash2Df grid{4.0f};
+                                             for (auto _ : state)
+                                             {
+                                                 grid.build(positions);
+                                                 benchmark::DoNotOptimize(grid.data().data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("SpatialHash2D<float>/queryRadius",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto positions = makeVectors<float>(count, 1);
+                                             Fzolv::SpatialHash2Df grid{4.0f};
+                                             grid.build(positions);
+                                             std::vector<std::uint32_t> found(256);
+                                             std::size_t total = 0;
+                                             for (auto _ : state)
+                                             {
+                                                 for (const auto &p : positions)
+                                                 {
+                                                     total += grid.queryRadius(p, 2.0f, found);
+                                                 }
+                                                 benchmark::DoNotOptimize(total);
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register the batch overlap test of every box against one query box
+     */
+    void registerAABB()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("AABB2<float>/overlaps",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto centers = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::AABB2f> boxes;
+                                             boxes.reserve(count);
+                                             for (const auto &center : centers)
+                                             {
+                                                 boxes.push_back(Fzolv::AABB2f::FromCenterExtents(center, {2.0f, 1.0f}));
+                                             }
+                                             const Fzolv::AABB2f query{{-40.0f, -30.0f}, {40.0f, 30.0f}};
+                                             std::vector<std::uint64_t> mask(Fzolv::batch::maskWords(count));
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::overlaps(boxes, query, mask);
+                                                 benchmark::DoNotOptimize(mask.data());
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("AABB3<float>/overlaps",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto centers = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::AABB3f> boxes;
+                                             boxes.reserve(count);
+                                             for (const auto &center : centers)
+                                             {
+                                                 const Fzolv::Vector3f center3{center.x, center.y, center.x - center.y};
+                                                 boxes.push_back(Fzolv::AABB3f::FromCenterExtents(center3, {2.0f, 1.0f, 1.5f}));
+                                             }
+                                             const Fzolv::AABB3f query{{-40.0f, -30.0f, -35.0f}, {40.0f, 30.0f, 35.0f}};
+                                             std::vector<std::uint64_t> mask(Fzolv::batch::maskWords(count));
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::overlaps(boxes, query, mask);
+                                                 benchmark::DoNotOptimize(mask.data());
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register the batch quaternion kernels used by skeletal animation
+     */
+    void registerQuaternion()
+    {
+        auto makeRotations = [](std::size_t count, unsigned seed)
+        {
+            std::mt19937 rng{seed};
+            std::uniform_real_distribution<float> dist{-1.0F, 1.0F};
+            std::vector<Fzolv::Quaternionf> rotations(count);
+            for (auto &q : rotations)
+            {
+                q = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+            }
+            return rotations;
+        };
+
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Quaternion<float>/rotate",
+                                         [count, makeRotations](benchmark::State &state)
+                                         {
+                                             const auto rotations = makeRotations(count, 1);
+                                             const auto flat = makeVectors<float>(count, 2);
+                                             std::vector<Fzolv::Vector3f> vectors(count), out(count);
+                                             for (std::size_t i = 0; i < count; ++i)
+                                             {
+                                                 vectors[i] = {flat[i].x, flat[i].y, 1.0F};
+                                             }
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::rotate(rotations, vectors, out);
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Quaternion<float>/nlerp",
+                                         [count, makeRotations](benchmark::State &state)
+                                         {
+                                             const auto a = makeRotations(count, 1);
+                                             const auto b = makeRotations(count, 2);
+                                             std::vector<Fzolv::Quaternionf> out(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::nlerp(a, b, 0.3F, out);
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Quaternion<float>/slerp",
+                                         [count, makeRotations](benchmark::State &state)
+                                         {
+                                             const auto a = makeRotations(count, 1);
+                                             const auto b = makeRotations(count, 2);
+                                             std::vector<Fzolv::Quaternionf> out(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::slerp(a, b, 0.3F, out);
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register a frame that normalizes into a temporary buffer, allocated from the heap or from a FrameArena
+     */
+    void registerArena()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Scratch/std::vector",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             for (auto _ : state)
+                                             {
+                                                 std::vector<Fzolv::Vector2f> scratch(count);
+                                                 Fzolv::batch::normalize(values, scratch);
+                                                 benchmark::DoNotOptimize(scratch.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Scratch/FrameArena",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             Fzolv::FrameArena arena{count * sizeof(Fzolv::Vector2f) * 2};
+                                             for (auto _ : state)
+                                             {
+                                                 {
+                                                     std::pmr::vector<Fzolv::Vector2f> scratch(count, &arena);
+                                                     Fzolv::batch::normalize(values, scratch);
+                                                     benchmark::DoNotOptimize(scratch.data());
+                                                 }
+                                                 arena.reset();
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register encoding and decoding of 16 bit quantized positions
+     */
+    void registerQuantize()
+    {
+        const Fzolv::Quantizer2f quantizer{{{-1.0f, -1.0f}, {1.0f, 1.0f}}, 16};
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Quantize/encode",
+                                         [count, quantizer](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<std::uint8_t> stream(quantizer.encodedSize(count));
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::encode(quantizer, values, stream);
+                                                 benchmark::DoNotOptimize(stream.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Quantize/decode",
+                                         [count, quantizer](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<std::uint8_t> stream(quantizer.encodedSize(count));
+                                             Fzolv::batch::encode(quantizer, values, stream);
+                                             std::vector<Fzolv::Vector2f> decoded(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::decode(quantizer, stream, decoded);
+                                                 benchmark::DoNotOptimize(decoded.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register snapping positions to grid cells, with floor() and a cast per vector or in one batch pass
+     */
+    void registerGridSnap()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Snap/member",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2i> cells(count);
+                                             for (auto _ : state)
+                                             {
+                                                 for (std::size_t i = 0; i < count; ++i)
+                                                 {
+                                                     Fzolv::Vector2f cell = values[i] / 0.25f;
+                                                     cell.floor();
+                                                     cells[i] = {static_cast<int>(cell.x), static_cast<int>(cell.y)};
+                                                 }
+                                                 benchmark::DoNotOptimize(cells.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Snap/snapToGrid",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2i> cells(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::snapToGrid(values, 0.25f, cells);
+                                                 benchmark::DoNotOptimize(cells.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register clamping Vector2f one at a time against batch::clamp
+     */
+    void registerClamp()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Clamp/member",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2f> out(count);
+                                             const Fzolv::Vector2f low{-0.5f, -0.25f}, high{0.5f, 0.25f};
+                                             for (auto _ : state)
+                                             {
+                                                 for (std::size_t i = 0; i < count; ++i)
+                                                 {
+                                                     out[i] = Fzolv::Vector2f::clamp(values[i], low, high);
+                                                 }
+                                                 benchmark::DoNotOptimize(out.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Clamp/batch",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2f> out(count);
+                                             const Fzolv::Vector2f low{-0.5f, -0.25f}, high{0.5f, 0.25f};
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::clamp(values, low, high, out);
+                                                 benchmark::DoNotOptimize(out.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register a line-of-sight pass of 20k rays against 256 walls, one ray at a time against closestHits
+     */
+    void registerLineOfSight()
+    {
+        constexpr std::size_t rayCount = 20000;
+        constexpr std::size_t wallCount = 256;
+        auto makeRays = []
+        {
+            const auto from = makeVectors<float>(rayCount, 1);
+            const auto to = makeVectors<float>(rayCount, 2);
+            std::vector<Fzolv::Ray2f> rays(rayCount);
+            for (std::size_t i = 0; i < rayCount; ++i)
+            {
+                rays[i] = Fzolv::Ray2f::FromPoints(from[i], to[i]);
+            }
+            return rays;
+        };
+        auto makeWalls = []
+        {
+            const auto starts = makeVectors<float>(wallCount, 3);
+            const auto offsets = makeVectors<float>(wallCount, 4);
+            std::vector<Fzolv::Segment2f> walls(wallCount);
+            for (std::size_t i = 0; i < wallCount; ++i)
+            {
+                walls[i] = {starts[i], starts[i] + offsets[i] * 0.1f};
+            }
+            return walls;
+        };
+
+        benchmark::RegisterBenchmark("LineOfSight/member",
+                                     [=](benchmark::State &state)
+                                     {
+                                         const auto rays = makeRays();
+                                         const auto walls = makeWalls();
+                                         std::vector<std::uint32_t> blockers(rayCount);
+                                         for (auto _ : state)
+                                         {
+                                             for (std::size_t r = 0; r < rayCount; ++r)
+                                             {
+                                                 float nearest = std::numeric_limits<float>::infinity();
+                                                 std::uint32_t blocker = Fzolv::batch::noHit;
+                                                 for (std::size_t i = 0; i < wallCount; ++i)
+                                                 {
+                                                     const float t = rays[r].intersect(walls[i]);
+                                                     if (t < nearest)
+                                                     {
+                                                         nearest = t;
+                                                         blocker = static_cast<std::uint32_t>(i);
+                                                     }
+                                                 }
+                                                 blockers[r] = blocker;
+                                             }
+                                             benchmark::DoNotOptimize(blockers.data());
+                                         }
+                                         state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rayCount));
+                                     });
+
+        benchmark::RegisterBenchmark("LineOfSight/closestHits",
+                                     [=](benchmark::State &state)
+                                     {
+                                         const auto rays = makeRays();
+                                         const auto walls = makeWalls();
+                                         std::vector<float> distances(rayCount);
+                                         std::vector<std::uint32_t> blockers(rayCount);
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::closestHits(rays, walls, distances, blockers);
+                                             benchmark::DoNotOptimize(blockers.data());
+                                         }
+                                         state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rayCount));
+                                     });
+    }
+
+    ///< Report the errors of the output a benchmark just produced next to its throughput
+    void setErrors(benchmark::State &state, const accuracy::Errors &errors)
+    {
+        state.counters["maxUlp"] = errors.maxUlp;
+        if (errors.relative)
+        {
+            state.counters["maxRelError"] = errors.maxRelative;
+        }
+        state.counters["maxAbsError"] = errors.maxAbsolute;
+    }
+
+    /**
+     * @brief Register the kernels that trade accuracy for speed, with their largest error against long double
+     *
+     * The inputs mix random vectors at every scale with the adversarial values of the accuracy tests, so the reported
+     * errors are the same the tests check against the documented bounds.
+     */
+    void registerAccuracy()
+    {
+        const auto sample = [](std::vector<Fzolv::Vector2f> vectors)
+        {
+            std::vector<Fzolv::Vector2f> normal;
+            for (const Fzolv::Vector2f &v : vectors)
+            {
+                const float lengthSquared = v.lengthSquared();
+                if (lengthSquared >= FLT_MIN && lengthSquared <= FLT_MAX)
+                {
+                    normal.push_back(v);
+                }
+            }
+            return normal;
+        };
+        const auto normalizeErrors = [](const std::vector<Fzolv::Vector2f> &in, const std::vector<Fzolv::Vector2f> &out)
+        {
+            accuracy::Errors errors;
+            for (std::size_t i = 0; i < in.size(); ++i)
+            {
+                long double x = 0.0L, y = 0.0L;
+                accuracy::referenceNormalize(in[i], x, y);
+                errors.add(out[i].x, x);
+                errors.add(out[i].y, y);
+            }
+            return errors;
+        };
+
+        benchmark::RegisterBenchmark("Accuracy/normalize",
+                                     [=](benchmark::State &state)
+                                     {
+                                         const auto values = sample(accuracy::adversarialVectors(4096, 73));
+                                         std::vector<Fzolv::Vector2f> out(values.size());
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::normalize(values, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                         }
+                                         setThroughput<float>(state, values.size());
+                                         setErrors(state, normalizeErrors(values, out));
+                                     });
+
+        benchmark::RegisterBenchmark("Accuracy/normalizeFast",
+                                     [=](benchmark::State &state)
+                                     {
+                                         const auto values = sample(accuracy::adversarialVectors(4096, 73));
+                                         std::vector<Fzolv::Vector2f> out(values.size());
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::normalizeFast(values, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                         }
+                                         setThroughput<float>(state, values.size());
+                                         setErrors(state, normalizeErrors(values, out));
+                                     });
+
+        benchmark::RegisterBenchmark("Accuracy/toHalf",
+                                     [](benchmark::State &state)
+                                     {
+                                         const auto values = accuracy::randomFloats(8192, 79, -30, 17);
+                                         std::vector<Fzolv::Half> halves(values.size());
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::toHalf(values, halves);
+                                             benchmark::DoNotOptimize(halves.data());
+                                         }
+                                         state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+                                         accuracy::Errors errors;
+                                         for (std::size_t i = 0; i < values.size(); ++i)
+                                         {
+                                             const long double reference = accuracy::referenceHalf(values[i]);
+                                             errors.add(halves[i], reference, accuracy::halfUlpOf(reference));
+                                         }
+                                         setErrors(state, errors);
+                                     });
+
+        benchmark::RegisterBenchmark("Accuracy/encodeUnitVectors",
+                                     [](benchmark::State &state)
+                                     {
+                                         std::mt19937 rng{83};
+                                         std::normal_distribution<float> dist{0.0f, 1.0f};
+                                         std::vector<Fzolv::Vector3f> directions(4096);
+                                         for (auto &direction : directions)
+                                         {
+                                             direction = Fzolv::Vector3f{dist(rng), dist(rng), dist(rng)}.normalized();
+                                         }
+                                         std::vector<std::uint32_t> words(directions.size());
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::encodeUnitVectors(directions, words);
+                                             benchmark::DoNotOptimize(words.data());
+                                         }
+                                         state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * directions.size()));
+                                         std::vector<Fzolv::Vector3f> decoded(directions.size());
+                                         Fzolv::batch::decodeUnitVectors(words, decoded);
+                                         accuracy::Errors errors = accuracy::Errors::absolute();
+                                         const long double unitUlp = accuracy::ulpOf(1.0L);
+                                         for (std::size_t i = 0; i < directions.size(); ++i)
+                                         {
+                                             errors.add(decoded[i].x, directions[i].x, unitUlp);
+                                             errors.add(decoded[i].y, directions[i].y, unitUlp);
+                                             errors.add(decoded[i].z, directions[i].z, unitUlp);
+                                         }
+                                         setErrors(state, errors);
+                                     });
+
+        benchmark::RegisterBenchmark("Accuracy/slerp",
+                                     [](benchmark::State &state)
+                                     {
+                                         std::mt19937 rng{89};
+                                         std::normal_distribution<float> dist{0.0f, 1.0f};
+                                         const auto random = [&]()
+                                         {
+                                             return Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+                                         };
+                                         std::vector<Fzolv::Quaternionf> start(4096), end(4096), out(4096);
+                                         for (std::size_t i = 0; i < start.size(); ++i)
+                                         {
+                                             start[i] = random();
+                                             end[i] = random();
+                                         }
+                                         const float amount = 0.3f;
+                                         for (auto _ : state)
+                                         {
+                                             Fzolv::batch::slerp(start, end, amount, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                         }
+                                         state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * start.size()));
+                                         accuracy::Errors errors = accuracy::Errors::absolute();
+                                         const long double unitUlp = accuracy::ulpOf(1.0L);
+                                         for (std::size_t i = 0; i < start.size(); ++i)
+                                         {
+                                             long double reference[4];
+                                             accuracy::referenceSlerp(start[i], end[i], amount, reference);
+                                             errors.add(out[i].x, reference[0], unitUlp);
+                                             errors.add(out[i].y, reference[1], unitUlp);
+                                             errors.add(out[i].z, reference[2], unitUlp);
+                                             errors.add(out[i].w, reference[3], unitUlp);
+                                         }
+                                         setErrors(state, errors);
+                                     });
+
+        ///< Float codes up to 16 bits, double ones above
+        for (unsigned bits : {8u, 13u, 16u, 24u})
+        {
+            benchmark::RegisterBenchmark(("Accuracy/quantize/" + std::to_string(bits)).c_str(),
+                                         [bits](benchmark::State &state)
+                                         {
+                                             const Fzolv::AABB3f bounds{{-10.0f, -3.3f, 100.0f}, {10.0f, 7.1f, 164.0f}};
+                                             const Fzolv::Quantizer3f quantizer{bounds, bits};
+                                             std::mt19937 rng{97};
+                                             std::uniform_real_distribution<float> t{0.0f, 1.0f};
+                                             const Fzolv::Vector3f low = quantizer.bounds().min;
+                                             const Fzolv::Vector3f high = quantizer.bounds().max;
+                                             std::vector<Fzolv::Vector3f> values(4096), decoded(4096);
+                                             for (auto &value : values)
+                                             {
+                                                 value = {low.x + t(rng) * (high.x - low.x),
+                                                          low.y + t(rng) * (high.y - low.y),
+                                                          low.z + t(rng) * (high.z - low.z)};
+                                             }
+                                             std::vector<std::uint8_t> stream(quantizer.encodedSize(values.size()));
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::encode(quantizer, values, stream);
+                                                 benchmark::DoNotOptimize(stream.data());
+                                             }
+                                             state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+                                             Fzolv::batch::decode(quantizer, stream, decoded);
+                                             ///< Counted in steps, against the bound documented on Quantizer
+                                             accuracy::Errors errors = accuracy::Errors::absolute();
+                                             for (std::size_t i = 0; i < values.size(); ++i)
+                                             {
+                                                 for (std::size_t k = 0; k < 3; ++k)
+                                                 {
+                                                     errors.add((&decoded[i].x)[k], (&values[i].x)[k], quantizer.wideStep(k));
+                                                 }
+                                             }
+                                             setErrors(state, errors);
+                                         });
+        }
+    }
+
+    /**
+     * @brief Register batch conversion of Vector2f to and from half precision
+     */
+    void registerHalf()
+    {
+        for (std::size_t count : benchSizes)
+        {
+            benchmark::RegisterBenchmark("Half/toHalf",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2h> halves(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::toHalf(values, halves);
+                                                 benchmark::DoNotOptimize(halves.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+
+            benchmark::RegisterBenchmark("Half/toFloat",
+                                         [count](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2h> halves(count);
+                                             Fzolv::batch::toHalf(values, halves);
+                                             std::vector<Fzolv::Vector2f> widened(count);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::toFloat(halves, widened);
+                                                 benchmark::DoNotOptimize(widened.data());
+                                             }
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+
+    /**
+     * @brief Register loading a file of four million points and summing them, read into a vector or mapped in place
+     */
+    void registerMapped()
+    {
+        constexpr std::size_t count = std::size_t{1} << 22;
+        static const std::string path = "fzolv_bench_points.bin";
+        const auto points = makeVectors<float>(count, 1);
+        Fzolv::writeVectorArray(path, points);
+
+        benchmark::RegisterBenchmark("Load/fread",
+                                     [](benchmark::State &state)
+                                     {
+                                         for (auto _ : state)
+                                         {
+                                             std::FILE *file = std::fopen(path.c_str(), "rb");
+                                             Fzolv::MappedFileHeader header{};
+                                             std::vector<Fzolv::Vector2f> points;
+                                             if (file != nullptr && std::fread(&header, sizeof(header), 1, file) == 1)
+                                             {
+                                                 points.resize(header.count);
+                                                 points.resize(std::fread(points.data(), sizeof(Fzolv::Vector2f), points.size(), file));
+                                             }
+                                             std::fclose(file);
+                                             Fzolv::Vector2f sum{};
+                                             for (const auto &p : points)
+                                             {
+                                                 sum += p;
+                                             }
+                                             benchmark::DoNotOptimize(sum);
+                                         }
+                                         setThroughput<float>(state, count);
+                                     });
+
+        benchmark::RegisterBenchmark("Load/MappedVectorArray",
+                                     [](benchmark::State &state)
+                                     {
+                                         for (auto _ : state)
+                                         {
+                                             const Fzolv::MappedVector2fArray points{path};
+                                             Fzolv::Vector2f sum{};
+                                             for (const auto &p : points)
+                                             {
+                                                 sum += p;
+                                             }
+                                             benchmark::DoNotOptimize(sum);
+                                         }
+                                         setThroughput<float>(state, count);
+                                     });
+    }
+
+    /**
+     * @brief Register batch normalization of a million vectors on the calling thread and on the default pool
+     */
+    void registerParallel()
+    {
+        static Fzolv::InlineExecutor serial;
+        constexpr std::size_t count = std::size_t{1} << 20;
+        Fzolv::Executor *const executors[] = {&serial, nullptr};
+        for (Fzolv::Executor *executor : executors)
+        {
+            benchmark::RegisterBenchmark(executor != nullptr ? "Parallel/normalize/inline" : "Parallel/normalize/pool",
+                                         [executor](benchmark::State &state)
+                                         {
+                                             const auto values = makeVectors<float>(count, 1);
+                                             std::vector<Fzolv::Vector2f> out(count);
+                                             Fzolv::setExecutor(executor);
+                                             for (auto _ : state)
+                                             {
+                                                 Fzolv::batch::normalize(values, out);
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             Fzolv::setExecutor(nullptr);
+                                             setThroughput<float>(state, count);
+                                         })
+                ->Arg(static_cast<int64_t>(count));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    registerVector2<float>();
+    registerVector2<double>();
+    registerVector2<int>();
+    registerVector2<Fzolv::Fixed16>();
+    registerBatchKernels<float>();
+    registerBatchKernels<double>();
+    registerSpatialHash();
+    registerAABB();
+    registerQuaternion();
+    registerArena();
+    registerQuantize();
+    registerMapped();
+    registerHalf();
+    registerGridSnap();
+    registerClamp();
+    registerLineOfSight();
+    registerAccuracy();
+    registerParallel();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
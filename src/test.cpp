@@ -1,4 +1,38 @@
+#include "accuracy.hpp"
+#include <aabb.hpp>
+#include <algorithm>
+#include <arena.hpp>
+#include <batch.hpp>
+#include <array>
+#include <atomic>
+#include <bvh.hpp>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <expr.hpp>
+#include <fixed.hpp>
+#include <geometry.hpp>
 #include <gtest/gtest.h>
+#include <half.hpp>
+#include <limits>
+#include <mapped.hpp>
+#include <matrix.hpp>
+#include <memory_resource>
+#include <parallel.hpp>
+#include <profile.hpp>
+#include <quantize.hpp>
+#include <quaternion.hpp>
+#include <random>
+#include <ranges.hpp>
+#include <soa.hpp>
+#include <spatial_hash.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <transform.hpp>
+#include <tuple>
+#include <vector>
 #include <vector.hpp>
 
 class Vector2Test : public ::testing::Test
@@ -46,8 +80,8 @@ TEST_F(Vector2Test, MoveConstructor)
     EXPECT_FLOAT_EQ(v.x, 1.0f);
     EXPECT_FLOAT_EQ(v.y, 2.0f);
 
-    EXPECT_FLOAT_EQ(temp.x, 0.0f);
-    EXPECT_FLOAT_EQ(temp.y, 0.0f);
+    EXPECT_FLOAT_EQ(temp.x, 1.0f);
+    EXPECT_FLOAT_EQ(temp.y, 2.0f);
 }
 
 TEST_F(Vector2Test, CopyAssignmentOperator)
@@ -66,8 +100,92 @@ TEST_F(Vector2Test, MoveAssignmentOperator)
     EXPECT_FLOAT_EQ(v3.x, 1.0f);
     EXPECT_FLOAT_EQ(v3.y, 2.0f);
 
-    EXPECT_FLOAT_EQ(temp.x, 0.0f);
-    EXPECT_FLOAT_EQ(temp.y, 0.0f);
+    EXPECT_FLOAT_EQ(temp.x, 1.0f);
+    EXPECT_FLOAT_EQ(temp.y, 2.0f);
+}
+
+TEST_F(Vector2Test, IntegerFactories)
+{
+    EXPECT_EQ(Fzolv::Vector2i::Zero(), Fzolv::Vector2i(0, 0));
+    EXPECT_EQ(Fzolv::Vector2i::One(), Fzolv::Vector2i(1, 1));
+    EXPECT_EQ(Fzolv::Vector2i::UnitX(), Fzolv::Vector2i(1, 0));
+    EXPECT_EQ(Fzolv::Vector2i::UnitY(), Fzolv::Vector2i(0, 1));
+}
+
+namespace
+{
+    ///< A compile-time table of the eight compass directions, normalized
+    constexpr auto makeCompass() -> std::array<Fzolv::Vector2f, 8>
+    {
+        std::array<Fzolv::Vector2f, 8> table{};
+        const int offsets[8][2] = {{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+        for (std::size_t i = 0; i < table.size(); ++i)
+        {
+            Fzolv::Vector2f direction{};
+            direction += Fzolv::Vector2f(static_cast<float>(offsets[i][0]), static_cast<float>(offsets[i][1]));
+            table[i] = direction.normalized();
+        }
+        return table;
+    }
+
+    constexpr auto compass = makeCompass();
+
+    constexpr double sqrtInputs[] = {2.0, 0.5, 1e-300, 3e300, 12345.678, 4.9e-324, 0.1, 7.0};
+    constexpr double roundInputs[] = {-2.5, -1.5, -0.5, -0.3, 0.49999999999999994, 0.5, 1.5, 2.5, 4503599627370497.0};
+
+    template <typename F, std::size_t N>
+    constexpr auto applyAll(F f, const double (&values)[N]) -> std::array<double, N>
+    {
+        std::array<double, N> result{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            result[i] = f(values[i]);
+        }
+        return result;
+    }
+}
+
+TEST_F(Vector2Test, ConstexprTables)
+{
+    static_assert(compass[0] == Fzolv::Vector2f::UnitX(), "compass table is built at compile time");
+    static_assert(Fzolv::Vector2i(3, 4).length() == 5.0, "integer lengths are exact");
+    static_assert(Fzolv::Vector2f(2.0f, 0.0f).normalizedFast() == Fzolv::Vector2f::UnitX(), "");
+    static_assert(Fzolv::Vector2f(1.5f, -1.5f).floor() == Fzolv::Vector2f(1.0f, -2.0f), "");
+    static_assert(Fzolv::Vector3f(0.0f, 3.0f, 4.0f).normalized() == Fzolv::Vector3f(0.0f, 0.6f, 0.8f), "");
+
+    ///< Constant evaluation must agree with the runtime path
+    volatile float one = 1.0f;
+    Fzolv::Vector2f diagonal{one, -one};
+    EXPECT_EQ(compass[7], diagonal.normalized());
+
+    constexpr auto roots = applyAll([](double v) { return Fzolv::math::sqrt(v); }, sqrtInputs);
+    constexpr auto floors = applyAll([](double v) { return Fzolv::math::floor(v); }, roundInputs);
+    constexpr auto ceils = applyAll([](double v) { return Fzolv::math::ceil(v); }, roundInputs);
+    constexpr auto rounds = applyAll([](double v) { return Fzolv::math::round(v); }, roundInputs);
+    for (std::size_t i = 0; i < roots.size(); ++i)
+    {
+        EXPECT_EQ(roots[i], std::sqrt(sqrtInputs[i]));
+    }
+    for (std::size_t i = 0; i < floors.size(); ++i)
+    {
+        EXPECT_EQ(floors[i], std::floor(roundInputs[i]));
+        EXPECT_EQ(ceils[i], std::ceil(roundInputs[i]));
+        EXPECT_EQ(rounds[i], std::round(roundInputs[i]));
+        EXPECT_EQ(std::signbit(ceils[i]), std::signbit(std::ceil(roundInputs[i])));
+    }
+}
+
+TEST_F(Vector2Test, TriviallyCopyable)
+{
+    EXPECT_TRUE(std::is_trivially_copyable<Fzolv::Vector2f>::value);
+    EXPECT_TRUE(std::is_standard_layout<Fzolv::Vector2f>::value);
+
+    Fzolv::Vector2f src[2] = {v1, v2};
+    Fzolv::Vector2f dst[2];
+    std::memcpy(dst, src, sizeof(src));
+
+    EXPECT_EQ(dst[0], v1);
+    EXPECT_EQ(dst[1], v2);
 }
 
 TEST_F(Vector2Test, ConstructorFromXY)
@@ -121,6 +239,42 @@ TEST_F(Vector2Test, LengthMethod)
     EXPECT_FLOAT_EQ(len, std::sqrt(v1.x * v1.x + v1.y * v1.y));
 }
 
+TEST_F(Vector2Test, LengthPrecision)
+{
+    static_assert(std::is_same<decltype(v1.length()), float>::value, "float vectors measure in float");
+    static_assert(std::is_same<decltype(v1.distanceTo(v2)), float>::value, "float vectors measure in float");
+    static_assert(std::is_same<decltype(v4.length()), double>::value, "integral vectors measure in double");
+    static_assert(std::is_same<decltype(v1.lengthPrecise()), double>::value, "precise variants use double");
+
+    EXPECT_DOUBLE_EQ(v1.lengthPrecise(), std::sqrt(5.0));
+    EXPECT_DOUBLE_EQ(v1.distanceToPrecise(v2), std::sqrt(8.0));
+    EXPECT_DOUBLE_EQ(v4.length(), std::sqrt(113.0));
+}
+
+TEST_F(Vector2Test, NormalizeFastMethod)
+{
+    Fzolv::Vector2f &ref = v2.normalizeFast();
+
+    EXPECT_EQ(&ref, &v2);
+    EXPECT_NEAR(v2.x, 0.6f, 0.6f * Fzolv::normalizeFastMaxRelativeError);
+    EXPECT_NEAR(v2.y, 0.8f, 0.8f * Fzolv::normalizeFastMaxRelativeError);
+
+    auto zero = Fzolv::Vector2f::Zero().normalizedFast();
+    EXPECT_EQ(zero, Fzolv::Vector2f::Zero());
+
+    Fzolv::Vector2f tiny{1e-20f, 0.0f};
+    EXPECT_EQ(tiny.normalizedFast(), tiny.normalized());
+}
+
+TEST_F(Vector2Test, NormalizePreciseMethod)
+{
+    Fzolv::Vector2f &ref = v2.normalizePrecise();
+
+    EXPECT_EQ(&ref, &v2);
+    EXPECT_FLOAT_EQ(v2.x, 0.6f);
+    EXPECT_FLOAT_EQ(v2.y, 0.8f);
+}
+
 TEST_F(Vector2Test, NormalizeMethod)
 {
     Fzolv::Vector2f &ref = v1.normalize();
@@ -189,6 +343,36 @@ TEST_F(Vector2Test, LerpMethod)
     EXPECT_FLOAT_EQ(v.y, (v1.y + v2.y) / 2.0f);
 }
 
+TEST_F(Vector2Test, LerpPrecision)
+{
+    ///< Doubles interpolate in double, 1e-10 steps are lost in float
+    Fzolv::Vector2<double> a{1.0, 0.0};
+    Fzolv::Vector2<double> b{1.0 + 1e-9, 1.0};
+    EXPECT_EQ(Fzolv::Vector2<double>::Lerp(a, b, 0.1).x, 1.0 + (1e-9 * 0.1));
+
+    ///< Integers round to the nearest value instead of truncating
+    EXPECT_EQ(Fzolv::Vector2i::Lerp({0, 10}, {3, -10}, 0.5), Fzolv::Vector2i(2, 0));
+    EXPECT_EQ(Fzolv::Vector2i::Lerp({0, 0}, {10, -10}, 0.26), Fzolv::Vector2i(3, -3));
+    EXPECT_EQ(Fzolv::Vector2i::Lerp({2000000000, 0}, {-2000000000, 0}, 0.25), Fzolv::Vector2i(1000000000, 0));
+}
+
+TEST_F(Vector2Test, SmoothStepAndHermite)
+{
+    EXPECT_EQ(Fzolv::Vector2f::SmoothStep(v1, v2, -1.0f), v1);
+    EXPECT_EQ(Fzolv::Vector2f::SmoothStep(v1, v2, 2.0f), v2);
+    EXPECT_EQ(Fzolv::Vector2f::SmoothStep(v1, v2, 0.5f), Fzolv::Vector2f::Lerp(v1, v2, 0.5f));
+
+    Fzolv::Vector2f m0{1.0f, 0.0f};
+    Fzolv::Vector2f m1{0.0f, 1.0f};
+    EXPECT_EQ(Fzolv::Vector2f::Hermite(v1, m0, v2, m1, 0.0f), v1);
+    EXPECT_EQ(Fzolv::Vector2f::Hermite(v1, m0, v2, m1, 1.0f), v2);
+
+    ///< Zero tangents make the spline follow the smoothstep curve
+    auto h = Fzolv::Vector2<double>::Hermite({0.0, 0.0}, {}, {1.0, 2.0}, {}, 0.25);
+    EXPECT_DOUBLE_EQ(h.x, 0.15625);
+    EXPECT_DOUBLE_EQ(h.y, 0.3125);
+}
+
 TEST_F(Vector2Test, ArithmeticOperators)
 {
     Fzolv::Vector2f v1plusv2 = v1 + v2;
@@ -275,3 +459,2902 @@ TEST_F(Vector2ClampTest, Clamp) {
     EXPECT_EQ(result.x, v4.x);
     EXPECT_EQ(result.y, v4.y);
 }
+
+
+class Vector3Test : public ::testing::Test
+{
+protected:
+    Fzolv::Vector3f v1{1.0f, 2.0f, 2.0f};
+    Fzolv::Vector3f v2{3.0f, -4.0f, 5.0f};
+    Fzolv::Vector3i v3{7, 8, 9};
+};
+
+TEST_F(Vector3Test, Constructors)
+{
+    Fzolv::Vector3f v;
+    Fzolv::Vector3f fromXY{Fzolv::Vector2f{1.0f, 2.0f}, 3.0f};
+
+    EXPECT_EQ(v, Fzolv::Vector3f::Zero());
+    EXPECT_EQ(fromXY, Fzolv::Vector3f(1.0f, 2.0f, 3.0f));
+    EXPECT_EQ(Fzolv::Vector3i::UnitZ(), Fzolv::Vector3i(0, 0, 1));
+    EXPECT_EQ(v3.x, 7);
+    EXPECT_EQ(v3.z, 9);
+}
+
+TEST_F(Vector3Test, LengthAndNormalize)
+{
+    EXPECT_FLOAT_EQ(v1.lengthSquared(), 9.0f);
+    EXPECT_FLOAT_EQ(v1.length(), 3.0f);
+
+    auto &ref = v1.normalize();
+
+    EXPECT_EQ(&ref, &v1);
+    EXPECT_FLOAT_EQ(v1.length(), 1.0f);
+    EXPECT_FLOAT_EQ(v1.x, 1.0f / 3.0f);
+
+    auto fast = v2.normalizedFast();
+    auto exact = v2.normalized();
+    EXPECT_NEAR(fast.z, exact.z, exact.z * Fzolv::normalizeFastMaxRelativeError);
+}
+
+TEST_F(Vector3Test, DotAndCross)
+{
+    EXPECT_FLOAT_EQ(v1.dot(v2), 3.0f - 8.0f + 10.0f);
+
+    auto cross = v1.cross(v2);
+
+    EXPECT_EQ(cross, Fzolv::Vector3f(2.0f * 5.0f - 2.0f * -4.0f, 2.0f * 3.0f - 1.0f * 5.0f, 1.0f * -4.0f - 2.0f * 3.0f));
+    EXPECT_FLOAT_EQ(cross.dot(v1), 0.0f);
+    EXPECT_EQ(Fzolv::Vector3f::UnitX().cross(Fzolv::Vector3f::UnitY()), Fzolv::Vector3f::UnitZ());
+}
+
+TEST_F(Vector3Test, DistanceClampAndLerp)
+{
+    EXPECT_FLOAT_EQ(v1.distanceToSquared(v2), (v1 - v2).lengthSquared());
+    EXPECT_FLOAT_EQ(v1.distanceTo(v2), (v1 - v2).length());
+
+    auto clamped = Fzolv::Vector3f::clamp(v2, Fzolv::Vector3f::Zero(), Fzolv::Vector3f::One());
+    EXPECT_EQ(clamped, Fzolv::Vector3f(1.0f, 0.0f, 1.0f));
+
+    auto mid = Fzolv::Vector3f::Lerp(v1, v2, 0.5f);
+    EXPECT_EQ(mid, Fzolv::Vector3f(2.0f, -1.0f, 3.5f));
+}
+
+TEST_F(Vector3Test, ArithmeticOperators)
+{
+    EXPECT_EQ(v1 + v2, Fzolv::Vector3f(4.0f, -2.0f, 7.0f));
+    EXPECT_EQ(v1 - v2, Fzolv::Vector3f(-2.0f, 6.0f, -3.0f));
+    EXPECT_EQ(v1 * 2.0f, Fzolv::Vector3f(2.0f, 4.0f, 4.0f));
+    EXPECT_EQ(v1 / 2.0f, Fzolv::Vector3f(0.5f, 1.0f, 1.0f));
+
+    v1 += v2;
+    v1 -= v2;
+    v1 *= 4.0f;
+    v1 /= 2.0f;
+    EXPECT_EQ(v1, Fzolv::Vector3f(2.0f, 4.0f, 4.0f));
+
+    Fzolv::Vector3f rounded{1.5f, -1.5f, 2.2f};
+    EXPECT_EQ(Fzolv::Vector3f(rounded).floor(), Fzolv::Vector3f(1.0f, -2.0f, 2.0f));
+    EXPECT_EQ(Fzolv::Vector3f(rounded).ceil(), Fzolv::Vector3f(2.0f, -1.0f, 3.0f));
+    EXPECT_EQ(Fzolv::Vector3f(rounded).round(), Fzolv::Vector3f(2.0f, -2.0f, 2.0f));
+}
+
+TEST_F(Vector3Test, AlignedVariantMatchesVector3)
+{
+    static_assert(sizeof(Fzolv::Vector3Af) == 16, "Vector3Af is padded to four floats");
+    static_assert(alignof(Fzolv::Vector3Af) == 16, "Vector3Af is register aligned");
+
+    Fzolv::Vector3Af a{v1};
+    Fzolv::Vector3Af b{v2};
+
+    EXPECT_EQ(a.dot(b), v1.dot(v2));
+    EXPECT_EQ(Fzolv::Vector3f(a.cross(b)), v1.cross(v2));
+    EXPECT_EQ(Fzolv::Vector3f(a + b), v1 + v2);
+    EXPECT_EQ(Fzolv::Vector3f(a - b), v1 - v2);
+    EXPECT_EQ(Fzolv::Vector3f(a * 3.0f), v1 * 3.0f);
+    EXPECT_EQ(Fzolv::Vector3f(a / 3.0f), v1 / 3.0f);
+    EXPECT_EQ(Fzolv::Vector3f(a.normalized()), v1.normalized());
+    EXPECT_EQ(Fzolv::Vector3f(Fzolv::Vector3Af::Lerp(a, b, 0.3f)), Fzolv::Vector3f::Lerp(v1, v2, 0.3f));
+    EXPECT_FLOAT_EQ(a.distanceTo(b), v1.distanceTo(v2));
+
+    auto divided = a / 0.0f;
+    EXPECT_EQ(divided.w, 0.0f);
+
+    ///< Infinite and NaN factors keep the padding zero, so padded four-lane dot products stay finite
+    const float inf = std::numeric_limits<float>::infinity();
+    for (float factor : {inf, -inf, std::nanf("")})
+    {
+        Fzolv::Vector3Af scaled = a * factor;
+        EXPECT_EQ(scaled.w, 0.0f);
+        scaled = a;
+        scaled *= factor;
+        EXPECT_EQ(scaled.w, 0.0f);
+        EXPECT_EQ(Fzolv::Vector3Af::Lerp(a, b, factor).w, 0.0f);
+    }
+    EXPECT_EQ(Fzolv::Vector3Af::Lerp(a, a, inf).w, 0.0f);
+}
+
+class Vector2SoATest : public ::testing::Test
+{
+protected:
+    Fzolv::Vector2f points[3] = {{3.0f, 4.0f}, {-1.0f, 0.5f}, {0.0f, 0.0f}};
+    Fzolv::Vector2fSoA soa{points, 3};
+};
+
+TEST_F(Vector2SoATest, LanesAreAligned)
+{
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.xData()) % Fzolv::cacheLineSize, 0U);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.yData()) % Fzolv::cacheLineSize, 0U);
+}
+
+TEST_F(Vector2SoATest, ProxyAccess)
+{
+    ASSERT_EQ(soa.size(), 3U);
+    EXPECT_EQ(soa.get(1), points[1]);
+
+    soa[1] = Fzolv::Vector2f{7.0f, 8.0f};
+    soa[0] += Fzolv::Vector2f{1.0f, 1.0f};
+    Fzolv::Vector2f read = soa[1];
+
+    EXPECT_EQ(read, Fzolv::Vector2f(7.0f, 8.0f));
+    EXPECT_FLOAT_EQ(soa.xData()[0], 4.0f);
+    EXPECT_FLOAT_EQ(soa.yData()[0], 5.0f);
+}
+
+TEST_F(Vector2SoATest, BulkArithmetic)
+{
+    Fzolv::Vector2fSoA other{points, 3};
+    soa += other;
+    soa *= 0.5f;
+
+    for (std::size_t i = 0; i < soa.size(); ++i)
+    {
+        EXPECT_EQ(soa.get(i), points[i]);
+    }
+}
+
+TEST_F(Vector2SoATest, NormalizeMatchesScalar)
+{
+    soa.normalize();
+
+    for (std::size_t i = 0; i < soa.size(); ++i)
+    {
+        auto expected = points[i];
+        expected.normalize();
+        EXPECT_EQ(soa.get(i), expected);
+    }
+}
+
+TEST_F(Vector2SoATest, ClampAndLerp)
+{
+    Fzolv::Vector2f low{-0.5f, -0.5f};
+    Fzolv::Vector2f high{1.0f, 1.0f};
+    Fzolv::Vector2fSoA start{points, 3};
+    Fzolv::Vector2fSoA result;
+
+    soa.clamp(low, high);
+    Fzolv::Vector2fSoA::Lerp(start, soa, 0.25f, result);
+
+    for (std::size_t i = 0; i < soa.size(); ++i)
+    {
+        EXPECT_EQ(soa.get(i), Fzolv::Vector2f::clamp(points[i], low, high));
+        EXPECT_EQ(result.get(i), Fzolv::Vector2f::Lerp(points[i], soa.get(i), 0.25f));
+    }
+}
+
+class BatchTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::mt19937 rng{1234};
+        std::uniform_real_distribution<float> dist{-100.0f, 100.0f};
+
+        ///< An odd size exercises both the SIMD body and the scalar tail
+        for (std::size_t i = 0; i < 37; ++i)
+        {
+            lhs.emplace_back(dist(rng), dist(rng));
+            rhs.emplace_back(dist(rng), dist(rng));
+        }
+        out.resize(lhs.size());
+    }
+
+    std::vector<Fzolv::Vector2f> lhs;
+    std::vector<Fzolv::Vector2f> rhs;
+    std::vector<float> out;
+};
+
+TEST_F(BatchTest, DotMatchesScalar)
+{
+    Fzolv::batch::dot(lhs, rhs, out);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(out[i], lhs[i].dot(rhs[i]));
+    }
+}
+
+TEST_F(BatchTest, CrossMatchesScalar)
+{
+    Fzolv::batch::cross(lhs, rhs, out);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(out[i], lhs[i].cross(rhs[i]));
+    }
+}
+
+TEST_F(BatchTest, LengthSquaredMatchesScalar)
+{
+    Fzolv::batch::lengthSquared(lhs, out);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(out[i], lhs[i].lengthSquared());
+    }
+}
+
+TEST_F(BatchTest, DistanceToSquaredMatchesScalar)
+{
+    Fzolv::batch::distanceToSquared(lhs, rhs, out);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(out[i], lhs[i].distanceToSquared(rhs[i]));
+    }
+}
+
+TEST_F(BatchTest, GenericTypesUseScalarPath)
+{
+    std::vector<Fzolv::Vector2i> a{{1, 2}, {3, 4}, {-5, 6}};
+    std::vector<Fzolv::Vector2i> b{{7, 8}, {9, -10}, {11, 12}};
+    std::vector<int> result(a.size());
+
+    Fzolv::batch::dot(Fzolv::span<const Fzolv::Vector2i>{a}, Fzolv::span<const Fzolv::Vector2i>{b}, Fzolv::span<int>{result});
+
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        EXPECT_EQ(result[i], a[i].dot(b[i]));
+    }
+}
+
+TEST_F(BatchTest, NormalizeMatchesScalar)
+{
+    std::vector<Fzolv::Vector2f> result(lhs.size());
+    lhs[5] = Fzolv::Vector2f::Zero();
+    Fzolv::batch::normalize(lhs, result);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], lhs[i].normalized());
+    }
+}
+
+TEST_F(BatchTest, NormalizeFastMatchesScalar)
+{
+    std::vector<Fzolv::Vector2f> result(lhs.size());
+    lhs[2] = Fzolv::Vector2f::Zero();
+    lhs[9] = Fzolv::Vector2f{1e-20f, 1e-20f};
+    Fzolv::batch::normalizeFast(lhs, result);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        auto exact = lhs[i].normalized();
+        EXPECT_EQ(result[i], lhs[i].normalizedFast());
+        EXPECT_NEAR(result[i].x, exact.x, std::abs(exact.x) * Fzolv::normalizeFastMaxRelativeError * 2.0f);
+        EXPECT_NEAR(result[i].y, exact.y, std::abs(exact.y) * Fzolv::normalizeFastMaxRelativeError * 2.0f);
+    }
+
+    Fzolv::batch::normalizeFast(Fzolv::span<Fzolv::Vector2f>{lhs});
+    EXPECT_EQ(lhs, result);
+}
+
+TEST_F(BatchTest, InterpolationMatchesScalar)
+{
+    std::vector<float> amounts(lhs.size());
+    for (std::size_t i = 0; i < amounts.size(); ++i)
+    {
+        ///< Includes factors outside [0, 1] to exercise the smoothstep clamp
+        amounts[i] = static_cast<float>(i) / 16.0f - 0.5f;
+    }
+    std::vector<Fzolv::Vector2f> result(lhs.size());
+
+    Fzolv::batch::lerp(lhs, rhs, amounts, result);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], Fzolv::Vector2f::Lerp(lhs[i], rhs[i], amounts[i]));
+    }
+
+    Fzolv::batch::lerp(lhs, rhs, 0.3f, result);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], Fzolv::Vector2f::Lerp(lhs[i], rhs[i], 0.3f));
+    }
+
+    Fzolv::batch::smoothstep(lhs, rhs, amounts, result);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], Fzolv::Vector2f::SmoothStep(lhs[i], rhs[i], amounts[i]));
+    }
+
+    Fzolv::batch::hermite(lhs, rhs, rhs, lhs, amounts, result);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], Fzolv::Vector2f::Hermite(lhs[i], rhs[i], rhs[i], lhs[i], amounts[i]));
+    }
+
+    std::vector<Fzolv::Vector2i> ints{{0, 0}, {5, -5}, {10, 7}};
+    std::vector<Fzolv::Vector2i> intsOut(ints.size());
+    Fzolv::batch::lerp<int>(ints, ints, 0.5, intsOut);
+    EXPECT_EQ(intsOut, ints);
+}
+
+TEST(Vector3SoATest, BulkOperationsMatchScalar)
+{
+    Fzolv::Vector3f points[3] = {{3.0f, 4.0f, 12.0f}, {-1.0f, 0.5f, 2.0f}, {0.0f, 0.0f, 0.0f}};
+    Fzolv::Vector3fSoA soa{points, 3};
+
+    soa[2] = Fzolv::Vector3f{1.0f, 1.0f, 1.0f};
+    points[2] = Fzolv::Vector3f{1.0f, 1.0f, 1.0f};
+    soa += Fzolv::Vector3f{1.0f, 2.0f, 3.0f};
+    soa *= 2.0f;
+    soa.normalize();
+
+    for (std::size_t i = 0; i < soa.size(); ++i)
+    {
+        auto expected = ((points[i] + Fzolv::Vector3f{1.0f, 2.0f, 3.0f}) * 2.0f).normalized();
+        EXPECT_EQ(soa.get(i), expected);
+    }
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.zData()) % Fzolv::cacheLineSize, 0U);
+}
+
+TEST(Vector3SoATest, NormalizeMatchesScalarOnEveryLevel)
+{
+    std::mt19937 rng{31};
+    std::uniform_real_distribution<float> component{-50.0f, 50.0f};
+    for (std::size_t count : {0u, 1u, 5u, 37u, 1000u})
+    {
+        std::vector<Fzolv::Vector2f> points2(count);
+        std::vector<Fzolv::Vector3f> points3(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ///< Every seventh vector is zero, which normalize leaves unchanged
+            points2[i] = i % 7 == 0 ? Fzolv::Vector2f{} : Fzolv::Vector2f{component(rng), component(rng)};
+            points3[i] = i % 7 == 0 ? Fzolv::Vector3f{} : Fzolv::Vector3f{component(rng), component(rng), component(rng)};
+        }
+
+        for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                           Fzolv::simd::Level::NEON})
+        {
+            if (!Fzolv::simd::setLevel(level))
+            {
+                continue;
+            }
+            SCOPED_TRACE(Fzolv::simd::levelName(level));
+            Fzolv::Vector2fSoA soa2{points2.data(), count};
+            Fzolv::Vector3fSoA soa3{points3.data(), count};
+            soa2.normalize();
+            soa3.normalize();
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                EXPECT_EQ(soa2.get(i), points2[i].normalized()) << i;
+                EXPECT_EQ(soa3.get(i), points3[i].normalized()) << i;
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+class Matrix4Test : public ::testing::Test
+{
+protected:
+    Fzolv::Matrix4f m = Fzolv::Matrix4f::FromRows({2.0f, 0.5f, -1.0f, 3.0f},
+                                                  {0.0f, 1.5f, 2.0f, -2.0f},
+                                                  {1.0f, -3.0f, 4.0f, 0.5f},
+                                                  {0.0f, 0.0f, 0.0f, 1.0f});
+    Fzolv::Matrix4f n = Fzolv::Matrix4f::Translation({1.0f, 2.0f, 3.0f}) * Fzolv::Matrix4f::Scale({2.0f, 3.0f, 4.0f});
+};
+
+TEST(Vector4Test, Operations)
+{
+    Fzolv::Vector4f a{1.0f, 2.0f, 3.0f, 4.0f};
+    Fzolv::Vector4f b{Fzolv::Vector3f{-1.0f, 0.5f, 2.0f}, 1.0f};
+
+    EXPECT_EQ(a.dot(b), ((1.0f * -1.0f + 2.0f * 0.5f) + 3.0f * 2.0f) + 4.0f * 1.0f);
+    EXPECT_EQ(a + b, Fzolv::Vector4f(0.0f, 2.5f, 5.0f, 5.0f));
+    EXPECT_EQ(a - b, Fzolv::Vector4f(2.0f, 1.5f, 1.0f, 3.0f));
+    EXPECT_EQ(a * 2.0f, Fzolv::Vector4f(2.0f, 4.0f, 6.0f, 8.0f));
+    EXPECT_EQ(a / 2.0f, Fzolv::Vector4f(0.5f, 1.0f, 1.5f, 2.0f));
+    EXPECT_EQ(b.xyz(), Fzolv::Vector3f(-1.0f, 0.5f, 2.0f));
+    EXPECT_FLOAT_EQ(a.normalized().length(), 1.0f);
+    EXPECT_EQ(Fzolv::Vector4f::Lerp(a, b, 0.5f), Fzolv::Vector4f(0.0f, 1.25f, 2.5f, 2.5f));
+    EXPECT_EQ(Fzolv::Vector4i(1, 2, 3, 4).dot(Fzolv::Vector4i(1, 1, 1, 1)), 10);
+}
+
+TEST_F(Matrix4Test, Accessors)
+{
+    EXPECT_EQ(m(0, 1), 0.5f);
+    EXPECT_EQ(m(1, 3), -2.0f);
+    EXPECT_EQ(m.columns[3], Fzolv::Vector4f(3.0f, -2.0f, 0.5f, 1.0f));
+    EXPECT_EQ(m.transposed().transposed(), m);
+    EXPECT_EQ(m.transposed()(1, 0), m(0, 1));
+}
+
+TEST_F(Matrix4Test, MultiplyMatchesScalarOrder)
+{
+    Fzolv::Vector4f v{1.5f, -2.0f, 0.25f, 1.0f};
+    auto result = m * v;
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        float expected = m(i, 0) * v.x + m(i, 1) * v.y + m(i, 2) * v.z + m(i, 3) * v.w;
+        EXPECT_EQ((&result.x)[i], expected);
+    }
+
+    auto product = m * n;
+    for (std::size_t c = 0; c < 4; ++c)
+    {
+        EXPECT_EQ(product.columns[c], m * n.columns[c]);
+    }
+}
+
+TEST_F(Matrix4Test, TransformPointsAndDirections)
+{
+    Fzolv::Vector3f p{1.0f, 1.0f, 1.0f};
+
+    EXPECT_EQ(n.transformPoint(p), Fzolv::Vector3f(3.0f, 5.0f, 7.0f));
+    EXPECT_EQ(n.transformDirection(p), Fzolv::Vector3f(2.0f, 3.0f, 4.0f));
+    EXPECT_EQ(Fzolv::Matrix4f::Identity() * m, m);
+}
+
+TEST_F(Matrix4Test, InverseMatchesDoublePrecision)
+{
+    Fzolv::Matrix4d md;
+    for (std::size_t r = 0; r < 4; ++r)
+    {
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            md(r, c) = m(r, c);
+        }
+    }
+
+    auto inv = m.inverse();
+    auto invd = md.inverse();
+    auto identity = m * inv;
+
+    for (std::size_t r = 0; r < 4; ++r)
+    {
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            EXPECT_NEAR(inv(r, c), invd(r, c), 1e-5);
+            EXPECT_NEAR(identity(r, c), r == c ? 1.0f : 0.0f, 1e-5);
+        }
+    }
+    EXPECT_NEAR(m.determinant(), md.determinant(), 1e-4);
+}
+
+class TransformTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::mt19937 rng{4321};
+        std::uniform_real_distribution<float> dist{-50.0f, 50.0f};
+
+        for (std::size_t i = 0; i < 37; ++i)
+        {
+            points.emplace_back(dist(rng), dist(rng), dist(rng));
+            flat.emplace_back(dist(rng), dist(rng));
+        }
+    }
+
+    Fzolv::Matrix4f m = Fzolv::Matrix4f::FromRows({2.0f, 0.5f, -1.0f, 3.0f},
+                                                  {0.25f, 1.5f, 2.0f, -2.0f},
+                                                  {1.0f, -3.0f, 4.0f, 0.5f},
+                                                  {0.0f, 0.0f, 0.0f, 1.0f});
+    std::vector<Fzolv::Vector3f> points;
+    std::vector<Fzolv::Vector2f> flat;
+};
+
+TEST_F(TransformTest, SpansMatchMatrixMethods)
+{
+    std::vector<Fzolv::Vector3f> out(points.size());
+
+    Fzolv::transformPoints(m, points, out);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(out[i], m.transformPoint(points[i]));
+    }
+
+    Fzolv::transformDirections(m, points, out);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(out[i], m.transformDirection(points[i]));
+    }
+
+    std::vector<Fzolv::Vector2f> flatOut(flat.size());
+    Fzolv::transformPoints(m, flat, flatOut);
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        auto expected = m.transformPoint(Fzolv::Vector3f{flat[i], 0.0f});
+        EXPECT_EQ(flatOut[i], Fzolv::Vector2f(expected.x, expected.y));
+    }
+
+    auto original = flat;
+    Fzolv::transformDirections(m, flat, flat);
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        auto expected = m.transformDirection(Fzolv::Vector3f{original[i], 0.0f});
+        EXPECT_EQ(flat[i], Fzolv::Vector2f(expected.x, expected.y));
+    }
+}
+
+TEST_F(TransformTest, SoAMatchesSpans)
+{
+    Fzolv::Vector3fSoA soa{points.data(), points.size()};
+    Fzolv::Vector3fSoA soaOut;
+    std::vector<Fzolv::Vector3f> out(points.size());
+
+    Fzolv::transformPoints(m, soa, soaOut);
+    Fzolv::transformPoints(m, points, out);
+    ASSERT_EQ(soaOut.size(), points.size());
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(soaOut.get(i), out[i]);
+    }
+
+    Fzolv::transformDirections(m, soa, soa);
+    Fzolv::transformDirections(m, points, out);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_EQ(soa.get(i), out[i]);
+    }
+
+    Fzolv::Vector2fSoA flatSoa{flat.data(), flat.size()};
+    Fzolv::Vector2fSoA flatSoaOut;
+    std::vector<Fzolv::Vector2f> flatOut(flat.size());
+
+    Fzolv::transformPoints(m, flatSoa, flatSoaOut);
+    Fzolv::transformPoints(m, flat, flatOut);
+    for (std::size_t i = 0; i < flat.size(); ++i)
+    {
+        EXPECT_EQ(flatSoaOut.get(i), flatOut[i]);
+    }
+}
+
+TEST_F(TransformTest, EveryLevelMatchesMatrixMethods)
+{
+    using Fzolv::simd::Level;
+
+    for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2, Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+
+        std::vector<Fzolv::Vector3f> out(points.size());
+        Fzolv::transformPoints(m, points, out);
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            EXPECT_EQ(out[i], m.transformPoint(points[i]));
+        }
+
+        Fzolv::Vector3fSoA soa{points.data(), points.size()};
+        Fzolv::Vector3fSoA soaOut;
+        Fzolv::transformDirections(m, soa, soaOut);
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            EXPECT_EQ(soaOut.get(i), m.transformDirection(points[i]));
+        }
+
+        std::vector<Fzolv::Vector2f> flatOut(flat.size());
+        Fzolv::transformPoints(m, flat, flatOut);
+        Fzolv::Vector2fSoA flatSoa{flat.data(), flat.size()};
+        Fzolv::Vector2fSoA flatSoaOut;
+        Fzolv::transformPoints(m, flatSoa, flatSoaOut);
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            auto expected = m.transformPoint(Fzolv::Vector3f{flat[i], 0.0f});
+            EXPECT_EQ(flatOut[i], Fzolv::Vector2f(expected.x, expected.y));
+            EXPECT_EQ(flatSoaOut.get(i), Fzolv::Vector2f(expected.x, expected.y));
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST_F(TransformTest, LargeInputsRunInParallel)
+{
+    const std::size_t threshold = Fzolv::parallelThreshold();
+    Fzolv::setParallelThreshold(0);
+
+    std::vector<Fzolv::Vector3f> input(100003);
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = points[i % points.size()];
+    }
+    std::vector<Fzolv::Vector3f> out(input.size());
+    Fzolv::transformPoints(m, input, out);
+
+    Fzolv::setParallelThreshold(threshold);
+
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        ASSERT_EQ(out[i], m.transformPoint(input[i]));
+    }
+}
+
+TEST_F(TransformTest, GenericTypesUseScalarPath)
+{
+    auto md = Fzolv::Matrix4d::Translation({1.0, 2.0, 3.0});
+    std::vector<Fzolv::Vector3<double>> in{{1.0, 1.0, 1.0}, {-2.0, 0.5, 4.0}};
+    std::vector<Fzolv::Vector3<double>> out(in.size());
+
+    Fzolv::transformPoints<double>(md, in, out);
+    EXPECT_EQ(out[0], Fzolv::Vector3<double>(2.0, 3.0, 4.0));
+    EXPECT_EQ(out[1], Fzolv::Vector3<double>(-1.0, 2.5, 7.0));
+}
+
+TEST_F(BatchTest, ExpressionsMatchEagerOperators)
+{
+    using Fzolv::expr::lazy;
+
+    const float s = 0.75f;
+    const Fzolv::Vector2f a = lhs[0];
+    const Fzolv::Vector2f b = lhs[1];
+    const Fzolv::Vector2f c = rhs[0];
+
+    Fzolv::Vector2f fused = lazy(a) + lazy(b) * s - c;
+    EXPECT_EQ(fused, a + b * s - c);
+
+    Fzolv::Vector2f scaled = 2.0f * (lazy(a) - b) / 4.0f;
+    EXPECT_EQ(scaled, (a - b) * 2.0f / 4.0f);
+
+    Fzolv::Vector2f accumulated = a;
+    accumulated += lazy(b) * s;
+    EXPECT_EQ(accumulated, a + b * s);
+}
+
+TEST_F(BatchTest, ExpressionsFuseOverContainers)
+{
+    using Fzolv::expr::lazy;
+
+    const float dt = 0.016f;
+    std::vector<Fzolv::Vector2f> positions = lhs;
+    positions += lazy(rhs) * dt;
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(positions[i], lhs[i] + rhs[i] * dt);
+    }
+
+    Fzolv::Vector2fSoA soa{lhs.data(), lhs.size()};
+    Fzolv::Vector2fSoA velocities{rhs.data(), rhs.size()};
+    soa -= lazy(velocities) * dt + rhs[0];
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(soa.get(i), lhs[i] - (rhs[i] * dt + rhs[0]));
+    }
+
+    std::vector<Fzolv::Vector2f> result;
+    Fzolv::expr::assign(result, lazy(lhs) - lazy(velocities) * 2.0f);
+    ASSERT_EQ(result.size(), lhs.size());
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], lhs[i] - rhs[i] * 2.0f);
+    }
+
+    Fzolv::expr::assign(Fzolv::span<Fzolv::Vector2f>{result}, lazy(result) * 0.5f);
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(result[i], (lhs[i] - rhs[i] * 2.0f) * 0.5f);
+    }
+}
+
+TEST(FixedTest, Arithmetic)
+{
+    using Fzolv::Fixed16;
+    EXPECT_EQ(Fixed16(3).raw(), 3 << 16);
+    EXPECT_EQ(static_cast<double>(Fixed16(1.5) * Fixed16(-2.25)), -3.375);
+    EXPECT_EQ(static_cast<double>(Fixed16(7) / Fixed16(2)), 3.5);
+    EXPECT_EQ(static_cast<int>(Fixed16(-7.75)), -7);
+    EXPECT_EQ(Fixed16(1) / Fixed16(0), std::numeric_limits<Fixed16>::max());
+    EXPECT_EQ(Fixed16(-1) / Fixed16(0), std::numeric_limits<Fixed16>::lowest());
+    EXPECT_EQ(Fixed16(0) / Fixed16(0), Fixed16(0));
+
+    ///< Products round to nearest, overflow wraps like two's complement
+    EXPECT_EQ((Fixed16::FromRaw(1) * Fixed16(0.5)).raw(), 1);
+    EXPECT_EQ(std::numeric_limits<Fixed16>::max() + Fixed16::FromRaw(1), std::numeric_limits<Fixed16>::lowest());
+
+    EXPECT_EQ(Fzolv::math::floor(Fixed16(-1.5)), Fixed16(-2));
+    EXPECT_EQ(Fzolv::math::ceil(Fixed16(-1.5)), Fixed16(-1));
+    EXPECT_EQ(Fzolv::math::round(Fixed16(-1.5)), Fixed16(-2));
+    EXPECT_EQ(Fzolv::math::round(Fixed16(1.5)), Fixed16(2));
+    EXPECT_EQ(Fzolv::math::round(Fixed16(1.25)), Fixed16(1));
+
+    EXPECT_EQ(Fzolv::Fixed32(Fixed16(-2.75)), Fzolv::Fixed32(-2.75));
+    EXPECT_EQ(Fixed16(Fzolv::Fixed32(-2.75)), Fixed16(-2.75));
+
+    static_assert(Fixed16(2) * Fixed16(3) == Fixed16(6), "fixed point arithmetic must be constexpr");
+    static_assert(Fzolv::math::sqrt(Fixed16(16)) == Fixed16(4), "fixed point sqrt must be constexpr");
+}
+
+TEST(FixedTest, SqrtIsCorrectlyRounded)
+{
+    std::mt19937 rng{11};
+    std::uniform_int_distribution<std::int32_t> dist{0, std::numeric_limits<std::int32_t>::max()};
+    for (int i = 0; i < 10000; ++i)
+    {
+        const auto value = Fzolv::Fixed16::FromRaw(dist(rng));
+        const double exact = std::sqrt(static_cast<double>(value)) * 65536.0;
+        EXPECT_LE(std::abs(static_cast<double>(Fzolv::math::sqrt(value).raw()) - exact), 0.5);
+
+        const auto wide = Fzolv::Fixed32::FromRaw(static_cast<std::int64_t>(dist(rng)) << 24);
+        const double wideExact = std::sqrt(static_cast<double>(wide)) * 4294967296.0;
+        EXPECT_LE(std::abs(static_cast<double>(Fzolv::math::sqrt(wide).raw()) - wideExact), 1.0);
+    }
+    EXPECT_EQ(Fzolv::math::sqrt(Fzolv::Fixed16(-4)), Fzolv::Fixed16(0));
+}
+
+TEST(FixedTest, VectorsUseFixedPoint)
+{
+    using Fzolv::Fixed16;
+    using V = Fzolv::Vector2q16;
+
+    V a{Fixed16(3), Fixed16(4)};
+    EXPECT_EQ(a.length(), Fixed16(5));
+    EXPECT_EQ(a.lengthPrecise(), Fzolv::Fixed32(5));
+    EXPECT_EQ(a.normalized(), V(Fixed16(0.6), Fixed16(0.8)));
+    EXPECT_EQ(a.normalizedFast(), a.normalized());
+    EXPECT_EQ(V(a).normalizePrecise(), V(Fixed16(0.6), Fixed16(0.8)));
+    EXPECT_EQ(a.dot(V::UnitX()), Fixed16(3));
+    EXPECT_EQ(V::Lerp(V::Zero(), a, Fixed16(0.5)), V(Fixed16(1.5), Fixed16(2)));
+    EXPECT_EQ(V::SmoothStep(V::Zero(), a, Fixed16(1)), a);
+    EXPECT_EQ((a * 2 - V::One()) / 2, V(Fixed16(2.5), Fixed16(3.5)));
+    EXPECT_EQ(V(Fixed16(-1.5), Fixed16(2.5)).floor(), V(Fixed16(-2), Fixed16(2)));
+
+    Fzolv::Vector3q32 b{Fzolv::Fixed32(2), Fzolv::Fixed32(3), Fzolv::Fixed32(6)};
+    EXPECT_EQ(b.length(), Fzolv::Fixed32(7));
+
+    ///< Repeating a simulation step gives the same bits every time
+    std::vector<V> positions(64, a);
+    std::vector<V> velocities(64, V(Fixed16(0.1), Fixed16(-0.3)));
+    for (int step = 0; step < 100; ++step)
+    {
+        positions += Fzolv::expr::lazy(velocities) * Fixed16(1.0 / 60.0);
+    }
+    EXPECT_EQ(positions[0].x.raw(), a.x.raw() + 100 * ((Fixed16(0.1) * Fixed16(1.0 / 60.0)).raw()));
+}
+
+TEST(SpatialHashTest, QueriesMatchBruteForce)
+{
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> dist{-50.0f, 50.0f};
+    std::vector<Fzolv::Vector2f> positions(2000);
+    for (auto &p : positions)
+    {
+        p = {dist(rng), dist(rng)};
+    }
+
+    Fzolv::SpatialHash2Df grid{4.0f};
+    grid.build(positions);
+    ASSERT_EQ(grid.size(), positions.size());
+
+    std::vector<std::uint32_t> found(positions.size());
+    auto check = [&](const Fzolv::Vector2f &center, float radius)
+    {
+        const std::size_t count = grid.queryRadius(center, radius, found);
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < positions.size(); ++i)
+        {
+            if (center.distanceToSquared(positions[i]) <= radius * radius)
+            {
+                expected.push_back(i);
+            }
+        }
+        std::vector<std::uint32_t> actual(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(count));
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(actual, expected);
+    };
+    for (int i = 0; i < 50; ++i)
+    {
+        check({dist(rng), dist(rng)}, 3.0f + static_cast<float>(i % 5) * 2.5f);
+    }
+
+    const Fzolv::Vector2f min{-10.0f, 5.0f};
+    const Fzolv::Vector2f max{12.5f, 20.0f};
+    std::size_t inBox = 0;
+    for (const auto &p : positions)
+    {
+        inBox += p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+    }
+    EXPECT_EQ(grid.queryBox(min, max, found), inBox);
+
+    ///< A short output span still reports every match
+    std::uint32_t one[1];
+    EXPECT_EQ(grid.queryBox(min, max, one), inBox);
+
+    ///< Small moves stay in their cells, large ones trigger a full rebuild
+    for (auto &p : positions)
+    {
+        p.x = std::floor(p.x / 4.0f) * 4.0f + 2.0f;
+    }
+    grid.build(positions);
+    for (auto &p : positions)
+    {
+        p.x += 0.5f;
+    }
+    grid.update(positions);
+    check({0.0f, 0.0f}, 9.0f);
+    for (auto &p : positions)
+    {
+        p = {dist(rng), dist(rng)};
+    }
+    grid.update(positions);
+    check({1.0f, -3.0f}, 7.0f);
+
+    ///< Huge radii scan the entries instead of every cell, far and NaN positions clamp to the border cells
+    check({0.0f, 0.0f}, 1e30f);
+    check({3e9f, -3e9f}, 1e20f);
+    positions[0] = {std::nanf(""), 1.0f};
+    positions[1] = {1e38f, -1e38f};
+    positions[2] = {-std::numeric_limits<float>::infinity(), 0.0f};
+    grid.build(positions);
+    check({0.0f, 0.0f}, std::numeric_limits<float>::infinity());
+    check({1e38f, -1e38f}, 1.0f);
+    check({std::nanf(""), 0.0f}, 5.0f);
+    EXPECT_EQ(grid.queryBox({-std::numeric_limits<float>::infinity(), 0.0f}, {0.0f, 0.0f}, found), 1u);
+}
+
+TEST(SpatialHashTest, UpdateMovesOnlyTheEntriesThatChangedBuckets)
+{
+    std::mt19937 rng{9};
+    std::uniform_real_distribution<float> dist{-50.0f, 50.0f};
+    std::vector<Fzolv::Vector2f> positions(3000);
+    for (auto &p : positions)
+    {
+        p = {dist(rng), dist(rng)};
+    }
+
+    Fzolv::SpatialHash2Df grid{4.0f};
+    grid.build(positions);
+
+    std::vector<std::uint32_t> found(positions.size());
+    auto check = [&](const Fzolv::Vector2f &center, float radius)
+    {
+        const std::size_t count = grid.queryRadius(center, radius, found);
+        std::vector<std::uint32_t> expected;
+        for (std::uint32_t i = 0; i < positions.size(); ++i)
+        {
+            if (center.distanceToSquared(positions[i]) <= radius * radius)
+            {
+                expected.push_back(i);
+            }
+        }
+        std::vector<std::uint32_t> actual(found.begin(), found.begin() + static_cast<std::ptrdiff_t>(count));
+        std::sort(actual.begin(), actual.end());
+        EXPECT_EQ(actual, expected);
+    };
+
+    ///< A few hundred jumps per frame stay below the rebuild limit, every entry must still be stored exactly once
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        for (std::size_t i = static_cast<std::size_t>(frame); i < positions.size(); i += 11)
+        {
+            positions[i] = {dist(rng), dist(rng)};
+        }
+        for (std::size_t i = 1; i < positions.size(); i += 7)
+        {
+            positions[i].y += 0.01f;
+        }
+        grid.update(positions);
+
+        std::vector<int> seen(positions.size(), 0);
+        for (const auto &entry : grid.data())
+        {
+            ++seen[entry.index];
+            EXPECT_EQ(entry.position, positions[entry.index]);
+        }
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), 1), static_cast<std::ptrdiff_t>(positions.size()));
+        for (int i = 0; i < 20; ++i)
+        {
+            check({dist(rng), dist(rng)}, 2.0f + static_cast<float>(i % 4) * 3.0f);
+        }
+        EXPECT_EQ(grid.queryBox({-60.0f, -60.0f}, {60.0f, 60.0f}, found), positions.size());
+    }
+}
+
+TEST(AABBTest, Operations)
+{
+    const Fzolv::AABB2f a{{0.0f, 0.0f}, {4.0f, 2.0f}};
+    const Fzolv::AABB2f b{{3.0f, 1.0f}, {6.0f, 5.0f}};
+    EXPECT_EQ(Fzolv::AABB2f::Union(a, b), Fzolv::AABB2f({0.0f, 0.0f}, {6.0f, 5.0f}));
+    EXPECT_EQ(Fzolv::AABB2f::Intersection(a, b), Fzolv::AABB2f({3.0f, 1.0f}, {4.0f, 2.0f}));
+    EXPECT_TRUE(Fzolv::AABB2f::Intersection(a, Fzolv::AABB2f({5.0f, 0.0f}, {6.0f, 1.0f})).isEmpty());
+    EXPECT_TRUE(a.overlaps(b));
+    EXPECT_TRUE(a.overlaps(Fzolv::AABB2f({4.0f, 2.0f}, {5.0f, 3.0f})));
+    EXPECT_FALSE(a.overlaps(Fzolv::AABB2f({4.5f, 0.0f}, {5.0f, 3.0f})));
+    EXPECT_TRUE(a.contains(Fzolv::Vector2f{4.0f, 0.0f}));
+    EXPECT_FALSE(a.contains(b));
+    EXPECT_TRUE(Fzolv::AABB2f::Union(a, b).contains(b));
+    EXPECT_EQ(a.center(), Fzolv::Vector2f(2.0f, 1.0f));
+    EXPECT_EQ(a.area(), 8.0f);
+    EXPECT_EQ(Fzolv::AABB2f(a).inflate(1.0f), Fzolv::AABB2f({-1.0f, -1.0f}, {5.0f, 3.0f}));
+    EXPECT_TRUE(Fzolv::AABB2f::Empty().isEmpty());
+
+    const Fzolv::Vector2f points[] = {{1.0f, -2.0f}, {-3.0f, 4.0f}, {0.5f, 0.5f}};
+    EXPECT_EQ(Fzolv::AABB2f::FromPoints(points), Fzolv::AABB2f({-3.0f, -2.0f}, {1.0f, 4.0f}));
+
+    constexpr Fzolv::AABB3<int> cube = Fzolv::AABB3<int>::FromCenterExtents({0, 0, 0}, {1, 2, 3});
+    static_assert(cube.volume() == 48 && cube.halfSurfaceArea() == 44, "AABB3 must be usable in constant expressions");
+    EXPECT_TRUE(cube.contains(Fzolv::Vector3i{1, -2, 3}));
+    EXPECT_FALSE(cube.overlaps(Fzolv::AABB3<int>({2, 0, 0}, {3, 1, 1})));
+}
+
+TEST(AABBTest, BatchOverlapsMatchScalar)
+{
+    std::mt19937 rng{21};
+    std::uniform_real_distribution<float> position{-20.0f, 20.0f};
+    std::uniform_real_distribution<float> extent{0.0f, 4.0f};
+    for (std::size_t count : {0u, 1u, 3u, 64u, 129u, 1000u})
+    {
+        std::vector<Fzolv::AABB2f> boxes(count);
+        for (auto &box : boxes)
+        {
+            box = Fzolv::AABB2f::FromCenterExtents({position(rng), position(rng)}, {extent(rng), extent(rng)});
+        }
+        const Fzolv::AABB2f query{{-5.0f, -3.0f}, {6.0f, 8.0f}};
+        if (count > 2)
+        {
+            ///< Touching boxes overlap, NaN boxes never do
+            boxes[1] = {{6.0f, 8.0f}, {7.0f, 9.0f}};
+            boxes[2] = {{std::nanf(""), 0.0f}, {1.0f, 1.0f}};
+        }
+
+        std::vector<std::uint64_t> mask(Fzolv::batch::maskWords(count), ~std::uint64_t{0});
+        Fzolv::batch::overlaps(boxes, query, mask);
+        for (std::size_t i = 0; i < mask.size() * 64; ++i)
+        {
+            const bool bit = (mask[i / 64] >> (i % 64)) & 1U;
+            EXPECT_EQ(bit, i < count && boxes[i].overlaps(query)) << i;
+        }
+    }
+}
+
+TEST(AABBTest, BatchOverlaps3DMatchScalarOnEveryLevel)
+{
+    std::mt19937 rng{22};
+    std::uniform_real_distribution<float> position{-20.0f, 20.0f};
+    std::uniform_real_distribution<float> extent{0.0f, 4.0f};
+    const Fzolv::AABB3f query{{-5.0f, -3.0f, -4.0f}, {6.0f, 8.0f, 2.0f}};
+    for (std::size_t count : {0u, 1u, 3u, 64u, 129u, 1000u})
+    {
+        std::vector<Fzolv::AABB3f> boxes(count);
+        for (auto &box : boxes)
+        {
+            box = Fzolv::AABB3f::FromCenterExtents({position(rng), position(rng), position(rng)},
+                                                   {extent(rng), extent(rng), extent(rng)});
+        }
+        if (count > 8)
+        {
+            ///< Touching boxes overlap, a NaN in any of the six components never does
+            boxes[1] = {{6.0f, 8.0f, 2.0f}, {7.0f, 9.0f, 3.0f}};
+            for (std::size_t k = 0; k < 6; ++k)
+            {
+                boxes[2 + k] = {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+                (&boxes[2 + k].min.x)[k] = std::nanf("");
+            }
+        }
+
+        for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                           Fzolv::simd::Level::NEON})
+        {
+            if (!Fzolv::simd::setLevel(level))
+            {
+                continue;
+            }
+            SCOPED_TRACE(Fzolv::simd::levelName(level));
+            std::vector<std::uint64_t> mask(Fzolv::batch::maskWords(count), ~std::uint64_t{0});
+            Fzolv::batch::overlaps(boxes, query, mask);
+            for (std::size_t i = 0; i < mask.size() * 64; ++i)
+            {
+                const bool bit = (mask[i / 64] >> (i % 64)) & 1U;
+                EXPECT_EQ(bit, i < count && boxes[i].overlaps(query)) << i;
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(DynamicBVHTest, QueriesMatchBruteForce)
+{
+    std::mt19937 rng{8};
+    std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+    std::uniform_real_distribution<float> extent{0.1f, 6.0f};
+    auto randomBox = [&]()
+    { return Fzolv::AABB2f::FromCenterExtents({position(rng), position(rng)}, {extent(rng), extent(rng)}); };
+
+    Fzolv::DynamicBVH2f tree{0.5f};
+    std::vector<Fzolv::AABB2f> boxes(600);
+    std::vector<Fzolv::DynamicBVH2f::proxy_type> proxies(boxes.size());
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        boxes[i] = randomBox();
+        proxies[i] = tree.insert(boxes[i], i);
+    }
+
+    ///< Small moves stay inside the fat boxes, large ones reinsert, and every third object is removed
+    EXPECT_FALSE(tree.move(proxies[0], Fzolv::AABB2f(boxes[0]).inflate(-0.05f)));
+    std::vector<bool> alive(boxes.size(), true);
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        if (i % 3 == 0)
+        {
+            tree.remove(proxies[i]);
+            alive[i] = false;
+        }
+        else if (i % 3 == 1)
+        {
+            boxes[i] = randomBox();
+            tree.move(proxies[i], boxes[i]);
+        }
+    }
+    ASSERT_EQ(tree.size(), 400u);
+    EXPECT_LE(tree.height(), 20);
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        if (alive[i])
+        {
+            EXPECT_TRUE(tree.fatBox(proxies[i]).contains(boxes[i]));
+            EXPECT_EQ(tree.userData(proxies[i]), i);
+        }
+    }
+
+    const Fzolv::AABB2f query{{-30.0f, -10.0f}, {25.0f, 40.0f}};
+    std::vector<std::uint32_t> found;
+    tree.query(query,
+               [&](std::uint32_t user, Fzolv::DynamicBVH2f::proxy_type)
+               {
+                   found.push_back(user);
+                   return true;
+               });
+    std::sort(found.begin(), found.end());
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        if (alive[i] && tree.fatBox(proxies[i]).overlaps(query))
+        {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(found, expected);
+
+    ///< Force the threaded path, chunks must still come back in order
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    const std::size_t threshold = Fzolv::parallelThreshold();
+    Fzolv::setParallelThreshold(0);
+    tree.findPairs(pairs);
+    Fzolv::setParallelThreshold(threshold);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> serial;
+    tree.forEachPair([&](std::uint32_t a, std::uint32_t b) { serial.emplace_back(a, b); });
+    EXPECT_EQ(pairs, serial);
+    for (auto &pair : pairs)
+    {
+        pair = std::minmax(pair.first, pair.second);
+    }
+    std::sort(pairs.begin(), pairs.end());
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> expectedPairs;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        for (std::uint32_t j = i + 1; j < boxes.size(); ++j)
+        {
+            if (alive[i] && alive[j] && tree.fatBox(proxies[i]).overlaps(tree.fatBox(proxies[j])))
+            {
+                expectedPairs.emplace_back(i, j);
+            }
+        }
+    }
+    EXPECT_EQ(pairs, expectedPairs);
+
+    ///< The closest hit along the ray wins once every hit clips the ray
+    const Fzolv::Vector2f origin{-120.0f, 3.0f};
+    const Fzolv::Vector2f direction{240.0f, 0.0f};
+    float closest = 1.0f;
+    tree.raycast(origin, direction, 1.0f,
+                 [&](std::uint32_t user, Fzolv::DynamicBVH2f::proxy_type proxy)
+                 {
+                     const float enter = (tree.fatBox(proxy).min.x - origin.x) / direction.x;
+                     closest = std::min(closest, enter);
+                     static_cast<void>(user);
+                     return closest;
+                 });
+    float expectedClosest = 1.0f;
+    for (std::uint32_t i = 0; i < boxes.size(); ++i)
+    {
+        const auto &fat = tree.fatBox(proxies[i]);
+        if (alive[i] && fat.min.y <= origin.y && fat.max.y >= origin.y)
+        {
+            expectedClosest = std::min(expectedClosest, (fat.min.x - origin.x) / direction.x);
+        }
+    }
+    EXPECT_EQ(closest, expectedClosest);
+}
+
+TEST(DynamicBVHTest, FindPairsSplitsTypicalScenesAcrossThreads)
+{
+    ///< Counts the chunks parallelFor hands out and runs them in order on the calling thread
+    struct CountingExecutor final : Fzolv::Executor
+    {
+        std::size_t tasks = 0;
+
+        [[nodiscard]] auto concurrency() const noexcept -> std::size_t override { return 4; }
+
+        void run(std::size_t count, Fzolv::TaskRef task) override
+        {
+            tasks += count;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                task(i);
+            }
+        }
+    };
+
+    std::mt19937 rng{12};
+    std::uniform_real_distribution<float> position{-500.0f, 500.0f};
+    Fzolv::DynamicBVH2f tree;
+    for (std::uint32_t i = 0; i < 4000; ++i)
+    {
+        tree.insert(Fzolv::AABB2f::FromCenterExtents({position(rng), position(rng)}, {2.0f, 2.0f}), i);
+    }
+    ASSERT_LT(4000u, Fzolv::parallelThreshold());
+
+    CountingExecutor executor;
+    Fzolv::setExecutor(&executor);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+    tree.findPairs(pairs);
+    Fzolv::setExecutor(nullptr);
+    EXPECT_GT(executor.tasks, 1u);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> serial;
+    tree.forEachPair([&](std::uint32_t a, std::uint32_t b) { serial.emplace_back(a, b); });
+    EXPECT_EQ(pairs, serial);
+}
+
+TEST(DynamicBVHTest, SortedInsertionsStayBalanced)
+{
+    Fzolv::DynamicBVH3f tree;
+    for (std::uint32_t i = 0; i < 1024; ++i)
+    {
+        const float x = static_cast<float>(i);
+        tree.insert({{x, 0.0f, 0.0f}, {x + 0.5f, 1.0f, 1.0f}}, i);
+    }
+    EXPECT_LE(tree.height(), 20);
+
+    std::size_t pairs = 0;
+    tree.forEachPair([&](std::uint32_t, std::uint32_t) { ++pairs; });
+    EXPECT_EQ(pairs, 0u);
+}
+
+TEST(QuaternionTest, Rotation)
+{
+    const auto quarter = Fzolv::Quaterniond::FromAxisAngle({0.0, 0.0, 1.0}, std::acos(0.0));
+    const Fzolv::Vector3<double> rotated = quarter.rotate({1.0, 2.0, 3.0});
+    EXPECT_NEAR(rotated.x, -2.0, 1e-15);
+    EXPECT_NEAR(rotated.y, 1.0, 1e-15);
+    EXPECT_NEAR(rotated.z, 3.0, 1e-15);
+
+    const auto tilt = Fzolv::Quaterniond::FromAxisAngle(Fzolv::Vector3<double>{1.0, 1.0, 0.0}.normalized(), 0.7);
+    const Fzolv::Vector3<double> v{0.5, -1.5, 2.0};
+    const auto composed = (tilt * quarter).rotate(v);
+    const auto sequential = tilt.rotate(quarter.rotate(v));
+    EXPECT_NEAR(composed.x, sequential.x, 1e-14);
+    EXPECT_NEAR(composed.y, sequential.y, 1e-14);
+    EXPECT_NEAR(composed.z, sequential.z, 1e-14);
+
+    const auto back = tilt.conjugate().rotate(tilt.rotate(v));
+    EXPECT_NEAR(back.x, v.x, 1e-14);
+    const auto scaled = tilt * 2.0;
+    const auto identity = scaled * scaled.inverse();
+    EXPECT_NEAR(identity.w, 1.0, 1e-15);
+    EXPECT_NEAR(identity.x, 0.0, 1e-15);
+
+    const auto matrix = tilt.toMatrix() * Fzolv::Vector4<double>{v, 0.0};
+    const auto direct = tilt.rotate(v);
+    EXPECT_NEAR(matrix.x, direct.x, 1e-14);
+    EXPECT_NEAR(matrix.y, direct.y, 1e-14);
+    EXPECT_NEAR(matrix.z, direct.z, 1e-14);
+}
+
+TEST(QuaternionTest, Interpolation)
+{
+    const Fzolv::Vector3<double> axis = Fzolv::Vector3<double>{1.0, -2.0, 0.5}.normalized();
+    const auto start = Fzolv::Quaterniond::FromAxisAngle(axis, 0.2);
+    const auto end = Fzolv::Quaterniond::FromAxisAngle(axis, 2.4);
+    for (double t : {0.0, 0.25, 0.5, 0.9, 1.0})
+    {
+        const auto expected = Fzolv::Quaterniond::FromAxisAngle(axis, 0.2 + 2.2 * t);
+        const auto slerp = Fzolv::Quaterniond::Slerp(start, end, t);
+        EXPECT_NEAR(slerp.x, expected.x, 1e-15);
+        EXPECT_NEAR(slerp.w, expected.w, 1e-15);
+        const auto fast = Fzolv::Quaterniond::SlerpFast(start, end, t);
+        EXPECT_NEAR(fast.x, expected.x, 1e-6);
+        EXPECT_NEAR(fast.w, expected.w, 1e-6);
+        EXPECT_NEAR(Fzolv::Quaterniond::Nlerp(start, end, t).length(), 1.0, 1e-15);
+    }
+
+    ///< The shortest path flips the sign of the end rotation, nearly equal rotations stay accurate
+    const auto negated = Fzolv::Quaterniond::Slerp(start, -end, 0.5);
+    const auto expected = Fzolv::Quaterniond::FromAxisAngle(axis, 1.3);
+    EXPECT_NEAR(negated.y, expected.y, 1e-15);
+    const auto close = Fzolv::Quaterniond::FromAxisAngle(axis, 0.2 + 1e-9);
+    EXPECT_NEAR(Fzolv::Quaterniond::Slerp(start, close, 0.5).z, Fzolv::Quaterniond::FromAxisAngle(axis, 0.2 + 5e-10).z, 1e-16);
+    EXPECT_EQ(Fzolv::Quaterniond::Slerp(start, start, 0.3), start);
+}
+
+TEST(QuaternionTest, BatchMatchesScalar)
+{
+    std::mt19937 rng{13};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+    for (std::size_t count : {0u, 3u, 4u, 13u, 64u})
+    {
+        std::vector<Fzolv::Quaternionf> a(count), b(count);
+        std::vector<Fzolv::Vector3f> vectors(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            a[i] = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+            b[i] = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+            vectors[i] = {dist(rng), dist(rng), dist(rng)};
+        }
+
+        std::vector<Fzolv::Vector3f> rotated(count);
+        Fzolv::batch::rotate(a, vectors, rotated);
+        std::vector<Fzolv::Vector3f> single(count);
+        Fzolv::batch::rotate(count > 0 ? b[0] : Fzolv::Quaternionf{}, vectors, single);
+        std::vector<Fzolv::Quaternionf> nlerp(count), slerp(count);
+        Fzolv::batch::nlerp(a, b, 0.3f, nlerp);
+        Fzolv::batch::slerp(a, b, 0.7f, slerp);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            EXPECT_EQ(rotated[i], a[i].rotate(vectors[i]));
+            EXPECT_EQ(single[i], b[0].rotate(vectors[i]));
+            EXPECT_EQ(nlerp[i], Fzolv::Quaternionf::Nlerp(a[i], b[i], 0.3f));
+            EXPECT_EQ(slerp[i], Fzolv::Quaternionf::SlerpFast(a[i], b[i], 0.7f));
+
+            const auto exact = Fzolv::Quaternionf::Slerp(a[i], b[i], 0.7f);
+            EXPECT_NEAR(slerp[i].x, exact.x, 2e-6f);
+            EXPECT_NEAR(slerp[i].w, exact.w, 2e-6f);
+        }
+    }
+}
+
+TEST(ParallelTest, ThreadPoolRunsEveryTaskOnce)
+{
+    Fzolv::ThreadPool pool{4};
+    EXPECT_EQ(pool.concurrency(), 4u);
+
+    std::vector<std::atomic<int>> hits(1000);
+    for (int round = 0; round < 20; ++round)
+    {
+        pool.run(hits.size(), [&](std::size_t i) { hits[i].fetch_add(1); });
+    }
+    for (const auto &hit : hits)
+    {
+        ASSERT_EQ(hit.load(), 20);
+    }
+
+    ///< Nested runs execute inline instead of waiting on the busy workers
+    std::atomic<int> nested{0};
+    pool.run(8, [&](std::size_t) { pool.run(8, [&](std::size_t) { nested.fetch_add(1); }); });
+    EXPECT_EQ(nested.load(), 64);
+
+    EXPECT_THROW(pool.run(100,
+                          [](std::size_t i)
+                          {
+                              if (i == 42)
+                              {
+                                  throw std::runtime_error{"task failed"};
+                              }
+                          }),
+                 std::runtime_error);
+    std::atomic<int> after{0};
+    pool.run(10, [&](std::size_t) { after.fetch_add(1); });
+    EXPECT_EQ(after.load(), 10);
+}
+
+TEST(ParallelTest, ChunksAreAlignedAndCoverTheRange)
+{
+    Fzolv::ThreadPool pool{3};
+    Fzolv::setExecutor(&pool);
+    const std::size_t threshold = Fzolv::parallelThreshold();
+    Fzolv::setParallelThreshold(0);
+
+    std::vector<int> covered(100003);
+    std::atomic<int> chunks{0};
+    Fzolv::parallelFor(covered.size(), 1000,
+                       [&](std::size_t begin, std::size_t end)
+                       {
+                           EXPECT_EQ(begin % Fzolv::parallelChunkAlignment, 0u);
+                           for (std::size_t i = begin; i < end; ++i)
+                           {
+                               ++covered[i];
+                           }
+                           chunks.fetch_add(1);
+                       });
+    EXPECT_GT(chunks.load(), 1);
+    EXPECT_LE(chunks.load(), 12);
+    EXPECT_TRUE(std::all_of(covered.begin(), covered.end(), [](int c) { return c == 1; }));
+
+    Fzolv::setParallelThreshold(threshold);
+    Fzolv::setExecutor(nullptr);
+    EXPECT_EQ(&Fzolv::currentExecutor(), &Fzolv::defaultThreadPool());
+}
+
+TEST(ParallelTest, BatchOperationsMatchInlineResults)
+{
+    std::mt19937 rng{17};
+    std::uniform_real_distribution<float> dist{-100.0f, 100.0f};
+    const std::size_t count = 70001;
+    std::vector<Fzolv::Vector2f> a(count), b(count);
+    std::vector<Fzolv::Vector3f> vectors(count);
+    std::vector<Fzolv::AABB2f> boxes(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        a[i] = {dist(rng), dist(rng)};
+        b[i] = {dist(rng), dist(rng)};
+        vectors[i] = {dist(rng), dist(rng), dist(rng)};
+        boxes[i] = Fzolv::AABB2f::FromCenterExtents(a[i], {1.0f, 2.0f});
+    }
+    const auto rotation = Fzolv::Quaternionf::FromAxisAngle(Fzolv::Vector3f{1.0f, 2.0f, 3.0f}.normalized(), 0.5f);
+    const auto query = Fzolv::AABB2f::FromCenterExtents({0.0f, 0.0f}, {30.0f, 30.0f});
+
+    struct Results
+    {
+        std::vector<float> dots;
+        std::vector<Fzolv::Vector2f> normalized, lerped;
+        std::vector<Fzolv::Vector3f> rotated;
+        std::vector<std::uint64_t> mask;
+        std::vector<std::uint32_t> near;
+    };
+    auto compute = [&]()
+    {
+        Results r{std::vector<float>(count), std::vector<Fzolv::Vector2f>(count), std::vector<Fzolv::Vector2f>(count),
+                  std::vector<Fzolv::Vector3f>(count), std::vector<std::uint64_t>(Fzolv::batch::maskWords(count)),
+                  std::vector<std::uint32_t>(count)};
+        Fzolv::batch::dot(a, b, r.dots);
+        Fzolv::batch::normalize(a, r.normalized);
+        Fzolv::batch::lerp(a, b, 0.25f, r.lerped);
+        Fzolv::batch::rotate(rotation, vectors, r.rotated);
+        Fzolv::batch::overlaps(boxes, query, r.mask);
+        Fzolv::SpatialHash2Df grid{8.0f};
+        grid.build(a);
+        grid.update(b);
+        r.near.resize(grid.queryRadius({1.0f, -2.0f}, 20.0f, r.near));
+        std::sort(r.near.begin(), r.near.end());
+        return r;
+    };
+
+    Fzolv::InlineExecutor serial;
+    Fzolv::setExecutor(&serial);
+    const Results expected = compute();
+
+    Fzolv::ThreadPool pool{4};
+    Fzolv::setExecutor(&pool);
+    const std::size_t threshold = Fzolv::parallelThreshold();
+    Fzolv::setParallelThreshold(0);
+    const Results threaded = compute();
+    Fzolv::setParallelThreshold(threshold);
+    Fzolv::setExecutor(nullptr);
+
+    EXPECT_EQ(threaded.dots, expected.dots);
+    EXPECT_EQ(threaded.normalized, expected.normalized);
+    EXPECT_EQ(threaded.lerped, expected.lerped);
+    EXPECT_EQ(threaded.rotated, expected.rotated);
+    EXPECT_EQ(threaded.mask, expected.mask);
+    EXPECT_EQ(threaded.near, expected.near);
+    EXPECT_FALSE(expected.near.empty());
+}
+
+TEST(SimdDispatchTest, EveryLevelMatchesScalar)
+{
+    using Fzolv::simd::Level;
+    EXPECT_TRUE(Fzolv::simd::isSupported(Level::Scalar));
+    EXPECT_TRUE(Fzolv::simd::isSupported(Fzolv::simd::detectedLevel()));
+    EXPECT_STREQ(Fzolv::simd::levelName(Level::AVX2), "avx2");
+
+    std::mt19937 rng{23};
+    std::uniform_real_distribution<float> dist{-10.0f, 10.0f};
+    const std::size_t count = 131;
+    std::vector<Fzolv::Vector2f> a(count), b(count), c(count), d(count);
+    std::vector<Fzolv::Vector3f> vectors(count);
+    std::vector<Fzolv::Quaternionf> rotations(count);
+    std::vector<Fzolv::AABB2f> boxes(count);
+    std::vector<float> amounts(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        a[i] = {dist(rng), dist(rng)};
+        b[i] = {dist(rng), dist(rng)};
+        c[i] = {dist(rng), dist(rng)};
+        d[i] = {dist(rng), dist(rng)};
+        vectors[i] = {dist(rng), dist(rng), dist(rng)};
+        rotations[i] = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+        boxes[i] = Fzolv::AABB2f::FromCenterExtents(a[i], {1.0f, 1.0f});
+        amounts[i] = dist(rng) * 0.1f;
+    }
+    const auto query = Fzolv::AABB2f::FromCenterExtents({0.0f, 0.0f}, {5.0f, 5.0f});
+    const std::vector<Fzolv::Quaternionf> reversed(rotations.rbegin(), rotations.rend());
+
+    struct Results
+    {
+        std::vector<float> dots, crosses, distances;
+        std::vector<Fzolv::Vector2f> normalized, fast, lerped, eased, splines;
+        std::vector<Fzolv::Vector3f> rotated;
+        std::vector<Fzolv::Quaternionf> slerped;
+        std::vector<std::uint64_t> mask;
+    };
+    auto compute = [&]()
+    {
+        Results r{std::vector<float>(count), std::vector<float>(count), std::vector<float>(count),
+                  std::vector<Fzolv::Vector2f>(count), std::vector<Fzolv::Vector2f>(count),
+                  std::vector<Fzolv::Vector2f>(count), std::vector<Fzolv::Vector2f>(count),
+                  std::vector<Fzolv::Vector2f>(count), std::vector<Fzolv::Vector3f>(count),
+                  std::vector<Fzolv::Quaternionf>(count), std::vector<std::uint64_t>(Fzolv::batch::maskWords(count))};
+        Fzolv::batch::dot(a, b, r.dots);
+        Fzolv::batch::cross(a, b, r.crosses);
+        Fzolv::batch::distanceToSquared(a, b, r.distances);
+        Fzolv::batch::normalize(a, r.normalized);
+        Fzolv::batch::normalizeFast(a, r.fast);
+        Fzolv::batch::lerp(a, b, amounts, r.lerped);
+        Fzolv::batch::smoothstep(a, b, amounts, r.eased);
+        Fzolv::batch::hermite(a, b, c, d, amounts, r.splines);
+        Fzolv::batch::rotate(rotations, vectors, r.rotated);
+        Fzolv::batch::slerp(rotations, reversed, 0.4f, r.slerped);
+        Fzolv::batch::overlaps(boxes, query, r.mask);
+        return r;
+    };
+
+    ASSERT_TRUE(Fzolv::simd::setLevel(Level::Scalar));
+    EXPECT_EQ(Fzolv::simd::activeLevel(), Level::Scalar);
+    const Results expected = compute();
+
+    for (Level level : {Level::SSE2, Level::AVX2, Level::NEON})
+    {
+        ASSERT_EQ(Fzolv::simd::setLevel(level), Fzolv::simd::isSupported(level));
+        if (!Fzolv::simd::isSupported(level))
+        {
+            EXPECT_EQ(Fzolv::simd::activeLevel(), Level::Scalar);
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        const Results r = compute();
+        EXPECT_EQ(r.dots, expected.dots);
+        EXPECT_EQ(r.crosses, expected.crosses);
+        EXPECT_EQ(r.distances, expected.distances);
+        EXPECT_EQ(r.normalized, expected.normalized);
+        EXPECT_EQ(r.fast, expected.fast);
+        EXPECT_EQ(r.lerped, expected.lerped);
+        EXPECT_EQ(r.eased, expected.eased);
+        EXPECT_EQ(r.splines, expected.splines);
+        EXPECT_EQ(r.rotated, expected.rotated);
+        EXPECT_EQ(r.slerped, expected.slerped);
+        EXPECT_EQ(r.mask, expected.mask);
+        ASSERT_TRUE(Fzolv::simd::setLevel(Level::Scalar));
+    }
+
+    Fzolv::simd::resetLevel();
+    EXPECT_EQ(Fzolv::simd::activeLevel(), Fzolv::simd::detectedLevel());
+}
+
+namespace
+{
+    ///< Counts the allocations an arena takes from its upstream
+    class CountingResource final : public std::pmr::memory_resource
+    {
+    public:
+        std::size_t allocations = 0;
+        std::size_t live = 0;
+
+    private:
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override
+        {
+            ++allocations;
+            ++live;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override
+        {
+            --live;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        auto do_is_equal(const std::pmr::memory_resource &other) const noexcept -> bool override { return this == &other; }
+    };
+}
+
+TEST(FrameArenaTest, AllocationsAreAlignedAndResetPerFrame)
+{
+    CountingResource upstream;
+    {
+        Fzolv::FrameArena arena{1024, &upstream};
+        EXPECT_EQ(upstream.allocations, 1u);
+
+        void *first = arena.allocate(3, 1);
+        void *second = arena.allocate(100, 8);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % Fzolv::cacheLineSize, 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % Fzolv::cacheLineSize, 0u);
+        EXPECT_NE(first, second);
+        EXPECT_EQ(arena.bytesUsed(), 103u);
+
+        ///< Outgrowing the first block adds another one, the reset merges them so the next frame fits
+        void *large = arena.allocate(5000, 128);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 128, 0u);
+        EXPECT_EQ(upstream.allocations, 2u);
+        arena.reset();
+        EXPECT_EQ(arena.generation(), 1u);
+        EXPECT_EQ(arena.bytesUsed(), 0u);
+        EXPECT_EQ(upstream.live, 1u);
+
+        const std::size_t steady = upstream.allocations;
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            EXPECT_NE(arena.allocate(3, 1), nullptr);
+            EXPECT_NE(arena.allocate(100, 8), nullptr);
+            EXPECT_NE(arena.allocate(5000, 128), nullptr);
+            arena.reset();
+        }
+        EXPECT_EQ(upstream.allocations, steady);
+        EXPECT_GE(arena.capacity(), 1024u + 5000u);
+    }
+    EXPECT_EQ(upstream.live, 0u);
+}
+
+TEST(FrameArenaTest, ContainersAllocateFromTheArena)
+{
+    CountingResource upstream;
+    Fzolv::FrameArena arena{std::size_t{1} << 16, &upstream};
+    const std::vector<Fzolv::Vector3f> points{{1.0f, 2.0f, 3.0f}, {-4.0f, 5.0f, 0.5f}, {0.0f, 0.0f, 1.0f}};
+    const auto m = Fzolv::Matrix4f::Translation({1.0f, 2.0f, 3.0f});
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        arena.reset();
+        std::pmr::vector<Fzolv::Vector2f> scratch{&arena};
+        scratch.resize(37, {3.0f, 4.0f});
+        Fzolv::batch::normalize(Fzolv::span<Fzolv::Vector2f>{scratch.data(), scratch.size()});
+        EXPECT_EQ(scratch[36], (Fzolv::Vector2f{0.6f, 0.8f}));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(scratch.data()) % Fzolv::cacheLineSize, 0u);
+
+        const Fzolv::Vector3SoA<float> in{points.data(), points.size(), &arena};
+        Fzolv::Vector3SoA<float> out{&arena};
+        Fzolv::transformPoints(m, in, out);
+        EXPECT_EQ(out.get_allocator().resource(), &arena);
+        EXPECT_EQ(out.get(1), m.transformPoint(points[1]));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(out.zData()) % Fzolv::cacheLineSize, 0u);
+
+        ///< Copies go back to the heap, they may outlive the frame
+        const Fzolv::Vector3SoA<float> kept = out;
+        EXPECT_EQ(kept.get_allocator().resource(), nullptr);
+        EXPECT_EQ(kept.get(2), out.get(2));
+    }
+    arena.reset();
+    EXPECT_EQ(upstream.allocations, 1u);
+}
+
+TEST(QuantizeTest, RoundTripStaysWithinHalfAStep)
+{
+    const Fzolv::Quantizer3f quantizer{{{-100.0f, 0.0f, -50.0f}, {100.0f, 20.0f, 50.0f}}, 16};
+    EXPECT_EQ(quantizer.bytesPerVector(), 6u);
+    EXPECT_EQ(quantizer.maxCode(), 65535u);
+
+    std::mt19937 rng{29};
+    std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+    const std::size_t count = 1000;
+    std::vector<Fzolv::Vector3f> positions(count);
+    for (auto &p : positions)
+    {
+        p = {-100.0f + 200.0f * unit(rng), 20.0f * unit(rng), -50.0f + 100.0f * unit(rng)};
+    }
+    positions[0] = {-500.0f, 21.0f, std::nanf("")}; ///< Clamps to the bounds, NaN to the minimum
+
+    std::vector<std::uint8_t> stream(quantizer.encodedSize(count));
+    EXPECT_EQ(Fzolv::batch::encode(quantizer, positions, stream), stream.size());
+    std::vector<Fzolv::Vector3f> decoded(count);
+    Fzolv::batch::decode(quantizer, stream, decoded);
+
+    EXPECT_EQ(decoded[0], (Fzolv::Vector3f{-100.0f, 20.0f, -50.0f}));
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        EXPECT_EQ(decoded[i], quantizer.quantized(positions[i]));
+        EXPECT_LE(std::fabs(decoded[i].x - positions[i].x), quantizer.step(0) * 0.501f);
+        EXPECT_LE(std::fabs(decoded[i].y - positions[i].y), quantizer.step(1) * 0.501f);
+        EXPECT_LE(std::fabs(decoded[i].z - positions[i].z), quantizer.step(2) * 0.501f);
+    }
+
+    const auto codes = quantizer.encode(positions[7]);
+    EXPECT_EQ(stream[7 * 6 + 2], static_cast<std::uint8_t>(codes[1]));
+    EXPECT_EQ(stream[7 * 6 + 3], static_cast<std::uint8_t>(codes[1] >> 8));
+
+    const Fzolv::Quantizer2f coarse{{{0.0f, 0.0f}, {1.0f, 1.0f}}, 20};
+    const std::vector<Fzolv::Vector2f> points{{0.25f, 0.75f}, {1.0f, 0.0f}, {0.5f, 0.125f}};
+    std::vector<std::uint8_t> packed(coarse.encodedSize(points.size()));
+    EXPECT_EQ(packed.size(), 18u);
+    Fzolv::batch::encode(coarse, points, packed);
+    std::vector<Fzolv::Vector2f> unpacked(points.size());
+    Fzolv::batch::decode(coarse, packed, unpacked);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        EXPECT_NEAR(unpacked[i].x, points[i].x, 1e-6f);
+        EXPECT_NEAR(unpacked[i].y, points[i].y, 1e-6f);
+    }
+}
+
+TEST(QuantizeTest, WideCodesStayWithinHalfAStepOnEveryLevel)
+{
+    using Fzolv::simd::Level;
+    const Fzolv::AABB2f boxes[] = {{{-1000.0f, -1000.0f}, {1000.0f, 1000.0f}}, {{0.0f, 0.0f}, {1.0f, 1.0f}}};
+    for (const auto &bounds : boxes)
+    {
+        const Fzolv::Quantizer2f quantizer{bounds, 24};
+        EXPECT_TRUE(quantizer.isWide());
+        std::mt19937 rng{43};
+        std::uniform_real_distribution<float> dist{bounds.min.x, bounds.max.x};
+        std::uniform_int_distribution<std::uint32_t> code{0, quantizer.maxCode() - 1};
+        const std::size_t count = 4000;
+        std::vector<Fzolv::Vector2f> points(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ///< y sits next to the middle of two codes, where rounding in float picked the wrong one
+            const double middle = bounds.min.y + (code(rng) + 0.5) * quantizer.wideStep(1);
+            points[i] = {dist(rng), static_cast<float>(middle)};
+        }
+
+        for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2, Level::NEON})
+        {
+            if (!Fzolv::simd::setLevel(level))
+            {
+                continue;
+            }
+            SCOPED_TRACE(Fzolv::simd::levelName(level));
+            std::vector<std::uint8_t> stream(quantizer.encodedSize(count));
+            Fzolv::batch::encode(quantizer, points, stream);
+            std::vector<Fzolv::Vector2f> decoded(count);
+            Fzolv::batch::decode(quantizer, stream, decoded);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                EXPECT_EQ(decoded[i], quantizer.quantized(points[i])) << i;
+                for (std::size_t k = 0; k < 2; ++k)
+                {
+                    const float value = (&decoded[i].x)[k];
+                    const double error = std::fabs(static_cast<double>(value) - (&points[i].x)[k]);
+                    const double rounding = (std::nextafter(std::fabs(value), INFINITY) - std::fabs(value)) / 2.0;
+                    EXPECT_LE(error, quantizer.wideStep(k) * (0.5 + 1e-6) + rounding) << i;
+                }
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(QuantizeTest, DeltaRebuildsTheSnapshotExactly)
+{
+    const Fzolv::Quantizer2f quantizer{{{-1000.0f, -1000.0f}, {1000.0f, 1000.0f}}, 24};
+    std::mt19937 rng{31};
+    std::uniform_real_distribution<float> dist{-1000.0f, 1000.0f};
+    const std::size_t count = 500;
+    std::vector<Fzolv::Vector2f> before(count);
+    for (auto &p : before)
+    {
+        p = {dist(rng), dist(rng)};
+    }
+    std::vector<Fzolv::Vector2f> after = before;
+    for (std::size_t i = 0; i < count; i += 10)
+    {
+        after[i] += {0.5f, -0.25f};
+    }
+    after[3] = {-1000.0f, 1000.0f};
+
+    std::vector<std::uint8_t> baseline(quantizer.encodedSize(count)), current(quantizer.encodedSize(count));
+    Fzolv::batch::encode(quantizer, before, baseline);
+    Fzolv::batch::encode(quantizer, after, current);
+
+    std::vector<std::uint8_t> delta(Fzolv::batch::maxDeltaSize(quantizer, count));
+    const std::size_t size = Fzolv::batch::encodeDelta(quantizer, baseline, current, delta);
+    EXPECT_LT(size, current.size() / 8);
+
+    std::vector<std::uint8_t> rebuilt(current.size());
+    EXPECT_EQ(Fzolv::batch::decodeDelta(quantizer, baseline, {delta.data(), size}, rebuilt), size);
+    EXPECT_EQ(rebuilt, current);
+
+    EXPECT_EQ(Fzolv::batch::decodeDelta(quantizer, baseline, {delta.data(), size - 1}, rebuilt), 0u);
+    EXPECT_EQ(Fzolv::batch::decodeDelta(quantizer, baseline, {delta.data(), 10}, rebuilt), 0u);
+
+    std::vector<std::uint8_t> unchanged(Fzolv::batch::maxDeltaSize(quantizer, count));
+    EXPECT_EQ(Fzolv::batch::encodeDelta(quantizer, baseline, baseline, unchanged), (count + 7) / 8);
+}
+
+TEST(QuantizeTest, MalformedWordsDecodeTheSameOnEveryLevel)
+{
+    using Fzolv::simd::Level;
+    ///< Index 3 cannot come out of encodeUnitVector, the decode clamps it to 2 on every level
+    const std::vector<std::uint32_t> words{0xC0001234u, 0xFFFFFFFFu, 0xE0000000u, 0xC0000000u, 0x80001234u,
+                                           0x00000000u, 0x7FFFFFFFu, 0xDEADBEEFu, 0xFFFF0000u};
+    std::vector<Fzolv::Vector3f> expected(words.size());
+    for (std::size_t i = 0; i < words.size(); ++i)
+    {
+        expected[i] = Fzolv::decodeUnitVector(words[i]);
+        EXPECT_TRUE(std::isfinite(expected[i].x) && std::isfinite(expected[i].y) && std::isfinite(expected[i].z));
+        if ((words[i] >> 30) == 3u)
+        {
+            EXPECT_EQ(expected[i], Fzolv::decodeUnitVector(words[i] & ~0x40000000u));
+        }
+    }
+
+    for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2, Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<Fzolv::Vector3f> directions(words.size());
+        std::vector<Fzolv::Quaternionf> rotations(words.size());
+        Fzolv::batch::decodeUnitVectors(words, directions);
+        Fzolv::batch::decodeRotations(words, rotations);
+        EXPECT_EQ(directions, expected);
+        for (std::size_t i = 0; i < words.size(); ++i)
+        {
+            EXPECT_EQ(rotations[i], Fzolv::decodeRotation(words[i]));
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(QuantizeTest, SmallestThreeKeepsRotationsAndDirections)
+{
+    std::mt19937 rng{37};
+    std::normal_distribution<float> dist{0.0f, 1.0f};
+    const std::size_t count = 203;
+    std::vector<Fzolv::Quaternionf> rotations(count);
+    std::vector<Fzolv::Vector3f> directions(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        rotations[i] = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+        directions[i] = Fzolv::Vector3f{dist(rng), dist(rng), dist(rng)}.normalized();
+    }
+    rotations[0] = {0.0f, 0.0f, 0.0f, -1.0f};
+    directions[0] = {0.0f, -1.0f, 0.0f};
+
+    std::vector<std::uint32_t> rotationWords(count), directionWords(count);
+    Fzolv::batch::encodeRotations(rotations, rotationWords);
+    Fzolv::batch::encodeUnitVectors(directions, directionWords);
+    std::vector<Fzolv::Quaternionf> rotationsBack(count);
+    std::vector<Fzolv::Vector3f> directionsBack(count);
+    Fzolv::batch::decodeRotations(rotationWords, rotationsBack);
+    Fzolv::batch::decodeUnitVectors(directionWords, directionsBack);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(rotationWords[i], Fzolv::encodeRotation(rotations[i]));
+        EXPECT_EQ(directionWords[i], Fzolv::encodeUnitVector(directions[i]));
+        EXPECT_EQ(rotationsBack[i], Fzolv::decodeRotation(rotationWords[i]));
+        EXPECT_EQ(directionsBack[i], Fzolv::decodeUnitVector(directionWords[i]));
+
+        ///< Both signs describe the same rotation
+        const Fzolv::Quaternionf &q = rotations[i];
+        const Fzolv::Quaternionf &r = rotationsBack[i];
+        const float sign = q.x * r.x + q.y * r.y + q.z * r.z + q.w * r.w < 0.0f ? -1.0f : 1.0f;
+        EXPECT_NEAR(r.x * sign, q.x, 2e-3f);
+        EXPECT_NEAR(r.y * sign, q.y, 2e-3f);
+        EXPECT_NEAR(r.z * sign, q.z, 2e-3f);
+        EXPECT_NEAR(r.w * sign, q.w, 2e-3f);
+
+        EXPECT_NEAR(directionsBack[i].x, directions[i].x, 1e-4f);
+        EXPECT_NEAR(directionsBack[i].y, directions[i].y, 1e-4f);
+        EXPECT_NEAR(directionsBack[i].z, directions[i].z, 1e-4f);
+    }
+    EXPECT_GT(rotationsBack[0].w, 0.9999f);
+    EXPECT_LT(directionsBack[0].y, -0.9999f);
+}
+
+TEST(QuantizeTest, EveryLevelMatchesScalar)
+{
+    using Fzolv::simd::Level;
+    std::mt19937 rng{41};
+    std::uniform_real_distribution<float> dist{-12.0f, 12.0f};
+    const std::size_t count = 97;
+    std::vector<Fzolv::Vector3f> positions(count), directions(count);
+    std::vector<Fzolv::Quaternionf> rotations(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        positions[i] = {dist(rng), dist(rng), dist(rng)};
+        directions[i] = positions[i].normalized();
+        rotations[i] = Fzolv::Quaternionf{dist(rng), dist(rng), dist(rng), dist(rng)}.normalized();
+    }
+    const Fzolv::Quaternionf *constRotations = rotations.data();
+    const Fzolv::Quantizer3f quantizer{{{-10.0f, -10.0f, -10.0f}, {10.0f, 10.0f, 10.0f}}, 13};
+
+    struct Results
+    {
+        std::vector<std::uint8_t> stream;
+        std::vector<Fzolv::Vector3f> decoded, directions;
+        std::vector<std::uint32_t> rotationWords, directionWords;
+        std::vector<Fzolv::Quaternionf> rotations;
+    };
+    auto compute = [&]()
+    {
+        Results r{std::vector<std::uint8_t>(quantizer.encodedSize(count)), std::vector<Fzolv::Vector3f>(count),
+                  std::vector<Fzolv::Vector3f>(count), std::vector<std::uint32_t>(count),
+                  std::vector<std::uint32_t>(count), std::vector<Fzolv::Quaternionf>(count)};
+        Fzolv::batch::encode(quantizer, positions, r.stream);
+        Fzolv::batch::decode(quantizer, r.stream, r.decoded);
+        Fzolv::batch::encodeRotations({constRotations, count}, r.rotationWords);
+        Fzolv::batch::decodeRotations(r.rotationWords, r.rotations);
+        Fzolv::batch::encodeUnitVectors(directions, r.directionWords);
+        Fzolv::batch::decodeUnitVectors(r.directionWords, r.directions);
+        return r;
+    };
+
+    ASSERT_TRUE(Fzolv::simd::setLevel(Level::Scalar));
+    const Results expected = compute();
+    for (Level level : {Level::SSE2, Level::AVX2, Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        const Results r = compute();
+        EXPECT_EQ(r.stream, expected.stream);
+        EXPECT_EQ(r.decoded, expected.decoded);
+        EXPECT_EQ(r.rotationWords, expected.rotationWords);
+        EXPECT_EQ(r.rotations, expected.rotations);
+        EXPECT_EQ(r.directionWords, expected.directionWords);
+        EXPECT_EQ(r.directions, expected.directions);
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(MappedVectorArrayTest, MapsWhatTheWriterProduced)
+{
+    const std::string path = ::testing::TempDir() + "fzolv_mapped_points.bin";
+    std::vector<Fzolv::Vector3f> points(1000);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = {static_cast<float>(i), static_cast<float>(i) * 0.5f, -static_cast<float>(i)};
+    }
+    Fzolv::writeVectorArray(path, points);
+
+    Fzolv::MappedVector3fArray mapped{path};
+    ASSERT_TRUE(mapped.isOpen());
+    ASSERT_EQ(mapped.size(), points.size());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(mapped.data()) % 64, 0u);
+    EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), points.begin()));
+
+    Fzolv::MappedVector3fArray moved{std::move(mapped)};
+    EXPECT_FALSE(mapped.isOpen());
+    EXPECT_EQ(moved[999], points[999]);
+    moved.close();
+    EXPECT_TRUE(moved.empty());
+
+    Fzolv::writeVectorArray(path, Fzolv::span<const Fzolv::Vector3f>{});
+    EXPECT_TRUE(Fzolv::MappedVector3fArray{path}.empty());
+    std::remove(path.c_str());
+}
+
+TEST(MappedVectorArrayTest, RejectsFilesOfAnotherFormat)
+{
+    const std::string path = ::testing::TempDir() + "fzolv_mapped_invalid.bin";
+    const std::vector<Fzolv::Vector2f> points{{1.0f, 2.0f}, {3.0f, 4.0f}};
+    Fzolv::writeVectorArray(path, points);
+
+    EXPECT_THROW(Fzolv::MappedVector3fArray{path}, Fzolv::MappedFileError);
+    EXPECT_THROW(Fzolv::MappedVectorArray<Fzolv::Vector2<double>>{path}, Fzolv::MappedFileError);
+    {
+        const Fzolv::MappedVector2fArray mapped{path};
+        EXPECT_EQ(mapped[1], points[1]);
+        std::vector<float> lengths(mapped.size());
+        Fzolv::batch::lengthSquared(mapped, lengths);
+        EXPECT_EQ(lengths[1], 25.0f);
+    }
+
+    auto patch = [&path](long offset, const void *bytes, std::size_t size)
+    {
+        std::FILE *file = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(file, nullptr);
+        std::fseek(file, offset, SEEK_SET);
+        std::fwrite(bytes, size, 1, file);
+        std::fclose(file);
+    };
+    const std::uint64_t tooMany = 3;
+    patch(offsetof(Fzolv::MappedFileHeader, count), &tooMany, sizeof(tooMany));
+    EXPECT_THROW(Fzolv::MappedVector2fArray{path}, Fzolv::MappedFileError);
+
+    const std::uint32_t swapped = 0x04030201U;
+    patch(offsetof(Fzolv::MappedFileHeader, byteOrder), &swapped, sizeof(swapped));
+    EXPECT_THROW(Fzolv::MappedVector2fArray{path}, Fzolv::MappedFileError);
+
+    patch(0, "XXXX", 4);
+    EXPECT_THROW(Fzolv::MappedVector2fArray{path}, Fzolv::MappedFileError);
+    std::remove(path.c_str());
+    EXPECT_THROW(Fzolv::MappedVector2fArray{path}, Fzolv::MappedFileError);
+}
+
+TEST(HalfTest, ConvertsLikeIeeeBinary16)
+{
+    EXPECT_EQ(Fzolv::Half{1.0f}.toBits(), 0x3C00u);
+    EXPECT_EQ(Fzolv::Half{-2.0f}.toBits(), 0xC000u);
+    EXPECT_EQ(Fzolv::Half{65504.0f}.toBits(), 0x7BFFu);
+    EXPECT_EQ(Fzolv::Half{65520.0f}.toBits(), 0x7C00u); ///< Halfway to the next binade rounds to infinity
+    EXPECT_EQ(Fzolv::Half{std::ldexp(1.0f, -24)}.toBits(), 0x0001u);
+    EXPECT_EQ(Fzolv::Half{std::ldexp(1.0f, -25)}.toBits(), 0x0000u); ///< Ties go to even
+    EXPECT_EQ(Fzolv::Half{std::ldexp(3.0f, -25)}.toBits(), 0x0002u);
+    EXPECT_EQ(Fzolv::Half{1.0f + std::ldexp(1.0f, -11)}.toBits(), 0x3C00u);
+    EXPECT_EQ(Fzolv::Half{1.0f + std::ldexp(3.0f, -11)}.toBits(), 0x3C02u);
+    EXPECT_EQ(Fzolv::Half{-0.0f}.toBits(), 0x8000u);
+    EXPECT_EQ(static_cast<float>(Fzolv::Half::FromBits(0x3555)), 0.333251953125f);
+    EXPECT_TRUE(std::isnan(static_cast<float>(Fzolv::Half{std::nanf("")})));
+
+    const Fzolv::Vector3h packed{Fzolv::Vector3f{0.5f, -1.25f, 1024.0f}};
+    const Fzolv::Vector3f widened = packed;
+    EXPECT_EQ(widened, (Fzolv::Vector3f{0.5f, -1.25f, 1024.0f}));
+    const Fzolv::Vector2f sum = Fzolv::Vector2f{Fzolv::Vector2h{Fzolv::Vector2f{1.5f, 2.0f}}} + Fzolv::Vector2f{1.0f, 1.0f};
+    EXPECT_EQ(sum, (Fzolv::Vector2f{2.5f, 3.0f}));
+
+    ///< Every finite half and every quiet NaN survives the round trip through float
+    for (std::uint32_t bits = 0; bits <= 0xFFFFu; ++bits)
+    {
+        const auto half = Fzolv::Half::FromBits(static_cast<std::uint16_t>(bits));
+        const bool signaling = (bits & 0x7C00u) == 0x7C00u && (bits & 0x3FFu) != 0 && (bits & 0x200u) == 0;
+        if (!signaling)
+        {
+            ASSERT_EQ(Fzolv::Half{static_cast<float>(half)}.toBits(), bits);
+        }
+    }
+}
+
+TEST(HalfTest, EveryLevelMatchesScalar)
+{
+    using Fzolv::simd::Level;
+    std::vector<Fzolv::Half> halves(0x10000);
+    for (std::uint32_t bits = 0; bits <= 0xFFFFu; ++bits)
+    {
+        halves[bits] = Fzolv::Half::FromBits(static_cast<std::uint16_t>(bits));
+    }
+    std::vector<float> floats{0.0f, -0.0f, 65504.0f, 65519.99f, 65520.0f, 1e9f, -1e9f, std::ldexp(1.0f, -25),
+                              std::ldexp(3.0f, -25), std::ldexp(1.0f, -14), std::ldexp(1023.5f, -24), 1e-30f,
+                              std::numeric_limits<float>::infinity(), std::numeric_limits<float>::denorm_min()};
+    for (std::uint32_t payload : {0x7FC00000u, 0xFF800001u, 0x7F802000u, 0x7FFFFFFFu})
+    {
+        float nan;
+        std::memcpy(&nan, &payload, sizeof(nan));
+        floats.push_back(nan);
+    }
+    std::mt19937 rng{43};
+    std::uniform_int_distribution<std::uint32_t> bitDist;
+    while (floats.size() < 4099)
+    {
+        const std::uint32_t bits = bitDist(rng);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        floats.push_back(value);
+    }
+    std::vector<Fzolv::Vector3f> vectors(floats.size() / 3);
+    std::memcpy(static_cast<void *>(vectors.data()), floats.data(), vectors.size() * sizeof(Fzolv::Vector3f));
+
+    ///< Compared as bytes, NaNs never compare equal as floats
+    auto bitsOf = [](const auto &values)
+    {
+        std::vector<std::uint8_t> bytes(values.size() * sizeof(values[0]));
+        std::memcpy(bytes.data(), values.data(), bytes.size());
+        return bytes;
+    };
+    auto compute = [&]()
+    {
+        std::vector<float> widened(halves.size());
+        std::vector<Fzolv::Half> narrowed(floats.size());
+        std::vector<Fzolv::Vector3h> packed(vectors.size());
+        std::vector<Fzolv::Vector3f> unpacked(vectors.size());
+        Fzolv::batch::toFloat(halves, widened);
+        Fzolv::batch::toHalf(floats, narrowed);
+        Fzolv::batch::toHalf(vectors, packed);
+        Fzolv::batch::toFloat(packed, unpacked);
+        return std::make_tuple(bitsOf(widened), bitsOf(narrowed), bitsOf(unpacked));
+    };
+
+    ASSERT_TRUE(Fzolv::simd::setLevel(Level::Scalar));
+    const auto expected = compute();
+    for (std::size_t i = 0; i < floats.size(); ++i)
+    {
+        std::uint16_t bits;
+        std::memcpy(&bits, &std::get<1>(expected)[2 * i], sizeof(bits));
+        ASSERT_EQ(bits, Fzolv::Half{floats[i]}.toBits());
+    }
+    for (Level level : {Level::SSE2, Level::AVX2, Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        const auto r = compute();
+        EXPECT_EQ(std::get<0>(r), std::get<0>(expected));
+        EXPECT_EQ(std::get<1>(r), std::get<1>(expected));
+        EXPECT_EQ(std::get<2>(r), std::get<2>(expected));
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(BatchRoundingTest, MatchesTheMemberFunctions)
+{
+    std::vector<Fzolv::Vector2f> values{{3.7f, 5.2f},    {-3.7f, -5.2f}, {2.5f, -2.5f},       {-0.0f, -0.3f},
+                                        {0.5f, 0.49999997f}, {8388607.5f, -8388607.5f}, {1e20f, -16777217.0f},
+                                        {std::nanf(""), std::numeric_limits<float>::infinity()}};
+    std::mt19937 rng{47};
+    std::uniform_real_distribution<float> dist{-1000.0f, 1000.0f};
+    while (values.size() < 203)
+    {
+        values.push_back({dist(rng), std::ldexp(dist(rng), -12)});
+    }
+
+    auto bytesOf = [](const auto &v)
+    {
+        std::vector<std::uint8_t> bytes(v.size() * sizeof(v[0]));
+        std::memcpy(bytes.data(), v.data(), bytes.size());
+        return bytes;
+    };
+    std::vector<Fzolv::Vector2f> floors(values.size()), ceils(values.size()), rounds(values.size());
+    std::vector<Fzolv::Vector2f> expectedFloors(values.size()), expectedCeils(values.size()), expectedRounds(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        expectedFloors[i] = Fzolv::Vector2f{values[i]}.floor();
+        expectedCeils[i] = Fzolv::Vector2f{values[i]}.ceil();
+        expectedRounds[i] = Fzolv::Vector2f{values[i]}.round();
+    }
+    EXPECT_EQ(expectedRounds[2], (Fzolv::Vector2f{3.0f, -3.0f}));
+
+    const std::vector<Fzolv::Vector2f> positions{{0.0f, -0.1f}, {31.9f, 32.0f}, {-64.0f, 1e12f}, {std::nanf(""), 95.99f}};
+    const std::vector<Fzolv::Vector2i> expectedCells{{0, -1}, {0, 1}, {-2, INT_MIN}, {INT_MIN, 2}};
+    ///< The random values only, the special ones have no int cell
+    std::vector<Fzolv::Vector2f> grid(values.begin() + 8, values.end());
+    std::vector<Fzolv::Vector2i> expectedGrid(grid.size());
+    for (std::size_t i = 0; i < grid.size(); ++i)
+    {
+        expectedGrid[i] = {static_cast<int>(std::floor(grid[i].x / 1.5f)), static_cast<int>(std::floor(grid[i].y / 0.25f))};
+    }
+
+    for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                       Fzolv::simd::Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        Fzolv::batch::floor(values, floors);
+        Fzolv::batch::ceil(values, ceils);
+        rounds = values;
+        Fzolv::batch::round(rounds);
+        EXPECT_EQ(bytesOf(floors), bytesOf(expectedFloors));
+        EXPECT_EQ(bytesOf(ceils), bytesOf(expectedCeils));
+        EXPECT_EQ(bytesOf(rounds), bytesOf(expectedRounds));
+
+        std::vector<Fzolv::Vector2i> cells(positions.size());
+        Fzolv::batch::snapToGrid(positions, 32.0f, cells);
+        EXPECT_EQ(cells, expectedCells);
+        std::vector<Fzolv::Vector2i> gridCells(grid.size());
+        Fzolv::batch::snapToGrid(grid, Fzolv::Vector2f{1.5f, 0.25f}, gridCells);
+        EXPECT_EQ(gridCells, expectedGrid);
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(BatchClampTest, EveryLevelMatchesTheScalarFunctions)
+{
+    const float nan = std::nanf("");
+    std::vector<Fzolv::Vector3f> values{{-5.0f, 0.5f, 5.0f}, {nan, -0.0f, 0.0f},
+                                        {std::numeric_limits<float>::infinity(), -2.0f, 2.0f}};
+    std::mt19937 rng{53};
+    std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+    while (values.size() < 157)
+    {
+        values.push_back({dist(rng), dist(rng), dist(rng)});
+    }
+    std::vector<Fzolv::Vector3f> others(values.rbegin(), values.rend());
+    std::vector<Fzolv::Vector2f> flat(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        flat[i] = {values[i].x, values[i].y};
+    }
+
+    auto bytesOf = [](const auto &v)
+    {
+        std::vector<std::uint8_t> bytes(v.size() * sizeof(v[0]));
+        std::memcpy(bytes.data(), v.data(), bytes.size());
+        return bytes;
+    };
+    const Fzolv::Vector3f low{-1.0f, 0.0f, -3.0f}, high{1.0f, 0.0f, 2.5f};
+    const Fzolv::Vector2f flatLow{-0.5f, -2.0f}, flatHigh{3.0f, 1.0f};
+    std::vector<Fzolv::Vector3f> expectedClamp(values.size()), expectedMin(values.size()), expectedMax(values.size()),
+        expectedAbs(values.size());
+    std::vector<Fzolv::Vector2f> expectedFlat(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        expectedClamp[i] = Fzolv::Vector3f::clamp(values[i], low, high);
+        expectedMin[i] = {std::min(values[i].x, others[i].x), std::min(values[i].y, others[i].y),
+                          std::min(values[i].z, others[i].z)};
+        expectedMax[i] = {std::max(values[i].x, others[i].x), std::max(values[i].y, others[i].y),
+                          std::max(values[i].z, others[i].z)};
+        expectedAbs[i] = {std::fabs(values[i].x), std::fabs(values[i].y), std::fabs(values[i].z)};
+        expectedFlat[i] = Fzolv::Vector2f::clamp(flat[i], flatLow, flatHigh);
+    }
+    EXPECT_EQ(expectedClamp[0], (Fzolv::Vector3f{-1.0f, 0.0f, 2.5f}));
+
+    for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                       Fzolv::simd::Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<Fzolv::Vector3f> out(values.size());
+        Fzolv::batch::clamp(values, low, high, out);
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedClamp));
+        Fzolv::batch::min(values, others, out);
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedMin));
+        Fzolv::batch::max(values, others, out);
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedMax));
+        Fzolv::batch::abs(values, out);
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedAbs));
+
+        std::vector<Fzolv::Vector2f> clamped = flat;
+        Fzolv::batch::clamp(clamped, flatLow, flatHigh);
+        EXPECT_EQ(bytesOf(clamped), bytesOf(expectedFlat));
+
+        Fzolv::Vector3fSoA soa, soaOthers, soaOut;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            soa.push_back(values[i]);
+            soaOthers.push_back(others[i]);
+        }
+        Fzolv::batch::min(soa, soaOthers, soaOut);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            out[i] = soaOut[i];
+        }
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedMin));
+        Fzolv::batch::clamp(soa, low, high);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            out[i] = soa[i];
+        }
+        EXPECT_EQ(bytesOf(out), bytesOf(expectedClamp));
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(ProfileTest, CountsZonesOverThreadsAndCallsTheHooks)
+{
+    struct Trace
+    {
+        std::atomic<int> begins{0};
+        std::atomic<int> ends{0};
+        std::atomic<std::size_t> elements{0};
+    } trace;
+    Fzolv::profile::ZoneHooks hooks;
+    hooks.begin = [](const char *, std::size_t elements, void *user)
+    {
+        ++static_cast<Trace *>(user)->begins;
+        static_cast<Trace *>(user)->elements += elements;
+    };
+    hooks.end = [](const char *, void *user) { ++static_cast<Trace *>(user)->ends; };
+    hooks.user = &trace;
+
+    const std::vector<Fzolv::Vector2f> lhs(1000, {1.0f, 2.0f}), rhs(1000, {3.0f, 4.0f});
+    std::vector<float> dots(lhs.size());
+    Fzolv::SpatialHash2D<float> grid{1.0f};
+    Fzolv::profile::reset();
+    Fzolv::profile::setZoneHooks(&hooks);
+    Fzolv::batch::dot(lhs, rhs, dots);
+    std::thread worker{[&]() { Fzolv::batch::dot(lhs, rhs, dots); }};
+    worker.join();
+    grid.build(lhs);
+    Fzolv::profile::setZoneHooks(nullptr);
+
+    const auto stats = Fzolv::profile::snapshot();
+    if constexpr (!Fzolv::profile::enabled)
+    {
+        EXPECT_TRUE(stats.empty());
+        EXPECT_EQ(trace.begins.load(), 0);
+        return;
+    }
+    auto find = [&](const std::string &name) -> Fzolv::profile::KernelStats
+    {
+        for (const auto &entry : stats)
+        {
+            if (entry.name == name)
+            {
+                return entry;
+            }
+        }
+        return {};
+    };
+    ///< The worker thread has exited, its counters must still be part of the totals
+    EXPECT_EQ(find("batch::dot").calls, 2u);
+    EXPECT_EQ(find("batch::dot").elements, 2000u);
+    EXPECT_EQ(find("SpatialHash2D::build").calls, 1u);
+    EXPECT_EQ(find("SpatialHash2D::build").elements, 1000u);
+    EXPECT_EQ(trace.begins.load(), 3);
+    EXPECT_EQ(trace.ends.load(), 3);
+    EXPECT_EQ(trace.elements.load(), 3000u);
+
+    Fzolv::profile::reset();
+    EXPECT_TRUE(Fzolv::profile::snapshot().empty());
+}
+
+TEST(SwizzleTest, PermutesComponentsAtCompileTime)
+{
+    constexpr Fzolv::Vector2i flat{1, 2};
+    static_assert(flat.yx() == Fzolv::Vector2i{2, 1}, "swizzles of the scalar vectors are constant expressions");
+    static_assert(flat.swizzle<1, 0, 1>() == Fzolv::Vector3i{2, 1, 2}, "");
+    EXPECT_EQ(flat.xx(), (Fzolv::Vector2i{1, 1}));
+    EXPECT_EQ(flat.yy(), (Fzolv::Vector2i{2, 2}));
+
+    const Fzolv::Vector3f v{1.0f, 2.0f, 3.0f};
+    EXPECT_EQ(v.xz(), (Fzolv::Vector2f{1.0f, 3.0f}));
+    EXPECT_EQ(v.zyx(), (Fzolv::Vector3f{3.0f, 2.0f, 1.0f}));
+    EXPECT_EQ(v.yzx().zxy(), v);
+    EXPECT_EQ((v.swizzle<2, 2, 0, 1>()), (Fzolv::Vector4f{3.0f, 3.0f, 1.0f, 2.0f}));
+
+    ///< The SIMD-backed types shuffle their register and must agree with the component path
+    const Fzolv::Vector3Af a{1.0f, 2.0f, 3.0f};
+    const Fzolv::Vector3Af rotated = a.yzx();
+    EXPECT_EQ(Fzolv::Vector3f{rotated}, v.yzx());
+    EXPECT_EQ(rotated.w, 0.0f);
+    EXPECT_EQ(Fzolv::Vector3f{a.zxy()}, v.zxy());
+    EXPECT_EQ((a.swizzle<0, 0, 1, 2>()), (Fzolv::Vector4f{1.0f, 1.0f, 2.0f, 3.0f}));
+    EXPECT_EQ(a.xy(), (Fzolv::Vector2f{1.0f, 2.0f}));
+
+    const Fzolv::Vector4f q{1.0f, 2.0f, 3.0f, 4.0f};
+    EXPECT_EQ(q.wzyx(), (Fzolv::Vector4f{4.0f, 3.0f, 2.0f, 1.0f}));
+    EXPECT_EQ((q.swizzle<1, 1, 3, 0>()), (Fzolv::Vector4f{2.0f, 2.0f, 4.0f, 1.0f}));
+    EXPECT_EQ((q.swizzle<3, 0, 2>()), (Fzolv::Vector3f{4.0f, 1.0f, 3.0f}));
+    EXPECT_EQ(q.xy(), (Fzolv::Vector2f{1.0f, 2.0f}));
+    EXPECT_EQ((Fzolv::Vector4i{1, 2, 3, 4}.swizzle<3, 2, 1, 0>()), (Fzolv::Vector4i{4, 3, 2, 1}));
+}
+
+TEST(GeometryTest, PrimitivesReportTheRayParameter)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const Fzolv::Ray2f ray = Fzolv::Ray2f::FromPoints({0.0f, 0.0f}, {4.0f, 0.0f});
+    EXPECT_EQ(ray.pointAt(0.5f), (Fzolv::Vector2f{2.0f, 0.0f}));
+    EXPECT_FLOAT_EQ(ray.intersect(Fzolv::Segment2f{{2.0f, -1.0f}, {2.0f, 1.0f}}), 0.5f);
+    EXPECT_FLOAT_EQ(ray.intersect(Fzolv::Segment2f{{8.0f, 0.0f}, {8.0f, 1.0f}}), 2.0f);
+    EXPECT_EQ(ray.intersect(Fzolv::Segment2f{{-2.0f, -1.0f}, {-2.0f, 1.0f}}), inf);
+    EXPECT_EQ(ray.intersect(Fzolv::Segment2f{{2.0f, 0.5f}, {2.0f, 1.0f}}), inf);
+    EXPECT_EQ(ray.intersect(Fzolv::Segment2f{{1.0f, 0.0f}, {3.0f, 0.0f}}), inf);
+
+    EXPECT_FLOAT_EQ(ray.intersect(Fzolv::Circlef{{3.0f, 0.0f}, 1.0f}), 0.5f);
+    EXPECT_EQ(ray.intersect(Fzolv::Circlef{{0.0f, 0.5f}, 1.0f}), 0.0f);
+    EXPECT_EQ(ray.intersect(Fzolv::Circlef{{-3.0f, 0.0f}, 1.0f}), inf);
+    EXPECT_EQ(ray.intersect(Fzolv::Circlef{{2.0f, 3.0f}, 1.0f}), inf);
+
+    ///< A ray that does not move hits a circle only from inside, also when its squared length underflows
+    const Fzolv::Circlef unit{{0.0f, 0.0f}, 1.0f};
+    EXPECT_EQ((Fzolv::Ray2f{{0.5f, 0.0f}, {0.0f, 0.0f}}.intersect(unit)), 0.0f);
+    EXPECT_EQ((Fzolv::Ray2f{{1.0f, 0.0f}, {0.0f, 0.0f}}.intersect(unit)), 0.0f);
+    EXPECT_EQ((Fzolv::Ray2f{{3.0f, 0.0f}, {0.0f, 0.0f}}.intersect(unit)), inf);
+    EXPECT_EQ((Fzolv::Ray2f{{0.5f, 0.0f}, {1e-30f, 0.0f}}.intersect(unit)), 0.0f);
+    EXPECT_EQ((Fzolv::Ray2f{{3.0f, 0.0f}, {-1e-30f, 0.0f}}.intersect(unit)), inf);
+
+    const Fzolv::Segment2f segment{{0.0f, 0.0f}, {2.0f, 0.0f}};
+    EXPECT_EQ(segment.closestPoint({1.0f, 3.0f}), (Fzolv::Vector2f{1.0f, 0.0f}));
+    EXPECT_EQ(segment.closestPoint({-1.0f, 1.0f}), (Fzolv::Vector2f{0.0f, 0.0f}));
+    EXPECT_FLOAT_EQ(segment.distanceSquared({3.0f, 1.0f}), 2.0f);
+    EXPECT_FLOAT_EQ(segment.length(), 2.0f);
+    EXPECT_TRUE(segment.intersects({{1.0f, -1.0f}, {1.0f, 1.0f}}));
+    EXPECT_FALSE(segment.intersects({{3.0f, -1.0f}, {3.0f, 1.0f}}));
+
+    const Fzolv::Circlef circle{{0.0f, 0.0f}, 1.0f};
+    EXPECT_TRUE(circle.contains({0.6f, 0.8f}));
+    EXPECT_FALSE(circle.contains({1.0f, 1.0f}));
+    EXPECT_TRUE(circle.overlaps(Fzolv::Circlef{{1.5f, 0.0f}, 0.5f}));
+    EXPECT_TRUE(circle.overlaps(Fzolv::Segment2f{{-2.0f, 0.5f}, {2.0f, 0.5f}}));
+    EXPECT_EQ(circle.bounds(), (Fzolv::AABB2f{{-1.0f, -1.0f}, {1.0f, 1.0f}}));
+
+    const Fzolv::Planef plane = Fzolv::Planef::FromPoints({0.0f, 0.0f, 2.0f}, {1.0f, 0.0f, 2.0f}, {0.0f, 1.0f, 2.0f});
+    EXPECT_EQ(plane.normal, (Fzolv::Vector3f{0.0f, 0.0f, 1.0f}));
+    EXPECT_FLOAT_EQ(plane.distance, 2.0f);
+    EXPECT_FLOAT_EQ(plane.signedDistance({5.0f, 5.0f, -1.0f}), -3.0f);
+    EXPECT_EQ(plane.project({5.0f, 5.0f, -1.0f}), (Fzolv::Vector3f{5.0f, 5.0f, 2.0f}));
+
+    const Fzolv::Ray3f down{{1.0f, 1.0f, 6.0f}, {0.0f, 0.0f, -2.0f}};
+    EXPECT_FLOAT_EQ(down.intersect(plane), 2.0f);
+    EXPECT_EQ(down.pointAt(down.intersect(plane)), (Fzolv::Vector3f{1.0f, 1.0f, 2.0f}));
+    EXPECT_EQ((Fzolv::Ray3f{{0.0f, 0.0f, 6.0f}, {1.0f, 0.0f, 0.0f}}.intersect(plane)), inf);
+    EXPECT_EQ((Fzolv::Ray3f{{0.0f, 0.0f, 6.0f}, {0.0f, 0.0f, 1.0f}}.intersect(plane)), inf);
+    const Fzolv::AABB3f box{{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+    EXPECT_FLOAT_EQ(down.intersect(box), 2.5f);
+    EXPECT_EQ((Fzolv::Ray3f{{0.5f, 0.5f, 0.5f}, {1.0f, 0.0f, 0.0f}}.intersect(box)), 0.0f);
+    EXPECT_EQ((Fzolv::Ray3f{{2.0f, 0.5f, 6.0f}, {0.0f, 0.0f, -1.0f}}.intersect(box)), inf);
+}
+
+TEST(GeometryTest, BatchIntersectionMatchesTheScalarPrimitivesOnEveryLevel)
+{
+    std::mt19937 rng{61};
+    std::uniform_real_distribution<float> dist{-8.0f, 8.0f};
+    std::vector<Fzolv::Segment2f> segments{{{21.0f, 19.0f}, {21.0f, 21.0f}}, {{20.0f, 20.0f}, {22.0f, 20.0f}},
+                                           {{23.0f, 23.0f}, {23.0f, 23.0f}}, {{21.0f, 21.0f}, {21.0f, 19.0f}}};
+    while (segments.size() < 203)
+    {
+        segments.push_back({{dist(rng), dist(rng)}, {dist(rng), dist(rng)}});
+    }
+    std::vector<Fzolv::Ray2f> rays{{{20.0f, 20.0f}, {1.0f, 0.0f}}, {{0.0f, 0.0f}, {0.0f, 0.0f}},
+                                   {{20.5f, 20.0f}, {0.0f, 1.0f}},  {{5.0f, 0.0f}, {0.0f, 0.0f}},
+                                   {{0.0f, 0.0f}, {1e-30f, 0.0f}},  {{5.0f, 0.0f}, {-1e-30f, 0.0f}}};
+    while (rays.size() < 149)
+    {
+        rays.push_back({{dist(rng), dist(rng)}, {dist(rng), dist(rng)}});
+    }
+    const Fzolv::Ray2f ray{{-6.0f, 0.5f}, {1.0f, 0.25f}};
+    const Fzolv::Circlef circle{{0.5f, 0.0f}, 2.0f};
+
+    auto bytesOf = [](const auto &v)
+    {
+        std::vector<std::uint8_t> bytes(v.size() * sizeof(v[0]));
+        std::memcpy(bytes.data(), v.data(), bytes.size());
+        return bytes;
+    };
+    std::vector<float> expectedSegments(segments.size()), expectedCircle(rays.size()), expectedClosest(rays.size());
+    std::vector<std::uint64_t> expectedSegmentMask(Fzolv::batch::maskWords(segments.size()));
+    std::vector<std::uint64_t> expectedCircleMask(Fzolv::batch::maskWords(rays.size()));
+    std::vector<std::uint32_t> expectedIndices(rays.size(), Fzolv::batch::noHit);
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+        expectedSegments[i] = ray.intersect(segments[i]);
+        if (expectedSegments[i] < std::numeric_limits<float>::infinity())
+        {
+            expectedSegmentMask[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+    for (std::size_t r = 0; r < rays.size(); ++r)
+    {
+        expectedCircle[r] = rays[r].intersect(circle);
+        if (expectedCircle[r] < std::numeric_limits<float>::infinity())
+        {
+            expectedCircleMask[r / 64] |= std::uint64_t{1} << (r % 64);
+        }
+        expectedClosest[r] = std::numeric_limits<float>::infinity();
+        for (std::size_t i = 0; i < segments.size(); ++i)
+        {
+            const float t = rays[r].intersect(segments[i]);
+            if (t < expectedClosest[r])
+            {
+                expectedClosest[r] = t;
+                expectedIndices[r] = static_cast<std::uint32_t>(i);
+            }
+        }
+    }
+    EXPECT_EQ(expectedIndices[0], 0U);
+    EXPECT_EQ(expectedClosest[0], rays[0].intersect(segments[3]));
+    EXPECT_EQ(expectedIndices[1], Fzolv::batch::noHit);
+    EXPECT_EQ(expectedIndices[2], 1U);
+    EXPECT_EQ(expectedClosest[2], 0.0f);
+    EXPECT_EQ(expectedCircle[1], 0.0f);
+    EXPECT_EQ(expectedCircle[3], std::numeric_limits<float>::infinity());
+    EXPECT_EQ(expectedCircle[4], 0.0f);
+    EXPECT_EQ(expectedCircle[5], std::numeric_limits<float>::infinity());
+
+    for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                       Fzolv::simd::Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<std::uint64_t> segmentMask(expectedSegmentMask.size(), ~std::uint64_t{0});
+        std::vector<float> distances(segments.size());
+        Fzolv::batch::intersect(ray, segments, segmentMask, distances);
+        EXPECT_EQ(segmentMask, expectedSegmentMask);
+        EXPECT_EQ(bytesOf(distances), bytesOf(expectedSegments));
+
+        std::vector<std::uint64_t> circleMask(expectedCircleMask.size(), ~std::uint64_t{0});
+        distances.assign(rays.size(), 0.0f);
+        Fzolv::batch::intersect(rays, circle, circleMask, distances);
+        EXPECT_EQ(circleMask, expectedCircleMask);
+        EXPECT_EQ(bytesOf(distances), bytesOf(expectedCircle));
+
+        for (std::size_t used : {std::size_t{0}, std::size_t{5}, segments.size()})
+        {
+            std::vector<std::uint32_t> indices(rays.size());
+            Fzolv::span<const Fzolv::Segment2f> subset{segments.data(), used};
+            Fzolv::batch::closestHits(rays, subset, distances, indices);
+            for (std::size_t r = 0; r < rays.size(); ++r)
+            {
+                float nearest = std::numeric_limits<float>::infinity();
+                std::uint32_t index = Fzolv::batch::noHit;
+                for (std::size_t i = 0; i < used; ++i)
+                {
+                    const float t = rays[r].intersect(segments[i]);
+                    if (t < nearest)
+                    {
+                        nearest = t;
+                        index = static_cast<std::uint32_t>(i);
+                    }
+                }
+                ASSERT_EQ(indices[r], index) << "ray " << r << " against " << used;
+                ASSERT_EQ(std::memcmp(&distances[r], &nearest, sizeof(float)), 0) << "ray " << r;
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(GeometryTest, BatchIntersectionAcceptsEmptySpansOnEveryLevel)
+{
+    const std::vector<Fzolv::Ray2f> rays = {{{0.0f, 0.0f}, {1.0f, 0.0f}}, {{2.0f, 1.0f}, {0.0f, -1.0f}}};
+    const Fzolv::span<const Fzolv::Segment2f> noSegments{};
+    const Fzolv::span<const Fzolv::Ray2f> noRays{};
+    const Fzolv::Circlef circle{{4.0f, 0.0f}, 1.0f};
+    for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                       Fzolv::simd::Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        Fzolv::batch::intersect(rays[0], noSegments, Fzolv::span<std::uint64_t>{}, Fzolv::span<float>{});
+        Fzolv::batch::intersect(noRays, circle, Fzolv::span<std::uint64_t>{}, Fzolv::span<float>{});
+
+        ///< Rays against no walls at all miss, without reading the segments
+        std::vector<float> distances(rays.size(), 0.0f);
+        std::vector<std::uint32_t> indices(rays.size(), 0U);
+        Fzolv::batch::closestHits(rays, noSegments, distances, indices);
+        for (std::size_t r = 0; r < rays.size(); ++r)
+        {
+            EXPECT_EQ(distances[r], std::numeric_limits<float>::infinity());
+            EXPECT_EQ(indices[r], Fzolv::batch::noHit);
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+#if __cplusplus >= 202002L
+static_assert(Fzolv::VectorLike<Fzolv::Vector3Af> && !Fzolv::VectorLike<float>);
+static_assert(Fzolv::ContiguousVectorRange<std::vector<Fzolv::Vector2f>>);
+static_assert(Fzolv::ContiguousVectorRange<std::array<Fzolv::Vector3f, 4>>);
+static_assert(Fzolv::ContiguousVectorRange<Fzolv::span<const Fzolv::Vector2f>>);
+static_assert(Fzolv::ContiguousVectorRange<std::pmr::vector<Fzolv::Vector4f>>);
+static_assert(Fzolv::IndexedVectorRange<Fzolv::Vector2fSoA> && !Fzolv::ContiguousVectorRange<Fzolv::Vector2fSoA>);
+static_assert(!Fzolv::ContiguousVectorRange<std::vector<float>>);
+
+TEST(RangesTest, PipelinesAreLazyAndEvaluateInOneFusedPass)
+{
+    const Fzolv::Matrix4f m = Fzolv::Matrix4f::FromRows({2.0f, 0.5f, -1.0f, 3.0f}, {0.25f, 1.5f, 2.0f, -2.0f},
+                                                        {1.0f, -3.0f, 4.0f, 0.5f}, {0.0f, 0.0f, 0.0f, 1.0f});
+    const Fzolv::Vector2f low{-0.75f, -0.5f}, high{0.5f, 0.75f};
+    std::mt19937 rng{67};
+    std::uniform_real_distribution<float> dist{-4.0f, 4.0f};
+    std::vector<Fzolv::Vector2f> values{Fzolv::Vector2f::Zero()};
+    while (values.size() < 1001)
+    {
+        values.push_back({dist(rng), dist(rng)});
+    }
+
+    auto pipeline =
+        values | Fzolv::views::normalized() | Fzolv::views::clamped(low, high) | Fzolv::views::transformed(m);
+    static_assert(std::ranges::view<decltype(pipeline)> && std::ranges::random_access_range<decltype(pipeline)>);
+    ASSERT_EQ(pipeline.size(), values.size());
+
+    std::vector<Fzolv::Vector2f> expected;
+    for (const Fzolv::Vector2f &value : values)
+    {
+        const Fzolv::Vector3f point = m.transformPoint({Fzolv::Vector2f::clamp(value.normalized(), low, high), 0.0f});
+        expected.push_back({point.x, point.y});
+    }
+    EXPECT_TRUE(std::ranges::equal(pipeline, expected));
+    EXPECT_EQ(pipeline[7], expected[7]);
+
+    auto bytesOf = [](const auto &v)
+    {
+        std::vector<std::uint8_t> bytes(v.size() * sizeof(v[0]));
+        std::memcpy(bytes.data(), v.data(), bytes.size());
+        return bytes;
+    };
+    for (auto level : {Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2, Fzolv::simd::Level::AVX2,
+                       Fzolv::simd::Level::NEON})
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<Fzolv::Vector2f> out(values.size());
+        Fzolv::batch::evaluate(pipeline, out);
+        EXPECT_EQ(bytesOf(out), bytesOf(expected));
+
+        std::vector<Fzolv::Vector2f> inPlace = values;
+        Fzolv::batch::evaluate(inPlace | Fzolv::views::normalized() | Fzolv::views::clamped(low, high) |
+                                   Fzolv::views::transformed(m),
+                               inPlace);
+        EXPECT_EQ(bytesOf(inPlace), bytesOf(expected));
+    }
+    Fzolv::simd::resetLevel();
+
+    Fzolv::Vector3fSoA soa;
+    std::array<Fzolv::Vector3f, 300> points{};
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        points[i] = {dist(rng), dist(rng), dist(rng)};
+        soa.push_back(points[i]);
+    }
+    const Fzolv::Vector3f boxLow{-1.0f, -2.0f, -3.0f}, boxHigh{1.0f, 2.0f, 3.0f};
+    std::vector<Fzolv::Vector3f> fromArray(points.size()), fromSoa(points.size());
+    Fzolv::batch::evaluate(points | Fzolv::views::transformedDirections(m) | Fzolv::views::clamped(boxLow, boxHigh),
+                           fromArray);
+    Fzolv::batch::evaluate(soa | Fzolv::views::transformedDirections(m) | Fzolv::views::clamped(boxLow, boxHigh),
+                           fromSoa);
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const Fzolv::Vector3f direction = Fzolv::Vector3f::clamp(m.transformDirection(points[i]), boxLow, boxHigh);
+        EXPECT_EQ(fromArray[i], direction);
+        EXPECT_EQ(fromSoa[i], direction);
+    }
+}
+#endif
+
+namespace
+{
+    const std::initializer_list<Fzolv::simd::Level> everyLevel{Fzolv::simd::Level::Scalar, Fzolv::simd::Level::SSE2,
+                                                               Fzolv::simd::Level::AVX2, Fzolv::simd::Level::NEON};
+
+    auto kernelName(const char *kernel, Fzolv::simd::Level level) -> std::string
+    {
+        return std::string{kernel} + "/" + Fzolv::simd::levelName(level);
+    }
+
+    ///< Print the errors of a kernel and record them in the XML output of the test
+    void report(const std::string &kernel, const accuracy::Errors &errors, double bound)
+    {
+        accuracy::print(kernel.c_str(), errors, bound);
+        testing::Test::RecordProperty(kernel + ".maxUlp", std::to_string(errors.maxUlp));
+        if (errors.relative)
+        {
+            testing::Test::RecordProperty(kernel + ".maxRelative", std::to_string(errors.maxRelative));
+        }
+        testing::Test::RecordProperty(kernel + ".maxAbsolute", std::to_string(errors.maxAbsolute));
+    }
+}
+
+TEST(AccuracyTest, RsqrtStaysWithinItsBound)
+{
+    std::vector<float> values = accuracy::randomFloats(20000, 71, -126, 127);
+    for (float value : accuracy::adversarialFloats())
+    {
+        if (std::isnormal(value) && value > 0.0f)
+        {
+            values.push_back(value);
+        }
+    }
+    accuracy::Errors errors;
+    for (float &value : values)
+    {
+        value = std::fabs(value);
+        errors.add(Fzolv::simd::rsqrt(value), 1.0L / std::sqrt(static_cast<long double>(value)));
+    }
+    report("simd::rsqrt", errors, Fzolv::simd::rsqrtMaxRelativeError);
+    EXPECT_LE(errors.maxRelative, Fzolv::simd::rsqrtMaxRelativeError);
+}
+
+TEST(AccuracyTest, NormalizeStaysWithinItsBoundOnEveryLevel)
+{
+    const std::vector<Fzolv::Vector2f> values = accuracy::adversarialVectors(20000, 73);
+    std::vector<long double> referenceX(values.size()), referenceY(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        accuracy::referenceNormalize(values[i], referenceX[i], referenceY[i]);
+    }
+
+    for (auto level : everyLevel)
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<Fzolv::Vector2f> exact(values.size()), fast(values.size());
+        Fzolv::batch::normalize(values, exact);
+        Fzolv::batch::normalizeFast(values, fast);
+
+        accuracy::Errors exactErrors, fastErrors;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            const float lengthSquared = values[i].lengthSquared();
+            if (lengthSquared >= FLT_MIN && lengthSquared <= FLT_MAX)
+            {
+                ///< normalize itself returns zero once the squared length underflows and loses precision when it
+                ///< is denormal, so both are measured where it is representable
+                exactErrors.add(exact[i].x, referenceX[i]);
+                exactErrors.add(exact[i].y, referenceY[i]);
+                fastErrors.add(fast[i].x, referenceX[i]);
+                fastErrors.add(fast[i].y, referenceY[i]);
+            }
+            else
+            {
+                ///< Zero, denormal and overflowing squared lengths are documented to take the exact path
+                ASSERT_EQ(std::memcmp(&fast[i], &exact[i], sizeof(Fzolv::Vector2f)), 0) << values[i].x << " " << values[i].y;
+            }
+        }
+        report(kernelName("batch::normalize", level), exactErrors, accuracy::noBound);
+        report(kernelName("batch::normalizeFast", level), fastErrors, Fzolv::normalizeFastMaxRelativeError);
+        EXPECT_LE(fastErrors.maxRelative, Fzolv::normalizeFastMaxRelativeError);
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(AccuracyTest, HalfConversionIsCorrectlyRoundedOnEveryLevel)
+{
+    std::vector<float> values = accuracy::randomFloats(20000, 79, -30, 17);
+    for (float value : accuracy::adversarialFloats())
+    {
+        values.push_back(value);
+    }
+    values.push_back(std::nanf(""));
+    std::vector<Fzolv::Half> everyHalf(65536);
+    for (std::size_t bits = 0; bits < everyHalf.size(); ++bits)
+    {
+        everyHalf[bits] = Fzolv::Half::FromBits(static_cast<std::uint16_t>(bits));
+    }
+
+    for (auto level : everyLevel)
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<Fzolv::Half> halves(values.size());
+        Fzolv::batch::toHalf(values, halves);
+        accuracy::Errors narrowing;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            const long double reference = accuracy::referenceHalf(values[i]);
+            const float narrowed = halves[i];
+            narrowing.add(narrowed, reference, accuracy::halfUlpOf(reference));
+            ASSERT_TRUE(std::isnan(reference) ? std::isnan(narrowed)
+                                              : static_cast<long double>(narrowed) == reference &&
+                                                    std::signbit(narrowed) == std::signbit(reference))
+                << values[i];
+        }
+        report(kernelName("batch::toHalf", level), narrowing, 0.5);
+        EXPECT_LE(narrowing.maxUlp, 0.5);
+
+        std::vector<float> widened(everyHalf.size());
+        Fzolv::batch::toFloat(everyHalf, widened);
+        accuracy::Errors widening;
+        for (std::size_t bits = 0; bits < everyHalf.size(); ++bits)
+        {
+            const int exponent = static_cast<int>(bits >> 10 & 0x1F);
+            const long double mantissa = static_cast<long double>(bits & 0x3FF);
+            long double reference = exponent == 0 ? std::ldexp(mantissa, -24)
+                                                  : std::ldexp(1024.0L + mantissa, exponent - 25);
+            if (exponent == 0x1F)
+            {
+                reference = (bits & 0x3FF) != 0 ? std::numeric_limits<long double>::quiet_NaN()
+                                                : std::numeric_limits<long double>::infinity();
+            }
+            reference = (bits & 0x8000) != 0 ? -reference : reference;
+            widening.add(widened[bits], reference);
+        }
+        report(kernelName("batch::toFloat", level), widening, 0.0);
+        EXPECT_EQ(widening.maxUlp, 0.0);
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(AccuracyTest, SmallestThreeStaysWithinItsBoundsOnEveryLevel)
+{
+    std::mt19937 rng{83};
+    std::normal_distribution<float> dist{0.0f, 1.0f};
+    std::vector<Fzolv::Vector3f> directions{{1.0f, 0.0f, 0.0f},  {0.0f, -1.0f, 0.0f}, {-0.0f, 0.0f, 1.0f},
+                                            {1.0f, 1.0f, 1.0f},  {1.0f, 1.0f, 0.0f},  {1.0f, 1e-30f, -1e-40f},
+                                            {-1.0f, -1.0f, 1.0f}};
+    std::vector<Fzolv::Quaternionf> rotations{{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f, -1.0f},
+                                              {0.5f, 0.5f, 0.5f, 0.5f}, {1.0f, 1.0f, 0.0f, 0.0f},
+                                              {1e-30f, 0.0f, -1e-40f, 1.0f}};
+    while (directions.size() < 5000)
+    {
+        directions.push_back({dist(rng), dist(rng), dist(rng)});
+        rotations.push_back({dist(rng), dist(rng), dist(rng), dist(rng)});
+    }
+    for (auto &direction : directions)
+    {
+        direction.normalize();
+    }
+    for (auto &rotation : rotations)
+    {
+        rotation = rotation.normalized();
+    }
+    ///< The bounds are absolute, so errors are counted in ulps of the unit components rather than of each value
+    const long double unitUlp = accuracy::ulpOf(1.0L);
+
+    for (auto level : everyLevel)
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        std::vector<std::uint32_t> words(directions.size());
+        std::vector<Fzolv::Vector3f> decodedDirections(directions.size());
+        Fzolv::batch::encodeUnitVectors(directions, words);
+        Fzolv::batch::decodeUnitVectors(words, decodedDirections);
+        accuracy::Errors directionErrors = accuracy::Errors::absolute();
+        for (std::size_t i = 0; i < directions.size(); ++i)
+        {
+            directionErrors.add(decodedDirections[i].x, directions[i].x, unitUlp);
+            directionErrors.add(decodedDirections[i].y, directions[i].y, unitUlp);
+            directionErrors.add(decodedDirections[i].z, directions[i].z, unitUlp);
+        }
+        report(kernelName("batch::encodeUnitVectors", level), directionErrors, 1e-4);
+        EXPECT_LE(directionErrors.maxAbsolute, 1e-4);
+
+        words.resize(rotations.size());
+        std::vector<Fzolv::Quaternionf> decodedRotations(rotations.size());
+        Fzolv::batch::encodeRotations(rotations, words);
+        Fzolv::batch::decodeRotations(words, decodedRotations);
+        accuracy::Errors rotationErrors = accuracy::Errors::absolute();
+        for (std::size_t i = 0; i < rotations.size(); ++i)
+        {
+            ///< q and -q are the same rotation, either may come back
+            const Fzolv::Quaternionf &q = decodedRotations[i];
+            const float sign = q.x * rotations[i].x + q.y * rotations[i].y + q.z * rotations[i].z +
+                                           q.w * rotations[i].w <
+                                       0.0f
+                                   ? -1.0f
+                                   : 1.0f;
+            rotationErrors.add(sign * q.x, rotations[i].x, unitUlp);
+            rotationErrors.add(sign * q.y, rotations[i].y, unitUlp);
+            rotationErrors.add(sign * q.z, rotations[i].z, unitUlp);
+            rotationErrors.add(sign * q.w, rotations[i].w, unitUlp);
+        }
+        report(kernelName("batch::encodeRotations", level), rotationErrors, 2e-3);
+        EXPECT_LE(rotationErrors.maxAbsolute, 2e-3);
+
+        ///< Words no encoder writes decode to the same bounded components as the scalar path
+        const std::vector<std::uint32_t> malformed = accuracy::malformedWords();
+        std::vector<Fzolv::Vector3f> malformedDirections(malformed.size());
+        std::vector<Fzolv::Quaternionf> malformedRotations(malformed.size());
+        Fzolv::batch::decodeUnitVectors(malformed, malformedDirections);
+        Fzolv::batch::decodeRotations(malformed, malformedRotations);
+        for (std::size_t i = 0; i < malformed.size(); ++i)
+        {
+            const Fzolv::Vector3f &d = malformedDirections[i];
+            const Fzolv::Quaternionf &q = malformedRotations[i];
+            EXPECT_EQ(d, Fzolv::decodeUnitVector(malformed[i])) << std::hex << malformed[i];
+            EXPECT_EQ(q, Fzolv::decodeRotation(malformed[i])) << std::hex << malformed[i];
+            for (float component : {d.x, d.y, d.z, q.x, q.y, q.z, q.w})
+            {
+                EXPECT_LE(std::fabs(component), 1.0f) << std::hex << malformed[i];
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(AccuracyTest, SlerpFastStaysWithinItsBoundOnEveryLevel)
+{
+    std::mt19937 rng{89};
+    std::normal_distribution<float> dist{0.0f, 1.0f};
+    std::vector<Fzolv::Quaternionf> start{{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f, 1.0f},
+                                          {0.5f, 0.5f, 0.5f, 0.5f}, {1.0f, 0.0f, 0.0f, 0.0f}};
+    std::vector<Fzolv::Quaternionf> end{{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f, 0.0f},
+                                        {0.5f, 0.5f, 0.5f, 0.5001f}, {0.0f, 0.0f, 1.0f, 1e-30f}};
+    while (start.size() < 5000)
+    {
+        start.push_back({dist(rng), dist(rng), dist(rng), dist(rng)});
+        end.push_back({dist(rng), dist(rng), dist(rng), dist(rng)});
+    }
+    for (std::size_t i = 0; i < start.size(); ++i)
+    {
+        start[i] = start[i].normalized();
+        end[i] = end[i].normalized();
+    }
+    ///< The series is within 1e-6 of slerp, the float evaluation adds a few roundings of unit components
+    const double bound = 1e-6 + 8.0 * FLT_EPSILON;
+    const long double unitUlp = accuracy::ulpOf(1.0L);
+
+    for (auto level : everyLevel)
+    {
+        if (!Fzolv::simd::setLevel(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(Fzolv::simd::levelName(level));
+        accuracy::Errors errors = accuracy::Errors::absolute();
+        std::vector<Fzolv::Quaternionf> blended(start.size());
+        for (float amount : {0.0f, 0.125f, 0.25f, 0.5f, 0.7f, 0.999f, 1.0f})
+        {
+            Fzolv::batch::slerp(start, end, amount, blended);
+            for (std::size_t i = 0; i < start.size(); ++i)
+            {
+                long double reference[4];
+                accuracy::referenceSlerp(start[i], end[i], amount, reference);
+                errors.add(blended[i].x, reference[0], unitUlp);
+                errors.add(blended[i].y, reference[1], unitUlp);
+                errors.add(blended[i].z, reference[2], unitUlp);
+                errors.add(blended[i].w, reference[3], unitUlp);
+            }
+        }
+        report(kernelName("batch::slerp", level), errors, bound);
+        EXPECT_LE(errors.maxAbsolute, bound);
+    }
+    Fzolv::simd::resetLevel();
+}
+
+TEST(AccuracyTest, QuantizerStaysWithinHalfAStepOnEveryLevel)
+{
+    ///< Bounds whose steps are not exact in float, one of them away from the origin
+    const Fzolv::AABB3f bounds{{-10.0f, -3.3f, 100.0f}, {10.0f, 7.1f, 164.0f}};
+    const Fzolv::Vector3f low = bounds.min;
+    const Fzolv::Vector3f high = bounds.max;
+    std::vector<Fzolv::Vector3f> samples = {low, high, bounds.center()};
+    std::mt19937 rng{97};
+    std::uniform_real_distribution<float> t{0.0f, 1.0f};
+    while (samples.size() < 20000)
+    {
+        samples.push_back(Fzolv::Vector3f{low.x + t(rng) * (high.x - low.x), low.y + t(rng) * (high.y - low.y),
+                                          low.z + t(rng) * (high.z - low.z)});
+    }
+
+    ///< Every few widths of each representation, the float codes up to 16 bits and the double ones above
+    for (unsigned bits : {1u, 4u, 8u, 13u, 16u, 17u, 20u, 24u})
+    {
+        SCOPED_TRACE(bits);
+        const Fzolv::Quantizer3f quantizer{bounds, bits};
+        std::vector<Fzolv::Vector3f> values = samples;
+        ///< The midpoints between neighbouring codes are the worst case
+        for (std::uint32_t code : {0u, 1u, quantizer.maxCode() / 2, quantizer.maxCode() - 1})
+        {
+            Fzolv::Vector3f midpoint;
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                (&midpoint.x)[k] = static_cast<float>(quantizer.minimum(k) + (code + 0.5) * quantizer.wideStep(k));
+            }
+            values.push_back(midpoint);
+        }
+
+        for (auto level : everyLevel)
+        {
+            if (!Fzolv::simd::setLevel(level))
+            {
+                continue;
+            }
+            SCOPED_TRACE(Fzolv::simd::levelName(level));
+            std::vector<std::uint8_t> stream(quantizer.encodedSize(values.size()));
+            std::vector<Fzolv::Vector3f> decoded(values.size());
+            Fzolv::batch::encode(quantizer, values, stream);
+            Fzolv::batch::decode(quantizer, stream, decoded);
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                ///< Errors are counted in steps: half a step, the documented 2^(bits - 20) steps of float codes and
+                ///< the roundings of minimum + code * step
+                const long double step = quantizer.wideStep(k);
+                const long double magnitude = std::fmax(std::fabs((&low.x)[k]), std::fabs((&high.x)[k]));
+                const long double slack = quantizer.isWide() ? 0.0L : std::ldexp(1.0L, static_cast<int>(bits) - 20);
+                const double bound = static_cast<double>(0.5L + slack + accuracy::ulpOf(magnitude) / step);
+                accuracy::Errors errors = accuracy::Errors::absolute();
+                for (std::size_t i = 0; i < values.size(); ++i)
+                {
+                    errors.add((&decoded[i].x)[k], (&values[i].x)[k], step);
+                }
+                const std::string axis = "batch::encode/" + std::to_string(bits) + "/" + "xyz"[k];
+                report(kernelName(axis.c_str(), level), errors, bound);
+                EXPECT_LE(errors.maxUlp, bound);
+            }
+        }
+    }
+    Fzolv::simd::resetLevel();
+}